@@ -0,0 +1,366 @@
+// mantrax-cook: convierte los assets fuente a los formatos que carga el runtime sin procesar nada.
+//   modelos  → <fuente>.mxmesh (MeshImporter: Assimp + optimización + LODs + meshlets)
+//   texturas → <fuente>.ktx2   (BC + mips, TextureCompressor)
+//   shaders  → <fuente>.spv    (glslc del Vulkan SDK)
+// Solo CPU, sin GPU ni ventana. Cada archivo es un trabajo del TaskPool y lo que ya está al
+// día se salta: el ImportCache (<asset dir>/ImportCache.idx) compara el contenido de cada fuente
+// y los ajustes con los del último cook, así que volver a correrlo solo cocina lo que cambió.
+
+#include "../../MantraxECS/include/MeshImporter.h"
+#include "../../MantraxECS/include/MeshCache.h"
+#include "../../MantraxECS/include/TextureCompressor.h"
+#include "../../MantraxECS/include/KTX2.h"
+#include "../../MantraxECS/include/AssetArchive.h"
+#include "../../MantraxECS/include/ImportCache.h"
+#include "../../MantraxECS/include/TaskPool.h"
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <future>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    enum class AssetKind
+    {
+        Unknown,
+        Model,
+        Texture,
+        Shader
+    };
+
+    enum class CookResult
+    {
+        Cooked,
+        UpToDate,
+        Failed
+    };
+
+    struct CookOptions
+    {
+        fs::path inputDir;
+        std::string packPath;          // Vacío = sin .mxpak
+        std::string glslc = "glslc";   // Compilador de shaders
+        uint32_t threads = 0;          // 0 = todos los núcleos
+        bool force = false;
+    };
+
+    std::string GetExtension(const fs::path &path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c)
+                       { return static_cast<char>(std::tolower(c)); });
+        return extension;
+    }
+
+    AssetKind Classify(const fs::path &path)
+    {
+        static const char *const models[] = {".fbx", ".obj", ".gltf", ".glb", ".dae", ".3ds", ".blend"};
+        static const char *const textures[] = {".png", ".jpg", ".jpeg", ".tga", ".bmp"};
+        static const char *const shaders[] = {".vert", ".frag", ".comp", ".geom", ".tesc", ".tese"};
+
+        const std::string extension = GetExtension(path);
+        for (const char *ext : models)
+            if (extension == ext)
+                return AssetKind::Model;
+        for (const char *ext : textures)
+            if (extension == ext)
+                return AssetKind::Texture;
+        for (const char *ext : shaders)
+            if (extension == ext)
+                return AssetKind::Shader;
+        return AssetKind::Unknown;
+    }
+
+    // Por nombre, como los exportan Substance / Blender: decide BC5 para normales y sin sRGB para máscaras
+    Mantrax::TextureUsage GuessTextureUsage(const fs::path &path)
+    {
+        std::string name = path.stem().string();
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c)
+                       { return static_cast<char>(std::tolower(c)); });
+
+        static const char *const normal[] = {"normal", "_nrm", "_nor", "_n"};
+        static const char *const mask[] = {"metal", "rough", "_ao", "occlusion", "orm", "mask", "spec", "height"};
+
+        auto endsOrContains = [&name](const char *token)
+        {
+            const std::string t(token);
+            if (t[0] != '_')
+                return name.find(t) != std::string::npos;
+            return name.size() >= t.size() && name.compare(name.size() - t.size(), t.size(), t) == 0;
+        };
+
+        for (const char *token : normal)
+            if (endsOrContains(token))
+                return Mantrax::TextureUsage::Normal;
+        for (const char *token : mask)
+            if (endsOrContains(token))
+                return Mantrax::TextureUsage::Mask;
+        return Mantrax::TextureUsage::Color;
+    }
+
+    bool IsNewer(const fs::path &output, const fs::path &source)
+    {
+        std::error_code ec;
+        auto outputTime = fs::last_write_time(output, ec);
+        if (ec)
+            return false;
+        auto sourceTime = fs::last_write_time(source, ec);
+        return !ec && outputTime >= sourceTime;
+    }
+
+    CookResult CookModel(const fs::path &path, const CookOptions &options)
+    {
+        const std::string source = path.string();
+        const Mantrax::MeshImportSettings settings; // Los de ModelManager por defecto
+        const uint64_t settingsHash = settings.GetHash();
+
+        if (!options.force)
+        {
+            Mantrax::MappedFile file;
+            Mantrax::MeshSource cached;
+            if (Mantrax::MeshCache::Open(source, settingsHash, file, cached))
+                return CookResult::UpToDate;
+        }
+
+        auto imported = Mantrax::MeshImporter::Import(source, settings, false);
+        if (!Mantrax::MeshCache::Save(source, settingsHash, imported->source))
+        {
+            std::cerr << "❌ Could not write " << Mantrax::MeshCache::GetCachePath(source) << std::endl;
+            return CookResult::Failed;
+        }
+
+        std::cout << "✅ Cooked " << source << " → " << Mantrax::MeshCache::GetCachePath(source) << std::endl;
+        return CookResult::Cooked;
+    }
+
+    CookResult CookTexture(const fs::path &path, const CookOptions &options)
+    {
+        const std::string source = path.string();
+        const std::string cookedPath = Mantrax::KTX2::GetCookedPath(source);
+        const Mantrax::TextureUsage usage = GuessTextureUsage(path);
+        const uint64_t settingsHash = Mantrax::TextureCompressor::GetSettingsHash(usage);
+        if (!options.force && !Mantrax::KTX2::IsStale(source, settingsHash))
+        {
+            // Al día por fecha pero sin registro (cocinado antes del índice): se adopta para la próxima
+            if (Mantrax::ImportCache::Check(source, cookedPath, settingsHash) == Mantrax::ImportState::Unknown)
+                Mantrax::ImportCache::Record(source, cookedPath, settingsHash);
+            return CookResult::UpToDate;
+        }
+
+        const bool cooked = Mantrax::TextureCompressor::CookFile(source, cookedPath, usage);
+        return cooked ? CookResult::Cooked : CookResult::Failed;
+    }
+
+    // Sin compilador GLSL en el árbol: se usa glslc, como compile_shaders.bat
+    CookResult CookShader(const fs::path &path, const CookOptions &options)
+    {
+        const fs::path output = path.string() + ".spv";
+        const uint64_t settingsHash = Mantrax::ImportCache::HashBytes(options.glslc.data(), options.glslc.size());
+        if (!options.force)
+        {
+            switch (Mantrax::ImportCache::Check(path.string(), output.string(), settingsHash))
+            {
+            case Mantrax::ImportState::UpToDate:
+                return CookResult::UpToDate;
+            case Mantrax::ImportState::Unknown:
+                // Sin registro (primer cook con el índice): por fecha, y se registra para la próxima
+                if (IsNewer(output, path))
+                {
+                    Mantrax::ImportCache::Record(path.string(), output.string(), settingsHash);
+                    return CookResult::UpToDate;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        const fs::path tempPath = output.string() + ".tmp";
+        std::string command = "\"" + options.glslc + "\" \"" + path.string() + "\" -o \"" + tempPath.string() + "\"";
+#ifdef _WIN32
+        // cmd /c quita las comillas exteriores
+        command = "\"" + command + "\"";
+#endif
+
+        std::error_code ec;
+        if (std::system(command.c_str()) != 0)
+        {
+            fs::remove(tempPath, ec);
+            std::cerr << "❌ glslc failed: " << path.string() << std::endl;
+            return CookResult::Failed;
+        }
+
+        fs::rename(tempPath, output, ec);
+        if (ec)
+        {
+            fs::remove(tempPath, ec);
+            std::cerr << "❌ Could not write " << output.string() << std::endl;
+            return CookResult::Failed;
+        }
+
+        Mantrax::ImportCache::Record(path.string(), output.string(), settingsHash);
+        std::cout << "✅ Compiled " << path.string() << " → " << output.string() << std::endl;
+        return CookResult::Cooked;
+    }
+
+    // Lo que lee el runtime: artefactos cocinados + imágenes fuente (respaldo si la GPU no tiene BC)
+    bool IsPackable(const fs::path &path)
+    {
+        const std::string extension = GetExtension(path);
+        return extension == ".mxmesh" || extension == ".ktx2" || extension == ".spv" ||
+               Classify(path) == AssetKind::Texture;
+    }
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: mantrax-cook <asset dir> [options]\n"
+                  << "  --pack <file.mxpak>  Pack the cooked assets (paths relative to <asset dir>)\n"
+                  << "  --jobs <n>           Worker threads (default: all cores)\n"
+                  << "  --glslc <path>       Shader compiler (default: glslc in PATH)\n"
+                  << "  --force              Cook everything, even if up to date\n";
+    }
+
+    bool ParseArguments(int argc, char **argv, CookOptions &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (arg == "--pack" && hasValue)
+                options.packPath = argv[++i];
+            else if (arg == "--jobs" && hasValue)
+                options.threads = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+            else if (arg == "--glslc" && hasValue)
+                options.glslc = argv[++i];
+            else if (arg == "--force")
+                options.force = true;
+            else if (!arg.empty() && arg[0] != '-' && options.inputDir.empty())
+                options.inputDir = arg;
+            else
+                return false;
+        }
+        return !options.inputDir.empty();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    CookOptions options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    std::error_code ec;
+    if (!fs::is_directory(options.inputDir, ec))
+    {
+        std::cerr << "❌ Not a directory: " << options.inputDir.string() << std::endl;
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    Mantrax::ImportCache::SetIndexPath((options.inputDir / "ImportCache.idx").string());
+
+    std::vector<std::pair<fs::path, AssetKind>> assets;
+    for (auto it = fs::recursive_directory_iterator(options.inputDir, fs::directory_options::skip_permission_denied, ec);
+         it != fs::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (ec)
+            break;
+        if (!it->is_regular_file(ec))
+            continue;
+
+        AssetKind kind = Classify(it->path());
+        if (kind != AssetKind::Unknown)
+            assets.emplace_back(it->path(), kind);
+    }
+
+    const uint32_t threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "🍳 Cooking " << assets.size() << " assets from " << options.inputDir.string()
+              << " on " << threads << " threads" << std::endl;
+
+    size_t counts[3] = {};
+    {
+        Mantrax::TaskPool pool(threads);
+        std::vector<std::future<CookResult>> jobs;
+        jobs.reserve(assets.size());
+
+        for (const auto &[path, kind] : assets)
+        {
+            jobs.push_back(pool.Submit([path = path, kind = kind, &options]()
+                                       {
+                switch (kind)
+                {
+                case AssetKind::Model:
+                    return CookModel(path, options);
+                case AssetKind::Texture:
+                    return CookTexture(path, options);
+                default:
+                    return CookShader(path, options);
+                } }));
+        }
+
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            CookResult result = CookResult::Failed;
+            try
+            {
+                result = jobs[i].get();
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "❌ " << assets[i].first.string() << ": " << e.what() << std::endl;
+            }
+            counts[static_cast<int>(result)]++;
+        }
+    }
+
+    // Aunque algo falle: lo que sí se cocinó queda registrado
+    Mantrax::ImportCache::Save();
+
+    bool success = counts[static_cast<int>(CookResult::Failed)] == 0;
+
+    if (!options.packPath.empty() && success)
+    {
+        const fs::path packPath = fs::absolute(options.packPath, ec);
+
+        std::vector<std::string> files;
+        for (auto it = fs::recursive_directory_iterator(options.inputDir, fs::directory_options::skip_permission_denied, ec);
+             it != fs::recursive_directory_iterator(); it.increment(ec))
+        {
+            if (ec)
+                break;
+            if (it->is_regular_file(ec) && IsPackable(it->path()) && fs::absolute(it->path(), ec) != packPath)
+                files.push_back(it->path().lexically_relative(options.inputDir).generic_string());
+        }
+
+        std::string error;
+        if (!Mantrax::AssetArchive::Build(options.packPath, options.inputDir.string(), files,
+                                          Mantrax::AssetArchiveBuildSettings{}, error))
+        {
+            std::cerr << "❌ Could not build " << options.packPath << ": " << error << std::endl;
+            success = false;
+        }
+    }
+
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << (success ? "✅" : "❌") << " Cook finished in " << seconds << " s: "
+              << counts[static_cast<int>(CookResult::Cooked)] << " cooked, "
+              << counts[static_cast<int>(CookResult::UpToDate)] << " up to date, "
+              << counts[static_cast<int>(CookResult::Failed)] << " failed" << std::endl;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    enum class AssetCompression : uint32_t
+    {
+        None = 0,
+        LZ4 = 1,
+    };
+
+    // Entrada de la tabla de contenidos: ordenada por pathHash para buscar en O(log n)
+    struct MANTRAX_API AssetArchiveEntry
+    {
+        uint64_t pathHash;   // FNV-1a de la ruta normalizada
+        uint64_t offset;     // Desde el inicio del archivo, alineado a AssetArchive::ALIGNMENT
+        uint64_t storedSize; // Bytes en el archivo (comprimidos o no)
+        uint64_t size;       // Bytes originales
+        uint32_t compression; // AssetCompression
+        uint32_t pathOffset;  // En la tabla de nombres (para colisiones de hash y listados)
+    };
+
+    struct MANTRAX_API AssetArchiveBuildSettings
+    {
+        AssetCompression compression = AssetCompression::LZ4;
+        float minSavings = 0.1f; // Si no ahorra al menos esto se guarda sin comprimir
+        // Se guardan tal cual: ya comprimidos, o leídos en sitio desde el mapeo (.mxmesh)
+        std::vector<std::string> storedExtensions = {".mxmesh", ".png", ".jpg", ".jpeg"};
+    };
+
+    // Paquete .mxpak: un solo archivo mapeado con todos los assets. Sustituye un open/seek/read
+    // por asset por una búsqueda en la tabla; las entradas sin comprimir se leen en sitio desde
+    // el mapeo (alineadas, listas para copiar al staging) y las LZ4 se descomprimen al leerlas.
+    // Montado con Mount(), MappedFile::Open lo consulta antes que el disco
+    class MANTRAX_API AssetArchive
+    {
+    public:
+        static constexpr uint64_t ALIGNMENT = 64;
+
+        AssetArchive() = default;
+        ~AssetArchive();
+
+        AssetArchive(const AssetArchive &) = delete;
+        AssetArchive &operator=(const AssetArchive &) = delete;
+
+        bool Open(const std::string &path);
+        void Close();
+
+        bool IsOpen() const { return m_File.IsOpen(); }
+        const std::string &GetPath() const { return m_Path; }
+        size_t GetEntryCount() const { return m_EntryCount; }
+        const AssetArchiveEntry &GetEntry(size_t index) const { return m_Entries[index]; }
+        std::string GetEntryPath(const AssetArchiveEntry &entry) const;
+
+        // Ruta ya normalizada (NormalizePath); nullptr si no está
+        const AssetArchiveEntry *Find(const std::string &normalizedPath) const;
+
+        // Entrada sin comprimir: puntero al mapeo (vive lo que viva el archivo). nullptr si está comprimida
+        const uint8_t *GetStoredData(const AssetArchiveEntry &entry) const;
+
+        // Copia o descomprime la entrada completa
+        bool Read(const AssetArchiveEntry &entry, std::vector<uint8_t> &out) const;
+
+        // Relativa a root (por defecto el directorio de trabajo), con '/' y en minúsculas.
+        // Vacía si la ruta queda fuera de root
+        static std::string NormalizePath(const std::string &path, const std::string &root = "");
+        static uint64_t HashPath(const std::string &normalizedPath);
+
+        // files: rutas relativas a rootDir; se guardan con su ruta normalizada
+        static bool Build(const std::string &archivePath, const std::string &rootDir,
+                          const std::vector<std::string> &files,
+                          const AssetArchiveBuildSettings &settings, std::string &error);
+
+        // Las rutas se resuelven relativas a mountRoot (por defecto el directorio de trabajo).
+        // Si varios contienen la misma ruta gana el último montado (parches sobre el base)
+        static bool Mount(const std::string &archivePath, const std::string &mountRoot = "");
+        static void Unmount(const std::string &archivePath);
+        static void UnmountAll();
+        static bool HasMounted();
+
+        // Archivo montado que contiene path (sin normalizar) y su entrada
+        static std::shared_ptr<const AssetArchive> FindMounted(const std::string &path,
+                                                               const AssetArchiveEntry *&outEntry);
+
+    private:
+        MappedFile m_File;
+        std::string m_Path;
+        std::string m_MountRoot;
+        const AssetArchiveEntry *m_Entries = nullptr;
+        size_t m_EntryCount = 0;
+        const char *m_Names = nullptr;
+        size_t m_NamesSize = 0;
+    };
+}
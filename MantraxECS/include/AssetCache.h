@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../../MantraxRender/include/MantraxGFX_API.h"
+#include "IService.h"
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Recursos de un tipo por clave. Guarda weak_ptr: el refcount es el del shared_ptr, así que
+    // el recurso vive mientras alguien lo use y se descarga (DeletionQueue) al soltar el último
+    template <typename T>
+    class AssetRegistry
+    {
+    public:
+        std::shared_ptr<T> Find(const std::string &key)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            auto it = m_Entries.find(key);
+            if (it != m_Entries.end())
+            {
+                if (auto asset = it->second.lock())
+                {
+                    m_Hits++;
+                    return asset;
+                }
+                m_Entries.erase(it);
+            }
+
+            m_Misses++;
+            return nullptr;
+        }
+
+        // Si la clave ya tiene un recurso vivo se devuelve ese y 'asset' se descarta
+        std::shared_ptr<T> Add(const std::string &key, std::shared_ptr<T> asset)
+        {
+            if (!asset)
+                return nullptr;
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            auto &entry = m_Entries[key];
+            if (auto existing = entry.lock())
+                return existing;
+
+            entry = asset;
+            return asset;
+        }
+
+        // Quita las entradas cuyo recurso ya se descargó; devuelve las vivas
+        size_t Prune()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            for (auto it = m_Entries.begin(); it != m_Entries.end();)
+            {
+                if (it->second.expired())
+                    it = m_Entries.erase(it);
+                else
+                    ++it;
+            }
+            return m_Entries.size();
+        }
+
+        uint64_t GetHits() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_Hits;
+        }
+
+        uint64_t GetMisses() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_Misses;
+        }
+
+    private:
+        std::unordered_map<std::string, std::weak_ptr<T>> m_Entries;
+        uint64_t m_Hits = 0;
+        uint64_t m_Misses = 0;
+        mutable std::mutex m_Mutex;
+    };
+
+    struct MANTRAX_API AssetCacheStats
+    {
+        size_t meshes = 0;   // Geometrías vivas (cada modelo es una instancia con su UBO)
+        size_t textures = 0; // Texturas vivas
+        uint64_t hits = 0;   // Peticiones servidas sin importar ni subir nada
+        uint64_t misses = 0;
+    };
+
+    // Registro central de recursos de GPU por ruta canónica + ajustes de import, compartido por
+    // ModelManager y MaterialManager: repetir un asset devuelve el mismo recurso sin volver a
+    // decodificarlo ni subirlo. Servicio "AssetCache" del ServiceLocator
+    class MANTRAX_API AssetCache : public IService
+    {
+    public:
+        std::string getName() override { return "AssetCache"; }
+
+        // El registrado en el ServiceLocator (lo crea la primera vez)
+        static std::shared_ptr<AssetCache> Shared();
+
+        // Ruta absoluta normalizada (en Windows sin distinguir mayúsculas) + hash de ajustes
+        static std::string MakeKey(const std::string &path, uint64_t settingsHash = 0);
+
+        // Geometría importada: los objetos usan GFX::CreateMeshInstance sobre ella
+        AssetRegistry<Mesh> &Meshes() { return m_Meshes; }
+        AssetRegistry<Texture> &Textures() { return m_Textures; }
+
+        AssetCacheStats GetStats();
+
+    private:
+        AssetRegistry<Mesh> m_Meshes;
+        AssetRegistry<Texture> m_Textures;
+    };
+}
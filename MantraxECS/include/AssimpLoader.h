@@ -3,10 +3,13 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <numeric>
+#include <algorithm>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include "../../MantraxRender/include/MantraxGFX_API.h"
+#include "MeshOptimizer.h"
 #include "EngineLoaderDLL.h"
 
 namespace Mantrax
@@ -26,6 +29,7 @@ namespace Mantrax
             bool preTransform = true;
             bool globalScale = true;
             bool genSmoothNormals = false;
+            bool optimizeMesh = true; // MeshOptimizer tras ProcessMesh (sustituye a ImproveCacheLocality)
 
             unsigned int GetFlags() const
             {
@@ -47,7 +51,8 @@ namespace Mantrax
 
                 // ✅ Flags adicionales recomendados
                 flags |= aiProcess_JoinIdenticalVertices; // Optimiza vértices duplicados
-                flags |= aiProcess_ImproveCacheLocality;  // Optimiza para cache GPU
+                if (!optimizeMesh)
+                    flags |= aiProcess_ImproveCacheLocality; // Optimiza para cache GPU
                 flags |= aiProcess_ValidateDataStructure; // Valida la estructura
 
                 return flags;
@@ -65,6 +70,7 @@ namespace Mantrax
             bool hasTexCoords = false;
             bool hasTangents = false;
             bool hasColors = false;
+            std::vector<std::string> materialNames; // Por slot (MeshSubmesh::materialSlot)
         };
 
         bool LoadModel(
@@ -83,9 +89,24 @@ namespace Mantrax
             std::vector<uint32_t> &indices,
             const LoadSettings &settings,
             bool verbose = true)
+        {
+            std::vector<MeshSubmesh> submeshes;
+            return LoadModel(path, vertices, indices, submeshes, settings, verbose);
+        }
+
+        // Un submesh por material: los aiMesh que comparten material quedan en un rango
+        // contiguo del index buffer (se dibujan con un solo draw)
+        bool LoadModel(
+            const std::string &path,
+            std::vector<Mantrax::Vertex> &vertices,
+            std::vector<uint32_t> &indices,
+            std::vector<MeshSubmesh> &submeshes,
+            const LoadSettings &settings,
+            bool verbose = true)
         {
             vertices.clear();
             indices.clear();
+            submeshes.clear();
 
             Assimp::Importer importer;
             const aiScene *scene = importer.ReadFile(path, settings.GetFlags());
@@ -102,15 +123,25 @@ namespace Mantrax
             m_modelInfo.filePath = path;
             m_modelInfo.numMeshes = scene->mNumMeshes;
             m_modelInfo.numMaterials = scene->mNumMaterials;
+            m_modelInfo.materialNames.clear();
+            for (unsigned int i = 0; i < scene->mNumMaterials; i++)
+                m_modelInfo.materialNames.push_back(scene->mMaterials[i]->GetName().C_Str());
 
             if (verbose)
             {
                 PrintModelInfo(scene, path);
             }
 
+            // ✅ Mallas ordenadas por material (estable: dentro de cada uno, el orden del archivo)
+            std::vector<unsigned int> order(scene->mNumMeshes);
+            std::iota(order.begin(), order.end(), 0u);
+            std::stable_sort(order.begin(), order.end(),
+                             [scene](unsigned int a, unsigned int b)
+                             { return scene->mMeshes[a]->mMaterialIndex < scene->mMeshes[b]->mMaterialIndex; });
+
             // ✅ FIX CRÍTICO: No usar indexOffset acumulativo
             // Procesar todas las mallas
-            for (unsigned int m = 0; m < scene->mNumMeshes; m++)
+            for (unsigned int m : order)
             {
                 aiMesh *mesh = scene->mMeshes[m];
 
@@ -118,7 +149,7 @@ namespace Mantrax
                 {
                     std::cout << "  📦 Mesh " << m << ": "
                               << mesh->mNumVertices << " verts, "
-                              << mesh->mNumFaces << " faces";
+                              << mesh->mNumFaces << " faces, material " << mesh->mMaterialIndex;
 
                     if (mesh->HasTextureCoords(0))
                         std::cout << " [has UVs]";
@@ -130,11 +161,35 @@ namespace Mantrax
                     std::cout << "\n";
                 }
 
+                if (submeshes.empty() || submeshes.back().materialSlot != mesh->mMaterialIndex)
+                {
+                    MeshSubmesh submesh;
+                    submesh.firstIndex = static_cast<uint32_t>(indices.size());
+                    submesh.materialSlot = mesh->mMaterialIndex;
+                    submeshes.push_back(submesh);
+                }
+
                 // ✅ Cada mesh agrega sus vértices/índices independientemente
                 uint32_t vertexOffset = static_cast<uint32_t>(vertices.size());
                 ProcessMesh(mesh, vertices, indices, vertexOffset);
+
+                submeshes.back().indexCount = static_cast<uint32_t>(indices.size()) - submeshes.back().firstIndex;
             }
 
+            // Materiales sin triángulos (solo puntos / líneas)
+            submeshes.erase(std::remove_if(submeshes.begin(), submeshes.end(),
+                                           [](const MeshSubmesh &submesh)
+                                           { return submesh.indexCount == 0; }),
+                            submeshes.end());
+
+            // ✅ Vertex cache / overdraw por submesh, vertex fetch sobre el mesh combinado
+            if (settings.optimizeMesh)
+            {
+                MeshOptimizer::Optimize(vertices, indices, submeshes, MeshOptimizeSettings{}, verbose);
+            }
+
+            ComputeSubmeshBounds(vertices, indices, submeshes);
+
             // Actualizar información del modelo
             m_modelInfo.totalVertices = static_cast<unsigned int>(vertices.size());
             m_modelInfo.totalIndices = static_cast<unsigned int>(indices.size());
@@ -145,6 +200,7 @@ namespace Mantrax
                 std::cout << "   Total vertices: " << m_modelInfo.totalVertices << "\n";
                 std::cout << "   Total indices: " << m_modelInfo.totalIndices << "\n";
                 std::cout << "   Triangles: " << (m_modelInfo.totalIndices / 3) << "\n";
+                std::cout << "   Submeshes: " << submeshes.size() << "\n";
 
                 // ✅ Mostrar rango de UVs para debug
                 if (m_modelInfo.hasTexCoords && !vertices.empty())
@@ -269,6 +325,26 @@ namespace Mantrax
             }
         }
 
+        static void ComputeSubmeshBounds(
+            const std::vector<Mantrax::Vertex> &vertices,
+            const std::vector<uint32_t> &indices,
+            std::vector<MeshSubmesh> &submeshes)
+        {
+            for (auto &submesh : submeshes)
+            {
+                const Mantrax::Vertex &first = vertices[indices[submesh.firstIndex]];
+                submesh.boundsMin = submesh.boundsMax = glm::vec3(first.position[0], first.position[1], first.position[2]);
+
+                for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; i++)
+                {
+                    const Mantrax::Vertex &v = vertices[indices[i]];
+                    glm::vec3 p(v.position[0], v.position[1], v.position[2]);
+                    submesh.boundsMin = glm::min(submesh.boundsMin, p);
+                    submesh.boundsMax = glm::max(submesh.boundsMax, p);
+                }
+            }
+        }
+
         void PrintModelInfo(const aiScene *scene, const std::string &path)
         {
             std::cout << "\n=== 📁 Model Loading Info ===\n";
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    enum class ImportState
+    {
+        Unknown,        // Sin registro del artefacto (o se reemplazó por fuera): decidir por fecha
+        UpToDate,       // Mismo contenido de la fuente y mismos ajustes
+        SourceChanged,  // La fuente cambió de contenido: hay que volver a importar
+        SettingsChanged // Misma fuente, otros ajustes de import/cook
+    };
+
+    // Qué contenido (hash de los bytes de la fuente) y qué ajustes produjeron cada artefacto
+    // cocinado (.mxmesh, .ktx2, .spv). Cambiar la fecha sin cambiar el contenido (checkout, copia)
+    // no invalida nada, y editar un asset solo invalida lo suyo.
+    // Los hashes se memorizan por ruta + tamaño + fecha en un índice persistente: al arrancar solo
+    // se vuelve a leer lo que se tocó. Compartido por el runtime y mantrax-cook; thread-safe
+    class MANTRAX_API ImportCache
+    {
+    public:
+        // Por defecto "ImportCache.idx" en el directorio de trabajo; se carga al primer uso
+        static void SetIndexPath(const std::string &path);
+
+        // Hash del contenido del archivo en disco; 0 si no existe
+        static uint64_t GetContentHash(const std::string &path);
+
+        static ImportState Check(const std::string &sourcePath, const std::string &artifactPath,
+                                 uint64_t settingsHash);
+
+        // Después de escribir el artefacto
+        static void Record(const std::string &sourcePath, const std::string &artifactPath,
+                           uint64_t settingsHash);
+
+        // Escribe el índice si cambió desde la última vez
+        static bool Save();
+
+        // Hash no criptográfico de 64 bits, 8 bytes por paso
+        static uint64_t HashBytes(const void *data, size_t size, uint64_t seed = 0xcbf29ce484222325ull);
+    };
+}
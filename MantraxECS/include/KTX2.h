@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../../MantraxRender/include/MantraxGFX_API.h"
+#include "TextureCompressor.h"
+#include <string>
+#include <memory>
+
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Contenedor KTX2 (Khronos): 2D, una capa, una cara, sin supercompresión.
+    // Formatos: los que entiende TextureImageData (RGBA8, BC1/3/5/7, ASTC 4x4)
+    class MANTRAX_API KTX2
+    {
+    public:
+        static bool Load(const std::string &path, TextureImageData &outImage);
+        static bool Save(const std::string &path, const TextureImageData &image);
+
+        // <fuente>.ktx2, o la propia ruta si ya es un .ktx2
+        static std::string GetCookedPath(const std::string &sourcePath);
+
+        // Falta el .ktx2 o la fuente cambió de contenido (ImportCache); settingsHash != 0 también
+        // lo invalida si se cocinó con otros ajustes. Sin registro en el ImportCache se comparan
+        // fechas. Si solo está dentro de un .mxpak montado no hay nada que comparar y el paquete manda
+        static bool IsStale(const std::string &sourcePath, uint64_t settingsHash = 0);
+
+#ifndef MANTRAX_HEADLESS
+        // Versión cocinada de la fuente si existe, no quedó vieja (contenido de la fuente y ajustes
+        // de 'usage', ver IsStale) y el dispositivo soporta su formato (streameada, ver
+        // GFX::CreateStreamedTexture); nullptr para caer al loader de siempre
+        static std::shared_ptr<Texture> LoadCookedTexture(GFX *gfx, const std::string &sourcePath, TextureUsage usage);
+        // Solo la parte de CPU (lectura y comprobaciones): se puede llamar desde un worker
+        static std::shared_ptr<TextureImageData> LoadCookedImage(const GFX *gfx, const std::string &sourcePath,
+                                                                 TextureUsage usage);
+#endif
+    };
+}
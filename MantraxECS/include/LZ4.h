@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Formato de bloque LZ4 (compatible con LZ4_compress_default / LZ4_decompress_safe).
+    // Compresor greedy de una tabla hash: menos ratio que LZ4-HC pero la descompresión es
+    // la misma y es lo que importa al cargar
+    class MANTRAX_API LZ4
+    {
+    public:
+        static size_t CompressBound(size_t size);
+
+        // Devuelve el bloque comprimido (vacío si size == 0)
+        static std::vector<uint8_t> Compress(const uint8_t *src, size_t size);
+
+        // dstSize es el tamaño original exacto; false si el bloque está corrupto o no cuadra
+        static bool Decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize);
+    };
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    class AssetArchive;
+
+    // Archivo de solo lectura mapeado en memoria (MapViewOfFile / mmap): las páginas
+    // las trae el sistema al tocarlas, sin copia intermedia a un buffer propio.
+    // Si la ruta está en un .mxpak montado se sirve desde ahí (ver AssetArchive)
+    class MANTRAX_API MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        bool Open(const std::string &path, bool searchArchives = true);
+        void Close();
+
+        // En un .mxpak montado o en disco
+        static bool Exists(const std::string &path);
+
+        bool IsOpen() const { return m_Data != nullptr; }
+        const uint8_t *GetData() const { return m_Data; }
+        size_t GetSize() const { return m_Size; }
+
+    private:
+        bool OpenFromArchive(const std::string &path);
+        bool MapFromDisk(const std::string &path);
+        void Unmap();
+
+        const uint8_t *m_Data = nullptr;
+        size_t m_Size = 0;
+#ifdef _WIN32
+        void *m_File = nullptr;    // HANDLE
+        void *m_Mapping = nullptr; // HANDLE
+#else
+        int m_Fd = -1;
+#endif
+        std::vector<uint8_t> m_Buffer;                 // Entrada LZ4 de un .mxpak, ya descomprimida
+        std::shared_ptr<const AssetArchive> m_Archive; // Entrada sin comprimir: vista sobre su mapeo
+    };
+}
@@ -2,6 +2,8 @@
 
 #include "../../MantraxRender/include/MantraxGFX_API.h"
 #include "TextureLoader.h"
+#include "KTX2.h"
+#include "AssetCache.h"
 #include "IService.h"
 #include <string>
 #include <unordered_map>
@@ -128,31 +130,31 @@ namespace Mantrax
             // Cargar texturas si existen
             if (!albedoPath.empty())
             {
-                textures.albedo = LoadTexture(albedoPath);
+                textures.albedo = LoadTexture(albedoPath, TextureUsage::Color);
                 std::cout << "  📦 Loaded albedo: " << albedoPath << "\n";
             }
 
             if (!normalPath.empty())
             {
-                textures.normal = LoadTexture(normalPath);
+                textures.normal = LoadTexture(normalPath, TextureUsage::Normal);
                 std::cout << "  📦 Loaded normal: " << normalPath << "\n";
             }
 
             if (!metallicPath.empty())
             {
-                textures.metallic = LoadTexture(metallicPath);
+                textures.metallic = LoadTexture(metallicPath, TextureUsage::Mask);
                 std::cout << "  📦 Loaded metallic: " << metallicPath << "\n";
             }
 
             if (!roughnessPath.empty())
             {
-                textures.roughness = LoadTexture(roughnessPath);
+                textures.roughness = LoadTexture(roughnessPath, TextureUsage::Mask);
                 std::cout << "  📦 Loaded roughness: " << roughnessPath << "\n";
             }
 
             if (!aoPath.empty())
             {
-                textures.ao = LoadTexture(aoPath);
+                textures.ao = LoadTexture(aoPath, TextureUsage::Mask);
                 std::cout << "  📦 Loaded AO: " << aoPath << "\n";
             }
 
@@ -253,7 +255,10 @@ namespace Mantrax
             if (!material)
                 return;
 
-            auto texture = LoadTexture(texturePath);
+            const TextureUsage usage = textureType == "albedo"   ? TextureUsage::Color
+                                       : textureType == "normal" ? TextureUsage::Normal
+                                                                 : TextureUsage::Mask;
+            auto texture = LoadTexture(texturePath, usage);
             auto &textures = m_materialTextures[name];
 
             if (textureType == "albedo")
@@ -355,7 +360,6 @@ namespace Mantrax
             m_materialShaders.clear();
             m_materialTextures.clear();
             m_materialProperties.clear();
-            m_loadedTextures.clear();
             std::cout << "🗑️  All materials cleared\n";
         }
 
@@ -420,14 +424,24 @@ namespace Mantrax
         // HELPERS PRIVADOS
         // ====================================================================
 
-        std::shared_ptr<Texture> LoadTexture(const std::string &path)
+        std::shared_ptr<Texture> LoadTexture(const std::string &path, TextureUsage usage)
         {
+            // ✅ Cache compartido con ModelManager: vive mientras algún material la use
+            auto &textures = AssetCache::Shared()->Textures();
+            // Con el hash de ajustes del uso: la misma ruta como albedo y como máscara no se comparte
+            const std::string key = AssetCache::MakeKey(path, TextureCompressor::GetSettingsHash(usage));
+
             // Verificar si ya está cargada
-            auto it = m_loadedTextures.find(path);
-            if (it != m_loadedTextures.end())
+            if (auto cached = textures.Find(key))
             {
                 std::cout << "  ♻️  Reusing cached texture: " << path << "\n";
-                return it->second;
+                return cached;
+            }
+
+            // Versión cocinada (KTX2) antes que la fuente
+            if (auto cooked = KTX2::LoadCookedTexture(m_gfxAPI, path, usage))
+            {
+                return textures.Add(key, cooked);
             }
 
             // Cargar nueva textura
@@ -443,8 +457,7 @@ namespace Mantrax
                 textureData->height);
 
             // Cachear para reutilización
-            m_loadedTextures[path] = texture;
-            return texture;
+            return textures.Add(key, texture);
         }
 
         // ====================================================================
@@ -458,8 +471,5 @@ namespace Mantrax
         std::unordered_map<std::string, std::shared_ptr<Shader>> m_materialShaders;
         std::unordered_map<std::string, MaterialTextures> m_materialTextures;
         std::unordered_map<std::string, MaterialProperties> m_materialProperties;
-
-        // Cache de texturas para evitar cargar duplicados
-        std::unordered_map<std::string, std::shared_ptr<Texture>> m_loadedTextures;
     };
 }
\ No newline at end of file
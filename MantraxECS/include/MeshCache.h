@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../../MantraxRender/include/MantraxGFX_API.h"
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Cache binario de mallas importadas (.mxmesh): vértices e índices finales (LOD0 + LODs),
+    // rangos de LOD, meshlets, submeshes (con sus LODs) y bounds tras un header versionado. Se lee mapeado
+    // y los bloques van tal cual al staging (GFX::CreateMesh(const MeshSource &))
+    class MANTRAX_API MeshCache
+    {
+    public:
+        // <fuente>.mxmesh
+        static std::string GetCachePath(const std::string &sourcePath);
+
+        // FNV-1a para combinar los ajustes de import (cambiarlos invalida el cache)
+        static uint64_t Hash(const void *data, size_t size, uint64_t seed = 0xcbf29ce484222325ull);
+
+        // Escribe la geometría final (índices del LOD0 seguidos de los de los LODs)
+        static bool Save(const std::string &sourcePath, uint64_t settingsHash, const MeshSource &source);
+
+        // Mapea y valida el cache sin tocar la GPU (se puede llamar desde un worker): 'outSource'
+        // apunta dentro de 'file', que tiene que seguir abierto hasta GFX::CreateMesh.
+        // false si no hay cache, es de otra versión / layout de Vertex, o el contenido de la fuente
+        // (hash del ImportCache, no la fecha) o los ajustes cambiaron desde que se escribió
+        static bool Open(const std::string &sourcePath, uint64_t settingsHash, MappedFile &file,
+                         MeshSource &outSource);
+
+#ifndef MANTRAX_HEADLESS
+        // Open + GFX::CreateMesh; nullptr en los mismos casos
+        static std::shared_ptr<Mesh> Load(GFX *gfx, const std::string &sourcePath, uint64_t settingsHash);
+#endif
+    };
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../../MantraxRender/include/MantraxGFX_API.h"
+#include "AssimpLoader.h"
+#include "MeshSimplifier.h"
+#include "MappedFile.h"
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Todo lo que cambia el resultado de un import: su hash invalida los .mxmesh
+    struct MANTRAX_API MeshImportSettings
+    {
+        AssimpLoader::LoadSettings load;
+
+        bool generateLODs = true;
+        MeshLODSettings lodSettings;
+
+        // Meshlets para culling por cluster (solo meshes con al menos meshletMinTriangles)
+        bool generateMeshlets = true;
+        uint32_t meshletMinTriangles = 4096;
+
+        uint64_t GetHash() const;
+    };
+
+    // Resultado de CPU de un import: arrays propios, o el .mxmesh mapeado
+    struct MANTRAX_API ImportedMesh
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices; // LOD0 + LODs
+        std::vector<MeshLOD> lods;
+        std::vector<Meshlet> meshlets;
+        std::vector<MeshSubmesh> submeshes;
+        std::vector<MeshLOD> submeshLODs;
+        MappedFile cacheFile;
+        MeshSource source; // Apunta a lo anterior
+    };
+
+    // Assimp + optimización + LODs + meshlets, sin GPU: lo usan ModelManager (en los workers)
+    // y mantrax-cook, así que el .mxmesh que cocina la herramienta es el que espera el runtime
+    class MANTRAX_API MeshImporter
+    {
+    public:
+        // El .mxmesh si está al día; si no, importa y (con useCache) lo escribe. Lanza si falla
+        static std::shared_ptr<ImportedMesh> Import(const std::string &modelPath,
+                                                    const MeshImportSettings &settings,
+                                                    bool useCache = true);
+
+        static void Build(const std::vector<Vertex> &vertices,
+                          const std::vector<uint32_t> &indices,
+                          const std::vector<MeshSubmesh> &submeshes,
+                          const MeshImportSettings &settings,
+                          ImportedMesh &out);
+    };
+}
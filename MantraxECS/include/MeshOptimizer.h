@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "../../MantraxRender/include/MantraxGFX_API.h"
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Estadísticas de la cache post-transform (FIFO simulada)
+    struct MANTRAX_API MeshCacheStats
+    {
+        float acmr = 0.0f; // Misses por triángulo (ideal ~0.5, peor caso 3)
+        float atvr = 0.0f; // Misses por vértice único (ideal 1.0)
+    };
+
+    struct MANTRAX_API MeshOptimizeSettings
+    {
+        bool vertexCache = true;         // Reordenar triángulos (Tipsify)
+        bool overdraw = true;            // Ordenar clusters de fuera hacia dentro
+        float overdrawThreshold = 1.05f; // ACMR máximo tolerado respecto al de Tipsify
+        bool vertexFetch = true;         // Reordenar vértices por primer uso
+        uint32_t cacheSize = 16;
+    };
+
+    // Optimización de índices/vértices tras importar o generar un mesh.
+    // Orden del pipeline: vertex cache → overdraw → vertex fetch.
+    class MANTRAX_API MeshOptimizer
+    {
+    public:
+        static MeshCacheStats AnalyzeVertexCache(
+            const std::vector<uint32_t> &indices,
+            size_t vertexCount,
+            uint32_t cacheSize = 16);
+
+        // Tipsify (Sander et al. 2007)
+        static void OptimizeVertexCache(
+            std::vector<uint32_t> &indices,
+            size_t vertexCount,
+            uint32_t cacheSize = 16);
+
+        // Parte la salida de Tipsify en clusters y los ordena para reducir overdraw.
+        // Espera índices ya optimizados para la cache.
+        static void OptimizeOverdraw(
+            std::vector<uint32_t> &indices,
+            const std::vector<Vertex> &vertices,
+            float threshold = 1.05f,
+            uint32_t cacheSize = 16);
+
+        // Reordena los vértices en orden de primer uso y remapea los índices.
+        // Los vértices no referenciados se eliminan. Devuelve el nuevo número de vértices.
+        static size_t OptimizeVertexFetch(
+            std::vector<Vertex> &vertices,
+            std::vector<uint32_t> &indices);
+
+        // Pipeline completo con estadísticas antes/después
+        static void Optimize(
+            std::vector<Vertex> &vertices,
+            std::vector<uint32_t> &indices,
+            const MeshOptimizeSettings &settings = MeshOptimizeSettings{},
+            bool verbose = false);
+
+        // Igual, pero los triángulos solo se reordenan dentro de cada submesh (sus rangos siguen
+        // valiendo); los vértices se reordenan para todo el mesh
+        static void Optimize(
+            std::vector<Vertex> &vertices,
+            std::vector<uint32_t> &indices,
+            const std::vector<MeshSubmesh> &submeshes,
+            const MeshOptimizeSettings &settings = MeshOptimizeSettings{},
+            bool verbose = false);
+    };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "../../MantraxRender/include/MantraxGFX_API.h"
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Parámetros de generación de LODs
+    struct MANTRAX_API MeshLODSettings
+    {
+        uint32_t maxLODs = 4;         // Niveles extra además del LOD0
+        float reductionPerLOD = 0.5f; // Fracción de índices que conserva cada nivel
+        float maxError = 0.05f;       // Error máximo relativo a la diagonal del mesh
+        uint32_t minTriangles = 32;   // No generar niveles por debajo de esto
+    };
+
+    // Simplificación por colapso de aristas (quadric error metrics).
+    // Los LODs reutilizan el vertex buffer original: solo cambian los índices.
+    class MANTRAX_API MeshSimplifier
+    {
+    public:
+        // Simplifica hasta targetIndexCount o hasta que el siguiente colapso supere maxError
+        // (distancia absoluta en espacio objeto). outError recibe el error alcanzado.
+        static std::vector<uint32_t> Simplify(
+            const std::vector<Vertex> &vertices,
+            const std::vector<uint32_t> &indices,
+            size_t targetIndexCount,
+            float maxError,
+            float *outError = nullptr);
+
+        // Cadena LOD1..N, cada nivel simplificado desde el anterior.
+        // El error de cada nivel es acumulado (cota superior respecto al LOD0).
+        static std::vector<MeshLODData> GenerateLODChain(
+            const std::vector<Vertex> &vertices,
+            const std::vector<uint32_t> &indices,
+            const MeshLODSettings &settings = MeshLODSettings{},
+            bool verbose = false);
+    };
+}
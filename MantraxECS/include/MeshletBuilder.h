@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "../../MantraxRender/include/MantraxGFX_API.h"
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Parte el LOD0 en clusters (meshlets) con esfera envolvente y cono de normales.
+    // Crece cada cluster por adyacencia y reordena los índices para que cada meshlet
+    // sea un rango contiguo del index buffer (se dibuja con un draw indexado normal).
+    class MANTRAX_API MeshletBuilder
+    {
+    public:
+        static const uint32_t kMaxVertices = 64;
+        static const uint32_t kMaxTriangles = 124;
+
+        static std::vector<Meshlet> Build(
+            const std::vector<Vertex> &vertices,
+            std::vector<uint32_t> &indices,
+            uint32_t maxVertices = kMaxVertices,
+            uint32_t maxTriangles = kMaxTriangles);
+
+        // Esfera y cono de un rango de triángulos [firstIndex, firstIndex + indexCount)
+        static void ComputeBounds(
+            const std::vector<Vertex> &vertices,
+            const std::vector<uint32_t> &indices,
+            Meshlet &meshlet);
+    };
+}
@@ -1,12 +1,20 @@
 #pragma once
 #include "../../MantraxRender/include/MantraxGFX_API.h"
-#include "AssimpLoader.h"
+#include "MeshImporter.h"
 #include "IService.h"
+#include "TaskPool.h"
+#include "MappedFile.h"
+#include "AssetCache.h"
+#include "TextureCompressor.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <future>
+#include <functional>
 #include "EngineLoaderDLL.h"
 
 struct MANTRAX_API RenderableObject
@@ -18,6 +26,31 @@ struct MANTRAX_API RenderableObject
     glm::mat4 modelMatrix{1.0f};
 
     std::string name;
+
+    // Modelos con varios materiales: un RenderObject por submesh (comparten el UBO de renderObj,
+    // que no se dibuja) y materials[slot] por slot del archivo. Vacío = renderObj dibuja todo
+    std::vector<Mantrax::RenderObject> submeshObjects;
+    std::vector<std::shared_ptr<Mantrax::Material>> materials;
+};
+
+enum class ModelLoadState
+{
+    Loading,
+    Ready,
+    Failed
+};
+
+// Carga asíncrona en curso: 'object' se rellena (y el modelo entra en GetModel) cuando
+// ModelManager::Update sube el resultado a la GPU
+struct MANTRAX_API ModelLoadHandle
+{
+    std::string name;
+    std::string modelPath;
+    ModelLoadState state = ModelLoadState::Loading;
+    RenderableObject *object = nullptr;
+    std::string error;
+
+    bool IsDone() const { return state != ModelLoadState::Loading; }
 };
 
 class MANTRAX_API ModelManager : public IService
@@ -46,6 +79,33 @@ public:
         const std::string &aoPath,
         std::shared_ptr<Mantrax::Shader> shader);
 
+    // Mallas y texturas pasan por el AssetCache (ruta canónica + ajustes de import): repetir un
+    // modelo solo crea una instancia con su propio UBO; la geometría se sube una vez
+
+    // Versiones asíncronas: devuelven al momento. Lectura, Assimp y decodificación de imágenes
+    // van al pool de workers (las cinco texturas PBR en paralelo con la malla); la subida a la
+    // GPU la hace Update en un solo lote. onLoaded se llama desde Update al terminar bien
+    std::shared_ptr<ModelLoadHandle> CreateModelFromFileAsync(
+        const std::string &modelPath,
+        const std::string &name,
+        std::shared_ptr<Mantrax::Shader> shader,
+        std::function<void(RenderableObject *)> onLoaded = nullptr);
+
+    std::shared_ptr<ModelLoadHandle> CreateModelWithPBRAsync(
+        const std::string &modelPath,
+        const std::string &name,
+        const std::string &albedoPath,
+        const std::string &normalPath,
+        const std::string &metallicPath,
+        const std::string &roughnessPath,
+        const std::string &aoPath,
+        std::shared_ptr<Mantrax::Shader> shader,
+        std::function<void(RenderableObject *)> onLoaded = nullptr);
+
+    // Hilo principal, una vez por frame (fuera del render): crea en la GPU lo que ya prepararon los workers
+    void Update();
+    size_t GetPendingLoadCount() const { return m_pendingLoads.size(); }
+
     // Eliminar modelo
     void DestroyModel(const std::string &name);
     void DestroyModel(RenderableObject *obj);
@@ -54,6 +114,9 @@ public:
         const std::string &modelPath,
         const std::string &name);
 
+    // Material de un slot (todos los submeshes que lo usan); slot = MeshSubmesh::materialSlot
+    void SetSubmeshMaterial(RenderableObject *obj, uint32_t slot, std::shared_ptr<Mantrax::Material> material);
+
     // Obtener modelo
     RenderableObject *GetModel(const std::string &name);
 
@@ -63,17 +126,102 @@ public:
     // Limpiar todos los modelos
     void Clear();
 
+    // LODs generados al importar
+    void SetLODGenerationEnabled(bool enabled) { m_importSettings.generateLODs = enabled; }
+    bool IsLODGenerationEnabled() const { return m_importSettings.generateLODs; }
+    void SetLODSettings(const Mantrax::MeshLODSettings &settings) { m_importSettings.lodSettings = settings; }
+    const Mantrax::MeshLODSettings &GetLODSettings() const { return m_importSettings.lodSettings; }
+
+    // Meshlets para culling por cluster (solo meshes con al menos minTriangles)
+    void SetMeshletGenerationEnabled(bool enabled) { m_importSettings.generateMeshlets = enabled; }
+    void SetMeshletMinTriangles(uint32_t minTriangles) { m_importSettings.meshletMinTriangles = minTriangles; }
+
+    // Los mismos que usa mantrax-cook por defecto: con otros, los .mxmesh cocinados no valen
+    const Mantrax::MeshImportSettings &GetImportSettings() const { return m_importSettings; }
+
+    // Cache binario (.mxmesh junto a la fuente): el primer import lo escribe y los
+    // siguientes lo mapean sin pasar por Assimp
+    void SetMeshCacheEnabled(bool enabled) { m_useMeshCache = enabled; }
+    bool IsMeshCacheEnabled() const { return m_useMeshCache; }
+
+    // .ktx2 cuya fuente cambió de contenido: se usa la fuente y se recocina en un worker
+    // (la próxima carga ya lee el nuevo). Solo lo ya cocinado; lo nuevo lo cocina mantrax-cook
+    void SetTextureRecookEnabled(bool enabled) { m_recookStaleTextures = enabled; }
+    bool IsTextureRecookEnabled() const { return m_recookStaleTextures; }
+
 private:
     ModelManager(const ModelManager &) = delete;
     ModelManager &operator=(const ModelManager &) = delete;
     ModelManager(ModelManager &&) = delete;
     ModelManager &operator=(ModelManager &&) = delete;
 
+    // Imagen decodificada; cooked = KTX2 con mips (se sube streameada), recook = su .ktx2 quedó viejo
+    struct PreparedTexture
+    {
+        std::shared_ptr<Mantrax::TextureImageData> image;
+        bool cooked = false;
+        bool recook = false;
+        std::string path;
+        Mantrax::TextureUsage usage = Mantrax::TextureUsage::Color;
+    };
+
+    static constexpr int PBR_TEXTURE_COUNT = 5; // Albedo, Normal, Metallic, Roughness, AO
+
+    using MeshJob = std::shared_future<std::shared_ptr<Mantrax::ImportedMesh>>;
+    using TextureJob = std::shared_future<std::shared_ptr<PreparedTexture>>;
+
+    // Lo que ya estaba en el AssetCache al pedirlo va en geometry/textureAssets y no lanza trabajo;
+    // lo demás comparte el trabajo en curso de otra carga con la misma clave
+    struct PendingLoad
+    {
+        std::shared_ptr<ModelLoadHandle> handle;
+        std::shared_ptr<Mantrax::Shader> shader;
+        std::string meshKey;
+        std::shared_ptr<Mantrax::Mesh> geometry;
+        MeshJob mesh;
+        bool pbr = false;
+        std::string textureKeys[PBR_TEXTURE_COUNT];
+        std::shared_ptr<Mantrax::Texture> textureAssets[PBR_TEXTURE_COUNT];
+        TextureJob textures[PBR_TEXTURE_COUNT];
+        std::function<void(RenderableObject *)> onLoaded;
+    };
+
     Mantrax::GFX *m_gfx;
     std::vector<std::unique_ptr<RenderableObject>> m_models;
-    Mantrax::AssimpLoader m_modelLoader;
+
+    std::unique_ptr<Mantrax::TaskPool> m_taskPool; // Se crea con la primera carga asíncrona
+    std::vector<PendingLoad> m_pendingLoads;
+
+    std::shared_ptr<Mantrax::AssetCache> m_assets;
+    std::unordered_map<std::string, MeshJob> m_meshJobs; // En curso, por clave del AssetCache
+    std::unordered_map<std::string, TextureJob> m_textureJobs;
+
+    Mantrax::MeshImportSettings m_importSettings;
+
+    bool m_useMeshCache = true;
+    bool m_recookStaleTextures = true;
+    std::unordered_set<std::string> m_recooking; // Fuentes ya encoladas para recocinar
+
+    std::shared_ptr<Mantrax::Mesh> LoadMesh(const std::string &modelPath);
+    std::string GetMeshKey(const std::string &modelPath) const;
+
+    // KTX2 cocinado o TextureLoader (solo CPU, lanza si falla) y su subida
+    std::shared_ptr<PreparedTexture> PrepareTexture(const std::string &path, const std::string &name,
+                                                    Mantrax::TextureUsage usage) const;
+    std::shared_ptr<Mantrax::Texture> CreateTexture(const PreparedTexture &prepared);
+    void QueueRecook(const PreparedTexture &prepared);
 
     std::shared_ptr<Mantrax::Texture> LoadTexture(
         const std::string &path,
-        const std::string &name);
+        const std::string &name,
+        Mantrax::TextureUsage usage);
+
+    RenderableObject *AddModel(
+        const std::string &name,
+        std::shared_ptr<Mantrax::Mesh> mesh,
+        std::shared_ptr<Mantrax::Shader> shader);
+    void ApplyPBRTextures(RenderableObject *obj, const std::shared_ptr<Mantrax::Texture> (&textures)[PBR_TEXTURE_COUNT]);
+
+    Mantrax::TaskPool &GetTaskPool();
+    void FinishLoad(PendingLoad &load);
 };
\ No newline at end of file
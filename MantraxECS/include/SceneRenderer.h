@@ -8,13 +8,21 @@
 #include "EngineLoaderDLL.h"
 #include <glm/glm.hpp>
 
+// Selección de LOD por error proyectado en pantalla
+struct MANTRAX_API LODSelectionSettings
+{
+    bool enabled = true;
+    float pixelErrorThreshold = 1.0f; // Error máximo tolerado en píxeles
+    float hysteresis = 0.2f;          // Margen para no alternar LODs en el umbral
+};
+
 class MANTRAX_API SceneRenderer : public IService
 {
 public:
     SceneRenderer(Mantrax::GFX *gfx);
     ~SceneRenderer();
 
-    Mantrax::FPSCamera *camera;
+    Mantrax::FPSCamera *camera = nullptr;
 
     std::string getName() override { return "SceneRenderer"; }
 
@@ -38,9 +46,21 @@ public:
     // Obtener objetos
     std::vector<Mantrax::RenderObject> GetRenderObjects();
 
+    // Contadores de frustum / HiZ del último RenderScene
+    const Mantrax::CullingStats &GetCullingStats() const { return m_gfx->GetCullingStats(); }
+    const Mantrax::TextureStreamingStats &GetTextureStreamingStats() const { return m_gfx->GetTextureStreamingStats(); }
+
+    // LODs
+    void SetLODSelectionSettings(const LODSelectionSettings &settings) { m_lodSettings = settings; }
+    const LODSelectionSettings &GetLODSelectionSettings() const { return m_lodSettings; }
+
 private:
     Mantrax::GFX *m_gfx;
     std::vector<RenderableObject *> m_sceneObjects;
+    LODSelectionSettings m_lodSettings;
+
+    void SelectLODs(uint32_t viewportHeight);
+    void SelectMeshLOD(Mantrax::Mesh &mesh, const glm::mat4 &model, float pixelsPerUnit, const glm::vec3 &camPos);
 
     void CopyMat4(float *dest, const glm::mat4 &src);
     glm::mat4 CreateRotationMatrix(const glm::vec3 &rotation);
@@ -11,40 +11,42 @@
 
 namespace Mantrax
 {
+    // Cielo a partir de una textura equirectangular: se convierte una vez a un cubemap
+    // con mips, se guarda junto a la fuente (<textura>.cubemap) y el GFX lo dibuja con
+    // un triángulo a pantalla completa (ver GFX::EnableSky)
     class MANTRAX_API SkyBox
     {
     public:
-        SkyBox(GFX *gfx, float radius = 5.0f, int segments = 64, int rings = 32);
+        SkyBox(GFX *gfx, uint32_t faceSize = 512);
         ~SkyBox();
 
-        bool LoadTexture(const std::string &texturePath, bool flipVertically = false);
-        void CreateMaterial(std::shared_ptr<Shader> shader);
+        // Usa la caché si coincide con la fuente (tamaño, fecha, faceSize); si no, convierte y la reescribe
+        bool LoadEquirectangular(const std::string &texturePath, bool flipVertically = false);
 
-        RenderObject GetRenderObject();
+        // Asigna el cubemap y el tinte al cielo del GFX
+        void Apply();
 
-        std::shared_ptr<Material> GetMaterial() const;
-        std::shared_ptr<Mesh> GetMesh() const;
+        void SetTint(const glm::vec3 &tint) { m_tint = tint; }
+        const glm::vec3 &GetTint() const { return m_tint; }
 
-        void UpdateTransform(const glm::vec3 &position, UniformBufferObject &ubo);
+        std::shared_ptr<Texture> GetCubemap() const;
+        uint32_t GetFaceSize() const;
+        uint32_t GetMipLevels() const;
 
-        float GetRadius() const;
-        int GetSegments() const;
-        int GetRings() const;
+        static std::string GetCachePath(const std::string &texturePath);
 
     private:
         GFX *m_gfx;
-        float m_radius;
-        int m_segments;
-        int m_rings;
+        uint32_t m_faceSize;
+        uint32_t m_mipLevels = 0;
+        glm::vec3 m_tint{1.0f};
 
-        std::vector<Vertex> m_vertices;
-        std::vector<uint32_t> m_indices;
+        // Por mip, las 6 caras RGBA8 (+X, -X, +Y, -Y, +Z, -Z)
+        std::vector<unsigned char> m_pixels;
+        std::shared_ptr<Texture> m_cubemap;
 
-        std::shared_ptr<Mesh> m_mesh;
-        std::shared_ptr<Material> m_material;
-        std::shared_ptr<Texture> m_texture;
-
-        void GenerateSphereMesh();
-        void CopyMat4(float *dest, const glm::mat4 &src);
+        void ConvertEquirectangular(const TextureData &source);
+        bool LoadCache(const std::string &cachePath, uint64_t sourceSize, int64_t sourceTime, bool flipped);
+        void SaveCache(const std::string &cachePath, uint64_t sourceSize, int64_t sourceTime, bool flipped) const;
     };
 }
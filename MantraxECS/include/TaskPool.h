@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <cstdint>
+
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Pool fijo de hilos para trabajo de CPU (lectura de archivos, Assimp, decodificar imágenes).
+    // Los trabajos no tocan Vulkan: lo que producen se sube a la GPU desde el hilo principal
+    class MANTRAX_API TaskPool
+    {
+    public:
+        // 0 = un hilo por núcleo menos el principal (mínimo 1)
+        explicit TaskPool(uint32_t threadCount = 0);
+        // Termina lo que ya está encolado antes de unir los hilos
+        ~TaskPool();
+
+        TaskPool(const TaskPool &) = delete;
+        TaskPool &operator=(const TaskPool &) = delete;
+
+        // Las excepciones del trabajo salen por future::get()
+        template <typename F>
+        auto Submit(F &&task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+        {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+
+            auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            std::future<Result> future = packaged->get_future();
+            Enqueue([packaged]()
+                    { (*packaged)(); });
+            return future;
+        }
+
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+        size_t GetQueuedCount() const;
+
+    private:
+        void Enqueue(std::function<void()> job);
+        void WorkerLoop();
+
+        std::vector<std::thread> m_Workers;
+        std::deque<std::function<void()>> m_Queue;
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_Stopping = false;
+    };
+}
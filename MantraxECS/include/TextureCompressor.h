@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../../MantraxRender/include/MantraxGFX_Texture.h"
+#include <string>
+
+#include "EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    enum class TextureCompression
+    {
+        None, // RGBA8
+        BC1,  // RGB, 4 bpp
+        BC3,  // RGBA (alfa BC4 + color BC1), 8 bpp
+        BC5,  // RG (dos bloques BC4), para normal maps
+        BC7   // RGBA alta calidad (modo 6), 8 bpp
+    };
+
+    enum class TextureUsage
+    {
+        Color,  // albedo / emisivo
+        Normal, // tangent space, solo XY (Z se reconstruye en el shader)
+        Mask    // metallic / roughness / AO
+    };
+
+    // Cook offline de texturas: RGBA8 → mips → bloques BC, listo para guardar como KTX2.
+    // Es lento a propósito (PCA por bloque); se corre una vez, no al cargar la escena
+    class MANTRAX_API TextureCompressor
+    {
+    public:
+        static TextureCompression ChooseCompression(TextureUsage usage, bool hasAlpha);
+        static VkFormat GetFormat(TextureCompression compression);
+
+        static TextureImageData Compress(const unsigned char *rgba, uint32_t width, uint32_t height,
+                                         TextureCompression compression, TextureUsage usage,
+                                         bool generateMips = true);
+
+        // Lo que decide el resultado del cook para una fuente (versión del compresor + uso)
+        static uint64_t GetSettingsHash(TextureUsage usage);
+
+        // Fuente (png/jpg/...) → KTX2 comprimido en destPath, registrado en el ImportCache
+        static bool CookFile(const std::string &sourcePath, const std::string &destPath, TextureUsage usage);
+    };
+}
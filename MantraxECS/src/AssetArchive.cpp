@@ -0,0 +1,432 @@
+#include "../include/AssetArchive.h"
+#include "../include/LZ4.h"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <mutex>
+#include <cctype>
+#include <cstring>
+
+namespace Mantrax
+{
+    namespace
+    {
+        const char ARCHIVE_MAGIC[4] = {'M', 'X', 'P', 'K'};
+        const uint32_t ARCHIVE_VERSION = 1;
+
+        // Datos | tabla de contenidos | nombres. La tabla va al final para escribir en una pasada
+        struct AssetArchiveHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t entryCount;
+            uint32_t alignment;
+            uint64_t tocOffset;
+            uint64_t namesOffset;
+            uint64_t namesSize;
+        };
+        static_assert(sizeof(AssetArchiveHeader) == 40, "AssetArchiveHeader layout");
+        static_assert(sizeof(AssetArchiveEntry) == 40, "AssetArchiveEntry layout");
+
+        std::mutex g_MountMutex;
+        std::vector<std::shared_ptr<AssetArchive>> g_Mounted;
+
+        uint64_t AlignOffset(uint64_t offset, uint64_t alignment)
+        {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+
+        std::string ToLower(std::string text)
+        {
+            std::transform(text.begin(), text.end(), text.begin(),
+                           [](unsigned char c)
+                           { return static_cast<char>(std::tolower(c)); });
+            return text;
+        }
+
+        std::string CurrentDirectory()
+        {
+            std::error_code ec;
+            std::filesystem::path cwd = std::filesystem::current_path(ec);
+            return ec ? std::string() : cwd.string();
+        }
+    }
+
+    AssetArchive::~AssetArchive()
+    {
+        Close();
+    }
+
+    bool AssetArchive::Open(const std::string &path)
+    {
+        Close();
+
+        // Directo del disco: un .mxpak no se busca dentro de otros montados
+        if (!m_File.Open(path, false) || m_File.GetSize() < sizeof(AssetArchiveHeader))
+        {
+            m_File.Close();
+            return false;
+        }
+
+        const uint8_t *data = m_File.GetData();
+        const size_t fileSize = m_File.GetSize();
+
+        AssetArchiveHeader header;
+        memcpy(&header, data, sizeof(header));
+
+        if (memcmp(header.magic, ARCHIVE_MAGIC, sizeof(header.magic)) != 0 || header.version != ARCHIVE_VERSION)
+        {
+            std::cerr << "❌ Not a Mantrax archive (or another version): " << path << std::endl;
+            m_File.Close();
+            return false;
+        }
+
+        const bool tocValid = header.tocOffset % alignof(AssetArchiveEntry) == 0 && header.tocOffset <= fileSize &&
+                              header.entryCount <= (fileSize - header.tocOffset) / sizeof(AssetArchiveEntry);
+        const bool namesValid = header.namesOffset <= fileSize && header.namesSize <= fileSize - header.namesOffset &&
+                                (header.namesSize == 0 || data[header.namesOffset + header.namesSize - 1] == '\0');
+
+        if (!tocValid || !namesValid)
+        {
+            std::cerr << "❌ Corrupt archive table of contents: " << path << std::endl;
+            m_File.Close();
+            return false;
+        }
+
+        const AssetArchiveEntry *entries = reinterpret_cast<const AssetArchiveEntry *>(data + header.tocOffset);
+        for (uint32_t i = 0; i < header.entryCount; ++i)
+        {
+            const AssetArchiveEntry &entry = entries[i];
+
+            bool valid = entry.offset <= fileSize && entry.storedSize <= fileSize - entry.offset &&
+                         entry.pathOffset < header.namesSize && (i == 0 || entries[i - 1].pathHash <= entry.pathHash);
+
+            if (entry.compression == static_cast<uint32_t>(AssetCompression::None))
+                valid = valid && entry.storedSize == entry.size;
+            else if (entry.compression != static_cast<uint32_t>(AssetCompression::LZ4))
+                valid = false;
+
+            if (!valid)
+            {
+                std::cerr << "❌ Corrupt archive entry " << i << ": " << path << std::endl;
+                m_File.Close();
+                return false;
+            }
+        }
+
+        m_Path = path;
+        m_Entries = entries;
+        m_EntryCount = header.entryCount;
+        m_Names = reinterpret_cast<const char *>(data + header.namesOffset);
+        m_NamesSize = static_cast<size_t>(header.namesSize);
+        return true;
+    }
+
+    void AssetArchive::Close()
+    {
+        m_File.Close();
+        m_Path.clear();
+        m_Entries = nullptr;
+        m_EntryCount = 0;
+        m_Names = nullptr;
+        m_NamesSize = 0;
+    }
+
+    std::string AssetArchive::GetEntryPath(const AssetArchiveEntry &entry) const
+    {
+        return std::string(m_Names + entry.pathOffset);
+    }
+
+    const AssetArchiveEntry *AssetArchive::Find(const std::string &normalizedPath) const
+    {
+        if (m_EntryCount == 0 || normalizedPath.empty())
+            return nullptr;
+
+        const uint64_t hash = HashPath(normalizedPath);
+        const AssetArchiveEntry *end = m_Entries + m_EntryCount;
+        const AssetArchiveEntry *it = std::lower_bound(m_Entries, end, hash,
+                                                       [](const AssetArchiveEntry &entry, uint64_t value)
+                                                       { return entry.pathHash < value; });
+
+        for (; it != end && it->pathHash == hash; ++it)
+        {
+            if (normalizedPath == m_Names + it->pathOffset)
+                return it;
+        }
+        return nullptr;
+    }
+
+    const uint8_t *AssetArchive::GetStoredData(const AssetArchiveEntry &entry) const
+    {
+        if (entry.compression != static_cast<uint32_t>(AssetCompression::None))
+            return nullptr;
+        return m_File.GetData() + entry.offset;
+    }
+
+    bool AssetArchive::Read(const AssetArchiveEntry &entry, std::vector<uint8_t> &out) const
+    {
+        const uint8_t *stored = m_File.GetData() + entry.offset;
+
+        if (entry.compression == static_cast<uint32_t>(AssetCompression::None))
+        {
+            out.assign(stored, stored + entry.storedSize);
+            return true;
+        }
+
+        out.resize(static_cast<size_t>(entry.size));
+        if (!LZ4::Decompress(stored, static_cast<size_t>(entry.storedSize), out.data(), out.size()))
+        {
+            std::cerr << "❌ Corrupt LZ4 block in " << m_Path << ": " << GetEntryPath(entry) << std::endl;
+            out.clear();
+            return false;
+        }
+        return true;
+    }
+
+    std::string AssetArchive::NormalizePath(const std::string &path, const std::string &root)
+    {
+        namespace fs = std::filesystem;
+
+        fs::path normalized = fs::path(path).lexically_normal();
+
+        if (normalized.is_absolute() || !root.empty())
+        {
+            std::error_code ec;
+            fs::path absolute = fs::absolute(normalized, ec).lexically_normal();
+            fs::path base = fs::absolute(root.empty() ? CurrentDirectory() : root, ec).lexically_normal();
+            if (ec)
+                return std::string();
+
+            normalized = absolute.lexically_relative(base);
+        }
+
+        std::string result = normalized.generic_string();
+        if (result.empty() || result == "." || result.rfind("..", 0) == 0)
+            return std::string();
+
+        if (result.rfind("./", 0) == 0)
+            result.erase(0, 2);
+
+        // Sin distinguir mayúsculas: las rutas de escenas/materiales vienen de Windows
+        return ToLower(result);
+    }
+
+    uint64_t AssetArchive::HashPath(const std::string &normalizedPath)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (unsigned char c : normalizedPath)
+        {
+            hash ^= c;
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    bool AssetArchive::Build(const std::string &archivePath, const std::string &rootDir,
+                             const std::vector<std::string> &files,
+                             const AssetArchiveBuildSettings &settings, std::string &error)
+    {
+        namespace fs = std::filesystem;
+
+        const std::string tempPath = archivePath + ".tmp";
+        std::vector<AssetArchiveEntry> entries;
+        std::string names;
+        uint64_t totalSize = 0;
+        uint64_t totalStored = 0;
+
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                error = "could not write " + tempPath;
+                return false;
+            }
+
+            auto writeAt = [&out](uint64_t offset, const void *data, size_t size)
+            {
+                static const char padding[ALIGNMENT] = {};
+                std::streamoff pos = out.tellp();
+                out.write(padding, static_cast<std::streamsize>(offset - static_cast<uint64_t>(pos)));
+                if (size > 0)
+                    out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+            };
+
+            AssetArchiveHeader header{};
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+            entries.reserve(files.size());
+            for (const std::string &file : files)
+            {
+                const fs::path sourcePath = fs::path(rootDir) / file;
+                const std::string name = NormalizePath(sourcePath.string(), rootDir);
+                if (name.empty())
+                {
+                    error = "outside of the archive root: " + file;
+                    break;
+                }
+
+                std::error_code ec;
+                const uint64_t size = fs::file_size(sourcePath, ec);
+                if (ec)
+                {
+                    error = "could not read " + sourcePath.string();
+                    break;
+                }
+
+                MappedFile source;
+                if (size > 0 && !source.Open(sourcePath.string(), false))
+                {
+                    error = "could not map " + sourcePath.string();
+                    break;
+                }
+
+                AssetArchiveEntry entry{};
+                entry.pathHash = HashPath(name);
+                entry.size = size;
+                entry.pathOffset = static_cast<uint32_t>(names.size());
+                names += name;
+                names.push_back('\0');
+
+                const std::string extension = ToLower(sourcePath.extension().string());
+                const bool store = settings.compression == AssetCompression::None ||
+                                   std::find(settings.storedExtensions.begin(), settings.storedExtensions.end(),
+                                             extension) != settings.storedExtensions.end();
+
+                const uint8_t *data = source.GetData();
+                uint64_t storedSize = size;
+                std::vector<uint8_t> compressed;
+
+                if (!store && size > 0)
+                {
+                    compressed = LZ4::Compress(data, static_cast<size_t>(size));
+                    if (compressed.size() <= static_cast<double>(size) * (1.0 - settings.minSavings))
+                    {
+                        entry.compression = static_cast<uint32_t>(AssetCompression::LZ4);
+                        data = compressed.data();
+                        storedSize = compressed.size();
+                    }
+                }
+
+                entry.offset = AlignOffset(static_cast<uint64_t>(out.tellp()), ALIGNMENT);
+                entry.storedSize = storedSize;
+                writeAt(entry.offset, data, static_cast<size_t>(storedSize));
+
+                totalSize += size;
+                totalStored += storedSize;
+                entries.push_back(entry);
+            }
+
+            if (error.empty())
+            {
+                std::sort(entries.begin(), entries.end(),
+                          [](const AssetArchiveEntry &a, const AssetArchiveEntry &b)
+                          { return a.pathHash < b.pathHash; });
+
+                for (size_t i = 1; i < entries.size(); ++i)
+                {
+                    if (entries[i].pathHash == entries[i - 1].pathHash &&
+                        strcmp(names.c_str() + entries[i].pathOffset, names.c_str() + entries[i - 1].pathOffset) == 0)
+                    {
+                        error = "duplicate entry: " + std::string(names.c_str() + entries[i].pathOffset);
+                        break;
+                    }
+                }
+            }
+
+            if (error.empty())
+            {
+                memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+                header.version = ARCHIVE_VERSION;
+                header.entryCount = static_cast<uint32_t>(entries.size());
+                header.alignment = static_cast<uint32_t>(ALIGNMENT);
+                header.tocOffset = AlignOffset(static_cast<uint64_t>(out.tellp()), alignof(AssetArchiveEntry));
+                header.namesOffset = header.tocOffset + sizeof(AssetArchiveEntry) * entries.size();
+                header.namesSize = names.size();
+
+                writeAt(header.tocOffset, entries.data(), sizeof(AssetArchiveEntry) * entries.size());
+                writeAt(header.namesOffset, names.data(), names.size());
+
+                out.seekp(0);
+                out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+                if (!out)
+                    error = "could not write " + tempPath;
+            }
+        }
+
+        std::error_code ec;
+        if (error.empty())
+        {
+            fs::rename(tempPath, archivePath, ec);
+            if (ec)
+                error = "could not replace " + archivePath + ": " + ec.message();
+        }
+
+        if (!error.empty())
+        {
+            fs::remove(tempPath, ec);
+            return false;
+        }
+
+        std::cout << "📦 Archive built: " << archivePath << " (" << entries.size() << " entries, "
+                  << totalSize / 1024 << " KB -> " << totalStored / 1024 << " KB)" << std::endl;
+        return true;
+    }
+
+    bool AssetArchive::Mount(const std::string &archivePath, const std::string &mountRoot)
+    {
+        auto archive = std::make_shared<AssetArchive>();
+        if (!archive->Open(archivePath))
+            return false;
+
+        archive->m_MountRoot = mountRoot.empty() ? CurrentDirectory() : mountRoot;
+
+        std::lock_guard<std::mutex> lock(g_MountMutex);
+        g_Mounted.push_back(archive);
+
+        std::cout << "📦 Mounted archive: " << archivePath << " (" << archive->GetEntryCount() << " entries)" << std::endl;
+        return true;
+    }
+
+    void AssetArchive::Unmount(const std::string &archivePath)
+    {
+        // Los MappedFile abiertos sobre él mantienen vivo el mapeo hasta cerrarse
+        std::lock_guard<std::mutex> lock(g_MountMutex);
+        g_Mounted.erase(std::remove_if(g_Mounted.begin(), g_Mounted.end(),
+                                       [&archivePath](const std::shared_ptr<AssetArchive> &archive)
+                                       { return archive->GetPath() == archivePath; }),
+                        g_Mounted.end());
+    }
+
+    void AssetArchive::UnmountAll()
+    {
+        std::lock_guard<std::mutex> lock(g_MountMutex);
+        g_Mounted.clear();
+    }
+
+    bool AssetArchive::HasMounted()
+    {
+        std::lock_guard<std::mutex> lock(g_MountMutex);
+        return !g_Mounted.empty();
+    }
+
+    std::shared_ptr<const AssetArchive> AssetArchive::FindMounted(const std::string &path,
+                                                                  const AssetArchiveEntry *&outEntry)
+    {
+        outEntry = nullptr;
+
+        std::lock_guard<std::mutex> lock(g_MountMutex);
+        for (auto it = g_Mounted.rbegin(); it != g_Mounted.rend(); ++it)
+        {
+            const AssetArchiveEntry *entry = (*it)->Find(NormalizePath(path, (*it)->m_MountRoot));
+            if (entry)
+            {
+                outEntry = entry;
+                return *it;
+            }
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,46 @@
+#include "../include/AssetCache.h"
+#include "../include/ServiceLocator.h"
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+
+namespace Mantrax
+{
+    std::shared_ptr<AssetCache> AssetCache::Shared()
+    {
+        auto cache = ServiceLocator::instance().get<AssetCache>("AssetCache");
+        if (!cache)
+        {
+            cache = std::make_shared<AssetCache>();
+            ServiceLocator::instance().registerService("AssetCache", cache);
+        }
+        return cache;
+    }
+
+    std::string AssetCache::MakeKey(const std::string &path, uint64_t settingsHash)
+    {
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(std::filesystem::absolute(path, ec), ec);
+
+        std::string key = ec ? path : canonical.generic_string();
+#ifdef _WIN32
+        std::transform(key.begin(), key.end(), key.begin(),
+                       [](unsigned char c)
+                       { return static_cast<char>(std::tolower(c)); });
+#endif
+
+        if (settingsHash != 0)
+            key += "|" + std::to_string(settingsHash);
+        return key;
+    }
+
+    AssetCacheStats AssetCache::GetStats()
+    {
+        AssetCacheStats stats;
+        stats.meshes = m_Meshes.Prune();
+        stats.textures = m_Textures.Prune();
+        stats.hits = m_Meshes.GetHits() + m_Textures.GetHits();
+        stats.misses = m_Meshes.GetMisses() + m_Textures.GetMisses();
+        return stats;
+    }
+}
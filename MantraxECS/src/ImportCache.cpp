@@ -0,0 +1,301 @@
+#include "../include/ImportCache.h"
+#include "../include/MappedFile.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <cstring>
+#include <cctype>
+
+namespace Mantrax
+{
+    namespace
+    {
+        const char IMPORT_CACHE_HEADER[] = "MXIC 1";
+
+        // Hash de la fuente válido mientras no cambien tamaño ni fecha
+        struct FileRecord
+        {
+            uint64_t size = 0;
+            int64_t time = 0;
+            uint64_t hash = 0;
+        };
+
+        // Artefacto cocinado: de qué fuente (y con qué contenido / ajustes) salió
+        struct ArtifactRecord
+        {
+            uint64_t size = 0;
+            int64_t time = 0;
+            uint64_t sourceHash = 0;
+            uint64_t settingsHash = 0;
+            std::string sourceKey;
+        };
+
+        std::mutex g_CacheMutex;
+        std::string g_IndexPath = "ImportCache.idx";
+        bool g_Loaded = false;
+        bool g_Dirty = false;
+        std::unordered_map<std::string, FileRecord> g_Files;
+        std::unordered_map<std::string, ArtifactRecord> g_Artifacts;
+
+        // Misma clave para "Assets/a.png" y "./assets/../Assets/a.png"
+        std::string MakeKey(const std::string &path)
+        {
+            std::error_code ec;
+            std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+            std::string key = (ec ? std::filesystem::path(path) : absolute).lexically_normal().generic_string();
+#ifdef _WIN32
+            std::transform(key.begin(), key.end(), key.begin(),
+                           [](unsigned char c)
+                           { return static_cast<char>(std::tolower(c)); });
+#endif
+            return key;
+        }
+
+        bool GetStamp(const std::string &path, uint64_t &size, int64_t &time)
+        {
+            std::error_code ec;
+            size = std::filesystem::file_size(path, ec);
+            if (ec)
+                return false;
+
+            auto stamp = std::filesystem::last_write_time(path, ec);
+            if (ec)
+                return false;
+
+            time = static_cast<int64_t>(stamp.time_since_epoch().count());
+            return true;
+        }
+
+        // Con g_CacheMutex tomado. Un índice dañado o de otra versión se descarta entero
+        void EnsureLoaded()
+        {
+            if (g_Loaded)
+                return;
+            g_Loaded = true;
+
+            std::ifstream in(g_IndexPath);
+            if (!in)
+                return;
+
+            std::string line;
+            if (!std::getline(in, line) || line != IMPORT_CACHE_HEADER)
+            {
+                std::cout << "⚠️ Import cache index from another version, rebuilding: " << g_IndexPath << std::endl;
+                return;
+            }
+
+            while (std::getline(in, line))
+            {
+                std::vector<std::string> fields;
+                std::stringstream stream(line);
+                for (std::string field; std::getline(stream, field, '\t');)
+                    fields.push_back(field);
+
+                try
+                {
+                    if (fields.size() == 5 && fields[0] == "F")
+                    {
+                        FileRecord &record = g_Files[fields[4]];
+                        record.size = std::stoull(fields[1]);
+                        record.time = std::stoll(fields[2]);
+                        record.hash = std::stoull(fields[3], nullptr, 16);
+                    }
+                    else if (fields.size() == 7 && fields[0] == "A")
+                    {
+                        ArtifactRecord &record = g_Artifacts[fields[6]];
+                        record.size = std::stoull(fields[1]);
+                        record.time = std::stoll(fields[2]);
+                        record.sourceHash = std::stoull(fields[3], nullptr, 16);
+                        record.settingsHash = std::stoull(fields[4], nullptr, 16);
+                        record.sourceKey = fields[5];
+                    }
+                }
+                catch (const std::exception &)
+                {
+                    // Línea cortada (escritura interrumpida): se ignora, el resto sigue valiendo
+                }
+            }
+        }
+    }
+
+    void ImportCache::SetIndexPath(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(g_CacheMutex);
+        if (path == g_IndexPath)
+            return;
+
+        g_IndexPath = path;
+        g_Loaded = false;
+        g_Dirty = false;
+        g_Files.clear();
+        g_Artifacts.clear();
+    }
+
+    uint64_t ImportCache::HashBytes(const void *data, size_t size, uint64_t seed)
+    {
+        const uint64_t prime = 0x100000001b3ull;
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        uint64_t hash = seed ^ (size * 0x9e3779b97f4a7c15ull);
+
+        // 8 bytes por paso: las fuentes son de varios MB y se hashean en el hilo que carga
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            memcpy(&word, bytes + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+            hash ^= hash >> 29;
+        }
+        for (; i < size; ++i)
+            hash = (hash ^ bytes[i]) * prime;
+
+        // Mezcla final (fmix64 de MurmurHash3)
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb3d63a7ed6a9ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    uint64_t ImportCache::GetContentHash(const std::string &path)
+    {
+        FileRecord record;
+        if (!GetStamp(path, record.size, record.time))
+            return 0;
+
+        const std::string key = MakeKey(path);
+        {
+            std::lock_guard<std::mutex> lock(g_CacheMutex);
+            EnsureLoaded();
+
+            auto it = g_Files.find(key);
+            if (it != g_Files.end() && it->second.size == record.size && it->second.time == record.time)
+                return it->second.hash;
+        }
+
+        // Fuera del lock: leer la fuente es lo caro y los workers hashean en paralelo
+        MappedFile file;
+        if (!file.Open(path, false))
+            return 0;
+
+        record.hash = HashBytes(file.GetData(), file.GetSize());
+        if (record.hash == 0)
+            record.hash = 1; // 0 = sin fuente
+
+        std::lock_guard<std::mutex> lock(g_CacheMutex);
+        g_Files[key] = record;
+        g_Dirty = true;
+        return record.hash;
+    }
+
+    ImportState ImportCache::Check(const std::string &sourcePath, const std::string &artifactPath,
+                                   uint64_t settingsHash)
+    {
+        uint64_t artifactSize = 0;
+        int64_t artifactTime = 0;
+        if (!GetStamp(artifactPath, artifactSize, artifactTime))
+            return ImportState::Unknown;
+
+        ArtifactRecord record;
+        {
+            std::lock_guard<std::mutex> lock(g_CacheMutex);
+            EnsureLoaded();
+
+            auto it = g_Artifacts.find(MakeKey(artifactPath));
+            if (it == g_Artifacts.end())
+                return ImportState::Unknown;
+            record = it->second;
+        }
+
+        // Artefacto reescrito por otro (copiado, cocinado por otra herramienta): no se sabe de dónde salió
+        if (record.size != artifactSize || record.time != artifactTime || record.sourceKey != MakeKey(sourcePath))
+            return ImportState::Unknown;
+
+        // Sin fuente (build distribuida) el artefacto es lo único que hay
+        const uint64_t sourceHash = GetContentHash(sourcePath);
+        if (sourceHash == 0)
+            return ImportState::UpToDate;
+
+        if (sourceHash != record.sourceHash)
+            return ImportState::SourceChanged;
+
+        if (settingsHash != 0 && settingsHash != record.settingsHash)
+            return ImportState::SettingsChanged;
+
+        return ImportState::UpToDate;
+    }
+
+    void ImportCache::Record(const std::string &sourcePath, const std::string &artifactPath,
+                             uint64_t settingsHash)
+    {
+        ArtifactRecord record;
+        if (!GetStamp(artifactPath, record.size, record.time))
+            return;
+
+        record.sourceHash = GetContentHash(sourcePath);
+        if (record.sourceHash == 0)
+            return;
+
+        record.settingsHash = settingsHash;
+        record.sourceKey = MakeKey(sourcePath);
+
+        const std::string key = MakeKey(artifactPath);
+        std::lock_guard<std::mutex> lock(g_CacheMutex);
+        EnsureLoaded();
+        g_Artifacts[key] = std::move(record);
+        g_Dirty = true;
+    }
+
+    bool ImportCache::Save()
+    {
+        std::lock_guard<std::mutex> lock(g_CacheMutex);
+        if (!g_Dirty)
+            return true;
+
+        // A un temporal y después rename: un cierre a mitad no deja un índice cortado
+        const std::string tempPath = g_IndexPath + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::trunc);
+            if (!out)
+            {
+                std::cerr << "❌ Could not write import cache: " << tempPath << std::endl;
+                return false;
+            }
+
+            out << IMPORT_CACHE_HEADER << '\n'
+                << std::hex;
+            for (const auto &[key, record] : g_Files)
+                out << "F\t" << std::dec << record.size << '\t' << record.time << '\t'
+                    << std::hex << record.hash << '\t' << key << '\n';
+            for (const auto &[key, record] : g_Artifacts)
+                out << "A\t" << std::dec << record.size << '\t' << record.time << '\t'
+                    << std::hex << record.sourceHash << '\t' << record.settingsHash << '\t'
+                    << record.sourceKey << '\t' << key << '\n';
+
+            if (!out)
+            {
+                std::cerr << "❌ Could not write import cache: " << tempPath << std::endl;
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, g_IndexPath, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            std::cerr << "❌ Could not write import cache: " << g_IndexPath << std::endl;
+            return false;
+        }
+
+        g_Dirty = false;
+        return true;
+    }
+}
@@ -0,0 +1,362 @@
+#include "../include/KTX2.h"
+#include "../include/MappedFile.h"
+#include "../include/ImportCache.h"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+
+namespace Mantrax
+{
+    namespace
+    {
+        const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+        // En el archivo sgdByteOffset cae en un múltiplo de 4: sin empaquetar habría relleno
+#pragma pack(push, 4)
+        struct KTX2Header
+        {
+            uint32_t vkFormat;
+            uint32_t typeSize;
+            uint32_t pixelWidth;
+            uint32_t pixelHeight;
+            uint32_t pixelDepth;
+            uint32_t layerCount;
+            uint32_t faceCount;
+            uint32_t levelCount;
+            uint32_t supercompressionScheme;
+
+            uint32_t dfdByteOffset;
+            uint32_t dfdByteLength;
+            uint32_t kvdByteOffset;
+            uint32_t kvdByteLength;
+            uint64_t sgdByteOffset;
+            uint64_t sgdByteLength;
+        };
+#pragma pack(pop)
+        static_assert(sizeof(KTX2Header) == 68, "KTX2Header debe coincidir con el archivo");
+
+        struct KTX2LevelIndex
+        {
+            uint64_t byteOffset;
+            uint64_t byteLength;
+            uint64_t uncompressedByteLength;
+        };
+
+        // Cada nivel empieza alineado a lcm(tamaño de bloque, 4)
+        size_t LevelAlignment(VkFormat format)
+        {
+            return std::max<size_t>(GetFormatBlockBytes(format), 4);
+        }
+
+        // Data Format Descriptor básico (KHR_DF_KHR_DESCRIPTORTYPE_BASICFORMAT, versión 2)
+        std::vector<uint32_t> BuildDataFormatDescriptor(VkFormat format)
+        {
+            enum : uint32_t
+            {
+                MODEL_RGBSDA = 1,
+                MODEL_BC1A = 128,
+                MODEL_BC3 = 130,
+                MODEL_BC5 = 132,
+                MODEL_BC7 = 134,
+                MODEL_ASTC = 162,
+                CHANNEL_QUALIFIER_LINEAR = 0x10
+            };
+
+            struct Sample
+            {
+                uint32_t bitOffset, bitLength, channel, upper;
+            };
+
+            bool srgb = format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_BC1_RGB_SRGB_BLOCK ||
+                        format == VK_FORMAT_BC1_RGBA_SRGB_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK ||
+                        format == VK_FORMAT_BC7_SRGB_BLOCK || format == VK_FORMAT_ASTC_4x4_SRGB_BLOCK;
+
+            uint32_t model = MODEL_RGBSDA;
+            std::vector<Sample> samples;
+
+            switch (format)
+            {
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                model = MODEL_BC1A;
+                samples = {{0, 63, 0, 0xFFFFFFFF}};
+                break;
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                model = MODEL_BC1A;
+                samples = {{0, 63, 15, 0xFFFFFFFF}};
+                break;
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+                model = MODEL_BC3;
+                samples = {{0, 63, 15 | (srgb ? CHANNEL_QUALIFIER_LINEAR : 0u), 0xFFFFFFFF}, {64, 63, 0, 0xFFFFFFFF}};
+                break;
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+                model = MODEL_BC5;
+                samples = {{0, 63, 0, 0xFFFFFFFF}, {64, 63, 1, 0xFFFFFFFF}};
+                break;
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                model = MODEL_BC7;
+                samples = {{0, 127, 0, 0xFFFFFFFF}};
+                break;
+            case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+            case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+                model = MODEL_ASTC;
+                samples = {{0, 127, 0, 0xFFFFFFFF}};
+                break;
+            default: // RGBA8
+                samples = {{0, 7, 0, 255}, {8, 7, 1, 255}, {16, 7, 2, 255},
+                           {24, 7, 15 | (srgb ? CHANNEL_QUALIFIER_LINEAR : 0u), 255}};
+                break;
+            }
+
+            uint32_t blockExtent = GetFormatBlockExtent(format);
+            uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+
+            std::vector<uint32_t> dfd;
+            dfd.push_back(4 + blockSize);          // dfdTotalSize
+            dfd.push_back(0);                      // vendorId KHRONOS / descriptorType BASICFORMAT
+            dfd.push_back(2u | (blockSize << 16)); // versionNumber / descriptorBlockSize
+            dfd.push_back(model | (1u << 8) | ((srgb ? 2u : 1u) << 16)); // BT709, sRGB/lineal, alfa directo
+            dfd.push_back(blockExtent > 1 ? ((blockExtent - 1) | ((blockExtent - 1) << 8)) : 0u);
+            dfd.push_back(GetFormatBlockBytes(format)); // bytesPlane0
+            dfd.push_back(0);
+
+            for (const Sample &s : samples)
+            {
+                dfd.push_back(s.bitOffset | (s.bitLength << 16) | (s.channel << 24));
+                dfd.push_back(0); // samplePosition
+                dfd.push_back(0); // sampleLower
+                dfd.push_back(s.upper);
+            }
+
+            return dfd;
+        }
+    }
+
+    bool KTX2::Load(const std::string &path, TextureImageData &outImage)
+    {
+        // Mapeado (o desde un .mxpak montado): los niveles se copian una sola vez, a la imagen
+        MappedFile file;
+        if (!file.Open(path))
+            return false;
+
+        const uint8_t *data = file.GetData();
+        const size_t dataSize = file.GetSize();
+
+        if (dataSize < sizeof(KTX2_IDENTIFIER) + sizeof(KTX2Header) ||
+            std::memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+        {
+            std::cerr << "❌ Not a KTX2 file: " << path << std::endl;
+            return false;
+        }
+
+        KTX2Header header;
+        std::memcpy(&header, data + sizeof(KTX2_IDENTIFIER), sizeof(header));
+
+        VkFormat format = static_cast<VkFormat>(header.vkFormat);
+        uint32_t levelCount = std::max(1u, header.levelCount);
+
+        if (GetFormatBlockExtent(format) == 0 || header.supercompressionScheme != 0 ||
+            header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1 ||
+            header.pixelWidth == 0 || header.pixelHeight == 0 || levelCount > 32)
+        {
+            std::cerr << "⚠️ Unsupported KTX2 layout (format " << header.vkFormat
+                      << ", supercompression " << header.supercompressionScheme << "): " << path << std::endl;
+            return false;
+        }
+
+        const size_t levelIndexOffset = sizeof(KTX2_IDENTIFIER) + sizeof(KTX2Header);
+        if (dataSize < levelIndexOffset + levelCount * sizeof(KTX2LevelIndex))
+            return false;
+
+        TextureImageData image;
+        image.format = format;
+        image.width = header.pixelWidth;
+        image.height = header.pixelHeight;
+
+        const size_t alignment = GetFormatBlockBytes(format);
+
+        for (uint32_t mip = 0; mip < levelCount; ++mip)
+        {
+            KTX2LevelIndex level;
+            std::memcpy(&level, data + levelIndexOffset + mip * sizeof(KTX2LevelIndex), sizeof(level));
+
+            TextureMip info;
+            info.width = std::max(1u, header.pixelWidth >> mip);
+            info.height = std::max(1u, header.pixelHeight >> mip);
+            info.size = GetTextureLevelSize(format, info.width, info.height);
+            info.offset = (image.bytes.size() + alignment - 1) / alignment * alignment;
+
+            if (level.byteLength < info.size || level.byteOffset + level.byteLength > dataSize)
+            {
+                std::cerr << "❌ KTX2 level " << mip << " truncated: " << path << std::endl;
+                return false;
+            }
+
+            image.bytes.resize(info.offset + info.size);
+            std::memcpy(image.bytes.data() + info.offset, data + level.byteOffset, info.size);
+            image.mips.push_back(info);
+        }
+
+        outImage = std::move(image);
+        return true;
+    }
+
+    bool KTX2::Save(const std::string &path, const TextureImageData &image)
+    {
+        if (image.mips.empty() || GetFormatBlockExtent(image.format) == 0)
+            return false;
+
+        const uint32_t levelCount = image.GetMipLevels();
+        const std::vector<uint32_t> dfd = BuildDataFormatDescriptor(image.format);
+
+        KTX2Header header{};
+        header.vkFormat = static_cast<uint32_t>(image.format);
+        header.typeSize = 1;
+        header.pixelWidth = image.width;
+        header.pixelHeight = image.height;
+        header.faceCount = 1;
+        header.levelCount = levelCount;
+
+        const size_t levelIndexOffset = sizeof(KTX2_IDENTIFIER) + sizeof(KTX2Header);
+        header.dfdByteOffset = static_cast<uint32_t>(levelIndexOffset + levelCount * sizeof(KTX2LevelIndex));
+        header.dfdByteLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+
+        // Los niveles van del más pequeño al más grande (así se puede leer el archivo
+        // por el principio y tener algo que mostrar antes de llegar al mip 0)
+        const size_t alignment = LevelAlignment(image.format);
+        std::vector<KTX2LevelIndex> levels(levelCount);
+        size_t offset = header.dfdByteOffset + header.dfdByteLength;
+
+        for (uint32_t i = 0; i < levelCount; ++i)
+        {
+            uint32_t mip = levelCount - 1 - i;
+            offset = (offset + alignment - 1) / alignment * alignment;
+            levels[mip].byteOffset = offset;
+            levels[mip].byteLength = image.mips[mip].size;
+            levels[mip].uncompressedByteLength = image.mips[mip].size;
+            offset += image.mips[mip].size;
+        }
+
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                std::cerr << "⚠️ Could not write KTX2: " << path << std::endl;
+                return false;
+            }
+
+            file.write(reinterpret_cast<const char *>(KTX2_IDENTIFIER), sizeof(KTX2_IDENTIFIER));
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char *>(levels.data()), levels.size() * sizeof(KTX2LevelIndex));
+            file.write(reinterpret_cast<const char *>(dfd.data()), dfd.size() * sizeof(uint32_t));
+
+            for (uint32_t i = 0; i < levelCount; ++i)
+            {
+                uint32_t mip = levelCount - 1 - i;
+                static const char padding[16] = {};
+                std::streamoff pos = file.tellp();
+                file.write(padding, static_cast<std::streamsize>(levels[mip].byteOffset - static_cast<uint64_t>(pos)));
+                file.write(reinterpret_cast<const char *>(image.bytes.data() + image.mips[mip].offset),
+                           static_cast<std::streamsize>(image.mips[mip].size));
+            }
+
+            if (!file)
+            {
+                std::cerr << "⚠️ Could not write KTX2: " << path << std::endl;
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec)
+        {
+            std::cerr << "⚠️ Could not write KTX2: " << path << " (" << ec.message() << ")" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    std::string KTX2::GetCookedPath(const std::string &sourcePath)
+    {
+        std::string extension = std::filesystem::path(sourcePath).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension == ".ktx2" ? sourcePath : sourcePath + ".ktx2";
+    }
+
+    bool KTX2::IsStale(const std::string &sourcePath, uint64_t settingsHash)
+    {
+        const std::string cookedPath = GetCookedPath(sourcePath);
+        if (cookedPath == sourcePath)
+            return false;
+
+        std::error_code ec;
+        if (!std::filesystem::exists(cookedPath, ec))
+            return !MappedFile::Exists(cookedPath);
+
+        if (!std::filesystem::exists(sourcePath, ec))
+            return false;
+
+        // ✅ Por contenido: guardar la fuente sin cambios o un checkout no obligan a recocinar
+        switch (ImportCache::Check(sourcePath, cookedPath, settingsHash))
+        {
+        case ImportState::UpToDate:
+            return false;
+        case ImportState::SourceChanged:
+        case ImportState::SettingsChanged:
+            return true;
+        default:
+            break;
+        }
+
+        return std::filesystem::last_write_time(sourcePath, ec) > std::filesystem::last_write_time(cookedPath, ec);
+    }
+
+#ifndef MANTRAX_HEADLESS
+    std::shared_ptr<Texture> KTX2::LoadCookedTexture(GFX *gfx, const std::string &sourcePath, TextureUsage usage)
+    {
+        auto image = LoadCookedImage(gfx, sourcePath, usage);
+        if (!image)
+            return nullptr;
+
+        // Con mips: solo la cola a la GPU, el resto según el tamaño en pantalla
+        return gfx->CreateStreamedTexture(image);
+    }
+
+    std::shared_ptr<TextureImageData> KTX2::LoadCookedImage(const GFX *gfx, const std::string &sourcePath,
+                                                            TextureUsage usage)
+    {
+        const std::string cookedPath = GetCookedPath(sourcePath);
+
+        if (!MappedFile::Exists(cookedPath))
+            return nullptr;
+
+        // Fuente editada o cocinada con otros ajustes: usar la fuente hasta que se vuelva a cocinar
+        if (IsStale(sourcePath, TextureCompressor::GetSettingsHash(usage)))
+        {
+            std::cout << "⚠️ Cooked texture is stale, using source: " << sourcePath << std::endl;
+            return nullptr;
+        }
+
+        auto image = std::make_shared<TextureImageData>();
+        if (!Load(cookedPath, *image))
+            return nullptr;
+
+        if (!gfx->IsTextureFormatSupported(image->format))
+        {
+            std::cout << "⚠️ " << GetTextureFormatName(image->format)
+                      << " not supported by this GPU, using source: " << sourcePath << std::endl;
+            return nullptr;
+        }
+
+        return image;
+    }
+#endif
+}
@@ -0,0 +1,199 @@
+#include "../include/LZ4.h"
+
+#include <cstring>
+
+namespace Mantrax
+{
+    namespace
+    {
+        const size_t MIN_MATCH = 4;
+        const size_t LAST_LITERALS = 5; // El bloque siempre termina con 5 literales
+        const size_t MF_LIMIT = 12;     // Ningún match empieza en los últimos 12 bytes
+        const size_t MAX_OFFSET = 65535;
+        const uint32_t HASH_LOG = 16;
+
+        uint32_t Read32(const uint8_t *p)
+        {
+            uint32_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        uint32_t HashSequence(uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - HASH_LOG);
+        }
+
+        void WriteLength(std::vector<uint8_t> &out, size_t length)
+        {
+            for (; length >= 255; length -= 255)
+                out.push_back(255);
+            out.push_back(static_cast<uint8_t>(length));
+        }
+
+        void WriteSequence(std::vector<uint8_t> &out, const uint8_t *literals, size_t literalCount,
+                           size_t offset, size_t matchLength)
+        {
+            const size_t matchCode = matchLength - MIN_MATCH;
+
+            uint8_t token = static_cast<uint8_t>((literalCount >= 15 ? 15 : literalCount) << 4);
+            if (matchLength != 0)
+                token |= static_cast<uint8_t>(matchCode >= 15 ? 15 : matchCode);
+            out.push_back(token);
+
+            if (literalCount >= 15)
+                WriteLength(out, literalCount - 15);
+            out.insert(out.end(), literals, literals + literalCount);
+
+            // Última secuencia: solo literales
+            if (matchLength == 0)
+                return;
+
+            out.push_back(static_cast<uint8_t>(offset & 0xFF));
+            out.push_back(static_cast<uint8_t>(offset >> 8));
+
+            if (matchCode >= 15)
+                WriteLength(out, matchCode - 15);
+        }
+
+        bool ReadLength(const uint8_t *&ip, const uint8_t *end, size_t &length)
+        {
+            uint8_t byte;
+            do
+            {
+                if (ip >= end)
+                    return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+    }
+
+    size_t LZ4::CompressBound(size_t size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    std::vector<uint8_t> LZ4::Compress(const uint8_t *src, size_t size)
+    {
+        std::vector<uint8_t> out;
+        if (size == 0)
+            return out;
+
+        out.reserve(CompressBound(size));
+
+        size_t anchor = 0;
+
+        if (size > MF_LIMIT)
+        {
+            // Posición + 1 de la última secuencia con ese hash (0 = vacía)
+            std::vector<uint32_t> table(size_t(1) << HASH_LOG, 0);
+
+            const size_t matchLimit = size - LAST_LITERALS;
+            const size_t lastMatchStart = size - MF_LIMIT;
+
+            size_t ip = 0;
+            while (ip <= lastMatchStart)
+            {
+                const uint32_t sequence = Read32(src + ip);
+                uint32_t &slot = table[HashSequence(sequence)];
+                const size_t candidate = slot;
+                slot = static_cast<uint32_t>(ip + 1);
+
+                if (candidate == 0 || ip - (candidate - 1) > MAX_OFFSET ||
+                    Read32(src + candidate - 1) != sequence)
+                {
+                    // Sin match: avanzar más rápido cuanto más tiempo llevamos sin encontrar
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+
+                size_t ref = candidate - 1;
+
+                // Extender hacia atrás sobre los literales pendientes
+                while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1])
+                {
+                    ip--;
+                    ref--;
+                }
+
+                size_t length = MIN_MATCH;
+                while (ip + length < matchLimit && src[ref + length] == src[ip + length])
+                    length++;
+
+                WriteSequence(out, src + anchor, ip - anchor, ip - ref, length);
+
+                ip += length;
+                anchor = ip;
+
+                // Registrar la posición previa para encadenar matches repetitivos
+                if (ip >= 2 && ip - 2 <= lastMatchStart)
+                    table[HashSequence(Read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2 + 1);
+            }
+        }
+
+        WriteSequence(out, src + anchor, size - anchor, 0, 0);
+        return out;
+    }
+
+    bool LZ4::Decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize)
+    {
+        const uint8_t *ip = src;
+        const uint8_t *const ipEnd = src + srcSize;
+        uint8_t *op = dst;
+        uint8_t *const opEnd = dst + dstSize;
+
+        while (ip < ipEnd)
+        {
+            const uint8_t token = *ip++;
+
+            size_t literalCount = token >> 4;
+            if (literalCount == 15 && !ReadLength(ip, ipEnd, literalCount))
+                return false;
+
+            if (literalCount > static_cast<size_t>(ipEnd - ip) || literalCount > static_cast<size_t>(opEnd - op))
+                return false;
+
+            memcpy(op, ip, literalCount);
+            ip += literalCount;
+            op += literalCount;
+
+            // La última secuencia no lleva match
+            if (ip == ipEnd)
+                break;
+
+            if (ipEnd - ip < 2)
+                return false;
+
+            const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+            ip += 2;
+
+            if (offset == 0 || offset > static_cast<size_t>(op - dst))
+                return false;
+
+            size_t length = token & 0x0F;
+            if (length == 15 && !ReadLength(ip, ipEnd, length))
+                return false;
+            length += MIN_MATCH;
+
+            if (length > static_cast<size_t>(opEnd - op))
+                return false;
+
+            const uint8_t *match = op - offset;
+            if (offset >= length)
+            {
+                memcpy(op, match, length);
+                op += length;
+            }
+            else
+            {
+                // Solapado (runs): copia byte a byte
+                for (size_t i = 0; i < length; i++)
+                    *op++ = *match++;
+            }
+        }
+
+        return op == opEnd;
+    }
+}
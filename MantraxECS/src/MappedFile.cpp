@@ -0,0 +1,165 @@
+#include "../include/MappedFile.h"
+#include "../include/AssetArchive.h"
+#include <filesystem>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Mantrax
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    bool MappedFile::Open(const std::string &path, bool searchArchives)
+    {
+        Close();
+
+        if (searchArchives && OpenFromArchive(path))
+            return true;
+
+        return MapFromDisk(path);
+    }
+
+    void MappedFile::Close()
+    {
+        Unmap();
+
+        m_Buffer.clear();
+        m_Buffer.shrink_to_fit();
+        m_Archive.reset();
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+
+    bool MappedFile::Exists(const std::string &path)
+    {
+        const AssetArchiveEntry *entry = nullptr;
+        if (AssetArchive::FindMounted(path, entry))
+            return true;
+
+        std::error_code ec;
+        return std::filesystem::is_regular_file(path, ec);
+    }
+
+    bool MappedFile::OpenFromArchive(const std::string &path)
+    {
+        const AssetArchiveEntry *entry = nullptr;
+        std::shared_ptr<const AssetArchive> archive = AssetArchive::FindMounted(path, entry);
+        if (!archive || entry->size == 0)
+            return false;
+
+        if (const uint8_t *stored = archive->GetStoredData(*entry))
+        {
+            m_Archive = archive;
+            m_Data = stored;
+        }
+        else
+        {
+            if (!archive->Read(*entry, m_Buffer))
+                return false;
+            m_Data = m_Buffer.data();
+        }
+
+        m_Size = static_cast<size_t>(entry->size);
+        return true;
+    }
+
+#ifdef _WIN32
+    bool MappedFile::MapFromDisk(const std::string &path)
+    {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        m_File = file;
+        m_Mapping = mapping;
+        m_Data = static_cast<const uint8_t *>(view);
+        m_Size = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Unmap()
+    {
+        if (m_Mapping)
+        {
+            UnmapViewOfFile(m_Data);
+            CloseHandle(static_cast<HANDLE>(m_Mapping));
+        }
+        if (m_File)
+            CloseHandle(static_cast<HANDLE>(m_File));
+
+        m_Mapping = nullptr;
+        m_File = nullptr;
+    }
+#else
+    bool MappedFile::MapFromDisk(const std::string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+
+        m_Fd = fd;
+        m_Data = static_cast<const uint8_t *>(view);
+        m_Size = static_cast<size_t>(st.st_size);
+        return true;
+    }
+
+    void MappedFile::Unmap()
+    {
+        if (m_Fd >= 0)
+        {
+            munmap(const_cast<uint8_t *>(m_Data), m_Size);
+            close(m_Fd);
+        }
+
+        m_Fd = -1;
+    }
+#endif
+}
@@ -0,0 +1,264 @@
+#include "../include/MeshCache.h"
+#include "../include/ImportCache.h"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+namespace Mantrax
+{
+    namespace
+    {
+        const char MESH_CACHE_MAGIC[4] = {'M', 'X', 'M', 'S'};
+        const uint32_t MESH_CACHE_VERSION = 3; // 2: submeshes por material con bounds y LODs; 3: hash del contenido de la fuente
+        const uint64_t MESH_CACHE_ALIGNMENT = 16; // Meshlet lleva vec4
+
+        struct MeshCacheHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t vertexStride; // sizeof(Vertex) al escribir: otro layout invalida el cache
+            uint32_t submeshCount;
+
+            uint64_t sourceSize;
+            uint64_t sourceHash; // ImportCache::GetContentHash: tocar la fecha no invalida el cache
+            uint64_t settingsHash;
+
+            float boundsMin[3];
+            float boundsMax[3];
+            float uvDensity;
+            uint32_t vertexCount;
+            uint32_t indexCount; // LOD0 + LODs
+            uint32_t lodCount;   // 0 = solo LOD0
+            uint32_t meshletCount;
+            uint32_t submeshLODCount;
+
+            uint64_t vertexOffset;
+            uint64_t indexOffset;
+            uint64_t lodOffset;
+            uint64_t meshletOffset;
+            uint64_t submeshOffset;
+            uint64_t submeshLODOffset;
+        };
+        static_assert(sizeof(MeshCacheHeader) == 136, "MeshCacheHeader layout");
+        static_assert(sizeof(MeshSubmesh) == 48, "MeshSubmesh layout");
+
+        uint64_t AlignOffset(uint64_t offset)
+        {
+            return (offset + MESH_CACHE_ALIGNMENT - 1) / MESH_CACHE_ALIGNMENT * MESH_CACHE_ALIGNMENT;
+        }
+
+        bool BlockInFile(uint64_t offset, uint64_t count, uint64_t stride, size_t fileSize)
+        {
+            return offset % MESH_CACHE_ALIGNMENT == 0 && offset <= fileSize &&
+                   count <= (fileSize - offset) / stride;
+        }
+    }
+
+    std::string MeshCache::GetCachePath(const std::string &sourcePath)
+    {
+        return sourcePath + ".mxmesh";
+    }
+
+    uint64_t MeshCache::Hash(const void *data, size_t size, uint64_t seed)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    bool MeshCache::Save(const std::string &sourcePath, uint64_t settingsHash, const MeshSource &source)
+    {
+        if (source.vertexCount == 0 || source.indexCount == 0)
+            return false;
+
+        MeshCacheHeader header{};
+        memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+        header.version = MESH_CACHE_VERSION;
+        header.vertexStride = sizeof(Vertex);
+        header.settingsHash = settingsHash;
+
+        std::error_code sizeError;
+        header.sourceSize = std::filesystem::file_size(sourcePath, sizeError);
+        header.sourceHash = ImportCache::GetContentHash(sourcePath);
+        if (sizeError || header.sourceHash == 0)
+            return false;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            header.boundsMin[i] = source.boundsMin[i];
+            header.boundsMax[i] = source.boundsMax[i];
+        }
+        header.uvDensity = source.uvDensity;
+        header.vertexCount = source.vertexCount;
+        header.indexCount = source.indexCount;
+        header.lodCount = source.lodCount;
+        header.meshletCount = source.meshletCount;
+        header.submeshCount = source.submeshes ? source.submeshCount : 0;
+        header.submeshLODCount = source.submeshLODs ? source.submeshLODCount : 0;
+
+        header.vertexOffset = AlignOffset(sizeof(MeshCacheHeader));
+        header.indexOffset = AlignOffset(header.vertexOffset + sizeof(Vertex) * header.vertexCount);
+        header.lodOffset = AlignOffset(header.indexOffset + sizeof(uint32_t) * header.indexCount);
+        header.meshletOffset = AlignOffset(header.lodOffset + sizeof(MeshLOD) * header.lodCount);
+        header.submeshOffset = AlignOffset(header.meshletOffset + sizeof(Meshlet) * header.meshletCount);
+        header.submeshLODOffset = AlignOffset(header.submeshOffset + sizeof(MeshSubmesh) * header.submeshCount);
+
+        const std::string path = GetCachePath(sourcePath);
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                std::cerr << "⚠️ Could not write mesh cache: " << path << std::endl;
+                return false;
+            }
+
+            auto writeAt = [&file](uint64_t offset, const void *data, size_t size)
+            {
+                static const char padding[MESH_CACHE_ALIGNMENT] = {};
+                std::streamoff pos = file.tellp();
+                file.write(padding, static_cast<std::streamsize>(offset - static_cast<uint64_t>(pos)));
+                if (size > 0)
+                    file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+            };
+
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            writeAt(header.vertexOffset, source.vertices, sizeof(Vertex) * header.vertexCount);
+            writeAt(header.indexOffset, source.indices, sizeof(uint32_t) * header.indexCount);
+            writeAt(header.lodOffset, source.lods, sizeof(MeshLOD) * header.lodCount);
+            writeAt(header.meshletOffset, source.meshlets, sizeof(Meshlet) * header.meshletCount);
+            writeAt(header.submeshOffset, source.submeshes, sizeof(MeshSubmesh) * header.submeshCount);
+            writeAt(header.submeshLODOffset, source.submeshLODs, sizeof(MeshLOD) * header.submeshLODCount);
+
+            if (!file)
+            {
+                std::cerr << "⚠️ Could not write mesh cache: " << path << std::endl;
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool MeshCache::Open(const std::string &sourcePath, uint64_t settingsHash, MappedFile &file,
+                         MeshSource &outSource)
+    {
+        const std::string path = GetCachePath(sourcePath);
+
+        // En un .mxpak montado o en disco
+        if (!file.Open(path) || file.GetSize() < sizeof(MeshCacheHeader))
+        {
+            file.Close();
+            return false;
+        }
+
+        MeshCacheHeader header;
+        memcpy(&header, file.GetData(), sizeof(header));
+
+        if (memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != MESH_CACHE_VERSION || header.vertexStride != sizeof(Vertex))
+        {
+            std::cout << "⚠️ Mesh cache from another version, reimporting: " << sourcePath << std::endl;
+            file.Close();
+            return false;
+        }
+
+        // Sin fuente (solo el .mxmesh, p. ej. desde un .mxpak) vale el cache; el tamaño descarta
+        // la mayoría de las ediciones sin leer la fuente
+        std::error_code ec;
+        const uint64_t sourceSize = std::filesystem::file_size(sourcePath, ec);
+        if (header.settingsHash != settingsHash ||
+            (!ec && (sourceSize != header.sourceSize || ImportCache::GetContentHash(sourcePath) != header.sourceHash)))
+        {
+            std::cout << "⚠️ Mesh cache is stale, reimporting: " << sourcePath << std::endl;
+            file.Close();
+            return false;
+        }
+
+        const size_t size = file.GetSize();
+        if (header.vertexCount == 0 || header.indexCount == 0 ||
+            !BlockInFile(header.vertexOffset, header.vertexCount, sizeof(Vertex), size) ||
+            !BlockInFile(header.indexOffset, header.indexCount, sizeof(uint32_t), size) ||
+            !BlockInFile(header.lodOffset, header.lodCount, sizeof(MeshLOD), size) ||
+            !BlockInFile(header.meshletOffset, header.meshletCount, sizeof(Meshlet), size) ||
+            !BlockInFile(header.submeshOffset, header.submeshCount, sizeof(MeshSubmesh), size) ||
+            !BlockInFile(header.submeshLODOffset, header.submeshLODCount, sizeof(MeshLOD), size))
+        {
+            std::cerr << "⚠️ Corrupt mesh cache: " << path << std::endl;
+            file.Close();
+            return false;
+        }
+
+        const uint8_t *data = file.GetData();
+
+        // Los bloques están alineados dentro de una vista alineada a página: se usan en el sitio
+        outSource.vertices = reinterpret_cast<const Vertex *>(data + header.vertexOffset);
+        outSource.vertexCount = header.vertexCount;
+        outSource.indices = reinterpret_cast<const uint32_t *>(data + header.indexOffset);
+        outSource.indexCount = header.indexCount;
+        outSource.lods = header.lodCount ? reinterpret_cast<const MeshLOD *>(data + header.lodOffset) : nullptr;
+        outSource.lodCount = header.lodCount;
+        outSource.meshlets = header.meshletCount ? reinterpret_cast<const Meshlet *>(data + header.meshletOffset) : nullptr;
+        outSource.meshletCount = header.meshletCount;
+        outSource.submeshes = header.submeshCount ? reinterpret_cast<const MeshSubmesh *>(data + header.submeshOffset) : nullptr;
+        outSource.submeshCount = header.submeshCount;
+        outSource.submeshLODs = header.submeshLODCount ? reinterpret_cast<const MeshLOD *>(data + header.submeshLODOffset) : nullptr;
+        outSource.submeshLODCount = header.submeshLODCount;
+        outSource.boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+        outSource.boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+        outSource.uvDensity = header.uvDensity;
+
+        auto inIndexBuffer = [&header](uint32_t firstIndex, uint32_t indexCount)
+        {
+            return uint64_t(firstIndex) + indexCount <= header.indexCount;
+        };
+
+        bool valid = true;
+        for (uint32_t i = 0; i < header.lodCount; ++i)
+            valid = valid && inIndexBuffer(outSource.lods[i].firstIndex, outSource.lods[i].indexCount);
+        for (uint32_t i = 0; i < header.submeshLODCount; ++i)
+            valid = valid && inIndexBuffer(outSource.submeshLODs[i].firstIndex, outSource.submeshLODs[i].indexCount);
+        for (uint32_t i = 0; i < header.submeshCount; ++i)
+        {
+            const MeshSubmesh &submesh = outSource.submeshes[i];
+            valid = valid && inIndexBuffer(submesh.firstIndex, submesh.indexCount) &&
+                    uint64_t(submesh.firstLOD) + submesh.lodCount <= header.submeshLODCount;
+        }
+
+        if (!valid)
+        {
+            std::cerr << "⚠️ Corrupt mesh cache: " << path << std::endl;
+            file.Close();
+            return false;
+        }
+
+        return true;
+    }
+
+#ifndef MANTRAX_HEADLESS
+    std::shared_ptr<Mesh> MeshCache::Load(GFX *gfx, const std::string &sourcePath, uint64_t settingsHash)
+    {
+        MappedFile file;
+        MeshSource source;
+        if (!Open(sourcePath, settingsHash, file, source))
+            return nullptr;
+
+        return gfx->CreateMesh(source);
+    }
+#endif
+}
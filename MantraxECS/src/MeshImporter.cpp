@@ -0,0 +1,176 @@
+#include "../include/MeshImporter.h"
+#include "../include/MeshOptimizer.h"
+#include "../include/MeshletBuilder.h"
+#include "../include/MeshCache.h"
+#include <iostream>
+#include <chrono>
+#include <stdexcept>
+
+namespace Mantrax
+{
+    uint64_t MeshImportSettings::GetHash() const
+    {
+        const uint32_t values[] = {
+            load.GetFlags(),
+            load.optimizeMesh ? 1u : 0u,
+            generateLODs ? 1u : 0u,
+            lodSettings.maxLODs,
+            lodSettings.minTriangles,
+            generateMeshlets ? meshletMinTriangles : 0u};
+        const float factors[] = {lodSettings.reductionPerLOD, lodSettings.maxError};
+
+        uint64_t hash = MeshCache::Hash(values, sizeof(values));
+        return MeshCache::Hash(factors, sizeof(factors), hash);
+    }
+
+    void MeshImporter::Build(const std::vector<Vertex> &vertices,
+                             const std::vector<uint32_t> &indices,
+                             const std::vector<MeshSubmesh> &submeshes,
+                             const MeshImportSettings &settings,
+                             ImportedMesh &out)
+    {
+        out.submeshes = submeshes;
+
+        // Varios materiales: LODs por submesh (simplificar el mesh entero mezclaría sus rangos).
+        // Sin meshlets: el builder reordena los triángulos de todo el LOD0
+        if (submeshes.size() > 1)
+        {
+            out.vertices = vertices;
+            out.indices = indices;
+            out.lods.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+
+            size_t lodCount = 0;
+            for (auto &submesh : out.submeshes)
+            {
+                if (!settings.generateLODs)
+                    break;
+
+                auto first = indices.begin() + submesh.firstIndex;
+                std::vector<uint32_t> range(first, first + submesh.indexCount);
+                auto lods = MeshSimplifier::GenerateLODChain(vertices, range, settings.lodSettings, false);
+
+                submesh.firstLOD = static_cast<uint32_t>(out.submeshLODs.size());
+                out.submeshLODs.push_back({submesh.firstIndex, submesh.indexCount, 0.0f});
+
+                for (auto &lod : lods)
+                {
+                    if (lod.indices.empty())
+                        continue;
+
+                    MeshOptimizer::OptimizeVertexCache(lod.indices, vertices.size());
+                    out.submeshLODs.push_back({static_cast<uint32_t>(out.indices.size()),
+                                               static_cast<uint32_t>(lod.indices.size()), lod.error});
+                    out.indices.insert(out.indices.end(), lod.indices.begin(), lod.indices.end());
+                    lodCount++;
+                }
+
+                submesh.lodCount = static_cast<uint32_t>(out.submeshLODs.size()) - submesh.firstLOD;
+                if (submesh.lodCount == 1)
+                {
+                    // Sin LODs útiles: solo su rango del LOD0
+                    out.submeshLODs.pop_back();
+                    submesh.firstLOD = 0;
+                    submesh.lodCount = 0;
+                }
+            }
+
+            if (settings.generateLODs)
+                std::cout << "  LODs generated: " << lodCount << " across " << out.submeshes.size() << " submeshes" << std::endl;
+
+            out.source.uvDensity = ComputeMeshUVDensity(vertices, indices);
+        }
+        else
+        {
+            std::vector<MeshLODData> lods;
+
+            if (settings.generateLODs)
+            {
+                lods = MeshSimplifier::GenerateLODChain(vertices, indices, settings.lodSettings, true);
+
+                // Los LODs comparten el orden de vértices del LOD0: solo se reordenan sus triángulos
+                for (auto &lod : lods)
+                    MeshOptimizer::OptimizeVertexCache(lod.indices, vertices.size());
+
+                std::cout << "  LODs generated: " << lods.size() << std::endl;
+            }
+
+            // Meshlets solo para meshes densos (reordena los triángulos del LOD0)
+            out.vertices = vertices;
+            out.indices = indices;
+
+            if (settings.generateMeshlets && out.indices.size() / 3 >= settings.meshletMinTriangles)
+            {
+                out.meshlets = MeshletBuilder::Build(out.vertices, out.indices);
+                std::cout << "  Meshlets generated: " << out.meshlets.size() << std::endl;
+            }
+
+            out.source.uvDensity = ComputeMeshUVDensity(out.vertices, out.indices);
+
+            // Rangos como Mesh::AddLOD: LOD0 y después cada LOD concatenado en el mismo buffer
+            const uint32_t lod0Count = static_cast<uint32_t>(out.indices.size());
+            for (const auto &lod : lods)
+            {
+                if (lod.indices.empty())
+                    continue;
+
+                if (out.lods.empty())
+                    out.lods.push_back({0, lod0Count, 0.0f});
+
+                out.lods.push_back({static_cast<uint32_t>(out.indices.size()),
+                                    static_cast<uint32_t>(lod.indices.size()), lod.error});
+                out.indices.insert(out.indices.end(), lod.indices.begin(), lod.indices.end());
+            }
+        }
+
+        ComputeMeshBounds(out.vertices, out.source.boundsMin, out.source.boundsMax);
+
+        out.source.vertices = out.vertices.data();
+        out.source.vertexCount = static_cast<uint32_t>(out.vertices.size());
+        out.source.indices = out.indices.data();
+        out.source.indexCount = static_cast<uint32_t>(out.indices.size());
+        out.source.lods = out.lods.empty() ? nullptr : out.lods.data();
+        out.source.lodCount = static_cast<uint32_t>(out.lods.size());
+        out.source.meshlets = out.meshlets.empty() ? nullptr : out.meshlets.data();
+        out.source.meshletCount = static_cast<uint32_t>(out.meshlets.size());
+        out.source.submeshes = out.submeshes.empty() ? nullptr : out.submeshes.data();
+        out.source.submeshCount = static_cast<uint32_t>(out.submeshes.size());
+        out.source.submeshLODs = out.submeshLODs.empty() ? nullptr : out.submeshLODs.data();
+        out.source.submeshLODCount = static_cast<uint32_t>(out.submeshLODs.size());
+    }
+
+    std::shared_ptr<ImportedMesh> MeshImporter::Import(const std::string &modelPath,
+                                                       const MeshImportSettings &settings,
+                                                       bool useCache)
+    {
+        const uint64_t settingsHash = settings.GetHash();
+        auto start = std::chrono::steady_clock::now();
+        auto imported = std::make_shared<ImportedMesh>();
+
+        // ✅ Geometría ya procesada: sin Assimp, sin LODs ni meshlets que recalcular
+        if (useCache && MeshCache::Open(modelPath, settingsHash, imported->cacheFile, imported->source))
+        {
+            auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "✓ Mesh cache: " << MeshCache::GetCachePath(modelPath) << " (" << ms << " ms)" << std::endl;
+            return imported;
+        }
+
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<MeshSubmesh> submeshes;
+
+        // Cada llamada usa su propio AssimpLoader: vale desde cualquier hilo
+        AssimpLoader loader;
+        if (!loader.LoadModel(modelPath, vertices, indices, submeshes, settings.load, true))
+            throw std::runtime_error(loader.GetLastError());
+
+        Build(vertices, indices, submeshes, settings, *imported);
+
+        if (useCache && MeshCache::Save(modelPath, settingsHash, imported->source))
+        {
+            auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "  Imported in " << ms << " ms, cached to " << MeshCache::GetCachePath(modelPath) << std::endl;
+        }
+
+        return imported;
+    }
+}
@@ -0,0 +1,402 @@
+#include "../include/MeshOptimizer.h"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+namespace Mantrax
+{
+    namespace
+    {
+        // Cache FIFO por timestamps: un vértice sigue en cache si entraron
+        // menos de cacheSize vértices después de él
+        struct CacheSim
+        {
+            std::vector<uint32_t> timestamps;
+            uint32_t time;
+            uint32_t size;
+
+            CacheSim(size_t vertexCount, uint32_t cacheSize)
+                : timestamps(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+            uint32_t Touch(uint32_t v)
+            {
+                if (time - timestamps[v] > size)
+                {
+                    timestamps[v] = time++;
+                    return 1;
+                }
+                return 0;
+            }
+
+            void Flush() { time += size + 1; }
+        };
+
+        glm::vec3 Position(const Vertex &v)
+        {
+            return glm::vec3(v.position[0], v.position[1], v.position[2]);
+        }
+    }
+
+    MeshCacheStats MeshOptimizer::AnalyzeVertexCache(
+        const std::vector<uint32_t> &indices,
+        size_t vertexCount,
+        uint32_t cacheSize)
+    {
+        MeshCacheStats stats;
+        if (indices.size() < 3 || vertexCount == 0)
+            return stats;
+
+        CacheSim cache(vertexCount, cacheSize);
+        std::vector<uint8_t> used(vertexCount, 0);
+
+        uint32_t misses = 0;
+        uint32_t unique = 0;
+
+        for (uint32_t idx : indices)
+        {
+            misses += cache.Touch(idx);
+
+            if (!used[idx])
+            {
+                used[idx] = 1;
+                unique++;
+            }
+        }
+
+        stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+        stats.atvr = unique > 0 ? static_cast<float>(misses) / static_cast<float>(unique) : 0.0f;
+        return stats;
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(
+        std::vector<uint32_t> &indices,
+        size_t vertexCount,
+        uint32_t cacheSize)
+    {
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0 || vertexCount == 0)
+            return;
+
+        // Adyacencia vértice → triángulos
+        std::vector<uint32_t> liveTriangles(vertexCount, 0);
+        for (size_t i = 0; i < triCount * 3; ++i)
+            liveTriangles[indices[i]]++;
+
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v)
+            offsets[v + 1] = offsets[v] + liveTriangles[v];
+
+        std::vector<uint32_t> adjacency(triCount * 3);
+        {
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < triCount * 3; ++i)
+                adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        std::vector<uint32_t> cacheTime(vertexCount, 0);
+        std::vector<uint8_t> emitted(triCount, 0);
+        std::vector<uint32_t> deadEnd;
+        deadEnd.reserve(triCount * 3);
+
+        std::vector<uint32_t> result;
+        result.reserve(triCount * 3);
+
+        uint32_t time = cacheSize + 1;
+        size_t scanCursor = 0;
+        uint32_t fanning = indices[0];
+
+        for (;;)
+        {
+            // Emitir todos los triángulos pendientes alrededor del vértice actual
+            size_t ringBegin = deadEnd.size();
+
+            for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; ++a)
+            {
+                uint32_t t = adjacency[a];
+                if (emitted[t])
+                    continue;
+
+                for (int k = 0; k < 3; ++k)
+                {
+                    uint32_t v = indices[t * 3 + k];
+                    result.push_back(v);
+                    deadEnd.push_back(v);
+                    liveTriangles[v]--;
+
+                    if (time - cacheTime[v] > cacheSize)
+                        cacheTime[v] = time++;
+                }
+
+                emitted[t] = 1;
+            }
+
+            // Siguiente vértice: el del 1-ring que seguirá en cache tras emitir su abanico
+            int64_t next = -1;
+            int64_t bestPriority = -1;
+
+            for (size_t c = ringBegin; c < deadEnd.size(); ++c)
+            {
+                uint32_t v = deadEnd[c];
+                if (liveTriangles[v] == 0)
+                    continue;
+
+                int64_t priority = 0;
+                if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize)
+                    priority = time - cacheTime[v];
+
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    next = v;
+                }
+            }
+
+            // Dead-end: volver a vértices recientes que aún tengan triángulos
+            while (next == -1 && !deadEnd.empty())
+            {
+                uint32_t v = deadEnd.back();
+                deadEnd.pop_back();
+
+                if (liveTriangles[v] > 0)
+                    next = v;
+            }
+
+            // Último recurso: siguiente vértice vivo en orden
+            if (next == -1)
+            {
+                while (scanCursor < vertexCount && liveTriangles[scanCursor] == 0)
+                    ++scanCursor;
+
+                if (scanCursor == vertexCount)
+                    break;
+
+                next = static_cast<int64_t>(scanCursor);
+            }
+
+            fanning = static_cast<uint32_t>(next);
+        }
+
+        indices.swap(result);
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(
+        std::vector<uint32_t> &indices,
+        const std::vector<Vertex> &vertices,
+        float threshold,
+        uint32_t cacheSize)
+    {
+        const size_t triCount = indices.size() / 3;
+        if (triCount < 2 || vertices.empty())
+            return;
+
+        // ============================================
+        // 1. Bordes duros: triángulos con 3 misses (Tipsify saltó a otra zona)
+        // ============================================
+        std::vector<uint32_t> hardClusters;
+        {
+            CacheSim cache(vertices.size(), cacheSize);
+            for (size_t t = 0; t < triCount; ++t)
+            {
+                uint32_t misses = cache.Touch(indices[t * 3 + 0]) +
+                                  cache.Touch(indices[t * 3 + 1]) +
+                                  cache.Touch(indices[t * 3 + 2]);
+
+                if (t == 0 || misses == 3)
+                    hardClusters.push_back(static_cast<uint32_t>(t));
+            }
+        }
+
+        // ============================================
+        // 2. Bordes blandos: partir mientras el ACMR local no empeore demasiado
+        // ============================================
+        const float acmrThreshold = AnalyzeVertexCache(indices, vertices.size(), cacheSize).acmr * threshold;
+
+        std::vector<uint32_t> clusters;
+        {
+            CacheSim cache(vertices.size(), cacheSize);
+
+            for (size_t c = 0; c < hardClusters.size(); ++c)
+            {
+                size_t start = hardClusters[c];
+                size_t end = (c + 1 < hardClusters.size()) ? hardClusters[c + 1] : triCount;
+
+                cache.Flush();
+                clusters.push_back(static_cast<uint32_t>(start));
+
+                size_t clusterStart = start;
+                uint32_t misses = 0;
+
+                for (size_t t = start; t < end; ++t)
+                {
+                    misses += cache.Touch(indices[t * 3 + 0]) +
+                              cache.Touch(indices[t * 3 + 1]) +
+                              cache.Touch(indices[t * 3 + 2]);
+
+                    float localAcmr = static_cast<float>(misses) / static_cast<float>(t + 1 - clusterStart);
+
+                    if (t + 1 < end && localAcmr <= acmrThreshold)
+                    {
+                        clusters.push_back(static_cast<uint32_t>(t + 1));
+                        clusterStart = t + 1;
+                        misses = 0;
+                        cache.Flush();
+                    }
+                }
+            }
+        }
+
+        if (clusters.size() < 2)
+            return;
+
+        // ============================================
+        // 3. Ordenar clusters: los que miran hacia fuera primero
+        // ============================================
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+
+        for (size_t t = 0; t < triCount; ++t)
+        {
+            glm::vec3 p0 = Position(vertices[indices[t * 3 + 0]]);
+            glm::vec3 p1 = Position(vertices[indices[t * 3 + 1]]);
+            glm::vec3 p2 = Position(vertices[indices[t * 3 + 2]]);
+
+            float area = glm::length(glm::cross(p1 - p0, p2 - p0));
+            meshCentroid += (p0 + p1 + p2) * (area / 3.0f);
+            meshArea += area;
+        }
+
+        if (meshArea > 0.0f)
+            meshCentroid /= meshArea;
+
+        std::vector<float> sortKeys(clusters.size(), 0.0f);
+
+        for (size_t c = 0; c < clusters.size(); ++c)
+        {
+            size_t start = clusters[c];
+            size_t end = (c + 1 < clusters.size()) ? clusters[c + 1] : triCount;
+
+            glm::vec3 centroid(0.0f);
+            glm::vec3 normal(0.0f);
+            float area = 0.0f;
+
+            for (size_t t = start; t < end; ++t)
+            {
+                glm::vec3 p0 = Position(vertices[indices[t * 3 + 0]]);
+                glm::vec3 p1 = Position(vertices[indices[t * 3 + 1]]);
+                glm::vec3 p2 = Position(vertices[indices[t * 3 + 2]]);
+
+                glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                float a = glm::length(n);
+
+                centroid += (p0 + p1 + p2) * (a / 3.0f);
+                normal += n;
+                area += a;
+            }
+
+            float normalLength = glm::length(normal);
+            if (area > 0.0f && normalLength > 0.0f)
+                sortKeys[c] = glm::dot(centroid / area - meshCentroid, normal / normalLength);
+        }
+
+        std::vector<uint32_t> order(clusters.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(),
+                         [&sortKeys](uint32_t l, uint32_t r)
+                         { return sortKeys[l] > sortKeys[r]; });
+
+        std::vector<uint32_t> result;
+        result.reserve(triCount * 3);
+
+        for (uint32_t c : order)
+        {
+            size_t start = clusters[c];
+            size_t end = (c + 1 < clusters.size()) ? clusters[c + 1] : triCount;
+            result.insert(result.end(), indices.begin() + start * 3, indices.begin() + end * 3);
+        }
+
+        indices.swap(result);
+    }
+
+    size_t MeshOptimizer::OptimizeVertexFetch(
+        std::vector<Vertex> &vertices,
+        std::vector<uint32_t> &indices)
+    {
+        const uint32_t unused = 0xffffffffu;
+        std::vector<uint32_t> remap(vertices.size(), unused);
+
+        std::vector<Vertex> result;
+        result.reserve(vertices.size());
+
+        for (auto &idx : indices)
+        {
+            if (remap[idx] == unused)
+            {
+                remap[idx] = static_cast<uint32_t>(result.size());
+                result.push_back(vertices[idx]);
+            }
+
+            idx = remap[idx];
+        }
+
+        vertices.swap(result);
+        return vertices.size();
+    }
+
+    void MeshOptimizer::Optimize(
+        std::vector<Vertex> &vertices,
+        std::vector<uint32_t> &indices,
+        const MeshOptimizeSettings &settings,
+        bool verbose)
+    {
+        MeshSubmesh all;
+        all.indexCount = static_cast<uint32_t>(indices.size());
+        Optimize(vertices, indices, std::vector<MeshSubmesh>{all}, settings, verbose);
+    }
+
+    void MeshOptimizer::Optimize(
+        std::vector<Vertex> &vertices,
+        std::vector<uint32_t> &indices,
+        const std::vector<MeshSubmesh> &submeshes,
+        const MeshOptimizeSettings &settings,
+        bool verbose)
+    {
+        if (vertices.empty() || indices.size() < 3 || indices.size() % 3 != 0)
+            return;
+
+        MeshCacheStats before = AnalyzeVertexCache(indices, vertices.size(), settings.cacheSize);
+
+        for (const auto &submesh : submeshes)
+        {
+            if (submesh.indexCount < 3 || uint64_t(submesh.firstIndex) + submesh.indexCount > indices.size())
+                continue;
+
+            auto first = indices.begin() + submesh.firstIndex;
+            std::vector<uint32_t> range(first, first + submesh.indexCount);
+
+            if (settings.vertexCache)
+                OptimizeVertexCache(range, vertices.size(), settings.cacheSize);
+
+            if (settings.overdraw)
+                OptimizeOverdraw(range, vertices, settings.overdrawThreshold, settings.cacheSize);
+
+            std::copy(range.begin(), range.end(), first);
+        }
+
+        size_t vertexCountBefore = vertices.size();
+        if (settings.vertexFetch)
+            OptimizeVertexFetch(vertices, indices);
+
+        if (verbose)
+        {
+            MeshCacheStats after = AnalyzeVertexCache(indices, vertices.size(), settings.cacheSize);
+
+            std::cout << "  ⚙️ Mesh optimized: ACMR " << before.acmr << " -> " << after.acmr
+                      << ", ATVR " << before.atvr << " -> " << after.atvr;
+
+            if (vertices.size() != vertexCountBefore)
+                std::cout << ", vertices " << vertexCountBefore << " -> " << vertices.size();
+
+            std::cout << "\n";
+        }
+    }
+}
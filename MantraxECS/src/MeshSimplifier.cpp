@@ -0,0 +1,421 @@
+#include "../include/MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+
+namespace Mantrax
+{
+    namespace
+    {
+        // Cuádrica simétrica (A 3x3, b, c) + peso acumulado (área de los planos)
+        struct Quadric
+        {
+            double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+            double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+            double c = 0.0;
+            double w = 0.0;
+
+            // Plano n·p + d = 0 con n normalizada
+            void AddPlane(const glm::dvec3 &n, double d, double weight)
+            {
+                a00 += weight * n.x * n.x;
+                a01 += weight * n.x * n.y;
+                a02 += weight * n.x * n.z;
+                a11 += weight * n.y * n.y;
+                a12 += weight * n.y * n.z;
+                a22 += weight * n.z * n.z;
+                b0 += weight * n.x * d;
+                b1 += weight * n.y * d;
+                b2 += weight * n.z * d;
+                c += weight * d * d;
+                w += weight;
+            }
+
+            void Add(const Quadric &q)
+            {
+                a00 += q.a00;
+                a01 += q.a01;
+                a02 += q.a02;
+                a11 += q.a11;
+                a12 += q.a12;
+                a22 += q.a22;
+                b0 += q.b0;
+                b1 += q.b1;
+                b2 += q.b2;
+                c += q.c;
+                w += q.w;
+            }
+
+            // Distancia cuadrática media (ponderada por área) a los planos acumulados
+            double Error(const glm::dvec3 &p) const
+            {
+                if (w <= 0.0)
+                    return 0.0;
+
+                double e = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z +
+                           2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z) +
+                           2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+
+                return std::max(e, 0.0) / w;
+            }
+        };
+
+        struct PositionKey
+        {
+            uint32_t x, y, z;
+            bool operator==(const PositionKey &o) const { return x == o.x && y == o.y && z == o.z; }
+        };
+
+        struct PositionKeyHash
+        {
+            size_t operator()(const PositionKey &k) const
+            {
+                return (static_cast<size_t>(k.x) * 73856093u) ^
+                       (static_cast<size_t>(k.y) * 19349663u) ^
+                       (static_cast<size_t>(k.z) * 83492791u);
+            }
+        };
+
+        PositionKey MakeKey(const Vertex &v)
+        {
+            PositionKey key;
+            memcpy(&key.x, &v.position[0], sizeof(float));
+            memcpy(&key.y, &v.position[1], sizeof(float));
+            memcpy(&key.z, &v.position[2], sizeof(float));
+            return key;
+        }
+
+        glm::dvec3 Position(const Vertex &v)
+        {
+            return glm::dvec3(v.position[0], v.position[1], v.position[2]);
+        }
+
+        struct Collapse
+        {
+            uint32_t from;
+            uint32_t to;
+            double cost;
+        };
+    }
+
+    std::vector<uint32_t> MeshSimplifier::Simplify(
+        const std::vector<Vertex> &vertices,
+        const std::vector<uint32_t> &indices,
+        size_t targetIndexCount,
+        float maxError,
+        float *outError)
+    {
+        if (outError)
+            *outError = 0.0f;
+
+        std::vector<uint32_t> result = indices;
+        if (indices.size() % 3 != 0 || vertices.empty() || result.size() <= targetIndexCount)
+            return result;
+
+        const size_t vertexCount = vertices.size();
+
+        // ============================================
+        // 1. Agrupar vértices por posición (wedges)
+        // ============================================
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> positionIds;
+        std::vector<uint32_t> positionId(vertexCount);
+        std::vector<uint32_t> wedgeCount;
+
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            auto it = positionIds.emplace(MakeKey(vertices[v]), static_cast<uint32_t>(wedgeCount.size()));
+            if (it.second)
+                wedgeCount.push_back(0);
+
+            positionId[v] = it.first->second;
+            wedgeCount[positionId[v]]++;
+        }
+
+        const size_t positionCount = wedgeCount.size();
+
+        // ============================================
+        // 2. Bordes abiertos / no-manifold (en espacio de posiciones)
+        // ============================================
+        std::unordered_map<uint64_t, uint32_t> edgeUse;
+        edgeUse.reserve(result.size());
+
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (int e = 0; e < 3; ++e)
+            {
+                uint32_t a = positionId[result[i + e]];
+                uint32_t b = positionId[result[i + (e + 1) % 3]];
+                if (a == b)
+                    continue;
+
+                uint64_t key = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+                edgeUse[key]++;
+            }
+        }
+
+        std::vector<uint8_t> positionLocked(positionCount, 0);
+
+        // Costuras UV/normales: varios vértices comparten posición → no se mueven
+        for (size_t p = 0; p < positionCount; ++p)
+        {
+            if (wedgeCount[p] > 1)
+                positionLocked[p] = 1;
+        }
+
+        for (const auto &edge : edgeUse)
+        {
+            if (edge.second != 2)
+            {
+                positionLocked[static_cast<uint32_t>(edge.first >> 32)] = 1;
+                positionLocked[static_cast<uint32_t>(edge.first & 0xffffffffu)] = 1;
+            }
+        }
+
+        // ============================================
+        // 3. Cuádricas por posición
+        // ============================================
+        std::vector<Quadric> quadrics(positionCount);
+
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            glm::dvec3 p0 = Position(vertices[result[i + 0]]);
+            glm::dvec3 p1 = Position(vertices[result[i + 1]]);
+            glm::dvec3 p2 = Position(vertices[result[i + 2]]);
+
+            glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+            double len = glm::length(n);
+            if (len <= 0.0)
+                continue;
+
+            n /= len;
+            double d = -glm::dot(n, p0);
+            double area = len * 0.5;
+
+            for (int k = 0; k < 3; ++k)
+                quadrics[positionId[result[i + k]]].AddPlane(n, d, area);
+        }
+
+        // ============================================
+        // 4. Pases de colapso
+        // ============================================
+        const double maxErrorSq = static_cast<double>(maxError) * static_cast<double>(maxError);
+        double resultErrorSq = 0.0;
+
+        std::vector<uint32_t> adjOffsets(vertexCount + 1);
+        std::vector<uint32_t> adjTriangles;
+        std::vector<uint32_t> collapseTo(vertexCount);
+        std::vector<uint8_t> touched(vertexCount);
+        std::vector<Collapse> candidates;
+
+        while (result.size() > targetIndexCount)
+        {
+            // Adyacencia vértice → triángulos del resultado actual
+            std::fill(adjOffsets.begin(), adjOffsets.end(), 0u);
+            for (uint32_t idx : result)
+                adjOffsets[idx + 1]++;
+            for (size_t v = 0; v < vertexCount; ++v)
+                adjOffsets[v + 1] += adjOffsets[v];
+
+            adjTriangles.resize(result.size());
+            {
+                std::vector<uint32_t> cursor(adjOffsets.begin(), adjOffsets.end() - 1);
+                for (size_t i = 0; i < result.size(); ++i)
+                    adjTriangles[cursor[result[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+
+            auto collapseCost = [&](uint32_t from, uint32_t to)
+            {
+                Quadric q = quadrics[positionId[from]];
+                q.Add(quadrics[positionId[to]]);
+                return q.Error(Position(vertices[to]));
+            };
+
+            candidates.clear();
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                for (int e = 0; e < 3; ++e)
+                {
+                    uint32_t a = result[i + e];
+                    uint32_t b = result[i + (e + 1) % 3];
+
+                    if (!positionLocked[positionId[a]])
+                        candidates.push_back({a, b, collapseCost(a, b)});
+                    if (!positionLocked[positionId[b]])
+                        candidates.push_back({b, a, collapseCost(b, a)});
+                }
+            }
+
+            if (candidates.empty())
+                break;
+
+            std::sort(candidates.begin(), candidates.end(),
+                      [](const Collapse &l, const Collapse &r)
+                      { return l.cost < r.cost; });
+
+            // Un colapso elimina ~2 triángulos (6 índices)
+            size_t collapsesNeeded = (result.size() - targetIndexCount) / 6 + 1;
+
+            std::iota(collapseTo.begin(), collapseTo.end(), 0u);
+            std::fill(touched.begin(), touched.end(), uint8_t(0));
+
+            // Evita colapsos que invierten triángulos vecinos
+            auto wouldFlip = [&](uint32_t from, uint32_t to)
+            {
+                glm::dvec3 newPos = Position(vertices[to]);
+
+                for (uint32_t a = adjOffsets[from]; a < adjOffsets[from + 1]; ++a)
+                {
+                    size_t t = static_cast<size_t>(adjTriangles[a]) * 3;
+                    uint32_t i0 = result[t], i1 = result[t + 1], i2 = result[t + 2];
+
+                    // Triángulos que contienen la arista desaparecen
+                    if (i0 == to || i1 == to || i2 == to)
+                        continue;
+
+                    glm::dvec3 p0 = Position(vertices[i0]);
+                    glm::dvec3 p1 = Position(vertices[i1]);
+                    glm::dvec3 p2 = Position(vertices[i2]);
+                    glm::dvec3 before = glm::cross(p1 - p0, p2 - p0);
+
+                    if (i0 == from)
+                        p0 = newPos;
+                    if (i1 == from)
+                        p1 = newPos;
+                    if (i2 == from)
+                        p2 = newPos;
+                    glm::dvec3 after = glm::cross(p1 - p0, p2 - p0);
+
+                    if (glm::dot(before, after) <= 0.0)
+                        return true;
+                }
+
+                return false;
+            };
+
+            auto touchNeighborhood = [&](uint32_t v)
+            {
+                for (uint32_t a = adjOffsets[v]; a < adjOffsets[v + 1]; ++a)
+                {
+                    size_t t = static_cast<size_t>(adjTriangles[a]) * 3;
+                    touched[result[t]] = 1;
+                    touched[result[t + 1]] = 1;
+                    touched[result[t + 2]] = 1;
+                }
+            };
+
+            size_t collapses = 0;
+            for (const auto &c : candidates)
+            {
+                if (c.cost > maxErrorSq)
+                    break;
+
+                if (touched[c.from] || touched[c.to])
+                    continue;
+
+                if (wouldFlip(c.from, c.to))
+                    continue;
+
+                collapseTo[c.from] = c.to;
+                quadrics[positionId[c.to]].Add(quadrics[positionId[c.from]]);
+                resultErrorSq = std::max(resultErrorSq, c.cost);
+
+                touchNeighborhood(c.from);
+                touchNeighborhood(c.to);
+
+                if (++collapses >= collapsesNeeded)
+                    break;
+            }
+
+            if (collapses == 0)
+                break;
+
+            // Reescribir y quitar triángulos degenerados
+            size_t write = 0;
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                uint32_t a = collapseTo[result[i]];
+                uint32_t b = collapseTo[result[i + 1]];
+                uint32_t c = collapseTo[result[i + 2]];
+
+                if (a == b || b == c || a == c)
+                    continue;
+
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+            result.resize(write);
+        }
+
+        if (outError)
+            *outError = static_cast<float>(std::sqrt(resultErrorSq));
+
+        return result;
+    }
+
+    std::vector<MeshLODData> MeshSimplifier::GenerateLODChain(
+        const std::vector<Vertex> &vertices,
+        const std::vector<uint32_t> &indices,
+        const MeshLODSettings &settings,
+        bool verbose)
+    {
+        std::vector<MeshLODData> lods;
+
+        if (vertices.empty() || indices.size() < static_cast<size_t>(settings.minTriangles) * 3 * 2)
+            return lods;
+
+        // Error absoluto a partir de la diagonal del mesh
+        glm::vec3 bmin(vertices[0].position[0], vertices[0].position[1], vertices[0].position[2]);
+        glm::vec3 bmax = bmin;
+        for (const auto &v : vertices)
+        {
+            glm::vec3 p(v.position[0], v.position[1], v.position[2]);
+            bmin = glm::min(bmin, p);
+            bmax = glm::max(bmax, p);
+        }
+
+        const float maxAbsError = settings.maxError * glm::length(bmax - bmin);
+
+        std::vector<uint32_t> current = indices;
+        float accumulatedError = 0.0f;
+
+        for (uint32_t level = 1; level <= settings.maxLODs; ++level)
+        {
+            size_t target = static_cast<size_t>(current.size() * settings.reductionPerLOD) / 3 * 3;
+            if (target < static_cast<size_t>(settings.minTriangles) * 3)
+                break;
+
+            float remainingError = maxAbsError - accumulatedError;
+            if (remainingError <= 0.0f)
+                break;
+
+            float levelError = 0.0f;
+            auto simplified = Simplify(vertices, current, target, remainingError, &levelError);
+
+            // Menos de un 10% de reducción: otro nivel no compensa
+            if (simplified.empty() || simplified.size() * 10 > current.size() * 9)
+                break;
+
+            accumulatedError += levelError;
+
+            if (verbose)
+            {
+                std::cout << "  LOD" << level << ": " << simplified.size() / 3 << " tris ("
+                          << (100 * simplified.size() / indices.size()) << "%), error "
+                          << accumulatedError << "\n";
+            }
+
+            MeshLODData lod;
+            lod.indices = simplified;
+            lod.error = accumulatedError;
+            lods.push_back(std::move(lod));
+
+            current = std::move(simplified);
+        }
+
+        return lods;
+    }
+}
@@ -0,0 +1,263 @@
+#include "../include/MeshletBuilder.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Mantrax
+{
+    namespace
+    {
+        glm::vec3 Position(const Vertex &v)
+        {
+            return glm::vec3(v.position[0], v.position[1], v.position[2]);
+        }
+    }
+
+    std::vector<Meshlet> MeshletBuilder::Build(
+        const std::vector<Vertex> &vertices,
+        std::vector<uint32_t> &indices,
+        uint32_t maxVertices,
+        uint32_t maxTriangles)
+    {
+        std::vector<Meshlet> meshlets;
+
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0 || vertices.empty() || maxVertices < 3 || maxTriangles == 0)
+            return meshlets;
+
+        const size_t vertexCount = vertices.size();
+
+        // Adyacencia vértice → triángulos
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < triCount * 3; ++i)
+            offsets[indices[i] + 1]++;
+        for (size_t v = 0; v < vertexCount; ++v)
+            offsets[v + 1] += offsets[v];
+
+        std::vector<uint32_t> adjacency(triCount * 3);
+        {
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < triCount * 3; ++i)
+                adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        std::vector<uint8_t> emitted(triCount, 0);
+        std::vector<uint32_t> seenIn(vertexCount, 0); // Marca del meshlet actual
+        uint32_t stamp = 1;
+
+        std::vector<uint32_t> meshletVertices;
+        meshletVertices.reserve(maxVertices);
+
+        std::vector<uint32_t> result;
+        result.reserve(triCount * 3);
+
+        Meshlet current;
+        uint32_t triangles = 0;
+        glm::vec3 centroidSum(0.0f);
+
+        auto triangleCentroid = [&](size_t t)
+        {
+            return (Position(vertices[indices[t * 3 + 0]]) +
+                    Position(vertices[indices[t * 3 + 1]]) +
+                    Position(vertices[indices[t * 3 + 2]])) / 3.0f;
+        };
+
+        // Vértices que el triángulo añadiría al meshlet actual
+        auto countNew = [&](size_t t)
+        {
+            uint32_t a = indices[t * 3 + 0];
+            uint32_t b = indices[t * 3 + 1];
+            uint32_t c = indices[t * 3 + 2];
+
+            uint32_t n = 0;
+            if (seenIn[a] != stamp)
+                n++;
+            if (b != a && seenIn[b] != stamp)
+                n++;
+            if (c != a && c != b && seenIn[c] != stamp)
+                n++;
+            return n;
+        };
+
+        auto emit = [&](size_t t)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                uint32_t v = indices[t * 3 + k];
+                if (seenIn[v] != stamp)
+                {
+                    seenIn[v] = stamp;
+                    meshletVertices.push_back(v);
+                }
+                result.push_back(v);
+            }
+
+            emitted[t] = 1;
+            centroidSum += triangleCentroid(t);
+            triangles++;
+        };
+
+        auto flush = [&]()
+        {
+            current.indexCount = static_cast<uint32_t>(result.size()) - current.firstIndex;
+            current.vertexCount = static_cast<uint32_t>(meshletVertices.size());
+            ComputeBounds(vertices, result, current);
+            meshlets.push_back(current);
+
+            current = Meshlet{};
+            current.firstIndex = static_cast<uint32_t>(result.size());
+            meshletVertices.clear();
+            centroidSum = glm::vec3(0.0f);
+            triangles = 0;
+            stamp++;
+        };
+
+        size_t seedCursor = 0;
+
+        for (size_t emittedCount = 0; emittedCount < triCount; ++emittedCount)
+        {
+            // Candidato: vecino que añade menos vértices, luego el más cercano al centro
+            int64_t best = -1;
+            uint32_t bestNew = 4;
+            float bestDistance = FLT_MAX;
+
+            if (triangles > 0)
+            {
+                glm::vec3 centroid = centroidSum / static_cast<float>(triangles);
+
+                for (uint32_t v : meshletVertices)
+                {
+                    for (uint32_t a = offsets[v]; a < offsets[v + 1]; ++a)
+                    {
+                        uint32_t t = adjacency[a];
+                        if (emitted[t])
+                            continue;
+
+                        uint32_t n = countNew(t);
+                        float distance = glm::length(triangleCentroid(t) - centroid);
+
+                        if (n < bestNew || (n == bestNew && distance < bestDistance))
+                        {
+                            best = t;
+                            bestNew = n;
+                            bestDistance = distance;
+                        }
+                    }
+                }
+            }
+
+            // Sin vecinos (isla agotada o meshlet nuevo): seguir el orden de entrada
+            if (best == -1)
+            {
+                while (emitted[seedCursor])
+                    ++seedCursor;
+
+                best = static_cast<int64_t>(seedCursor);
+                bestNew = countNew(seedCursor);
+            }
+
+            if (triangles > 0 &&
+                (meshletVertices.size() + bestNew > maxVertices || triangles + 1 > maxTriangles))
+            {
+                flush();
+            }
+
+            emit(static_cast<size_t>(best));
+        }
+
+        if (triangles > 0)
+            flush();
+
+        indices.swap(result);
+        return meshlets;
+    }
+
+    void MeshletBuilder::ComputeBounds(
+        const std::vector<Vertex> &vertices,
+        const std::vector<uint32_t> &indices,
+        Meshlet &meshlet)
+    {
+        const uint32_t begin = meshlet.firstIndex;
+        const uint32_t end = meshlet.firstIndex + meshlet.indexCount;
+
+        // Esfera: centro de la AABB + distancia máxima
+        glm::vec3 bmin(FLT_MAX);
+        glm::vec3 bmax(-FLT_MAX);
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            glm::vec3 p = Position(vertices[indices[i]]);
+            bmin = glm::min(bmin, p);
+            bmax = glm::max(bmax, p);
+        }
+
+        glm::vec3 center = (bmin + bmax) * 0.5f;
+        float radius = 0.0f;
+        for (uint32_t i = begin; i < end; ++i)
+            radius = std::max(radius, glm::length(Position(vertices[indices[i]]) - center));
+
+        meshlet.sphere = glm::vec4(center, radius);
+
+        // Cono: eje = normal media, cutoff = seno del semiángulo máximo
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.indexCount / 3);
+
+        glm::vec3 axis(0.0f);
+        for (uint32_t i = begin; i + 2 < end; i += 3)
+        {
+            glm::vec3 p0 = Position(vertices[indices[i + 0]]);
+            glm::vec3 p1 = Position(vertices[indices[i + 1]]);
+            glm::vec3 p2 = Position(vertices[indices[i + 2]]);
+
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float len = glm::length(n);
+            if (len <= 0.0f)
+            {
+                normals.push_back(glm::vec3(0.0f));
+                continue;
+            }
+
+            n /= len;
+            normals.push_back(n);
+            axis += n;
+        }
+
+        meshlet.cone = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        meshlet.coneApex = glm::vec4(center, 0.0f);
+
+        float axisLength = glm::length(axis);
+        if (axisLength <= 0.0f)
+            return;
+
+        axis /= axisLength;
+
+        float minDot = 1.0f;
+        for (const auto &n : normals)
+        {
+            if (n != glm::vec3(0.0f))
+                minDot = std::min(minDot, glm::dot(n, axis));
+        }
+
+        // Cono demasiado abierto: nunca se podría descartar
+        if (minDot <= 0.1f)
+            return;
+
+        // Vértice del cono: detrás de todos los planos de los triángulos,
+        // así la dirección apex→cámara vale para cualquier punto del cluster
+        float maxT = 0.0f;
+        size_t tri = 0;
+        for (uint32_t i = begin; i + 2 < end; i += 3, ++tri)
+        {
+            const glm::vec3 &n = normals[tri];
+            if (n == glm::vec3(0.0f))
+                continue;
+
+            glm::vec3 p0 = Position(vertices[indices[i]]);
+            float dc = glm::dot(center - p0, n);
+            float dn = glm::dot(axis, n);
+            maxT = std::max(maxT, dc / dn);
+        }
+
+        meshlet.cone = glm::vec4(axis, std::sqrt(1.0f - minDot * minDot));
+        meshlet.coneApex = glm::vec4(center - axis * maxT, 0.0f);
+    }
+}
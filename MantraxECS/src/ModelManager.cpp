@@ -1,50 +1,195 @@
 #include "../include/ModelManager.h"
 #include "../include/TextureLoader.h"
+#include "../include/KTX2.h"
+#include "../include/ImportCache.h"
+#include <filesystem>
 #include <iostream>
+#include <chrono>
+
+namespace
+{
+    const char *const PBR_TEXTURE_NAMES[] = {"Albedo", "Normal", "Metallic", "Roughness", "AO"};
+    const Mantrax::TextureUsage PBR_TEXTURE_USAGES[] = {
+        Mantrax::TextureUsage::Color, Mantrax::TextureUsage::Normal,
+        Mantrax::TextureUsage::Mask, Mantrax::TextureUsage::Mask, Mantrax::TextureUsage::Mask};
+
+    template <typename Future>
+    bool IsFutureReady(const Future &future)
+    {
+        return !future.valid() || future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+}
 
 ModelManager::ModelManager(Mantrax::GFX *gfx)
-    : m_gfx(gfx)
+    : m_gfx(gfx), m_assets(Mantrax::AssetCache::Shared())
 {
 }
 
 ModelManager::~ModelManager()
 {
+    // Los trabajos encolados usan 'this': se terminan antes de destruir nada
+    m_pendingLoads.clear();
+    m_meshJobs.clear();
+    m_textureJobs.clear();
+    m_taskPool.reset();
     Clear();
+
+    // Hashes y recocinados de esta sesión: el próximo arranque no vuelve a leer las fuentes
+    Mantrax::ImportCache::Save();
 }
 
-RenderableObject *ModelManager::CreateModelFromFile(
-    const std::string &modelPath,
-    const std::string &name,
-    std::shared_ptr<Mantrax::Shader> shader)
+std::string ModelManager::GetMeshKey(const std::string &modelPath) const
 {
-    std::vector<Mantrax::Vertex> vertices;
-    std::vector<uint32_t> indices;
-
-    Mantrax::AssimpLoader::LoadSettings settings;
-    settings.triangulate = true;
-    settings.genNormals = true;
-    settings.flipUVs = true;
-    settings.calcTangents = true;
+    return Mantrax::AssetCache::MakeKey(modelPath, m_importSettings.GetHash());
+}
 
-    std::cout << "Loading model: " << modelPath << std::endl;
+std::shared_ptr<Mantrax::Mesh> ModelManager::LoadMesh(const std::string &modelPath)
+{
+    const std::string key = GetMeshKey(modelPath);
 
-    if (!m_modelLoader.LoadModel(modelPath, vertices, indices, settings, true))
+    // ✅ Ya subida para otro modelo: solo una instancia nueva (UBO propio, buffers compartidos)
+    auto geometry = m_assets->Meshes().Find(key);
+    if (geometry)
     {
-        std::cerr << "ERROR: " << m_modelLoader.GetLastError() << std::endl;
-        return nullptr;
+        std::cout << "  ♻️  Reusing cached mesh: " << modelPath << std::endl;
     }
+    else
+    {
+        std::shared_ptr<Mantrax::ImportedMesh> prepared;
+        try
+        {
+            prepared = Mantrax::MeshImporter::Import(modelPath, m_importSettings, m_useMeshCache);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "ERROR: " << e.what() << std::endl;
+            return nullptr;
+        }
 
-    auto mesh = m_gfx->CreateMesh(vertices, indices);
-    auto material = m_gfx->CreateMaterial(shader);
+        geometry = m_assets->Meshes().Add(key, m_gfx->CreateMesh(prepared->source));
+    }
 
+    return m_gfx->CreateMeshInstance(geometry);
+}
+
+RenderableObject *ModelManager::AddModel(
+    const std::string &name,
+    std::shared_ptr<Mantrax::Mesh> mesh,
+    std::shared_ptr<Mantrax::Shader> shader)
+{
     auto obj = std::make_unique<RenderableObject>();
     obj->modelMatrix = glm::mat4(1.0f);
-    obj->material = material;
-    obj->renderObj = Mantrax::RenderObject(mesh, material);
     obj->name = name;
 
+    // ✅ Varios materiales: un material por slot y un RenderObject por submesh
+    if (mesh->submeshes.size() > 1)
+    {
+        for (const auto &submesh : mesh->submeshes)
+        {
+            if (submesh.materialSlot >= obj->materials.size())
+                obj->materials.resize(submesh.materialSlot + 1);
+
+            auto &material = obj->materials[submesh.materialSlot];
+            if (!material && shader)
+                material = m_gfx->CreateMaterial(shader);
+        }
+
+        for (uint32_t i = 0; i < mesh->submeshes.size(); ++i)
+        {
+            obj->submeshObjects.emplace_back(m_gfx->CreateSubmeshMesh(mesh, i),
+                                             obj->materials[mesh->submeshes[i].materialSlot]);
+        }
+    }
+
+    if (shader)
+    {
+        obj->material = obj->materials.empty() ? m_gfx->CreateMaterial(shader)
+                                               : obj->materials[mesh->submeshes[0].materialSlot];
+        obj->renderObj = Mantrax::RenderObject(mesh, obj->material);
+    }
+    else
+    {
+        obj->material = nullptr;
+        obj->renderObj.mesh = mesh;
+        obj->renderObj.material = nullptr;
+    }
+
     auto ptr = obj.get();
     m_models.push_back(std::move(obj));
+    return ptr;
+}
+
+void ModelManager::ApplyPBRTextures(
+    RenderableObject *obj,
+    const std::shared_ptr<Mantrax::Texture> (&textures)[PBR_TEXTURE_COUNT])
+{
+    // Las texturas PBR del modelo van a todos sus slots (cada uno se puede cambiar después)
+    std::vector<std::shared_ptr<Mantrax::Material>> materials = obj->materials;
+    if (materials.empty())
+        materials.push_back(obj->material);
+
+    for (auto &material : materials)
+    {
+        if (!material)
+            continue;
+
+        material->SetBaseColor(1.0f, 1.0f, 1.0f);
+        material->SetMetallicFactor(1.0f);
+        material->SetRoughnessFactor(0.2f);
+        material->SetNormalScale(1.0f);
+
+        m_gfx->SetMaterialPBRTextures(
+            material,
+            textures[0],
+            textures[1],
+            textures[2],
+            textures[3],
+            textures[4]);
+    }
+}
+
+void ModelManager::SetSubmeshMaterial(RenderableObject *obj, uint32_t slot, std::shared_ptr<Mantrax::Material> material)
+{
+    if (!obj || !material)
+        return;
+
+    if (obj->submeshObjects.empty())
+    {
+        // Un solo material: el del objeto
+        obj->material = material;
+        obj->renderObj.material = material;
+        if (obj->renderObj.mesh && obj->renderObj.mesh->descriptorSet != VK_NULL_HANDLE)
+            m_gfx->UpdateMeshMaterialTextures(obj->renderObj.mesh, material);
+        return;
+    }
+
+    if (slot >= obj->materials.size())
+        obj->materials.resize(slot + 1);
+    obj->materials[slot] = material;
+
+    for (auto &submeshObj : obj->submeshObjects)
+    {
+        if (submeshObj.mesh->submeshes[0].materialSlot != slot)
+            continue;
+
+        submeshObj.material = material;
+        if (submeshObj.mesh->descriptorSet != VK_NULL_HANDLE)
+            m_gfx->UpdateMeshMaterialTextures(submeshObj.mesh, material);
+    }
+}
+
+RenderableObject *ModelManager::CreateModelFromFile(
+    const std::string &modelPath,
+    const std::string &name,
+    std::shared_ptr<Mantrax::Shader> shader)
+{
+    std::cout << "Loading model: " << modelPath << std::endl;
+
+    auto mesh = LoadMesh(modelPath);
+    if (!mesh)
+        return nullptr;
+
+    auto ptr = AddModel(name, mesh, shader);
 
     std::cout << "Model '" << name << "' loaded successfully!" << std::endl;
     return ptr;
@@ -66,29 +211,208 @@ RenderableObject *ModelManager::CreateModelWithPBR(
 
     std::cout << "\n=== Loading PBR Textures for '" << name << "' ===" << std::endl;
 
-    auto albedoTex = LoadTexture(albedoPath, "Albedo");
-    auto normalTex = LoadTexture(normalPath, "Normal");
-    auto metalTex = LoadTexture(metallicPath, "Metallic");
-    auto roughnessTex = LoadTexture(roughnessPath, "Roughness");
-    auto aoTex = LoadTexture(aoPath, "AO");
-
-    obj->material->SetBaseColor(1.0f, 1.0f, 1.0f);
-    obj->material->SetMetallicFactor(1.0f);
-    obj->material->SetRoughnessFactor(0.2f);
-    obj->material->SetNormalScale(1.0f);
-
-    m_gfx->SetMaterialPBRTextures(
-        obj->material,
-        albedoTex,
-        normalTex,
-        metalTex,
-        roughnessTex,
-        aoTex);
+    const std::string paths[PBR_TEXTURE_COUNT] = {albedoPath, normalPath, metallicPath, roughnessPath, aoPath};
+    std::shared_ptr<Mantrax::Texture> textures[PBR_TEXTURE_COUNT];
+    for (int i = 0; i < PBR_TEXTURE_COUNT; ++i)
+        textures[i] = LoadTexture(paths[i], PBR_TEXTURE_NAMES[i], PBR_TEXTURE_USAGES[i]);
+
+    ApplyPBRTextures(obj, textures);
 
     std::cout << "PBR textures loaded successfully!" << std::endl;
     return obj;
 }
 
+Mantrax::TaskPool &ModelManager::GetTaskPool()
+{
+    if (!m_taskPool)
+    {
+        m_taskPool = std::make_unique<Mantrax::TaskPool>();
+        std::cout << "Asset loading pool: " << m_taskPool->GetThreadCount() << " workers" << std::endl;
+    }
+    return *m_taskPool;
+}
+
+std::shared_ptr<ModelLoadHandle> ModelManager::CreateModelFromFileAsync(
+    const std::string &modelPath,
+    const std::string &name,
+    std::shared_ptr<Mantrax::Shader> shader,
+    std::function<void(RenderableObject *)> onLoaded)
+{
+    std::cout << "Loading model (async): " << modelPath << std::endl;
+
+    PendingLoad load;
+    load.handle = std::make_shared<ModelLoadHandle>();
+    load.handle->name = name;
+    load.handle->modelPath = modelPath;
+    load.shader = std::move(shader);
+    load.onLoaded = std::move(onLoaded);
+    load.meshKey = GetMeshKey(modelPath);
+    load.geometry = m_assets->Meshes().Find(load.meshKey);
+
+    // ✅ Sin trabajo si ya está subida; si otra carga la está importando, se comparte su resultado
+    if (!load.geometry)
+    {
+        auto job = m_meshJobs.find(load.meshKey);
+        if (job != m_meshJobs.end())
+        {
+            load.mesh = job->second;
+        }
+        else
+        {
+            // Ajustes por copia: el worker no lee los de ModelManager mientras se cambian
+            load.mesh = GetTaskPool().Submit([modelPath, settings = m_importSettings, useCache = m_useMeshCache]()
+                                             { return Mantrax::MeshImporter::Import(modelPath, settings, useCache); })
+                            .share();
+            m_meshJobs[load.meshKey] = load.mesh;
+        }
+    }
+
+    auto handle = load.handle;
+    m_pendingLoads.push_back(std::move(load));
+    return handle;
+}
+
+std::shared_ptr<ModelLoadHandle> ModelManager::CreateModelWithPBRAsync(
+    const std::string &modelPath,
+    const std::string &name,
+    const std::string &albedoPath,
+    const std::string &normalPath,
+    const std::string &metallicPath,
+    const std::string &roughnessPath,
+    const std::string &aoPath,
+    std::shared_ptr<Mantrax::Shader> shader,
+    std::function<void(RenderableObject *)> onLoaded)
+{
+    auto handle = CreateModelFromFileAsync(modelPath, name, shader, std::move(onLoaded));
+
+    // ✅ Cada textura en su propio trabajo: se decodifican en paralelo con la malla
+    PendingLoad &load = m_pendingLoads.back();
+    load.pbr = true;
+
+    const std::string paths[PBR_TEXTURE_COUNT] = {albedoPath, normalPath, metallicPath, roughnessPath, aoPath};
+    for (int i = 0; i < PBR_TEXTURE_COUNT; ++i)
+    {
+        // La misma fuente cocinada con otro uso (sRGB / normal / máscara) es otra textura
+        load.textureKeys[i] = Mantrax::AssetCache::MakeKey(
+            paths[i], Mantrax::TextureCompressor::GetSettingsHash(PBR_TEXTURE_USAGES[i]));
+        load.textureAssets[i] = m_assets->Textures().Find(load.textureKeys[i]);
+        if (load.textureAssets[i])
+            continue;
+
+        auto job = m_textureJobs.find(load.textureKeys[i]);
+        if (job != m_textureJobs.end())
+        {
+            load.textures[i] = job->second;
+            continue;
+        }
+
+        load.textures[i] = GetTaskPool().Submit([this, path = paths[i], i]()
+                                                { return PrepareTexture(path, PBR_TEXTURE_NAMES[i], PBR_TEXTURE_USAGES[i]); })
+                               .share();
+        m_textureJobs[load.textureKeys[i]] = load.textures[i];
+    }
+
+    return handle;
+}
+
+void ModelManager::Update()
+{
+    if (m_pendingLoads.empty())
+        return;
+
+    std::vector<PendingLoad> finished;
+    for (auto it = m_pendingLoads.begin(); it != m_pendingLoads.end();)
+    {
+        bool ready = IsFutureReady(it->mesh);
+        for (const auto &texture : it->textures)
+            ready = ready && IsFutureReady(texture);
+
+        if (ready)
+        {
+            finished.push_back(std::move(*it));
+            it = m_pendingLoads.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (finished.empty())
+        return;
+
+    // ✅ Todo lo que terminó en este frame va a la GPU con un único submit
+    m_gfx->BeginUploadBatch();
+    for (auto &load : finished)
+        FinishLoad(load);
+    m_gfx->EndUploadBatch();
+
+    // Los resultados ya están en el AssetCache (si alguien los usa): fuera de los trabajos en curso
+    for (auto it = m_meshJobs.begin(); it != m_meshJobs.end();)
+        it = IsFutureReady(it->second) ? m_meshJobs.erase(it) : std::next(it);
+    for (auto it = m_textureJobs.begin(); it != m_textureJobs.end();)
+        it = IsFutureReady(it->second) ? m_textureJobs.erase(it) : std::next(it);
+
+    // Sin más cargas en curso: los hashes de las fuentes de esta tanda al índice
+    if (m_pendingLoads.empty())
+        Mantrax::ImportCache::Save();
+
+    for (auto &load : finished)
+    {
+        if (load.handle->state == ModelLoadState::Ready && load.onLoaded)
+            load.onLoaded(load.handle->object);
+    }
+}
+
+void ModelManager::FinishLoad(PendingLoad &load)
+{
+    ModelLoadHandle &handle = *load.handle;
+
+    try
+    {
+        // Otra carga del mismo lote pudo subirla ya
+        auto geometry = load.geometry ? load.geometry : m_assets->Meshes().Find(load.meshKey);
+        if (!geometry)
+            geometry = m_assets->Meshes().Add(load.meshKey, m_gfx->CreateMesh(load.mesh.get()->source));
+
+        auto mesh = m_gfx->CreateMeshInstance(geometry);
+        RenderableObject *obj = AddModel(handle.name, mesh, load.shader);
+
+        if (load.pbr && obj->material)
+        {
+            std::shared_ptr<Mantrax::Texture> textures[PBR_TEXTURE_COUNT];
+            for (int i = 0; i < PBR_TEXTURE_COUNT; ++i)
+            {
+                textures[i] = load.textureAssets[i] ? load.textureAssets[i] : m_assets->Textures().Find(load.textureKeys[i]);
+                if (textures[i])
+                    continue;
+
+                // Una textura que falla no tira el modelo (igual que CreateModelWithPBR)
+                try
+                {
+                    textures[i] = m_assets->Textures().Add(load.textureKeys[i], CreateTexture(*load.textures[i].get()));
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "❌ Exception loading " << PBR_TEXTURE_NAMES[i] << ": " << e.what() << std::endl;
+                }
+            }
+
+            ApplyPBRTextures(obj, textures);
+        }
+
+        handle.object = obj;
+        handle.state = ModelLoadState::Ready;
+        std::cout << "Model '" << handle.name << "' loaded successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        handle.error = e.what();
+        handle.state = ModelLoadState::Failed;
+        std::cerr << "ERROR: " << handle.modelPath << ": " << e.what() << std::endl;
+    }
+}
+
 void ModelManager::DestroyModel(const std::string &name)
 {
     auto it = std::find_if(m_models.begin(), m_models.end(),
@@ -123,34 +447,13 @@ RenderableObject *ModelManager::CreateModelOnly(
     const std::string &modelPath,
     const std::string &name)
 {
-    std::vector<Mantrax::Vertex> vertices;
-    std::vector<uint32_t> indices;
-
-    Mantrax::AssimpLoader::LoadSettings settings;
-    settings.triangulate = true;
-    settings.genNormals = true;
-    settings.flipUVs = true;
-    settings.calcTangents = true;
-
     std::cout << "Loading model (geometry only): " << modelPath << std::endl;
 
-    if (!m_modelLoader.LoadModel(modelPath, vertices, indices, settings, true))
-    {
-        std::cerr << "ERROR: " << m_modelLoader.GetLastError() << std::endl;
+    auto mesh = LoadMesh(modelPath);
+    if (!mesh)
         return nullptr;
-    }
-
-    auto mesh = m_gfx->CreateMesh(vertices, indices);
-
-    auto obj = std::make_unique<RenderableObject>();
-    obj->modelMatrix = glm::mat4(1.0f);
-    obj->material = nullptr;
-    obj->renderObj.mesh = mesh;
-    obj->renderObj.material = nullptr;
-    obj->name = name;
 
-    auto ptr = obj.get();
-    m_models.push_back(std::move(obj));
+    auto ptr = AddModel(name, mesh, nullptr);
 
     std::cout << "Model geometry '" << name << "' loaded (no material)!" << std::endl;
     return ptr;
@@ -180,45 +483,111 @@ std::vector<RenderableObject *> ModelManager::GetAllModels()
 void ModelManager::Clear()
 {
     std::cout << "Clearing all models..." << std::endl;
+    m_pendingLoads.clear(); // Lo que terminen los workers se descarta
+    m_meshJobs.clear();
+    m_textureJobs.clear();
     m_models.clear();
 }
 
-// ✅ NUEVA IMPLEMENTACIÓN: Usa WIC a través de TextureLoader
-std::shared_ptr<Mantrax::Texture> ModelManager::LoadTexture(
+// ✅ KTX2 cocinado, o TextureLoader (stb_image; WIC de respaldo en Windows)
+std::shared_ptr<ModelManager::PreparedTexture> ModelManager::PrepareTexture(
     const std::string &path,
-    const std::string &name)
+    const std::string &name,
+    Mantrax::TextureUsage usage) const
 {
-    try
-    {
+    // Se llama desde los workers a la vez: por textura solo con TextureLoader::SetVerbose
+    if (Mantrax::TextureLoader::IsVerbose())
         std::cout << "Loading " << name << " texture: " << path << std::endl;
 
-        // ✅ Usar tu TextureLoader con WIC (SIN flip porque Assimp ya lo hace)
-        auto textureData = Mantrax::TextureLoader::LoadFromFile(path, false);
+    auto prepared = std::make_shared<PreparedTexture>();
+    prepared->path = path;
+    prepared->usage = usage;
 
-        if (!textureData || !textureData->pixels)
-        {
-            std::cerr << "❌ Failed to load " << name << " texture: " << path << std::endl;
-            return nullptr;
-        }
+    // ✅ Versión cocinada (KTX2 con BC + mips) si existe y la GPU la soporta
+    prepared->image = Mantrax::KTX2::LoadCookedImage(m_gfx, path, usage);
+    if (prepared->image)
+    {
+        prepared->cooked = true;
+        return prepared;
+    }
+
+    // ⚠️ .ktx2 en disco pero de otra versión de la fuente o de otros ajustes (versión del cook,
+    // uso): se recocina en segundo plano (CreateTexture)
+    std::error_code ec;
+    prepared->recook = m_recookStaleTextures &&
+                       std::filesystem::exists(Mantrax::KTX2::GetCookedPath(path), ec) &&
+                       Mantrax::KTX2::IsStale(path, Mantrax::TextureCompressor::GetSettingsHash(usage));
+
+    // ✅ TextureLoader (stb_image, WIC de respaldo) SIN flip porque Assimp ya lo hace
+    auto textureData = Mantrax::TextureLoader::LoadFromFile(path, false);
 
-        // ✅ Información de debug
+    if (!textureData || !textureData->pixels)
+        throw std::runtime_error("Failed to load " + name + " texture: " + path);
+
+    // ✅ Información de debug
+    if (Mantrax::TextureLoader::IsVerbose())
+    {
         std::cout << "✓ Loaded " << name << std::endl;
         std::cout << "  Size: " << textureData->width << "x" << textureData->height << std::endl;
         std::cout << "  Channels: " << textureData->channels << " (RGBA)" << std::endl;
         std::cout << "  Has alpha: " << (textureData->hasAlpha ? "YES" : "NO") << std::endl;
+    }
+
+    // RGBA8 sin mips, como GFX::CreateTexture(pixels, width, height)
+    prepared->image = std::make_shared<Mantrax::TextureImageData>();
+    Mantrax::TextureImageData &image = *prepared->image;
+    image.format = VK_FORMAT_R8G8B8A8_UNORM;
+    image.width = static_cast<uint32_t>(textureData->width);
+    image.height = static_cast<uint32_t>(textureData->height);
+    image.bytes.assign(textureData->pixels, textureData->pixels + static_cast<size_t>(image.width) * image.height * 4);
+    image.mips.push_back({image.width, image.height, 0, image.bytes.size()});
+
+    // textureData se destruye automáticamente (unique_ptr)
+    return prepared;
+}
+
+std::shared_ptr<Mantrax::Texture> ModelManager::CreateTexture(const PreparedTexture &prepared)
+{
+    if (prepared.recook)
+        QueueRecook(prepared);
+
+    // Con mips: solo la cola a la GPU, el resto según el tamaño en pantalla
+    if (prepared.cooked)
+        return m_gfx->CreateStreamedTexture(prepared.image);
+
+    return m_gfx->CreateTexture(*prepared.image);
+}
 
-        // ✅ Crear textura en el GFX
-        auto texture = m_gfx->CreateTexture(
-            textureData->pixels,
-            textureData->width,
-            textureData->height);
+void ModelManager::QueueRecook(const PreparedTexture &prepared)
+{
+    // Una vez por fuente y sesión; el trabajo no toca 'this' y se termina con el pool
+    if (!m_recooking.insert(prepared.path).second)
+        return;
 
-        // textureData se destruye automáticamente (unique_ptr)
-        return texture;
+    std::cout << "🍳 Recooking changed texture in background: " << prepared.path << std::endl;
+    GetTaskPool().Submit([path = prepared.path, usage = prepared.usage]()
+                         { return Mantrax::TextureCompressor::CookFile(path, Mantrax::KTX2::GetCookedPath(path), usage); });
+}
+
+std::shared_ptr<Mantrax::Texture> ModelManager::LoadTexture(
+    const std::string &path,
+    const std::string &name,
+    Mantrax::TextureUsage usage)
+{
+    const std::string key = Mantrax::AssetCache::MakeKey(path, Mantrax::TextureCompressor::GetSettingsHash(usage));
+    if (auto cached = m_assets->Textures().Find(key))
+    {
+        std::cout << "  ♻️  Reusing cached " << name << " texture: " << path << std::endl;
+        return cached;
+    }
+
+    try
+    {
+        return m_assets->Textures().Add(key, CreateTexture(*PrepareTexture(path, name, usage)));
     }
     catch (const std::exception &e)
     {
         std::cerr << "❌ Exception loading " << name << ": " << e.what() << std::endl;
         return nullptr;
     }
-}
\ No newline at end of file
+}
@@ -1,5 +1,7 @@
 #include "../include/SceneRenderer.h"
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 SceneRenderer::SceneRenderer(Mantrax::GFX *gfx)
@@ -17,7 +19,22 @@ void SceneRenderer::AddObject(RenderableObject *obj)
     if (obj)
     {
         m_sceneObjects.push_back(obj);
-        m_gfx->AddRenderObject(obj->renderObj);
+
+        if (obj->submeshObjects.empty())
+        {
+            m_gfx->AddRenderObject(obj->renderObj);
+        }
+        else
+        {
+            // Slots sin material propio (ej. CreateModelOnly) usan el del objeto
+            for (auto &submeshObj : obj->submeshObjects)
+            {
+                if (!submeshObj.material)
+                    submeshObj.material = obj->renderObj.material;
+                m_gfx->AddRenderObject(submeshObj);
+            }
+        }
+
         std::cout << "Added object to scene: " << obj->name << std::endl;
     }
 }
@@ -51,6 +68,9 @@ void SceneRenderer::UpdateUBOs(Mantrax::FPSCamera *camera)
     glm::mat4 view = camera->GetViewMatrix();
     glm::mat4 proj = camera->GetProjectionMatrix();
 
+    // Cámara para frustum / HiZ culling del offscreen
+    m_gfx->SetCullingCamera(view, proj);
+
     for (auto *obj : m_sceneObjects)
     {
         CopyMat4(obj->ubo.model, obj->modelMatrix);
@@ -69,16 +89,114 @@ void SceneRenderer::UpdateUBOs(Mantrax::FPSCamera *camera)
 void SceneRenderer::RenderScene(
     std::shared_ptr<Mantrax::OffscreenFramebuffer> framebuffer)
 {
+    if (framebuffer)
+        SelectLODs(framebuffer->renderExtent.height);
+
     auto renderObjects = GetRenderObjects();
     m_gfx->RenderToOffscreenFramebuffer(framebuffer, renderObjects);
 }
 
+void SceneRenderer::SelectLODs(uint32_t viewportHeight)
+{
+    if (!camera || viewportHeight == 0)
+        return;
+
+    const glm::vec3 camPos = camera->GetPosition();
+
+    // Píxeles por unidad de mundo (a distancia 1 en perspectiva)
+    float pixelsPerUnit;
+    if (camera->IsPerspective())
+        pixelsPerUnit = viewportHeight / (2.0f * std::tan(glm::radians(camera->GetFOV()) * 0.5f));
+    else
+        pixelsPerUnit = viewportHeight / (2.0f * camera->GetOrthoSize());
+
+    for (auto *obj : m_sceneObjects)
+    {
+        // Cada submesh con sus propios LODs y bounds
+        if (obj->submeshObjects.empty())
+        {
+            if (obj->renderObj.mesh)
+                SelectMeshLOD(*obj->renderObj.mesh, obj->modelMatrix, pixelsPerUnit, camPos);
+            continue;
+        }
+
+        for (auto &submeshObj : obj->submeshObjects)
+            SelectMeshLOD(*submeshObj.mesh, obj->modelMatrix, pixelsPerUnit, camPos);
+    }
+}
+
+void SceneRenderer::SelectMeshLOD(
+    Mantrax::Mesh &mesh,
+    const glm::mat4 &model,
+    float pixelsPerUnit,
+    const glm::vec3 &camPos)
+{
+    if (mesh.GetLODCount() <= 1)
+        return;
+
+    if (!m_lodSettings.enabled)
+    {
+        mesh.activeLOD = 0;
+        return;
+    }
+
+    const float threshold = m_lodSettings.pixelErrorThreshold;
+
+    // Escala máxima del modelo: el error del LOD está en espacio objeto
+    float scale = std::max({glm::length(glm::vec3(model[0])),
+                            glm::length(glm::vec3(model[1])),
+                            glm::length(glm::vec3(model[2]))});
+
+    float errorToPixels = scale * pixelsPerUnit;
+    if (camera->IsPerspective())
+    {
+        // Distancia a la superficie de la esfera envolvente
+        glm::vec3 localCenter = (mesh.boundsMin + mesh.boundsMax) * 0.5f;
+        float radius = glm::length(mesh.boundsMax - mesh.boundsMin) * 0.5f * scale;
+        glm::vec3 center = glm::vec3(model * glm::vec4(localCenter, 1.0f));
+        float distance = glm::length(center - camPos) - radius;
+
+        if (distance <= 1e-3f)
+        {
+            mesh.activeLOD = 0;
+            return;
+        }
+
+        errorToPixels /= distance;
+    }
+
+    // LOD más grueso cuyo error proyectado cabe en el umbral
+    uint32_t target = 0;
+    for (uint32_t i = mesh.GetLODCount(); i-- > 1;)
+    {
+        if (mesh.lods[i].error * errorToPixels <= threshold)
+        {
+            target = i;
+            break;
+        }
+    }
+
+    // Histéresis: bajar calidad solo con margen, subirla en cuanto se supera el umbral
+    uint32_t current = std::min(mesh.activeLOD, mesh.GetLODCount() - 1);
+    if (target > current)
+    {
+        float coarserLimit = threshold * (1.0f - m_lodSettings.hysteresis);
+        while (target > current && mesh.lods[target].error * errorToPixels > coarserLimit)
+            --target;
+    }
+
+    mesh.activeLOD = target;
+}
+
 std::vector<Mantrax::RenderObject> SceneRenderer::GetRenderObjects()
 {
     std::vector<Mantrax::RenderObject> renderObjects;
     for (auto *obj : m_sceneObjects)
     {
-        renderObjects.push_back(obj->renderObj);
+        if (obj->submeshObjects.empty())
+            renderObjects.push_back(obj->renderObj);
+        else
+            renderObjects.insert(renderObjects.end(), obj->submeshObjects.begin(), obj->submeshObjects.end());
     }
     return renderObjects;
 }
@@ -1,42 +1,138 @@
 #include "../include/SkyBox.h"
 
 #include <glm/gtc/constants.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <iostream>
-#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cmath>
 
 namespace Mantrax
 {
-    SkyBox::SkyBox(GFX *gfx, float radius, int segments, int rings)
-        : m_gfx(gfx), m_radius(radius), m_segments(segments), m_rings(rings)
+    namespace
+    {
+        constexpr uint32_t CUBEMAP_CACHE_MAGIC = 0x4243584D; // "MXCB"
+        constexpr uint32_t CUBEMAP_CACHE_VERSION = 1;
+
+        struct CubemapCacheHeader
+        {
+            uint32_t magic = CUBEMAP_CACHE_MAGIC;
+            uint32_t version = CUBEMAP_CACHE_VERSION;
+            uint32_t faceSize = 0;
+            uint32_t mipLevels = 0;
+            uint64_t sourceSize = 0;
+            int64_t sourceTime = 0;
+            uint32_t flipped = 0;
+            uint32_t reserved = 0;
+        };
+
+        // Dirección de la cara para (sc, tc) en [-1, 1]: convención de cubemaps de Vulkan
+        glm::vec3 FaceDirection(int face, float sc, float tc)
+        {
+            switch (face)
+            {
+            case 0: return glm::vec3(1.0f, -tc, -sc);  // +X
+            case 1: return glm::vec3(-1.0f, -tc, sc);  // -X
+            case 2: return glm::vec3(sc, 1.0f, tc);    // +Y
+            case 3: return glm::vec3(sc, -1.0f, -tc);  // -Y
+            case 4: return glm::vec3(sc, -tc, 1.0f);   // +Z
+            default: return glm::vec3(-sc, -tc, -1.0f); // -Z
+            }
+        }
+
+        // Bilineal sobre la equirectangular (u se repite, v se limita)
+        void SampleEquirectangular(const TextureData &source, float u, float v, unsigned char *out)
+        {
+            float x = u * source.width - 0.5f;
+            float y = v * source.height - 0.5f;
+
+            int x0 = static_cast<int>(std::floor(x));
+            int y0 = static_cast<int>(std::floor(y));
+            float fx = x - x0;
+            float fy = y - y0;
+
+            auto texel = [&](int tx, int ty) -> const unsigned char *
+            {
+                tx = ((tx % source.width) + source.width) % source.width;
+                ty = std::clamp(ty, 0, source.height - 1);
+                return source.pixels + (static_cast<size_t>(ty) * source.width + tx) * 4;
+            };
+
+            const unsigned char *a = texel(x0, y0);
+            const unsigned char *b = texel(x0 + 1, y0);
+            const unsigned char *c = texel(x0, y0 + 1);
+            const unsigned char *d = texel(x0 + 1, y0 + 1);
+
+            for (int i = 0; i < 4; ++i)
+            {
+                float top = a[i] + (b[i] - a[i]) * fx;
+                float bottom = c[i] + (d[i] - c[i]) * fx;
+                out[i] = static_cast<unsigned char>(std::clamp(top + (bottom - top) * fy + 0.5f, 0.0f, 255.0f));
+            }
+        }
+
+        size_t MipFaceBytes(uint32_t faceSize, uint32_t mip)
+        {
+            size_t size = std::max(1u, faceSize >> mip);
+            return size * size * 4;
+        }
+    }
+
+    SkyBox::SkyBox(GFX *gfx, uint32_t faceSize)
+        : m_gfx(gfx), m_faceSize(std::max(1u, faceSize))
     {
-        GenerateSphereMesh();
     }
 
     SkyBox::~SkyBox() {}
 
-    bool SkyBox::LoadTexture(const std::string &texturePath, bool flipVertically)
+    std::string SkyBox::GetCachePath(const std::string &texturePath)
+    {
+        return texturePath + ".cubemap";
+    }
+
+    bool SkyBox::LoadEquirectangular(const std::string &texturePath, bool flipVertically)
     {
         try
         {
-            auto textureData = TextureLoader::LoadFromFile(texturePath, flipVertically);
-
-            if (!textureData || !textureData->pixels)
+            std::error_code ec;
+            uint64_t sourceSize = std::filesystem::file_size(texturePath, ec);
+            if (ec)
             {
                 std::cerr << "Failed to load skybox texture: " << texturePath << std::endl;
                 return false;
             }
+            int64_t sourceTime = static_cast<int64_t>(
+                std::filesystem::last_write_time(texturePath, ec).time_since_epoch().count());
 
-            m_texture = m_gfx->CreateTexture(
-                textureData->pixels,
-                textureData->width,
-                textureData->height);
+            const std::string cachePath = GetCachePath(texturePath);
 
-            std::cout << "✓ Loaded Skybox Texture: " << texturePath
-                      << " (" << textureData->width << "x" << textureData->height
-                      << ", " << textureData->channels << " channels)\n";
+            if (LoadCache(cachePath, sourceSize, sourceTime, flipVertically))
+            {
+                std::cout << "✓ Skybox cubemap from cache: " << cachePath << "\n";
+            }
+            else
+            {
+                auto textureData = TextureLoader::LoadFromFile(texturePath, flipVertically);
+
+                if (!textureData || !textureData->pixels)
+                {
+                    std::cerr << "Failed to load skybox texture: " << texturePath << std::endl;
+                    return false;
+                }
+
+                ConvertEquirectangular(*textureData);
+                SaveCache(cachePath, sourceSize, sourceTime, flipVertically);
+
+                std::cout << "✓ Skybox cubemap converted: " << texturePath
+                          << " (" << textureData->width << "x" << textureData->height << " → 6x"
+                          << m_faceSize << ", " << m_mipLevels << " mips) → " << cachePath << "\n";
+            }
 
+            m_cubemap = m_gfx->CreateCubemap(m_pixels.data(), m_faceSize, m_mipLevels);
+
+            // Ya está en la GPU: la copia en CPU solo servía para subirla
+            m_pixels.clear();
+            m_pixels.shrink_to_fit();
             return true;
         }
         catch (const std::exception &e)
@@ -46,117 +142,147 @@ namespace Mantrax
         }
     }
 
-    void SkyBox::CreateMaterial(std::shared_ptr<Shader> shader)
+    void SkyBox::Apply()
     {
-        m_material = m_gfx->CreateMaterial(shader);
-
-        m_material->SetBaseColor(1.0f, 1.0f, 1.0f);
-        m_material->SetMetallicFactor(0.0f);
-        m_material->SetRoughnessFactor(1.0f);
-
-        if (m_texture)
-        {
-            m_gfx->SetMaterialPBRTextures(
-                m_material,
-                m_texture,
-                nullptr,
-                nullptr,
-                nullptr,
-                nullptr);
-        }
+        m_gfx->SetSkyTint(m_tint);
+        m_gfx->SetSkyCubemap(m_cubemap);
     }
 
-    RenderObject SkyBox::GetRenderObject()
-    {
-        return RenderObject(m_mesh, m_material);
-    }
+    std::shared_ptr<Texture> SkyBox::GetCubemap() const { return m_cubemap; }
+    uint32_t SkyBox::GetFaceSize() const { return m_faceSize; }
+    uint32_t SkyBox::GetMipLevels() const { return m_mipLevels; }
 
-    std::shared_ptr<Material> SkyBox::GetMaterial() const
+    void SkyBox::ConvertEquirectangular(const TextureData &source)
     {
-        return m_material;
-    }
+        m_mipLevels = static_cast<uint32_t>(std::floor(std::log2(static_cast<float>(m_faceSize)))) + 1;
 
-    std::shared_ptr<Mesh> SkyBox::GetMesh() const
-    {
-        return m_mesh;
-    }
+        size_t totalBytes = 0;
+        for (uint32_t mip = 0; mip < m_mipLevels; ++mip)
+            totalBytes += MipFaceBytes(m_faceSize, mip) * 6;
+        m_pixels.assign(totalBytes, 0);
 
-    void SkyBox::UpdateTransform(const glm::vec3 &position, UniformBufferObject &ubo)
-    {
-        glm::mat4 model = glm::translate(glm::mat4(1.0f),
-                                         glm::vec3(0.0f, 0.0f, 0.0f));
-        CopyMat4(ubo.model, model);
-    }
+        // Mip 0: cada texel de cada cara toma la dirección de su centro
+        // (misma proyección que el antiguo skybox.frag: u = atan(z, x), v = asin(y))
+        for (int face = 0; face < 6; ++face)
+        {
+            unsigned char *dst = m_pixels.data() + face * MipFaceBytes(m_faceSize, 0);
 
-    float SkyBox::GetRadius() const { return m_radius; }
-    int SkyBox::GetSegments() const { return m_segments; }
-    int SkyBox::GetRings() const { return m_rings; }
+            for (uint32_t y = 0; y < m_faceSize; ++y)
+            {
+                float tc = 2.0f * (y + 0.5f) / m_faceSize - 1.0f;
+                for (uint32_t x = 0; x < m_faceSize; ++x)
+                {
+                    float sc = 2.0f * (x + 0.5f) / m_faceSize - 1.0f;
+                    glm::vec3 dir = glm::normalize(FaceDirection(face, sc, tc));
 
-    void SkyBox::GenerateSphereMesh()
-    {
-        m_vertices.clear();
-        m_indices.clear();
+                    float u = std::atan2(dir.z, dir.x) / glm::two_pi<float>() + 0.5f;
+                    float v = std::asin(std::clamp(dir.y, -1.0f, 1.0f)) / glm::pi<float>() + 0.5f;
+
+                    SampleEquirectangular(source, u, v, dst + (static_cast<size_t>(y) * m_faceSize + x) * 4);
+                }
+            }
+        }
+
+        // Resto de mips: promedio 2x2 del nivel anterior, cara por cara
+        size_t srcOffset = 0;
+        size_t dstOffset = MipFaceBytes(m_faceSize, 0) * 6;
 
-        for (int ring = 0; ring <= m_rings; ++ring)
+        for (uint32_t mip = 1; mip < m_mipLevels; ++mip)
         {
-            float phi = glm::pi<float>() * float(ring) / float(m_rings);
-            float sinPhi = sin(phi);
-            float cosPhi = cos(phi);
+            uint32_t srcSize = std::max(1u, m_faceSize >> (mip - 1));
+            uint32_t dstSize = std::max(1u, m_faceSize >> mip);
 
-            for (int seg = 0; seg <= m_segments; ++seg)
+            for (int face = 0; face < 6; ++face)
             {
-                float theta = 2.0f * glm::pi<float>() * float(seg) / float(m_segments);
-                float sinTheta = sin(theta);
-                float cosTheta = cos(theta);
+                const unsigned char *src = m_pixels.data() + srcOffset + face * MipFaceBytes(m_faceSize, mip - 1);
+                unsigned char *dst = m_pixels.data() + dstOffset + face * MipFaceBytes(m_faceSize, mip);
 
-                Vertex vertex;
+                for (uint32_t y = 0; y < dstSize; ++y)
+                {
+                    for (uint32_t x = 0; x < dstSize; ++x)
+                    {
+                        uint32_t sx0 = std::min(x * 2, srcSize - 1), sx1 = std::min(x * 2 + 1, srcSize - 1);
+                        uint32_t sy0 = std::min(y * 2, srcSize - 1), sy1 = std::min(y * 2 + 1, srcSize - 1);
+
+                        for (int i = 0; i < 4; ++i)
+                        {
+                            uint32_t sum = src[(sy0 * srcSize + sx0) * 4 + i] + src[(sy0 * srcSize + sx1) * 4 + i] +
+                                           src[(sy1 * srcSize + sx0) * 4 + i] + src[(sy1 * srcSize + sx1) * 4 + i];
+                            dst[(y * dstSize + x) * 4 + i] = static_cast<unsigned char>((sum + 2) / 4);
+                        }
+                    }
+                }
+            }
+
+            srcOffset = dstOffset;
+            dstOffset += MipFaceBytes(m_faceSize, mip) * 6;
+        }
+    }
 
-                float x = sinPhi * cosTheta;
-                float y = cosPhi;
-                float z = sinPhi * sinTheta;
+    bool SkyBox::LoadCache(const std::string &cachePath, uint64_t sourceSize, int64_t sourceTime, bool flipped)
+    {
+        std::ifstream file(cachePath, std::ios::binary);
+        if (!file)
+            return false;
 
-                vertex.position[0] = m_radius * x;
-                vertex.position[1] = m_radius * y;
-                vertex.position[2] = m_radius * z;
+        CubemapCacheHeader header;
+        if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+            return false;
 
-                vertex.normal[0] = -x;
-                vertex.normal[1] = -y;
-                vertex.normal[2] = -z;
+        // Fuente modificada, otro tamaño de cara o formato viejo: regenerar
+        if (header.magic != CUBEMAP_CACHE_MAGIC || header.version != CUBEMAP_CACHE_VERSION ||
+            header.faceSize != m_faceSize || header.sourceSize != sourceSize ||
+            header.sourceTime != sourceTime || header.flipped != (flipped ? 1u : 0u) ||
+            header.mipLevels == 0 || header.mipLevels > 32)
+            return false;
 
-                vertex.texCoord[0] = float(seg) / float(m_segments);
-                vertex.texCoord[1] = 1.0f - (float(ring) / float(m_rings));
+        size_t totalBytes = 0;
+        for (uint32_t mip = 0; mip < header.mipLevels; ++mip)
+            totalBytes += MipFaceBytes(header.faceSize, mip) * 6;
 
-                m_vertices.push_back(vertex);
-            }
+        std::vector<unsigned char> pixels(totalBytes);
+        if (!file.read(reinterpret_cast<char *>(pixels.data()), static_cast<std::streamsize>(totalBytes)))
+        {
+            std::cerr << "⚠️ Skybox cache truncated, regenerating: " << cachePath << std::endl;
+            return false;
         }
 
-        for (int ring = 0; ring < m_rings; ++ring)
+        m_mipLevels = header.mipLevels;
+        m_pixels = std::move(pixels);
+        return true;
+    }
+
+    void SkyBox::SaveCache(const std::string &cachePath, uint64_t sourceSize, int64_t sourceTime, bool flipped) const
+    {
+        CubemapCacheHeader header;
+        header.faceSize = m_faceSize;
+        header.mipLevels = m_mipLevels;
+        header.sourceSize = sourceSize;
+        header.sourceTime = sourceTime;
+        header.flipped = flipped ? 1u : 0u;
+
+        // Se escribe a un temporal y se renombra: una caché a medias nunca queda con el nombre final
+        const std::string tempPath = cachePath + ".tmp";
         {
-            for (int seg = 0; seg < m_segments; ++seg)
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file)
             {
-                int current = ring * (m_segments + 1) + seg;
-                int next = current + m_segments + 1;
-
-                m_indices.push_back(current);
-                m_indices.push_back(current + 1);
-                m_indices.push_back(next);
+                std::cerr << "⚠️ Could not write skybox cache: " << cachePath << std::endl;
+                return;
+            }
 
-                m_indices.push_back(current + 1);
-                m_indices.push_back(next + 1);
-                m_indices.push_back(next);
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char *>(m_pixels.data()), static_cast<std::streamsize>(m_pixels.size()));
+            if (!file)
+            {
+                std::cerr << "⚠️ Could not write skybox cache: " << cachePath << std::endl;
+                return;
             }
         }
 
-        m_mesh = m_gfx->CreateMesh(m_vertices, m_indices);
-
-        std::cout << "✓ Skybox Sphere Generated (INVERTED FACES): "
-                  << m_vertices.size() << " vertices, "
-                  << m_indices.size() << " indices, "
-                  << "radius: " << m_radius << "\n";
-    }
-
-    void SkyBox::CopyMat4(float *dest, const glm::mat4 &src)
-    {
-        memcpy(dest, glm::value_ptr(src), 16 * sizeof(float));
+        std::error_code ec;
+        std::filesystem::rename(tempPath, cachePath, ec);
+        if (ec)
+            std::cerr << "⚠️ Could not write skybox cache: " << cachePath << " (" << ec.message() << ")" << std::endl;
     }
 }
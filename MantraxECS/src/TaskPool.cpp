@@ -0,0 +1,66 @@
+#include "../include/TaskPool.h"
+
+namespace Mantrax
+{
+    TaskPool::TaskPool(uint32_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            uint32_t cores = std::thread::hardware_concurrency();
+            threadCount = cores > 1 ? cores - 1 : 1;
+        }
+
+        m_Workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i)
+            m_Workers.emplace_back([this]()
+                                   { WorkerLoop(); });
+    }
+
+    TaskPool::~TaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_Condition.notify_all();
+
+        for (auto &worker : m_Workers)
+            worker.join();
+    }
+
+    size_t TaskPool::GetQueuedCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Queue.size();
+    }
+
+    void TaskPool::Enqueue(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Queue.push_back(std::move(job));
+        }
+        m_Condition.notify_one();
+    }
+
+    void TaskPool::WorkerLoop()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this]()
+                                 { return m_Stopping || !m_Queue.empty(); });
+
+                if (m_Queue.empty())
+                    return;
+
+                job = std::move(m_Queue.front());
+                m_Queue.pop_front();
+            }
+
+            job();
+        }
+    }
+}
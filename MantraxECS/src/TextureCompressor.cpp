@@ -0,0 +1,511 @@
+#include "../include/TextureCompressor.h"
+#include "../include/KTX2.h"
+#include "../include/TextureLoader.h"
+#include "../include/ImportCache.h"
+
+#include <glm/glm.hpp>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace Mantrax
+{
+    namespace
+    {
+        // Subirlo cuando cambie lo que sale del compresor (encoders, filtro de mips): recocina todo
+        const uint32_t TEXTURE_COOK_VERSION = 1;
+
+        // ====================================================================
+        // MIPS
+        // ====================================================================
+
+        // Promedio 2x2 (los bordes impares repiten la última fila/columna)
+        std::vector<uint8_t> Downsample(const std::vector<uint8_t> &src, uint32_t srcW, uint32_t srcH,
+                                        uint32_t dstW, uint32_t dstH, bool normalMap)
+        {
+            std::vector<uint8_t> dst(static_cast<size_t>(dstW) * dstH * 4);
+
+            for (uint32_t y = 0; y < dstH; ++y)
+            {
+                uint32_t sy0 = std::min(y * 2, srcH - 1), sy1 = std::min(y * 2 + 1, srcH - 1);
+                for (uint32_t x = 0; x < dstW; ++x)
+                {
+                    uint32_t sx0 = std::min(x * 2, srcW - 1), sx1 = std::min(x * 2 + 1, srcW - 1);
+                    uint8_t *out = &dst[(static_cast<size_t>(y) * dstW + x) * 4];
+
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        uint32_t sum = src[(sy0 * srcW + sx0) * 4 + i] + src[(sy0 * srcW + sx1) * 4 + i] +
+                                       src[(sy1 * srcW + sx0) * 4 + i] + src[(sy1 * srcW + sx1) * 4 + i];
+                        out[i] = static_cast<uint8_t>((sum + 2) / 4);
+                    }
+
+                    // El promedio de normales acorta el vector: renormalizar
+                    if (normalMap)
+                    {
+                        glm::vec3 n(out[0] / 127.5f - 1.0f, out[1] / 127.5f - 1.0f, out[2] / 127.5f - 1.0f);
+                        float len = glm::length(n);
+                        n = len > 1e-4f ? n / len : glm::vec3(0.0f, 0.0f, 1.0f);
+                        for (int i = 0; i < 3; ++i)
+                            out[i] = static_cast<uint8_t>(std::clamp((n[i] + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f));
+                    }
+                }
+            }
+
+            return dst;
+        }
+
+        // Bloque 4x4 RGBA; fuera de la imagen (mips < 4x4) se repite el borde
+        void FetchBlock(const uint8_t *pixels, uint32_t width, uint32_t height,
+                        uint32_t bx, uint32_t by, uint8_t block[16][4])
+        {
+            for (uint32_t y = 0; y < 4; ++y)
+            {
+                uint32_t py = std::min(by * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; ++x)
+                {
+                    uint32_t px = std::min(bx * 4 + x, width - 1);
+                    std::memcpy(block[y * 4 + x], pixels + (static_cast<size_t>(py) * width + px) * 4, 4);
+                }
+            }
+        }
+
+        // ====================================================================
+        // BC1 / BC4 (y sus combinaciones BC3 / BC5)
+        // ====================================================================
+
+        uint16_t PackRGB565(const glm::vec3 &c)
+        {
+            int r = std::clamp(static_cast<int>(c.r * 31.0f / 255.0f + 0.5f), 0, 31);
+            int g = std::clamp(static_cast<int>(c.g * 63.0f / 255.0f + 0.5f), 0, 63);
+            int b = std::clamp(static_cast<int>(c.b * 31.0f / 255.0f + 0.5f), 0, 31);
+            return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        glm::vec3 UnpackRGB565(uint16_t c)
+        {
+            int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+            return glm::vec3((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+        }
+
+        // Eje principal de los colores del bloque (iteración de potencia sobre la covarianza)
+        template <int N>
+        glm::vec<N, float> PrincipalAxis(const uint8_t block[16][4], glm::vec<N, float> &mean)
+        {
+            using Vec = glm::vec<N, float>;
+
+            mean = Vec(0.0f);
+            Vec minC(255.0f), maxC(0.0f);
+            for (int i = 0; i < 16; ++i)
+            {
+                Vec c;
+                for (int k = 0; k < N; ++k)
+                    c[k] = block[i][k];
+                mean += c;
+                minC = glm::min(minC, c);
+                maxC = glm::max(maxC, c);
+            }
+            mean /= 16.0f;
+
+            float cov[N][N] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                Vec d;
+                for (int k = 0; k < N; ++k)
+                    d[k] = block[i][k] - mean[k];
+                for (int r = 0; r < N; ++r)
+                    for (int c = 0; c < N; ++c)
+                        cov[r][c] += d[r] * d[c];
+            }
+
+            Vec axis = maxC - minC;
+            if (glm::dot(axis, axis) < 1e-6f)
+                return Vec(0.0f);
+
+            for (int iter = 0; iter < 8; ++iter)
+            {
+                Vec next(0.0f);
+                for (int r = 0; r < N; ++r)
+                    for (int c = 0; c < N; ++c)
+                        next[r] += cov[r][c] * axis[c];
+
+                float len = glm::length(next);
+                if (len < 1e-6f)
+                    break;
+                axis = next / len;
+            }
+
+            return glm::normalize(axis);
+        }
+
+        // Bloque de color BC1 (8 bytes), siempre en modo de 4 colores (c0 > c1)
+        void EncodeBC1(const uint8_t block[16][4], uint8_t *out)
+        {
+            glm::vec3 mean;
+            glm::vec3 axis = PrincipalAxis<3>(block, mean);
+
+            float minT = 0.0f, maxT = 0.0f;
+            for (int i = 0; i < 16; ++i)
+            {
+                float t = glm::dot(glm::vec3(block[i][0], block[i][1], block[i][2]) - mean, axis);
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+
+            uint16_t c0 = PackRGB565(mean + axis * maxT);
+            uint16_t c1 = PackRGB565(mean + axis * minT);
+
+            uint32_t indices = 0;
+            if (c0 < c1)
+                std::swap(c0, c1);
+
+            if (c0 != c1)
+            {
+                glm::vec3 palette[4];
+                palette[0] = UnpackRGB565(c0);
+                palette[1] = UnpackRGB565(c1);
+                palette[2] = (palette[0] * 2.0f + palette[1]) / 3.0f;
+                palette[3] = (palette[0] + palette[1] * 2.0f) / 3.0f;
+
+                for (int i = 0; i < 16; ++i)
+                {
+                    glm::vec3 c(block[i][0], block[i][1], block[i][2]);
+                    uint32_t best = 0;
+                    float bestDist = 1e30f;
+                    for (uint32_t p = 0; p < 4; ++p)
+                    {
+                        glm::vec3 d = c - palette[p];
+                        float dist = glm::dot(d, d);
+                        if (dist < bestDist)
+                        {
+                            bestDist = dist;
+                            best = p;
+                        }
+                    }
+                    indices |= best << (i * 2);
+                }
+            }
+
+            out[0] = c0 & 0xFF;
+            out[1] = c0 >> 8;
+            out[2] = c1 & 0xFF;
+            out[3] = c1 >> 8;
+            std::memcpy(out + 4, &indices, 4);
+        }
+
+        // Bloque BC4 (8 bytes) de un canal, en modo de 8 valores (a0 > a1)
+        void EncodeBC4(const uint8_t block[16][4], int channel, uint8_t *out)
+        {
+            uint8_t a0 = 0, a1 = 255;
+            for (int i = 0; i < 16; ++i)
+            {
+                a0 = std::max(a0, block[i][channel]);
+                a1 = std::min(a1, block[i][channel]);
+            }
+
+            uint64_t indices = 0;
+            if (a0 != a1)
+            {
+                int palette[8];
+                palette[0] = a0;
+                palette[1] = a1;
+                for (int p = 2; p < 8; ++p)
+                    palette[p] = ((8 - p) * a0 + (p - 1) * a1) / 7;
+
+                for (int i = 0; i < 16; ++i)
+                {
+                    uint64_t best = 0;
+                    int bestDist = 256;
+                    for (int p = 0; p < 8; ++p)
+                    {
+                        int dist = std::abs(block[i][channel] - palette[p]);
+                        if (dist < bestDist)
+                        {
+                            bestDist = dist;
+                            best = static_cast<uint64_t>(p);
+                        }
+                    }
+                    indices |= best << (i * 3);
+                }
+            }
+
+            out[0] = a0;
+            out[1] = a1;
+            for (int i = 0; i < 6; ++i)
+                out[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+        }
+
+        // ====================================================================
+        // BC7 (solo modo 6: una partición, RGBA 7.7.7.7 + p-bit, índices de 4 bits)
+        // ====================================================================
+
+        const int BC7_WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        struct BitWriter
+        {
+            uint8_t *data;
+            uint32_t bit = 0;
+
+            void Write(uint32_t value, uint32_t count)
+            {
+                for (uint32_t i = 0; i < count; ++i, ++bit)
+                    if (value & (1u << i))
+                        data[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+            }
+        };
+
+        // Cuantiza un endpoint RGBA8 a 7 bits + p-bit compartido, eligiendo el p-bit con menos error
+        void QuantizeBC7Endpoint(const glm::vec4 &c, uint32_t q[4], uint32_t &pbit)
+        {
+            float bestError = 1e30f;
+            for (uint32_t p = 0; p < 2; ++p)
+            {
+                uint32_t candidate[4];
+                float error = 0.0f;
+                for (int k = 0; k < 4; ++k)
+                {
+                    int v = static_cast<int>(std::floor((c[k] - p) / 2.0f + 0.5f));
+                    candidate[k] = static_cast<uint32_t>(std::clamp(v, 0, 127));
+                    float d = c[k] - static_cast<float>((candidate[k] << 1) | p);
+                    error += d * d;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    pbit = p;
+                    std::memcpy(q, candidate, sizeof(candidate));
+                }
+            }
+        }
+
+        void EncodeBC7(const uint8_t block[16][4], uint8_t *out)
+        {
+            glm::vec4 mean;
+            glm::vec4 axis = PrincipalAxis<4>(block, mean);
+
+            float minT = 0.0f, maxT = 0.0f;
+            for (int i = 0; i < 16; ++i)
+            {
+                glm::vec4 c(block[i][0], block[i][1], block[i][2], block[i][3]);
+                float t = glm::dot(c - mean, axis);
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+
+            glm::vec4 endpoints[2] = {
+                glm::clamp(mean + axis * minT, glm::vec4(0.0f), glm::vec4(255.0f)),
+                glm::clamp(mean + axis * maxT, glm::vec4(0.0f), glm::vec4(255.0f))};
+
+            uint32_t q[2][4], pbit[2];
+            QuantizeBC7Endpoint(endpoints[0], q[0], pbit[0]);
+            QuantizeBC7Endpoint(endpoints[1], q[1], pbit[1]);
+
+            int e[2][4];
+            for (int s = 0; s < 2; ++s)
+                for (int k = 0; k < 4; ++k)
+                    e[s][k] = static_cast<int>((q[s][k] << 1) | pbit[s]);
+
+            uint32_t indices[16];
+            for (int i = 0; i < 16; ++i)
+            {
+                uint32_t best = 0;
+                int bestDist = 1 << 30;
+                for (uint32_t w = 0; w < 16; ++w)
+                {
+                    int dist = 0;
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        int v = ((64 - BC7_WEIGHTS4[w]) * e[0][k] + BC7_WEIGHTS4[w] * e[1][k] + 32) >> 6;
+                        int d = block[i][k] - v;
+                        dist += d * d;
+                    }
+                    if (dist < bestDist)
+                    {
+                        bestDist = dist;
+                        best = w;
+                    }
+                }
+                indices[i] = best;
+            }
+
+            // El índice del píxel 0 se guarda con 3 bits: su bit alto tiene que ser 0
+            if (indices[0] >= 8)
+            {
+                std::swap(q[0], q[1]);
+                std::swap(pbit[0], pbit[1]);
+                for (uint32_t &index : indices)
+                    index = 15 - index;
+            }
+
+            std::memset(out, 0, 16);
+            BitWriter writer{out};
+            writer.Write(1u << 6, 7); // modo 6
+            for (int k = 0; k < 4; ++k)
+            {
+                writer.Write(q[0][k], 7);
+                writer.Write(q[1][k], 7);
+            }
+            writer.Write(pbit[0], 1);
+            writer.Write(pbit[1], 1);
+            writer.Write(indices[0], 3);
+            for (int i = 1; i < 16; ++i)
+                writer.Write(indices[i], 4);
+        }
+
+        void EncodeLevel(const std::vector<uint8_t> &pixels, uint32_t width, uint32_t height,
+                         TextureCompression compression, uint8_t *out)
+        {
+            const uint32_t blocksX = (width + 3) / 4;
+            const uint32_t blocksY = (height + 3) / 4;
+            uint8_t block[16][4];
+
+            for (uint32_t by = 0; by < blocksY; ++by)
+            {
+                for (uint32_t bx = 0; bx < blocksX; ++bx)
+                {
+                    FetchBlock(pixels.data(), width, height, bx, by, block);
+
+                    switch (compression)
+                    {
+                    case TextureCompression::BC1:
+                        EncodeBC1(block, out);
+                        out += 8;
+                        break;
+                    case TextureCompression::BC3:
+                        EncodeBC4(block, 3, out);
+                        EncodeBC1(block, out + 8);
+                        out += 16;
+                        break;
+                    case TextureCompression::BC5:
+                        EncodeBC4(block, 0, out);
+                        EncodeBC4(block, 1, out + 8);
+                        out += 16;
+                        break;
+                    case TextureCompression::BC7:
+                        EncodeBC7(block, out);
+                        out += 16;
+                        break;
+                    default:
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    TextureCompression TextureCompressor::ChooseCompression(TextureUsage usage, bool hasAlpha)
+    {
+        switch (usage)
+        {
+        case TextureUsage::Normal:
+            return TextureCompression::BC5;
+        case TextureUsage::Mask:
+            return hasAlpha ? TextureCompression::BC3 : TextureCompression::BC1;
+        default:
+            return TextureCompression::BC7;
+        }
+    }
+
+    VkFormat TextureCompressor::GetFormat(TextureCompression compression)
+    {
+        switch (compression)
+        {
+        case TextureCompression::BC1: return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case TextureCompression::BC3: return VK_FORMAT_BC3_UNORM_BLOCK;
+        case TextureCompression::BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TextureCompression::BC7: return VK_FORMAT_BC7_UNORM_BLOCK;
+        default: return VK_FORMAT_R8G8B8A8_UNORM;
+        }
+    }
+
+    TextureImageData TextureCompressor::Compress(const unsigned char *rgba, uint32_t width, uint32_t height,
+                                                 TextureCompression compression, TextureUsage usage,
+                                                 bool generateMips)
+    {
+        if (!rgba || width == 0 || height == 0)
+            throw std::runtime_error("TextureCompressor: imagen vacía");
+
+        TextureImageData image;
+        image.format = GetFormat(compression);
+        image.width = width;
+        image.height = height;
+
+        const uint32_t mipLevels = generateMips
+                                       ? static_cast<uint32_t>(std::floor(std::log2(static_cast<float>(std::max(width, height))))) + 1
+                                       : 1;
+        const size_t alignment = GetFormatBlockBytes(image.format);
+
+        std::vector<uint8_t> level(rgba, rgba + static_cast<size_t>(width) * height * 4);
+        uint32_t levelW = width, levelH = height;
+
+        for (uint32_t mip = 0; mip < mipLevels; ++mip)
+        {
+            if (mip > 0)
+            {
+                uint32_t nextW = std::max(1u, levelW / 2), nextH = std::max(1u, levelH / 2);
+                level = Downsample(level, levelW, levelH, nextW, nextH, usage == TextureUsage::Normal);
+                levelW = nextW;
+                levelH = nextH;
+            }
+
+            TextureMip info;
+            info.width = levelW;
+            info.height = levelH;
+            info.offset = (image.bytes.size() + alignment - 1) / alignment * alignment;
+            info.size = GetTextureLevelSize(image.format, levelW, levelH);
+            image.bytes.resize(info.offset + info.size);
+
+            if (compression == TextureCompression::None)
+                std::memcpy(image.bytes.data() + info.offset, level.data(), info.size);
+            else
+                EncodeLevel(level, levelW, levelH, compression, image.bytes.data() + info.offset);
+
+            image.mips.push_back(info);
+        }
+
+        return image;
+    }
+
+    uint64_t TextureCompressor::GetSettingsHash(TextureUsage usage)
+    {
+        const uint32_t values[] = {TEXTURE_COOK_VERSION, static_cast<uint32_t>(usage)};
+        return ImportCache::HashBytes(values, sizeof(values));
+    }
+
+    bool TextureCompressor::CookFile(const std::string &sourcePath, const std::string &destPath, TextureUsage usage)
+    {
+        try
+        {
+            // Mismo origen que ModelManager::LoadTexture (sin flip: Assimp ya lo hace)
+            auto textureData = TextureLoader::LoadFromFile(sourcePath, false);
+            if (!textureData || !textureData->pixels)
+            {
+                std::cerr << "❌ Cook failed, could not load: " << sourcePath << std::endl;
+                return false;
+            }
+
+            TextureCompression compression = ChooseCompression(usage, textureData->hasAlpha);
+            TextureImageData image = Compress(textureData->pixels,
+                                              static_cast<uint32_t>(textureData->width),
+                                              static_cast<uint32_t>(textureData->height),
+                                              compression, usage);
+
+            if (!KTX2::Save(destPath, image))
+                return false;
+
+            ImportCache::Record(sourcePath, destPath, GetSettingsHash(usage));
+
+            size_t sourceBytes = static_cast<size_t>(textureData->width) * textureData->height * 4;
+            std::cout << "✅ Cooked " << sourcePath << " → " << destPath
+                      << " (" << GetTextureFormatName(image.format) << ", " << image.GetMipLevels() << " mips, "
+                      << sourceBytes / 1024 << " KB → " << image.bytes.size() / 1024 << " KB)" << std::endl;
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "❌ Cook failed for " << sourcePath << ": " << e.what() << std::endl;
+            return false;
+        }
+    }
+}
@@ -0,0 +1,376 @@
+#include "../include/TextureLoader.h"
+#include "../include/MappedFile.h"
+#include "../include/stb_image.h"
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MANTRAX_TEXTURE_SSE2 1
+#endif
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+// Windows Imaging Component
+#include <wincodec.h>
+#include <wrl/client.h>
+#pragma comment(lib, "windowscodecs.lib")
+#endif
+
+namespace Mantrax
+{
+    namespace
+    {
+        std::atomic<ImageDecoder> g_Decoder{ImageDecoder::Auto};
+        std::atomic<bool> g_Verbose{false};
+
+        void FlipVertically(unsigned char *pixels, int width, int height)
+        {
+            const size_t stride = static_cast<size_t>(width) * 4;
+            std::vector<unsigned char> rowBuffer(stride);
+
+            for (int y = 0; y < height / 2; y++)
+            {
+                unsigned char *row1 = pixels + y * stride;
+                unsigned char *row2 = pixels + (height - 1 - y) * stride;
+
+                // Swap rows
+                memcpy(rowBuffer.data(), row1, stride);
+                memcpy(row1, row2, stride);
+                memcpy(row2, rowBuffer.data(), stride);
+            }
+        }
+
+        void AnalyzePixels(const unsigned char *pixels, int width, int height, bool hasAlpha)
+        {
+            std::cout << "\n📊 Pixel Analysis:" << std::endl;
+
+            int totalPixels = width * height;
+
+            // Mostrar píxeles de muestra
+            std::cout << "   First pixel RGBA: ("
+                      << (int)pixels[0] << ", "
+                      << (int)pixels[1] << ", "
+                      << (int)pixels[2] << ", "
+                      << (int)pixels[3] << ")" << std::endl;
+
+            if (totalPixels > 1)
+            {
+                int centerIdx = (height / 2 * width + width / 2) * 4;
+                std::cout << "   Center pixel RGBA: ("
+                          << (int)pixels[centerIdx + 0] << ", "
+                          << (int)pixels[centerIdx + 1] << ", "
+                          << (int)pixels[centerIdx + 2] << ", "
+                          << (int)pixels[centerIdx + 3] << ")" << std::endl;
+
+                size_t lastIdx = (totalPixels - 1) * 4;
+                std::cout << "   Last pixel RGBA: ("
+                          << (int)pixels[lastIdx + 0] << ", "
+                          << (int)pixels[lastIdx + 1] << ", "
+                          << (int)pixels[lastIdx + 2] << ", "
+                          << (int)pixels[lastIdx + 3] << ")" << std::endl;
+            }
+
+            if (hasAlpha)
+            {
+                int fullyTransparent = 0;
+                int fullyOpaque = 0;
+                int semiTransparent = 0;
+
+                for (int i = 0; i < totalPixels; i++)
+                {
+                    unsigned char a = pixels[i * 4 + 3];
+                    if (a == 0)
+                        fullyTransparent++;
+                    else if (a == 255)
+                        fullyOpaque++;
+                    else
+                        semiTransparent++;
+                }
+
+                float opaquePercent = 100.0f * fullyOpaque / totalPixels;
+                float semiPercent = 100.0f * semiTransparent / totalPixels;
+                float transPercent = 100.0f * fullyTransparent / totalPixels;
+
+                std::cout << "   Alpha distribution:" << std::endl;
+                std::cout << "      Opaque (255): " << fullyOpaque << " (" << opaquePercent << "%)" << std::endl;
+                std::cout << "      Semi-transparent: " << semiTransparent << " (" << semiPercent << "%)" << std::endl;
+                std::cout << "      Transparent (0): " << fullyTransparent << " (" << transPercent << "%)" << std::endl;
+            }
+        }
+
+        // stb_image sobre el archivo mapeado; nullptr si el formato no lo entiende
+        std::unique_ptr<TextureData> DecodeSTB(const MappedFile &file, std::string &error)
+        {
+            if (file.GetSize() > static_cast<size_t>(INT32_MAX))
+            {
+                error = "file too large";
+                return nullptr;
+            }
+
+            int width = 0, height = 0, fileChannels = 0;
+            unsigned char *pixels = stbi_load_from_memory(file.GetData(), static_cast<int>(file.GetSize()),
+                                                          &width, &height, &fileChannels, 4);
+            if (!pixels)
+            {
+                error = stbi_failure_reason() ? stbi_failure_reason() : "unknown error";
+                return nullptr;
+            }
+
+            // stb ya expande a RGBA con alpha = 255: no hace falta otra pasada
+            auto data = std::make_unique<TextureData>();
+            data->pixels = pixels;
+            data->freePixels = stbi_image_free;
+            data->width = width;
+            data->height = height;
+            data->channels = 4;
+            data->hasAlpha = fileChannels == 2 || fileChannels == 4;
+            return data;
+        }
+
+#ifdef _WIN32
+        // Una pasada: BGRA -> RGBA (WIC) y/o alpha = 255 (fuentes sin alpha)
+        void SwizzleAndFillAlpha(unsigned char *pixels, size_t pixelCount, bool swapRB, bool fillAlpha)
+        {
+            if (!swapRB && !fillAlpha)
+                return;
+
+            size_t i = 0;
+
+#ifdef MANTRAX_TEXTURE_SSE2
+            // 4 píxeles por iteración; cada píxel es un entero de 32 bits 0xAARRGGBB / 0xAABBGGRR
+            const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+            const __m128i maskGA = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+            for (; i + 4 <= pixelCount; i += 4)
+            {
+                __m128i *block = reinterpret_cast<__m128i *>(pixels + i * 4);
+                __m128i px = _mm_loadu_si128(block);
+
+                if (swapRB)
+                {
+                    __m128i rb = _mm_and_si128(px, maskRB);
+                    rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+                    px = _mm_or_si128(_mm_and_si128(px, maskGA), rb);
+                }
+
+                if (fillAlpha)
+                    px = _mm_or_si128(px, alpha);
+
+                _mm_storeu_si128(block, px);
+            }
+#endif
+
+            for (; i < pixelCount; ++i)
+            {
+                unsigned char *px = pixels + i * 4;
+                if (swapRB)
+                    std::swap(px[0], px[2]);
+                if (fillAlpha)
+                    px[3] = 255;
+            }
+        }
+
+        using Microsoft::WRL::ComPtr;
+
+        // COM una vez por hilo (no en cada textura); se libera al salir el hilo
+        struct ComThreadScope
+        {
+            bool initialized = false;
+            ComThreadScope() { initialized = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED)); }
+            ~ComThreadScope()
+            {
+                if (initialized)
+                    CoUninitialize();
+            }
+        };
+
+        std::unique_ptr<TextureData> DecodeWIC(const std::string &filepath, bool verbose)
+        {
+            thread_local ComThreadScope com;
+
+            // Crear factory de WIC
+            ComPtr<IWICImagingFactory> factory;
+            HRESULT hr = CoCreateInstance(
+                CLSID_WICImagingFactory,
+                nullptr,
+                CLSCTX_INPROC_SERVER,
+                IID_PPV_ARGS(&factory));
+
+            if (FAILED(hr))
+            {
+                throw std::runtime_error("❌ Failed to create WIC factory");
+            }
+
+            // Convertir path a wstring
+            std::wstring wpath(filepath.begin(), filepath.end());
+
+            // Crear decoder
+            ComPtr<IWICBitmapDecoder> decoder;
+            hr = factory->CreateDecoderFromFilename(
+                wpath.c_str(),
+                nullptr,
+                GENERIC_READ,
+                WICDecodeMetadataCacheOnDemand,
+                &decoder);
+
+            if (FAILED(hr))
+            {
+                throw std::runtime_error("❌ Failed to create decoder for: " + filepath);
+            }
+
+            // Obtener el primer frame
+            ComPtr<IWICBitmapFrameDecode> frame;
+            hr = decoder->GetFrame(0, &frame);
+            if (FAILED(hr))
+            {
+                throw std::runtime_error("❌ Failed to get frame");
+            }
+
+            auto data = std::make_unique<TextureData>();
+
+            // Obtener dimensiones
+            UINT width, height;
+            frame->GetSize(&width, &height);
+            data->width = static_cast<int>(width);
+            data->height = static_cast<int>(height);
+
+            // Verificar formato de píxeles
+            WICPixelFormatGUID pixelFormat;
+            frame->GetPixelFormat(&pixelFormat);
+
+            // Determinar si tiene alpha
+            data->hasAlpha = !IsEqualGUID(pixelFormat, GUID_WICPixelFormat24bppBGR) &&
+                             !IsEqualGUID(pixelFormat, GUID_WICPixelFormat24bppRGB);
+
+            if (verbose)
+            {
+                std::cout << "📊 Image info (WIC):" << std::endl;
+                std::cout << "   Size: " << data->width << "x" << data->height << std::endl;
+                std::cout << "   Has alpha: " << (data->hasAlpha ? "Yes" : "No") << std::endl;
+            }
+
+            // Convertir a BGRA primero (es el formato nativo de WIC)
+            ComPtr<IWICFormatConverter> converter;
+            hr = factory->CreateFormatConverter(&converter);
+            if (FAILED(hr))
+            {
+                throw std::runtime_error("❌ Failed to create format converter");
+            }
+
+            // ✅ USAR BGRA (formato nativo de WIC) y luego convertir manualmente
+            hr = converter->Initialize(
+                frame.Get(),
+                GUID_WICPixelFormat32bppBGRA, // ✅ BGRA es el formato nativo
+                WICBitmapDitherTypeNone,
+                nullptr,
+                0.0,
+                WICBitmapPaletteTypeCustom);
+
+            if (FAILED(hr))
+            {
+                throw std::runtime_error("❌ Failed to initialize converter");
+            }
+
+            // Calcular tamaño del buffer
+            data->channels = 4; // Siempre RGBA
+            size_t stride = width * 4;
+            size_t bufferSize = stride * height;
+            data->pixels = new unsigned char[bufferSize];
+
+            // Copiar píxeles
+            hr = converter->CopyPixels(
+                nullptr,
+                static_cast<UINT>(stride),
+                static_cast<UINT>(bufferSize),
+                data->pixels);
+
+            if (FAILED(hr))
+            {
+                throw std::runtime_error("❌ Failed to copy pixels");
+            }
+
+            // WIC devuelve BGRA: a RGBA, y alpha opaco si la fuente no tenía
+            SwizzleAndFillAlpha(data->pixels, static_cast<size_t>(width) * height, true, !data->hasAlpha);
+            return data;
+        }
+#endif
+    }
+
+    void TextureLoader::SetDecoder(ImageDecoder decoder)
+    {
+        g_Decoder = decoder;
+    }
+
+    ImageDecoder TextureLoader::GetDecoder()
+    {
+        return g_Decoder;
+    }
+
+    void TextureLoader::SetVerbose(bool verbose)
+    {
+        g_Verbose = verbose;
+    }
+
+    bool TextureLoader::IsVerbose()
+    {
+        return g_Verbose;
+    }
+
+    std::unique_ptr<TextureData> TextureLoader::LoadFromFile(const std::string &filepath, bool flipVertically)
+    {
+        const bool verbose = g_Verbose;
+        const ImageDecoder decoder = g_Decoder;
+
+        if (verbose)
+            std::cout << "\n=== Loading Texture: " << filepath << " ===" << std::endl;
+
+        std::unique_ptr<TextureData> data;
+        std::string error;
+
+        if (decoder != ImageDecoder::WIC)
+        {
+            MappedFile file;
+            if (!file.Open(filepath))
+            {
+                throw std::runtime_error("❌ File does not exist: " + filepath);
+            }
+
+            data = DecodeSTB(file, error);
+        }
+
+#ifdef _WIN32
+        if (!data && decoder != ImageDecoder::STB)
+            data = DecodeWIC(filepath, verbose);
+#else
+        if (decoder == ImageDecoder::WIC)
+            error = "WIC is only available on Windows";
+#endif
+
+        if (!data)
+        {
+            throw std::runtime_error("❌ Failed to decode " + filepath + ": " + error);
+        }
+
+        // Voltear verticalmente si es necesario
+        if (flipVertically)
+        {
+            FlipVertically(data->pixels, data->width, data->height);
+        }
+
+        if (verbose)
+        {
+            std::cout << "   Size: " << data->width << "x" << data->height
+                      << ", has alpha: " << (data->hasAlpha ? "Yes" : "No") << std::endl;
+            AnalyzePixels(data->pixels, data->width, data->height, data->hasAlpha);
+            std::cout << "=== Texture Loaded Successfully ===" << std::endl;
+        }
+
+        return data;
+    }
+}
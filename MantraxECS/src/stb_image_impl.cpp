@@ -1,2 +1,2 @@
 #define STB_IMAGE_IMPLEMENTATION
-#include "../MantraxECS/include/TextureLoader.h"
\ No newline at end of file
+#include "../include/stb_image.h"
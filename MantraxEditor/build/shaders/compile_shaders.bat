@@ -25,6 +25,21 @@ if "%shaderName%"=="" (
     exit /b 1
 )
 
+:: --- Compute shader (solo .comp) ---
+if exist "%shaderName%.comp" (
+    echo.
+    echo Compilando %shaderName%.comp...
+    glslc "%shaderName%.comp" -o "%shaderName%.comp.spv"
+    if !errorlevel! neq 0 (
+        echo ERROR al compilar el compute shader.
+        pause
+        exit /b 1
+    )
+    echo ✓ Generado: %shaderName%.comp.spv
+    pause
+    exit /b 0
+)
+
 echo.
 echo Compilando shaders: %shaderName%.vert y %shaderName%.frag
 echo --------------------------------------
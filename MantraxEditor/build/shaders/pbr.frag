@@ -23,6 +23,7 @@ layout(binding = 4) uniform sampler2D roughnessMap;
 layout(binding = 5) uniform sampler2D aoMap;
 
 // Push constants para control de materiales
+// Los use*Map se mantienen por compatibilidad de layout; el shader usa las constantes
 layout(push_constant) uniform MaterialProperties {
     vec4 baseColorFactor;
     float metallicFactor;
@@ -35,22 +36,50 @@ layout(push_constant) uniform MaterialProperties {
     int useAOMap;
 } material;
 
-// ============ CONFIGURACIÓN DE ILUMINACIÓN REALISTA ============
+// Variantes por material (ShaderConfig::materialVariants = true): cada pipeline se
+// especializa con las texturas presentes y el compilador elimina ramas y lecturas
+layout(constant_id = 0) const bool HAS_ALBEDO_MAP = false;
+layout(constant_id = 1) const bool HAS_NORMAL_MAP = false;
+layout(constant_id = 2) const bool HAS_METALLIC_MAP = false;
+layout(constant_id = 3) const bool HAS_ROUGHNESS_MAP = false;
+layout(constant_id = 4) const bool HAS_AO_MAP = false;
 
-// Luz direccional principal (simula sol/luz de estudio)
-const vec3 mainLightDir = normalize(vec3(-0.3, -0.7, -0.5));
-const vec3 mainLightColor = vec3(1.0, 0.98, 0.95);
-const float mainLightIntensity = 5.0;
+// ============ LUCES DE LA ESCENA (CLUSTERED FORWARD) ============
 
-// Luz de relleno suave (simula rebote de luz)
-const vec3 fillLightDir = normalize(vec3(0.5, 0.3, 0.8));
-const vec3 fillLightColor = vec3(0.6, 0.65, 0.7);
-const float fillLightIntensity = 2.0;
+#define MAX_LIGHTS_PER_CLUSTER 128
 
-// Luz trasera/rim (para definir siluetas)
-const vec3 rimLightDir = normalize(vec3(0.0, 0.2, 1.0));
-const vec3 rimLightColor = vec3(0.9, 0.95, 1.0);
-const float rimLightIntensity = 2.0;
+struct Light {
+    vec3 position;
+    float range;
+    vec3 color;
+    float intensity;
+    vec3 direction;
+    uint type; // 0: directional, 1: point, 2: spot
+    float cosInnerCone;
+    float cosOuterCone;
+    vec2 padding;
+};
+
+// Set 1: global, lo enlaza GFX (light_cull.comp llena las listas por cluster)
+layout(std430, set = 1, binding = 0) readonly buffer ClusterParams {
+    mat4 view;
+    mat4 invProjection;
+    uvec4 grid;     // xyz: celdas, w: número de luces
+    vec4 viewport;  // xy: tamaño en píxeles, z: near, w: far (profundidad de vista)
+    uvec4 flags;    // x: cortes lineales (ortográfica), y: clusters válidos
+} clusters;
+
+layout(std430, set = 1, binding = 1) readonly buffer Lights {
+    Light lights[];
+};
+
+layout(std430, set = 1, binding = 2) readonly buffer ClusterCounts {
+    uint clusterCounts[];
+};
+
+layout(std430, set = 1, binding = 3) readonly buffer ClusterIndices {
+    uint clusterIndices[];
+};
 
 // Iluminación ambiental (IBL simulado)
 const vec3 ambientColorTop = vec3(0.25, 0.28, 0.32);
@@ -79,7 +108,10 @@ mat3 CalculateTBN(vec3 N, vec3 P, vec2 uv) {
 }
 
 vec3 GetNormalFromMap(mat3 TBN) {
-    vec3 tangentNormal = texture(normalMap, fragTexCoord).xyz * 2.0 - 1.0;
+    // Solo XY: los normal maps cocinados son BC5 (dos canales); Z se reconstruye
+    vec3 tangentNormal;
+    tangentNormal.xy = texture(normalMap, fragTexCoord).xy * 2.0 - 1.0;
+    tangentNormal.z = sqrt(max(1.0 - dot(tangentNormal.xy, tangentNormal.xy), 0.0));
     tangentNormal.xy *= material.normalScale;
     return normalize(TBN * tangentNormal);
 }
@@ -218,6 +250,50 @@ vec3 CalculatePBRLight(
     return (kD * albedo / PI + specular) * radiance * NdotL;
 }
 
+// Radiancia de una luz en el punto (sin atenuar = direccional)
+vec3 LightRadiance(Light light, vec3 P, out vec3 L) {
+    vec3 radiance = light.color * light.intensity;
+
+    if (light.type == 0u) {
+        L = -normalize(light.direction);
+        return radiance;
+    }
+
+    vec3 toLight = light.position - P;
+    float dist2 = max(dot(toLight, toLight), EPSILON);
+    L = toLight * inversesqrt(dist2);
+
+    // Inverso del cuadrado con ventana: llega a 0 exactamente en 'range'
+    float ratio = dist2 / (light.range * light.range);
+    float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+    float attenuation = window * window / (dist2 + 1.0);
+
+    if (light.type == 2u) {
+        float cd = dot(-L, normalize(light.direction));
+        attenuation *= smoothstep(light.cosOuterCone, light.cosInnerCone, cd);
+    }
+
+    return radiance * attenuation;
+}
+
+uint ClusterIndex() {
+    uvec2 tile = uvec2(gl_FragCoord.xy / clusters.viewport.xy * vec2(clusters.grid.xy));
+    tile = min(tile, clusters.grid.xy - 1u);
+
+    float depth = -(clusters.view * vec4(fragWorldPos, 1.0)).z;
+    float zNear = clusters.viewport.z;
+    float zFar = clusters.viewport.w;
+
+    float slice;
+    if (clusters.flags.x != 0u)
+        slice = (depth - zNear) / (zFar - zNear) * float(clusters.grid.z);
+    else
+        slice = log(max(depth, zNear) / zNear) / log(zFar / zNear) * float(clusters.grid.z);
+
+    uint z = uint(clamp(slice, 0.0, float(clusters.grid.z - 1u)));
+    return (z * clusters.grid.y + tile.y) * clusters.grid.x + tile.x;
+}
+
 // ============ MAIN ============
 
 void main() {
@@ -235,23 +311,20 @@ void main() {
     
     // Albedo: PRIMERO lee la textura, LUEGO multiplica por baseColorFactor
     vec3 albedo;
-    if (material.useAlbedoMap == 1) {
+    if (HAS_ALBEDO_MAP) {
         // Leer textura con gamma correction
         vec4 albedoSample = texture(albedoMap, fragTexCoord);
         albedo = pow(albedoSample.rgb, vec3(2.2));
         
-        // SOLO multiplicar por baseColorFactor si no es blanco (1,1,1)
-        // Esto permite tintear la textura si es necesario
-        if (material.baseColorFactor.rgb != vec3(1.0)) {
-            albedo *= material.baseColorFactor.rgb;
-        }
+        // Tinte: con baseColorFactor blanco el producto no cambia nada
+        albedo *= material.baseColorFactor.rgb;
     } else {
         // Si no hay textura, usar baseColorFactor directamente
         albedo = pow(material.baseColorFactor.rgb, vec3(2.2));
     }
     
     // Normal mapping
-    if (material.useNormalMap == 1) {
+    if (HAS_NORMAL_MAP) {
         mat3 TBN = CalculateTBN(N, fragWorldPos, fragTexCoord);
         N = GetNormalFromMap(TBN);
     }
@@ -260,7 +333,7 @@ void main() {
     // CORREGIDO: Los mapas metálicos pueden estar en diferentes canales
     // Común: R (glTF), B (algunos workflows), o escala de grises
     float metallic;
-    if (material.useMetallicMap == 1) {
+    if (HAS_METALLIC_MAP) {
         vec4 metallicSample = texture(metallicMap, fragTexCoord);
         // Intentar detectar el canal correcto:
         // Si es escala de grises, todos los canales son iguales
@@ -268,10 +341,8 @@ void main() {
         // Si es canal R (rojo), usar ese
         metallic = metallicSample.r; // La mayoría de texturas usan canal R o grayscale
         
-        // Si el factor no es 1.0, multiplicar (permite ajustar la intensidad)
-        if (material.metallicFactor != 1.0) {
-            metallic *= material.metallicFactor;
-        }
+        // El factor ajusta la intensidad (1.0 = sin cambio)
+        metallic *= material.metallicFactor;
     } else {
         metallic = material.metallicFactor;
     }
@@ -280,15 +351,13 @@ void main() {
     // Roughness
     // CORREGIDO: Similar al metallic, puede estar en diferentes canales
     float roughness;
-    if (material.useRoughnessMap == 1) {
+    if (HAS_ROUGHNESS_MAP) {
         vec4 roughnessSample = texture(roughnessMap, fragTexCoord);
         // glTF 2.0 estándar: roughness en canal G (verde)
         // Pero muchas texturas usan R o grayscale
         roughness = roughnessSample.g; // Estándar glTF usa canal G
         
-        if (material.roughnessFactor != 1.0) {
-            roughness *= material.roughnessFactor;
-        }
+        roughness *= material.roughnessFactor;
     } else {
         roughness = material.roughnessFactor;
     }
@@ -296,7 +365,7 @@ void main() {
     
     // Ambient Occlusion
     float ao;
-    if (material.useAOMap == 1) {
+    if (HAS_AO_MAP) {
         ao = texture(aoMap, fragTexCoord).r;
     } else {
         ao = 1.0;
@@ -317,22 +386,23 @@ void main() {
     // Acumulador de luz directa
     vec3 Lo = vec3(0.0);
     
-    // Luz principal
-    vec3 L_main = -mainLightDir;
-    vec3 radiance_main = mainLightColor * mainLightIntensity;
-    Lo += CalculatePBRLight(N, V, L_main, radiance_main, albedo, metallic, roughness, F0);
-    
-    // Luz de relleno
-    vec3 L_fill = fillLightDir;
-    vec3 radiance_fill = fillLightColor * fillLightIntensity;
-    Lo += CalculatePBRLight(N, V, L_fill, radiance_fill, albedo, metallic, roughness, F0);
-    
-    // Luz trasera/rim (sutil)
-    vec3 L_rim = rimLightDir;
-    vec3 radiance_rim = rimLightColor * rimLightIntensity;
-    float rimFactor = 1.0 - max(dot(N, V), 0.0);
-    rimFactor = pow(rimFactor, 3.0);
-    Lo += CalculatePBRLight(N, V, L_rim, radiance_rim * rimFactor, albedo, metallic, roughness, F0);
+    // Solo las luces del cluster del fragmento (sin culling en GPU: todas)
+    if (clusters.flags.y != 0u) {
+        uint cluster = ClusterIndex();
+        uint count = clusterCounts[cluster];
+        for (uint i = 0u; i < count; ++i) {
+            Light light = lights[clusterIndices[cluster * MAX_LIGHTS_PER_CLUSTER + i]];
+            vec3 L;
+            vec3 radiance = LightRadiance(light, fragWorldPos, L);
+            Lo += CalculatePBRLight(N, V, L, radiance, albedo, metallic, roughness, F0);
+        }
+    } else {
+        for (uint i = 0u; i < clusters.grid.w; ++i) {
+            vec3 L;
+            vec3 radiance = LightRadiance(lights[i], fragWorldPos, L);
+            Lo += CalculatePBRLight(N, V, L, radiance, albedo, metallic, roughness, F0);
+        }
+    }
     
     // Iluminación ambiental realista (IBL simulado)
     vec3 ambient = CalculateRealisticAmbient(N, V, albedo, F0, roughness, metallic, ao);
@@ -17,6 +17,98 @@ layout(binding = 0) uniform UniformBufferObject {
 
 layout(binding = 1) uniform sampler2D albedoMap;
 
+// ============ LUCES DE LA ESCENA (CLUSTERED FORWARD, mismo set 1 que pbr.frag) ============
+
+#define MAX_LIGHTS_PER_CLUSTER 128
+
+struct Light {
+    vec3 position;
+    float range;
+    vec3 color;
+    float intensity;
+    vec3 direction;
+    uint type; // 0: directional, 1: point, 2: spot
+    float cosInnerCone;
+    float cosOuterCone;
+    vec2 padding;
+};
+
+// Set 1: global, lo enlaza GFX (light_cull.comp llena las listas por cluster)
+layout(std430, set = 1, binding = 0) readonly buffer ClusterParams {
+    mat4 view;
+    mat4 invProjection;
+    uvec4 grid;     // xyz: celdas, w: número de luces
+    vec4 viewport;  // xy: tamaño en píxeles, z: near, w: far (profundidad de vista)
+    uvec4 flags;    // x: cortes lineales (ortográfica), y: clusters válidos
+} clusters;
+
+layout(std430, set = 1, binding = 1) readonly buffer Lights {
+    Light lights[];
+};
+
+layout(std430, set = 1, binding = 2) readonly buffer ClusterCounts {
+    uint clusterCounts[];
+};
+
+layout(std430, set = 1, binding = 3) readonly buffer ClusterIndices {
+    uint clusterIndices[];
+};
+
+const float PI = 3.14159265359;
+const float EPSILON = 0.0001;
+
+// Radiancia de una luz en el punto (sin atenuar = direccional), igual que pbr.frag
+vec3 LightRadiance(Light light, vec3 P, out vec3 L) {
+    vec3 radiance = light.color * light.intensity;
+
+    if (light.type == 0u) {
+        L = -normalize(light.direction);
+        return radiance;
+    }
+
+    vec3 toLight = light.position - P;
+    float dist2 = max(dot(toLight, toLight), EPSILON);
+    L = toLight * inversesqrt(dist2);
+
+    // Inverso del cuadrado con ventana: llega a 0 exactamente en 'range'
+    float ratio = dist2 / (light.range * light.range);
+    float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+    float attenuation = window * window / (dist2 + 1.0);
+
+    if (light.type == 2u) {
+        float cd = dot(-L, normalize(light.direction));
+        attenuation *= smoothstep(light.cosOuterCone, light.cosInnerCone, cd);
+    }
+
+    return radiance * attenuation;
+}
+
+uint ClusterIndex() {
+    uvec2 tile = uvec2(gl_FragCoord.xy / clusters.viewport.xy * vec2(clusters.grid.xy));
+    tile = min(tile, clusters.grid.xy - 1u);
+
+    float depth = -(clusters.view * vec4(fragWorldPos, 1.0)).z;
+    float zNear = clusters.viewport.z;
+    float zFar = clusters.viewport.w;
+
+    float slice;
+    if (clusters.flags.x != 0u)
+        slice = (depth - zNear) / (zFar - zNear) * float(clusters.grid.z);
+    else
+        slice = log(max(depth, zNear) / zNear) / log(zFar / zNear) * float(clusters.grid.z);
+
+    uint z = uint(clamp(slice, 0.0, float(clusters.grid.z - 1u)));
+    return (z * clusters.grid.y + tile.y) * clusters.grid.x + tile.x;
+}
+
+// Lambert + Blinn-Phong; la intensidad de la luz en las mismas unidades que pbr.frag (/PI)
+vec3 ShadeLight(vec3 N, vec3 V, vec3 L, vec3 radiance) {
+    float diff = max(dot(N, L), 0.0);
+    vec3 H = normalize(L + V);
+    float spec = pow(max(dot(N, H), 0.0), 64.0) * step(EPSILON, diff); // Sin brillo de espaldas a la luz
+    return (vec3(diff) + vec3(0.5) * spec) * radiance / PI;
+}
+
 void main() {
     // Samplear textura
     vec4 texColor = texture(albedoMap, fragTexCoord);
@@ -26,25 +118,41 @@ void main() {
         discard;
     }
     
-    // Iluminación mejorada con más brillo
     vec3 N = normalize(fragNormal);
-    vec3 lightDir = normalize(vec3(1.0, 1.0, 0.5));
     vec3 viewDir = normalize(fragCameraPos - fragWorldPos);
     
     // ✅ Ambient MÁS ALTO (más luz base)
     vec3 ambient = vec3(0.6); // Era 0.3, ahora 0.6 (doble)
     
-    // ✅ Diffuse MÁS INTENSO
-    float diff = max(dot(N, lightDir), 0.0);
-    vec3 diffuse = vec3(1.2) * diff; // Era 0.8, ahora 1.2
-    
-    // ✅ Specular más brillante
-    vec3 reflectDir = reflect(-lightDir, N);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
-    vec3 specular = vec3(0.8) * spec; // Era 0.5, ahora 0.8
+    // ✅ Luces de la escena (entidades Light): solo las del cluster del fragmento
+    vec3 direct = vec3(0.0);
+    if (clusters.flags.y != 0u) {
+        uint cluster = ClusterIndex();
+        uint count = clusterCounts[cluster];
+        for (uint i = 0u; i < count; ++i) {
+            Light light = lights[clusterIndices[cluster * MAX_LIGHTS_PER_CLUSTER + i]];
+            vec3 L;
+            vec3 radiance = LightRadiance(light, fragWorldPos, L);
+            direct += ShadeLight(N, viewDir, L, radiance);
+        }
+    } else if (clusters.grid.w > 0u) {
+        // Sin culling en GPU: todas
+        for (uint i = 0u; i < clusters.grid.w; ++i) {
+            vec3 L;
+            vec3 radiance = LightRadiance(lights[i], fragWorldPos, L);
+            direct += ShadeLight(N, viewDir, L, radiance);
+        }
+    } else {
+        // Escena sin luces: la luz fija de siempre para que se vea algo
+        vec3 lightDir = normalize(vec3(1.0, 1.0, 0.5));
+        float diff = max(dot(N, lightDir), 0.0);
+        vec3 reflectDir = reflect(-lightDir, N);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
+        direct = vec3(1.2) * diff + vec3(0.8) * spec;
+    }
     
     // Combinar iluminación
-    vec3 result = (ambient + diffuse + specular) * texColor.rgb;
+    vec3 result = (ambient + direct) * texColor.rgb;
     
     // ✅ OPCIONAL: Aplicar un multiplicador general de brillo
     result *= 1.2; // Aumentar brillo general un 20%
@@ -0,0 +1,18 @@
+#version 450
+
+layout(location = 0) in vec3 fragDirection;
+
+layout(location = 0) out vec4 outColor;
+
+// Cubemap generado desde la equirectangular (ver SkyBox::LoadEquirectangular)
+layout(binding = 0) uniform samplerCube skyMap;
+
+layout(push_constant) uniform SkyParams {
+    mat4 invViewProj;
+    vec4 tint; // rgb: multiplicador de brillo
+} sky;
+
+void main() {
+    vec3 color = texture(skyMap, normalize(fragDirection)).rgb;
+    outColor = vec4(color * sky.tint.rgb, 1.0);
+}
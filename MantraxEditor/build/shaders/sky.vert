@@ -0,0 +1,24 @@
+#version 450
+
+// Triángulo a pantalla completa (sin vertex buffer): cubre el viewport con 3 vértices
+// en (-1,-1), (3,-1), (-1,3). Va a depth 1.0: con LESS_OR_EQUAL solo se rasteriza
+// donde no hay geometría opaca.
+
+layout(push_constant) uniform SkyParams {
+    mat4 invViewProj; // (proyección * vista sin traslación)^-1
+    vec4 tint;
+} sky;
+
+layout(location = 0) out vec3 fragDirection;
+
+void main() {
+    vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    vec2 ndc = uv * 2.0 - 1.0;
+
+    gl_Position = vec4(ndc, 1.0, 1.0);
+
+    // Punto del far plane en espacio de mundo (centrado en la cámara).
+    // Con z fijo, w es igual en los 3 vértices: la interpolación lineal es exacta
+    vec4 farPoint = sky.invViewProj * vec4(ndc, 1.0, 1.0);
+    fragDirection = farPoint.xyz / farPoint.w;
+}
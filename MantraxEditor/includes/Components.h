@@ -11,6 +11,8 @@
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtc/epsilon.hpp>
 
+#include "../../MantraxRender/include/MantraxGFX_Lighting.h"
+
 // Forward declaration
 struct RenderableObject;
 
@@ -409,6 +411,21 @@ struct RenderComponent
         : renderObject(obj) {}
 };
 
+// Luz de la escena: posición y dirección (eje -Z) salen del Transform
+struct Light
+{
+    Mantrax::LightType type = Mantrax::LightType::Point;
+    glm::vec3 color = glm::vec3(1.0f);
+    float intensity = 5.0f;
+    float range = 10.0f;            // Point/Spot
+    float innerConeDegrees = 20.0f; // Spot
+    float outerConeDegrees = 30.0f; // Spot
+
+    Light() = default;
+    Light(Mantrax::LightType t, const glm::vec3 &c, float i)
+        : type(t), color(c), intensity(i) {}
+};
+
 struct Sprite
 {
     std::string texturePath;
@@ -249,6 +249,10 @@ namespace Mantrax
 
             vkDeviceWaitIdle(m_GFX->GetDevice());
 
+            // Las texturas de ImGui retiradas (render targets) deben liberarse antes del backend
+            m_GFX->ClearRenderTargetPool();
+            m_GFX->GetDeletionQueue()->Flush();
+
             ImGui_ImplVulkan_Shutdown();
             ImGui_ImplWin32_Shutdown();
             ImGui::DestroyContext();
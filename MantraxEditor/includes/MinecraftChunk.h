@@ -4,6 +4,7 @@
 #include <random>
 #include <glm/glm.hpp>
 #include "../../MantraxRender/include/MantraxGFX_API.h"
+#include "../../MantraxECS/include/MeshOptimizer.h"
 
 namespace Mantrax
 {
@@ -147,6 +148,9 @@ namespace Mantrax
                     }
                 }
             }
+
+            // Assimp nunca ve estos meshes: optimizar aquí
+            MeshOptimizer::Optimize(vertices, indices);
         }
 
     private:
@@ -0,0 +1,12 @@
+#pragma once
+#include "../../../MantraxRender/include/MantraxGFX_Memory.h"
+#include "../imgui/imgui.h"
+#include "../UIBehaviour.h"
+
+// Uso de VRAM por categoría y heap, presupuesto y streaming de texturas
+class MemoryPanel : public UIBehaviour
+{
+public:
+    MemoryPanel();
+    void OnRender() override;
+};
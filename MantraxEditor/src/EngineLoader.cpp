@@ -36,21 +36,6 @@ void EngineLoader::Start(HINSTANCE hInst, const std::function<LRESULT(HWND, UINT
 
     normalShader = gfx->CreateShader(normalShaderConfig);
 
-    skyboxShaderConfig.vertexShaderPath = "shaders/skybox.vert.spv";
-    skyboxShaderConfig.fragmentShaderPath = "shaders/skybox.frag.spv";
-    skyboxShaderConfig.vertexBinding = Mantrax::Vertex::GetBindingDescription();
-    skyboxShaderConfig.vertexAttributes = Mantrax::Vertex::GetAttributeDescriptions();
-
-    skyboxShaderConfig.depthTestEnable = true;                       // Testear depth
-    skyboxShaderConfig.depthWriteEnable = false;                     // ❌ NO escribir en depth
-    skyboxShaderConfig.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL; // Permitir depth = 1.0
-    skyboxShaderConfig.cullMode = VK_CULL_MODE_FRONT_BIT;            // Cull frontal (interior de esfera)
-    skyboxShaderConfig.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    skyboxShaderConfig.polygonMode = VK_POLYGON_MODE_FILL;
-    skyboxShaderConfig.blendEnable = false;
-
-    skyboxShader = gfx->CreateShader(skyboxShaderConfig);
-
     // --- Outline shader ---
     outlineShaderConfig.vertexShaderPath = "shaders/outline.vert.spv";
     outlineShaderConfig.fragmentShaderPath = "shaders/outline.frag.spv";
@@ -59,6 +44,47 @@ void EngineLoader::Start(HINSTANCE hInst, const std::function<LRESULT(HWND, UINT
     outlineShaderConfig.cullMode = VK_CULL_MODE_FRONT_BIT;
     outlineShaderConfig.depthTestEnable = true;
     outlineShader = gfx->CreateShader(outlineShaderConfig);
+
+    // --- HiZ occlusion culling (el .spv lo genera el build, ver MantraxShaders en CMakeLists;
+    //     si falta igual se renderiza, sin oclusión) ---
+    try
+    {
+        gfx->EnableHiZOcclusion("shaders/hiz.comp.spv");
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "⚠️ HiZ occlusion culling deshabilitado: " << e.what() << "\n";
+    }
+
+    // --- Meshlet culling (opcional: sin el .spv los meshes densos usan draws indexados) ---
+    try
+    {
+        gfx->EnableMeshletCulling("shaders/meshlet_cull.comp.spv");
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "⚠️ Meshlet culling deshabilitado: " << e.what() << "\n";
+    }
+
+    // --- Clustered lighting (opcional: sin el .spv el shader PBR recorre todas las luces) ---
+    try
+    {
+        gfx->EnableClusteredLighting("shaders/light_cull.comp.spv");
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "⚠️ Clustered lighting deshabilitado: " << e.what() << "\n";
+    }
+
+    // --- Cielo (opcional: sin los .spv el fondo es el clear color) ---
+    try
+    {
+        gfx->EnableSky("shaders/sky.vert.spv", "shaders/sky.frag.spv");
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "⚠️ Cielo deshabilitado: " << e.what() << "\n";
+    }
 }
 
 void EngineLoader::Render(const std::function<void()> &renderLambda)
@@ -7,6 +7,7 @@
 #include "../../MantraxECS/include/ModelManager.h"
 #include "../../MantraxECS/include/SceneRenderer.h"
 #include "../../MantraxECS/include/TextureLoader.h"
+#include "../../MantraxECS/include/AssetArchive.h"
 #include "../../MantraxECS/include/SceneManager.h"
 #include "../../MantraxECS/include/Scene.h"
 #include "../../MantraxECS/include/LuaScript.h"
@@ -20,6 +21,7 @@
 #include "../includes/ui/Inspector.h"
 #include "../includes/ui/Hierarchy.h"
 #include "../includes/ui/MenuBar.h"
+#include "../includes/ui/MemoryPanel.h"
 #include "../includes/ImGuiManager.h"
 #include <iostream>
 #include <vector>
@@ -119,6 +121,38 @@ void SyncRenderSystem(Scene *scene)
         } });
 }
 
+void SyncLightSystem(Scene *scene, Mantrax::GFX *gfx)
+{
+    auto &world = scene->GetWorld();
+    std::vector<Mantrax::GPULight> lights;
+
+    world.forEach<Transform, Light>([&lights](ecs::Entity entity, Transform &transform, Light &light)
+                                    {
+        transform.UpdateWorldMatrix();
+
+        glm::vec3 position = transform.GetWorldPosition();
+        glm::vec3 direction = glm::normalize(transform.GetWorldRotation() * glm::vec3(0.0f, 0.0f, -1.0f));
+
+        Mantrax::GPULight gpu;
+        gpu.position[0] = position.x;
+        gpu.position[1] = position.y;
+        gpu.position[2] = position.z;
+        gpu.range = light.range;
+        gpu.color[0] = light.color.r;
+        gpu.color[1] = light.color.g;
+        gpu.color[2] = light.color.b;
+        gpu.intensity = light.intensity;
+        gpu.direction[0] = direction.x;
+        gpu.direction[1] = direction.y;
+        gpu.direction[2] = direction.z;
+        gpu.type = static_cast<uint32_t>(light.type);
+        gpu.cosInnerCone = std::cos(glm::radians(light.innerConeDegrees));
+        gpu.cosOuterCone = std::cos(glm::radians(std::max(light.outerConeDegrees, light.innerConeDegrees)));
+        lights.push_back(gpu); });
+
+    gfx->SetLights(lights);
+}
+
 // Función helper para configurar vista isométrica
 void SetupIsometricCamera(Mantrax::FPSCamera &camera, float distance = 15.0f)
 {
@@ -228,6 +262,19 @@ void SetupGameScene(EngineLoader *loader, ModelManager *modelManager, SceneRende
 
     std::cout << "✅ Isometric ground plane created!\n";
 
+    // ========================================================================
+    // LUCES (sol + relleno; las leen pbr.frag y simple.frag, antes tenían una fija)
+    // ========================================================================
+    EntityObject sunEntity = scene->CreateEntityObject("Sun");
+    Transform &sunTransform = sunEntity.AddComponent<Transform>();
+    sunTransform.SetRotation(glm::quatLookAt(glm::normalize(glm::vec3(-0.3f, -0.7f, -0.5f)), glm::vec3(0, 1, 0)));
+    sunEntity.AddComponent<Light>(Mantrax::LightType::Directional, glm::vec3(1.0f, 0.98f, 0.95f), 5.0f);
+
+    EntityObject fillEntity = scene->CreateEntityObject("FillLight");
+    Transform &fillTransform = fillEntity.AddComponent<Transform>();
+    fillTransform.SetRotation(glm::quatLookAt(glm::normalize(glm::vec3(-0.5f, -0.3f, -0.8f)), glm::vec3(0, 1, 0)));
+    fillEntity.AddComponent<Light>(Mantrax::LightType::Directional, glm::vec3(0.6f, 0.65f, 0.7f), 2.0f);
+
     // ========================================================================
     // CREAR MATERIALES ADICIONALES DE EJEMPLO
     // ========================================================================
@@ -261,51 +308,16 @@ void SetupGameScene(EngineLoader *loader, ModelManager *modelManager, SceneRende
     // ========================================================================
     // SKYBOX
     // ========================================================================
-    Mantrax::SkyBox skybox(loader->gfx.get(), 1.0f, 32, 16);
-
-    auto skyboxTextureData = Mantrax::TextureLoader::LoadFromFile(
-        "textures/skybox.jpg",
-        true);
-    auto skyboxTexture = loader->gfx->CreateTexture(
-        skyboxTextureData->pixels,
-        skyboxTextureData->width,
-        skyboxTextureData->height);
-
-    auto skyboxMaterial = loader->gfx->CreateMaterial(loader->skyboxShader);
-    skyboxMaterial->SetBaseColor(2.0f, 2.0f, 2.0f);
-
-    // ✅ CAMBIO: Ya no usar SetMaterialPBRTextures, usar el nuevo flujo
-    skyboxMaterial->SetAlbedoTexture(skyboxTexture);
-
-    auto skyboxRenderObj = skybox.GetRenderObject();
-    skyboxRenderObj.material = skyboxMaterial;
+    // ✅ La equirectangular se convierte a cubemap una vez (textures/skybox.jpg.cubemap)
+    // y se dibuja como triángulo a pantalla completa detrás de los opacos
+    Mantrax::SkyBox skybox(loader->gfx.get(), 512);
 
-    // ✅ NUEVO: Crear descriptor set para skybox
-    if (skyboxRenderObj.mesh && skyboxMaterial)
+    if (skybox.LoadEquirectangular("textures/skybox.jpg", true))
     {
-        loader->gfx->CreateMeshDescriptorSet(skyboxRenderObj.mesh, skyboxMaterial);
-        std::cout << "✅ Descriptor set created for skybox\n";
+        skybox.SetTint(glm::vec3(2.0f));
+        skybox.Apply();
     }
-
-    // Crear EntityObject para el skybox
-    EntityObject skyboxEntity = scene->CreateEntityObject("Skybox");
-
-    Transform &skyboxTransform = skyboxEntity.AddComponent<Transform>();
-    skyboxTransform.SetPosition(0.0f, 0.0f, 0.0f);
-    skyboxTransform.SetRotationFromEulerDegrees(0.0f, 0.0f, 0.0f);
-    skyboxTransform.SetScale(1.0f, 1.0f, 1.0f);
-
-    RenderComponent &skyboxRender = skyboxEntity.AddComponent<RenderComponent>();
-
-    // Crear RenderableObject para skybox
-    RenderableObject *skyboxObj = new RenderableObject();
-    skyboxObj->renderObj = skyboxRenderObj;
-    skyboxObj->material = skyboxMaterial;
-    skyboxObj->name = "Skybox";
-    skyboxObj->modelMatrix = glm::mat4(1.0f);
-
-    skyboxRender.renderObject = skyboxObj;
-    sceneRenderer->AddObject(skyboxObj);
+    loader->gfx->SetSkyEnabled(g_SkyboxEnabled);
 
     // ========================================================================
     // LISTAR TODOS LOS MATERIALES CREADOS
@@ -338,6 +350,10 @@ int main()
         // ====================================================================
         // INICIALIZACIÓN DE SERVICIOS
         // ====================================================================
+        // Assets empaquetados (shaders, texturas, meshes cocinados) antes de cargar nada;
+        // sin paquete, o lo que no esté en él, se lee del disco como siempre
+        Mantrax::AssetArchive::Mount("Assets.mxpak");
+
         ServiceLocator::instance().registerService("EngineLoader", std::make_shared<EngineLoader>());
         auto loader = ServiceLocator::instance().get<EngineLoader>("EngineLoader");
         loader->Start(hInst, CustomWndProc);
@@ -387,7 +403,27 @@ int main()
         // ====================================================================
         // UI SETUP
         // ====================================================================
-        auto offscreen = loader->gfx->CreateOffscreenFramebuffer(1024, 768);
+        auto offscreen = loader->gfx->AcquireOffscreenFramebuffer(1024, 768);
+
+        // Registra el color del target en ImGui (una vez por target: el pool los reutiliza)
+        auto registerSceneTexture = [](std::shared_ptr<Mantrax::OffscreenFramebuffer> target)
+        {
+            if (target->renderID != VK_NULL_HANDLE)
+                return;
+
+            target->renderID = ImGui_ImplVulkan_AddTexture(
+                target->sampler,
+                target->colorImageView,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+            // Se llama desde la cola diferida, cuando ningún frame en vuelo lo usa
+            target->releaseRenderID = [](VkDescriptorSet id)
+            {
+                if (ImGui::GetCurrentContext())
+                    ImGui_ImplVulkan_RemoveTexture(id);
+            };
+        };
+        registerSceneTexture(offscreen);
         ServiceLocator::instance().registerService("UIRender", std::make_shared<UIRender>());
         auto uiRender = ServiceLocator::instance().get<UIRender>("UIRender");
 
@@ -398,7 +434,12 @@ int main()
 
         uiRender->Set(new Inspector());
         uiRender->Set(new Hierarchy());
+        uiRender->Set(new MemoryPanel());
         uiRender->GetByType<SceneView>()->renderID = offscreen->renderID;
+        renderView->framebuffer = offscreen;
+
+        // Resolución dinámica del viewport de escena
+        Mantrax::DynamicResolution dynamicResolution;
 
         Mantrax::Timer gameTimer;
         bool running = true;
@@ -434,6 +475,9 @@ int main()
         // ====================================================================
         while (running)
         {
+            // ✅ Pacing: esperar al frame anterior antes de leer input (menos latencia que la cola FIFO)
+            loader->gfx->WaitForFramePacing(&gameTimer);
+
             if (!loader->window->ProcessMessages())
             {
                 running = false;
@@ -479,11 +523,15 @@ int main()
             // ================================================================
             // UPDATE SYSTEMS (ahora usan Scene*)
             // ================================================================
+            // ✅ Modelos cargados en segundo plano: sube a la GPU lo que ya terminó
+            modelManager->Update();
+
             activeScene->OnUpdate(delta);
 
             UpdateRotationSystem(activeScene, delta);
             UpdatePhysicsSystem(activeScene, delta);
             SyncRenderSystem(activeScene);
+            SyncLightSystem(activeScene, loader->gfx.get());
 
             ProcessCameraInput(camera, *g_InputSystem, delta);
             g_InputSystem->Update();
@@ -493,17 +541,16 @@ int main()
             // ================================================================
             if (renderView->CheckResize())
             {
-                loader->gfx->ResizeOffscreenFramebuffer(
-                    offscreen,
-                    static_cast<uint32_t>(renderView->width),
-                    static_cast<uint32_t>(renderView->height));
+                const uint32_t panelWidth = static_cast<uint32_t>(renderView->width);
+                const uint32_t panelHeight = static_cast<uint32_t>(renderView->height);
 
-                offscreen->renderID = ImGui_ImplVulkan_AddTexture(
-                    offscreen->sampler,
-                    offscreen->colorImageView,
-                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                // ✅ Pool de render targets: si el panel cabe se renderiza en un sub-rectángulo,
+                // si no se cambia a un target del bucket adecuado sin esperar a la GPU
+                offscreen = loader->gfx->ResizeOffscreenPooled(offscreen, panelWidth, panelHeight);
+                registerSceneTexture(offscreen);
 
                 renderView->renderID = offscreen->renderID;
+                renderView->framebuffer = offscreen;
 
                 camera.SetAspectRatio(
                     static_cast<float>(renderView->width) /
@@ -512,6 +559,13 @@ int main()
                 renderView->ResetResizeFlag();
             }
 
+            // ✅ Escala según el tiempo de GPU del frame anterior
+            dynamicResolution.Update(loader->gfx->GetOffscreenGPUTimeMs());
+            VkExtent2D renderExtent = dynamicResolution.Apply(
+                static_cast<uint32_t>(renderView->width),
+                static_cast<uint32_t>(renderView->height));
+            loader->gfx->SetOffscreenRenderExtent(offscreen, renderExtent.width, renderExtent.height);
+
             sceneRenderer->UpdateUBOs(&camera);
             sceneRenderer->RenderScene(offscreen);
 
@@ -144,6 +144,40 @@ void Inspector::OnRender()
             world.addComponent<Velocity>(entity);
     }
 
+    // ------------------------------------------------------------
+    // LIGHT
+    // ------------------------------------------------------------
+    if (auto *light = world.getComponent<Light>(entity))
+    {
+        if (ImGui::CollapsingHeader("Light"))
+        {
+            const char *types[] = {"Directional", "Point", "Spot"};
+            int type = static_cast<int>(light->type);
+            if (ImGui::Combo("Type", &type, types, IM_ARRAYSIZE(types)))
+                light->type = static_cast<Mantrax::LightType>(type);
+
+            ImGui::ColorEdit3("Color", &light->color.x);
+            ImGui::DragFloat("Intensity", &light->intensity, 0.1f, 0.0f, 1000.0f);
+
+            if (light->type != Mantrax::LightType::Directional)
+                ImGui::DragFloat("Range", &light->range, 0.1f, 0.01f, 1000.0f);
+
+            if (light->type == Mantrax::LightType::Spot)
+            {
+                ImGui::DragFloat("Inner Cone", &light->innerConeDegrees, 0.5f, 0.0f, 89.0f);
+                ImGui::DragFloat("Outer Cone", &light->outerConeDegrees, 0.5f, 0.0f, 89.0f);
+            }
+
+            if (ImGui::Button("Remove Light"))
+                world.removeComponent<Light>(entity);
+        }
+    }
+    else
+    {
+        if (ImGui::Button("Add Light"))
+            world.addComponent<Light>(entity);
+    }
+
     // ------------------------------------------------------------
     // RENDER COMPONENT
     // ------------------------------------------------------------
@@ -0,0 +1,140 @@
+#include "../../includes/ui/MemoryPanel.h"
+#include "../../MantraxECS/include/ServiceLocator.h"
+#include "../../includes/EngineLoader.h"
+#include <cstdio>
+
+namespace
+{
+    float ToMB(uint64_t bytes) { return static_cast<float>(bytes / (1024.0 * 1024.0)); }
+}
+
+MemoryPanel::MemoryPanel() {}
+
+void MemoryPanel::OnRender()
+{
+    ImGui::Begin("Memory");
+
+    auto loader = ServiceLocator::instance().get<EngineLoader>("EngineLoader");
+    if (!loader || !loader->gfx)
+    {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "No device");
+        ImGui::End();
+        return;
+    }
+
+    Mantrax::GFX &gfx = *loader->gfx;
+    const Mantrax::MemoryStats stats = gfx.GetMemoryStats();
+
+    // ------------------------------------------------------------
+    // PRESUPUESTO
+    // ------------------------------------------------------------
+    float fraction = stats.deviceLocalBudget > 0
+                         ? static_cast<float>(static_cast<double>(stats.deviceLocalUsage) / stats.deviceLocalBudget)
+                         : 0.0f;
+
+    char label[96];
+    snprintf(label, sizeof(label), "%.0f / %.0f MB", ToMB(stats.deviceLocalUsage), ToMB(stats.deviceLocalBudget));
+
+    ImGui::Text("VRAM");
+    ImGui::PushStyleColor(ImGuiCol_PlotHistogram, fraction > 1.0f    ? ImVec4(0.9f, 0.25f, 0.25f, 1.0f)
+                                                  : fraction > 0.85f ? ImVec4(0.9f, 0.7f, 0.2f, 1.0f)
+                                                                     : ImVec4(0.3f, 0.7f, 0.35f, 1.0f));
+    ImGui::ProgressBar(fraction > 1.0f ? 1.0f : fraction, ImVec2(-1.0f, 0.0f), label);
+    ImGui::PopStyleColor();
+
+    if (!stats.hasBudgetExtension)
+        ImGui::TextColored(ImVec4(0.9f, 0.7f, 0.2f, 1.0f), "VK_EXT_memory_budget not available: engine allocations only");
+
+    if (stats.retiredBytes > 0)
+        ImGui::TextDisabled("Pending free: %.1f MB", ToMB(stats.retiredBytes));
+
+    // ------------------------------------------------------------
+    // CATEGORÍAS
+    // ------------------------------------------------------------
+    ImGui::Separator();
+    if (ImGui::BeginTable("MemoryCategories", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+    {
+        ImGui::TableSetupColumn("Category");
+        ImGui::TableSetupColumn("Allocations");
+        ImGui::TableSetupColumn("MB");
+        ImGui::TableHeadersRow();
+
+        for (size_t i = 0; i < Mantrax::MEMORY_CATEGORY_COUNT; ++i)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(Mantrax::GetMemoryCategoryName(static_cast<Mantrax::MemoryCategory>(i)));
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", stats.categoryAllocations[i]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", ToMB(stats.categoryBytes[i]));
+        }
+        ImGui::EndTable();
+    }
+
+    if (stats.hostFallbackBytes > 0)
+        ImGui::TextColored(ImVec4(0.9f, 0.7f, 0.2f, 1.0f), "In system memory: %.1f MB", ToMB(stats.hostFallbackBytes));
+
+    ImGui::Text("Evictions: %u (%.1f MB)", stats.evictions, ToMB(stats.evictedBytes));
+    ImGui::Text("Host fallbacks: %u | Failed allocations: %u", stats.hostFallbacks, stats.failedAllocations);
+
+    // ------------------------------------------------------------
+    // HEAPS
+    // ------------------------------------------------------------
+    if (ImGui::CollapsingHeader("Heaps"))
+    {
+        for (size_t i = 0; i < stats.heaps.size(); ++i)
+        {
+            const Mantrax::MemoryHeapInfo &heap = stats.heaps[i];
+            ImGui::Text("Heap %zu%s: %.0f / %.0f MB (size %.0f MB)", i, heap.deviceLocal ? " [device]" : "",
+                        ToMB(heap.usage), ToMB(heap.budget), ToMB(heap.size));
+        }
+    }
+
+    // ------------------------------------------------------------
+    // AJUSTES
+    // ------------------------------------------------------------
+    if (ImGui::CollapsingHeader("Budget", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        Mantrax::MemoryBudgetSettings settings = gfx.GetMemoryBudgetSettings();
+        bool changed = false;
+
+        int budgetMB = static_cast<int>(settings.budgetBytes / (1024 * 1024));
+        if (ImGui::DragInt("Budget (MB, 0 = auto)", &budgetMB, 16.0f, 0, 65536))
+        {
+            settings.budgetBytes = static_cast<uint64_t>(budgetMB) * 1024 * 1024;
+            changed = true;
+        }
+        changed |= ImGui::SliderFloat("Driver budget fraction", &settings.budgetFraction, 0.1f, 1.0f, "%.2f");
+        changed |= ImGui::Checkbox("Fall back to system memory", &settings.allowHostFallback);
+
+        if (changed)
+            gfx.SetMemoryBudgetSettings(settings);
+    }
+
+    if (ImGui::CollapsingHeader("Texture streaming"))
+    {
+        Mantrax::TextureStreamingSettings settings = gfx.GetTextureStreamingSettings();
+        const Mantrax::TextureStreamingStats &streaming = gfx.GetTextureStreamingStats();
+        bool changed = false;
+
+        changed |= ImGui::Checkbox("Enabled", &settings.enabled);
+
+        int budgetMB = static_cast<int>(settings.budgetBytes / (1024 * 1024));
+        if (ImGui::DragInt("Pool (MB)", &budgetMB, 8.0f, 16, 16384))
+        {
+            settings.budgetBytes = static_cast<uint64_t>(budgetMB) * 1024 * 1024;
+            changed = true;
+        }
+
+        if (changed)
+            gfx.SetTextureStreamingSettings(settings);
+
+        ImGui::Text("Textures: %u | Resident %.1f / %.1f MB", streaming.streamedTextures,
+                    ToMB(streaming.residentBytes), ToMB(streaming.fullBytes));
+        ImGui::Text("Uploads %u | Evictions %u | Pending %u", streaming.uploads, streaming.evictions,
+                    streaming.pendingRequests);
+    }
+
+    ImGui::End();
+}
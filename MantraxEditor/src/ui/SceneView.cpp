@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -53,7 +54,13 @@ void SceneView::OnRender()
     if (HasValidRenderTarget())
     {
         ImVec2 imageSize((float)width, (float)height);
-        ImGui::Image(renderID, imageSize);
+
+        // Resolución dinámica: solo se muestra el sub-rectángulo renderizado, escalado al panel
+        ImVec2 uvMax(1.0f, 1.0f);
+        if (HasValidFramebuffer())
+            uvMax = ImVec2(framebuffer->GetUVMaxX(), framebuffer->GetUVMaxY());
+
+        ImGui::Image(renderID, imageSize, ImVec2(0.0f, 0.0f), uvMax);
 
         ImVec2 imageMin = ImGui::GetItemRectMin();
         ImVec2 imageMax = ImGui::GetItemRectMax();
@@ -70,6 +77,42 @@ void SceneView::OnRender()
                 imageMax);
         }
 
+        // Overlay con los contadores de culling
+        if (sceneRenderer)
+        {
+            const auto &stats = sceneRenderer->GetCullingStats();
+            uint32_t renderWidth = HasValidFramebuffer() ? framebuffer->renderExtent.width : width;
+            uint32_t renderHeight = HasValidFramebuffer() ? framebuffer->renderExtent.height : height;
+
+            char overlay[192];
+            snprintf(overlay, sizeof(overlay),
+                     "Drawn %u/%u | Frustum -%u | HiZ -%u/%u | Meshlets %u | %ux%u",
+                     stats.drawn, stats.submitted, stats.frustumRejected,
+                     stats.occlusionRejected, stats.occlusionTested, stats.meshletObjects,
+                     renderWidth, renderHeight);
+
+            ImGui::GetWindowDrawList()->AddText(
+                ImVec2(imageMin.x + 8.0f, imageMin.y + 8.0f),
+                IM_COL32(255, 255, 255, 200),
+                overlay);
+
+            const auto &streaming = sceneRenderer->GetTextureStreamingStats();
+            if (streaming.streamedTextures > 0)
+            {
+                snprintf(overlay, sizeof(overlay),
+                         "Textures %u | VRAM %.1f/%.1f MB | Up %u Evict %u | Pending %u",
+                         streaming.streamedTextures,
+                         streaming.residentBytes / (1024.0 * 1024.0),
+                         streaming.fullBytes / (1024.0 * 1024.0),
+                         streaming.uploads, streaming.evictions, streaming.pendingRequests);
+
+                ImGui::GetWindowDrawList()->AddText(
+                    ImVec2(imageMin.x + 8.0f, imageMin.y + 8.0f + ImGui::GetTextLineHeightWithSpacing()),
+                    IM_COL32(255, 255, 255, 200),
+                    overlay);
+            }
+        }
+
         isHovered = ImGui::IsItemHovered();
         isFocused = ImGui::IsWindowFocused();
     }
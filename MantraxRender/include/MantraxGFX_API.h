@@ -8,7 +8,10 @@
 #include <vulkan/vulkan_win32.h>
 #elif defined(__linux__)
 #include <vulkan/vulkan.h>
-#include <X11/Xlib.h>
+// Sin backend de ventana en Linux: handles opacos para que compilen las herramientas offline
+// (mantrax-cook), que solo usan los tipos de CPU. Xlib no: su macro None choca con los enums
+typedef void *HINSTANCE;
+typedef void *HWND;
 #else
 #error "Plataforma no soportada"
 #endif
@@ -25,11 +28,22 @@
 #include <iostream>
 #include <functional>
 #include <array>
+#include <chrono>
+#include <deque>
 
 #include <glm/glm.hpp>
 #include <algorithm>
+#include <cmath>
 
 #include "../../MantraxECS/include/EngineLoaderDLL.h"
+#include "MantraxGFX_Culling.h"
+#include "MantraxGFX_Lighting.h"
+#include "MantraxGFX_Texture.h"
+#include "MantraxGFX_DynamicResolution.h"
+#include "MantraxGFX_DeletionQueue.h"
+#include "MantraxGFX_Memory.h"
+#include "MantraxGFX_RenderGraph.h"
+#include "MantraxGFX_Timer.h"
 
 namespace Mantrax
 {
@@ -91,6 +105,77 @@ namespace Mantrax
         float cameraPosition[4];
     };
 
+    // Rango de índices de un nivel de detalle dentro del index buffer del mesh
+    struct MANTRAX_API MeshLOD
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        float error = 0.0f; // Error geométrico en espacio objeto
+    };
+
+    // Índices de un LOD generado en CPU (comparten el vertex buffer del LOD0)
+    struct MANTRAX_API MeshLODData
+    {
+        std::vector<uint32_t> indices;
+        float error = 0.0f;
+    };
+
+    // Rango del LOD0 con un solo material. materialSlot es el índice de material del archivo
+    // importado; sus LODs son Mesh::submeshLODs[firstLOD, firstLOD + lodCount) (el primero,
+    // su propio rango del LOD0). Layout fijo: se guarda tal cual en el .mxmesh
+    struct MANTRAX_API MeshSubmesh
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        uint32_t materialSlot = 0;
+        uint32_t firstLOD = 0;
+        uint32_t lodCount = 0; // 0 = sin LODs
+        uint32_t reserved = 0;
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+    };
+
+    // Solo CPU: los usa Mesh y el import sin GPU (MeshImporter)
+    inline void ComputeMeshBounds(const std::vector<Vertex> &vertices, glm::vec3 &boundsMin, glm::vec3 &boundsMax)
+    {
+        if (vertices.empty())
+        {
+            boundsMin = boundsMax = glm::vec3(0.0f);
+            return;
+        }
+
+        boundsMin = boundsMax = glm::vec3(vertices[0].position[0], vertices[0].position[1], vertices[0].position[2]);
+        for (const auto &v : vertices)
+        {
+            glm::vec3 p(v.position[0], v.position[1], v.position[2]);
+            boundsMin = glm::min(boundsMin, p);
+            boundsMax = glm::max(boundsMax, p);
+        }
+    }
+
+    // Ver Mesh::uvDensity
+    inline float ComputeMeshUVDensity(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices)
+    {
+        double uvArea = 0.0, surfaceArea = 0.0;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const Vertex &a = vertices[indices[i]];
+            const Vertex &b = vertices[indices[i + 1]];
+            const Vertex &c = vertices[indices[i + 2]];
+
+            glm::vec3 pa(a.position[0], a.position[1], a.position[2]);
+            glm::vec3 e0 = glm::vec3(b.position[0], b.position[1], b.position[2]) - pa;
+            glm::vec3 e1 = glm::vec3(c.position[0], c.position[1], c.position[2]) - pa;
+            surfaceArea += 0.5 * glm::length(glm::cross(e0, e1));
+
+            glm::vec2 t0(b.texCoord[0] - a.texCoord[0], b.texCoord[1] - a.texCoord[1]);
+            glm::vec2 t1(c.texCoord[0] - a.texCoord[0], c.texCoord[1] - a.texCoord[1]);
+            uvArea += 0.5 * std::abs(t0.x * t1.y - t0.y * t1.x);
+        }
+
+        return surfaceArea > 0.0 ? static_cast<float>(std::sqrt(uvArea / surfaceArea)) : 0.0f;
+    }
+
     class MANTRAX_API Mesh
     {
     public:
@@ -106,12 +191,122 @@ namespace Mantrax
         VkBuffer uniformBuffer = VK_NULL_HANDLE;
         VkDeviceMemory uniformBufferMemory = VK_NULL_HANDLE;
         VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        uint64_t textureGeneration = 0; // Suma de Texture::generation al escribir descriptorSet
+
+        // AABB en espacio local (para frustum / HiZ culling)
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+
+        // Unidades UV por unidad local (raíz de área UV / área de superficie); 0 = sin UVs
+        float uvDensity = 0.0f;
+
+        // LODs: índices extra concatenados tras 'indices' en el index buffer.
+        // lods vacío = solo LOD0 (todo 'indices').
+        std::vector<uint32_t> lodIndices;
+        std::vector<MeshLOD> lods;
+        uint32_t activeLOD = 0;
+
+        // Submeshes por material (vacío o uno solo = todo el mesh con un material). Con varios,
+        // los LODs se generan por submesh y 'lods' solo tiene el LOD0 completo
+        std::vector<MeshSubmesh> submeshes;
+        std::vector<MeshLOD> submeshLODs;
+
+        // Meshlets del LOD0 + buffers del culling por cluster en GPU
+        std::vector<Meshlet> meshlets;
+        VkBuffer meshletBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory meshletBufferMemory = VK_NULL_HANDLE;
+        VkBuffer drawCommandBuffer = VK_NULL_HANDLE; // VkDrawIndexedIndirectCommand por meshlet
+        VkDeviceMemory drawCommandBufferMemory = VK_NULL_HANDLE;
+        VkDescriptorSet meshletDescriptorSet = VK_NULL_HANDLE;
+
+        // Al destruirse, los handles van a la cola diferida del GFX que lo creó
+        std::shared_ptr<DeletionQueue> deletionQueue;
+
+        // Instancia (GFX::CreateMeshInstance): vertex / index / meshlets son de este mesh, que
+        // vive mientras quede alguna instancia. UBO, descriptor sets y draws indirectos son propios
+        std::shared_ptr<Mesh> geometrySource;
+
+        // Submesh de un objeto (GFX::CreateSubmeshMesh): usa el UBO de este mesh en vez de uno propio
+        std::shared_ptr<Mesh> transformSource;
 
         Mesh() = default;
         Mesh(const std::vector<Vertex> &verts, const std::vector<uint32_t> &inds)
-            : vertices(verts), indices(inds) {}
+            : vertices(verts), indices(inds)
+        {
+            ComputeBounds();
+            ComputeUVDensity();
+        }
+        ~Mesh();
+
+        Mesh(const Mesh &) = delete;
+        Mesh &operator=(const Mesh &) = delete;
+
+        void ComputeBounds() { ComputeMeshBounds(vertices, boundsMin, boundsMax); }
+        void ComputeUVDensity() { uvDensity = ComputeMeshUVDensity(vertices, indices); }
+
+        void AddLOD(const std::vector<uint32_t> &lodIdx, float error)
+        {
+            if (lods.empty())
+                lods.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+
+            MeshLOD lod;
+            lod.firstIndex = static_cast<uint32_t>(indices.size() + lodIndices.size());
+            lod.indexCount = static_cast<uint32_t>(lodIdx.size());
+            lod.error = error;
+            lods.push_back(lod);
+
+            lodIndices.insert(lodIndices.end(), lodIdx.begin(), lodIdx.end());
+        }
+
+        // Transform con el que se dibuja (el del objeto si es un submesh)
+        const UniformBufferObject &GetTransformUBO() const { return transformSource ? transformSource->ubo : ubo; }
+
+        uint32_t GetLODCount() const { return lods.empty() ? 1u : static_cast<uint32_t>(lods.size()); }
+        bool HasMeshlets() const { return !meshlets.empty() && meshletBuffer != VK_NULL_HANDLE; }
+        uint32_t GetFirstIndex() const { return lods.empty() ? 0u : lods[activeLOD].firstIndex; }
+        uint32_t GetIndexCount() const
+        {
+            return lods.empty() ? static_cast<uint32_t>(indices.size()) : lods[activeLOD].indexCount;
+        }
     };
 
+    // Geometría final en memoria ajena (ej. un .mxmesh mapeado): va directa al staging y el
+    // Mesh no guarda copia en CPU. 'indices' es el LOD0 seguido de los LODs (rangos en 'lods')
+    struct MANTRAX_API MeshSource
+    {
+        const Vertex *vertices = nullptr;
+        uint32_t vertexCount = 0;
+        const uint32_t *indices = nullptr;
+        uint32_t indexCount = 0;
+        const MeshLOD *lods = nullptr; // nullptr = solo LOD0 con todos los índices
+        uint32_t lodCount = 0;
+        const Meshlet *meshlets = nullptr;
+        uint32_t meshletCount = 0;
+        const MeshSubmesh *submeshes = nullptr;
+        uint32_t submeshCount = 0;
+        const MeshLOD *submeshLODs = nullptr;
+        uint32_t submeshLODCount = 0;
+
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+        float uvDensity = 0.0f;
+    };
+
+    // Constante de especialización (escalar de 32 bits: bool/int/uint, o float por bits)
+    struct MANTRAX_API SpecializationConstant
+    {
+        uint32_t constantID = 0;
+        uint32_t value = 0;
+    };
+
+    // Features del material: bit i = constant_id i en el fragment shader (ver pbr.frag)
+    constexpr uint32_t MATERIAL_FEATURE_ALBEDO_MAP = 1u << 0;
+    constexpr uint32_t MATERIAL_FEATURE_NORMAL_MAP = 1u << 1;
+    constexpr uint32_t MATERIAL_FEATURE_METALLIC_MAP = 1u << 2;
+    constexpr uint32_t MATERIAL_FEATURE_ROUGHNESS_MAP = 1u << 3;
+    constexpr uint32_t MATERIAL_FEATURE_AO_MAP = 1u << 4;
+    constexpr uint32_t MATERIAL_FEATURE_COUNT = 5;
+
     struct MANTRAX_API ShaderConfig
     {
         std::string vertexShaderPath;
@@ -127,6 +322,13 @@ namespace Mantrax
         bool depthWriteEnable = true;
         bool depthTestEnable = true;
         bool blendEnable = true;
+
+        // Se aplican a vertex y fragment (un ID que el stage no declara se ignora)
+        std::vector<SpecializationConstant> specializationConstants;
+
+        // Un pipeline por máscara de features del material: las constantes
+        // 0..MATERIAL_FEATURE_COUNT-1 se fijan según sus texturas (shader sin ramas)
+        bool materialVariants = false;
     };
 
     class MANTRAX_API Shader
@@ -137,8 +339,18 @@ namespace Mantrax
         VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
         ShaderConfig config;
 
+        // Variantes compiladas bajo demanda (máscara → pipeline); la máscara 0 es 'pipeline'
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        std::unordered_map<uint32_t, VkPipeline> variants;
+
+        std::shared_ptr<DeletionQueue> deletionQueue;
+
         Shader() = default;
         Shader(const ShaderConfig &cfg) : config(cfg) {}
+        ~Shader();
+
+        Shader(const Shader &) = delete;
+        Shader &operator=(const Shader &) = delete;
     };
 
     class MANTRAX_API Texture
@@ -148,10 +360,91 @@ namespace Mantrax
         VkDeviceMemory memory = VK_NULL_HANDLE;
         VkImageView imageView = VK_NULL_HANDLE;
         VkSampler sampler = VK_NULL_HANDLE;
+        VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
         uint32_t width = 0;
         uint32_t height = 0;
+        uint32_t mipLevels = 1;
+        bool cubemap = false; // 6 capas, view VK_IMAGE_VIEW_TYPE_CUBE
+
+        // Streaming (GFX::CreateStreamedTexture): la imagen guarda los mips [residentMip, mipLevels)
+        // de streamSource; width/height/mipLevels describen la textura completa
+        uint32_t residentMip = 0;
+        uint32_t generation = 0; // Cambia cada vez que se reemplaza la imagen
+        std::shared_ptr<const TextureImageData> streamSource;
+
+        std::shared_ptr<DeletionQueue> deletionQueue;
 
         Texture() = default;
+        ~Texture();
+
+        Texture(const Texture &) = delete;
+        Texture &operator=(const Texture &) = delete;
+    };
+
+    // Compute: binding i del descriptor set = bindings[i]
+    struct MANTRAX_API ComputeShaderConfig
+    {
+        std::string computeShaderPath;
+        std::vector<VkDescriptorType> bindings;
+        uint32_t pushConstantSize = 0;
+    };
+
+    class MANTRAX_API ComputeShader
+    {
+    public:
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        std::vector<VkDescriptorSet> descriptorSets; // Creados con CreateComputeDescriptorSet
+        ComputeShaderConfig config;
+
+        std::shared_ptr<DeletionQueue> deletionQueue;
+
+        ComputeShader() = default;
+        ComputeShader(const ComputeShaderConfig &cfg) : config(cfg) {}
+        ~ComputeShader();
+
+        ComputeShader(const ComputeShader &) = delete;
+        ComputeShader &operator=(const ComputeShader &) = delete;
+    };
+
+    // SSBO para compute; hostVisible = mapeado de forma persistente en 'mapped'
+    class MANTRAX_API StorageBuffer
+    {
+    public:
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        void *mapped = nullptr;
+
+        std::shared_ptr<DeletionQueue> deletionQueue;
+
+        StorageBuffer() = default;
+        ~StorageBuffer();
+
+        StorageBuffer(const StorageBuffer &) = delete;
+        StorageBuffer &operator=(const StorageBuffer &) = delete;
+    };
+
+    // Imagen de almacenamiento: vive en GENERAL (escritura en compute, muestreo en gráficos)
+    class MANTRAX_API StorageImage
+    {
+    public:
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView imageView = VK_NULL_HANDLE;
+        VkSampler sampler = VK_NULL_HANDLE;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        std::shared_ptr<DeletionQueue> deletionQueue;
+
+        StorageImage() = default;
+        ~StorageImage();
+
+        StorageImage(const StorageImage &) = delete;
+        StorageImage &operator=(const StorageImage &) = delete;
     };
 
     struct MANTRAX_API MaterialPushConstants
@@ -239,6 +532,36 @@ namespace Mantrax
         {
             pushConstants.normalScale = s;
         }
+
+        // Cambia cuando el streaming reemplaza la imagen de alguna textura
+        uint64_t GetTextureGeneration() const
+        {
+            uint64_t generation = 0;
+            for (const auto *tex : {pbrTextures.albedo.get(), pbrTextures.normal.get(), pbrTextures.metallic.get(),
+                                    pbrTextures.roughness.get(), pbrTextures.ao.get()})
+            {
+                if (tex)
+                    generation += tex->generation;
+            }
+            return generation;
+        }
+
+        // Clave de la variante de pipeline (ShaderConfig::materialVariants)
+        uint32_t GetFeatureMask() const
+        {
+            uint32_t mask = 0;
+            if (pushConstants.useAlbedoMap)
+                mask |= MATERIAL_FEATURE_ALBEDO_MAP;
+            if (pushConstants.useNormalMap)
+                mask |= MATERIAL_FEATURE_NORMAL_MAP;
+            if (pushConstants.useMetallicMap)
+                mask |= MATERIAL_FEATURE_METALLIC_MAP;
+            if (pushConstants.useRoughnessMap)
+                mask |= MATERIAL_FEATURE_ROUGHNESS_MAP;
+            if (pushConstants.useAOMap)
+                mask |= MATERIAL_FEATURE_AO_MAP;
+            return mask;
+        }
     };
 
     struct MANTRAX_API RenderObject
@@ -246,15 +569,64 @@ namespace Mantrax
         std::shared_ptr<Mesh> mesh;
         std::shared_ptr<Material> material;
 
+        // false para objetos que no siguen su AABB (ej. skybox centrado en la cámara)
+        bool enableCulling = true;
+
         RenderObject() = default;
         RenderObject(std::shared_ptr<Mesh> m, std::shared_ptr<Material> mat)
             : mesh(m), material(mat) {}
     };
 
+    // Modo de presentación pedido; si la surface no lo soporta se usa el siguiente de la lista
+    enum class PresentMode : uint32_t
+    {
+        VSync,     // FIFO: sin tearing, los frames se encolan (más latencia)
+        Mailbox,   // MAILBOX → FIFO: sin tearing y sin cola
+        Immediate, // IMMEDIATE → MAILBOX → FIFO: mínima latencia, con tearing
+    };
+
+    // Pacing: espera en CPU antes de muestrear input para no acumular frames en cola
+    struct MANTRAX_API FramePacingSettings
+    {
+        bool enabled = true;
+        uint32_t maxQueuedFrames = 1; // Frames presentados pendientes al empezar uno nuevo (con present_wait)
+        float targetFrameRate = 0.0f; // 0 = sin límite
+    };
+
     struct MANTRAX_API GFXConfig
     {
         bool enableValidation = false;
         VkClearColorValue clearColor = {0.1f, 0.1f, 0.1f, 1.0f};
+        PresentMode presentMode = PresentMode::Mailbox;
+        uint32_t swapchainImageCount = 0; // 0 = minImageCount + 1 (se ajusta a los límites de la surface)
+    };
+
+    // Pirámide de profundidad (max) construida por compute desde el depth del offscreen
+    class MANTRAX_API HiZPyramid
+    {
+    public:
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        std::vector<VkImageView> mipViews;
+        std::vector<VkDescriptorSet> mipDescriptorSets; // Uno por nivel: origen → destino
+        VkSampler sampler = VK_NULL_HANDLE;
+
+        VkExtent2D extent = {0, 0}; // Tamaño del nivel 0 (mitad del depth asignado)
+        uint32_t mipLevels = 0;
+
+        // Niveles gruesos copiados a CPU para el test de oclusión del siguiente frame
+        VkBuffer readbackBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory readbackMemory = VK_NULL_HANDLE;
+        void *readbackMapped = nullptr;
+        HiZReadback readback;
+
+        std::shared_ptr<DeletionQueue> deletionQueue;
+
+        HiZPyramid() = default;
+        ~HiZPyramid();
+
+        HiZPyramid(const HiZPyramid &) = delete;
+        HiZPyramid &operator=(const HiZPyramid &) = delete;
     };
 
     class MANTRAX_API OffscreenFramebuffer
@@ -274,11 +646,47 @@ namespace Mantrax
         VkDescriptorSet renderID = VK_NULL_HANDLE;
         VkSampler sampler = VK_NULL_HANDLE;
 
-        VkExtent2D extent = {0, 0};
+        // Quien registra renderID (ej. ImGui_ImplVulkan_RemoveTexture) indica cómo liberarlo
+        std::function<void(VkDescriptorSet)> releaseRenderID;
+
+        VkExtent2D extent = {0, 0};       // Tamaño asignado de las imágenes
+        VkExtent2D renderExtent = {0, 0}; // Sub-rectángulo que se renderiza (resolución dinámica)
         VkFormat colorFormat = VK_FORMAT_R8G8B8A8_UNORM;
         VkFormat depthFormat = VK_FORMAT_D32_SFLOAT;
 
+        std::shared_ptr<HiZPyramid> hiz;
+
+        std::shared_ptr<DeletionQueue> deletionQueue;
+
         OffscreenFramebuffer() = default;
+        ~OffscreenFramebuffer();
+
+        OffscreenFramebuffer(const OffscreenFramebuffer &) = delete;
+        OffscreenFramebuffer &operator=(const OffscreenFramebuffer &) = delete;
+
+        // Entrega imágenes, vistas y framebuffer a la cola (resize / destrucción)
+        void RetireAttachments();
+        // Libera renderID cuando termine el frame que aún lo muestra
+        void RetireRenderID();
+
+        // UV máximo del sub-rectángulo renderizado, para componer solo esa zona
+        float GetUVMaxX() const
+        {
+            return extent.width ? static_cast<float>(renderExtent.width) / static_cast<float>(extent.width) : 1.0f;
+        }
+        float GetUVMaxY() const
+        {
+            return extent.height ? static_cast<float>(renderExtent.height) / static_cast<float>(extent.height) : 1.0f;
+        }
+    };
+
+    // Pool de render targets offscreen: tamaños redondeados por bucket para reutilizar
+    // imágenes al redimensionar en vez de recrearlas
+    struct MANTRAX_API RenderTargetPoolSettings
+    {
+        uint32_t bucketGranularity = 128; // Ancho/alto redondeados hacia arriba a múltiplos
+        uint32_t maxFreeTargets = 4;      // Targets libres retenidos
+        uint32_t maxIdleFrames = 300;     // Frames sin uso antes de liberar un target libre
     };
 
     struct MANTRAX_API RenderPassConfig
@@ -321,6 +729,17 @@ namespace Mantrax
         GFX(HINSTANCE hInstance, HWND hWnd, const Config &config = Config{});
         ~GFX();
         std::shared_ptr<Texture> CreateTexture(unsigned char *data, int width, int height, VkFilter TextureFilter = VK_FILTER_LINEAR);
+        // Sube todos los mips de la imagen en su formato (RGBA8, BC1/3/5/7, ASTC 4x4).
+        // Lanza si el dispositivo no soporta el formato (ver IsTextureFormatSupported)
+        std::shared_ptr<Texture> CreateTexture(const TextureImageData &image, VkFilter TextureFilter = VK_FILTER_LINEAR);
+        bool IsTextureFormatSupported(VkFormat format) const;
+        // Sube solo la cola de mips; RenderToOffscreenFramebuffer pide los mips altos según el
+        // tamaño en pantalla de los objetos visibles y los descarga si se pasa del presupuesto
+        std::shared_ptr<Texture> CreateStreamedTexture(std::shared_ptr<const TextureImageData> image,
+                                                       VkFilter TextureFilter = VK_FILTER_LINEAR);
+        void SetTextureStreamingSettings(const TextureStreamingSettings &settings) { m_TextureStreamingSettings = settings; }
+        const TextureStreamingSettings &GetTextureStreamingSettings() const { return m_TextureStreamingSettings; }
+        const TextureStreamingStats &GetTextureStreamingStats() const { return m_TextureStreamingStats; }
         void SetMaterialTexture(std::shared_ptr<Material> material, std::shared_ptr<Texture> texture);
 
         std::shared_ptr<OffscreenFramebuffer> CreateOffscreenFramebuffer(uint32_t width, uint32_t height);
@@ -330,6 +749,39 @@ namespace Mantrax
         void RenderToOffscreenFramebuffer(std::shared_ptr<OffscreenFramebuffer> offscreen,
                                           const std::vector<RenderObject> &objects);
 
+        // Culling: frustum con la cámara actual + HiZ del frame anterior (conservador)
+        void EnableHiZOcclusion(const std::string &computeShaderPath);
+        void SetHiZOcclusionEnabled(bool enabled) { m_HiZEnabled = enabled; }
+        bool IsHiZOcclusionEnabled() const { return m_HiZEnabled && m_HiZPipeline != VK_NULL_HANDLE; }
+        void SetCullingCamera(const glm::mat4 &view, const glm::mat4 &projection);
+        const CullingStats &GetCullingStats() const { return m_CullingStats; }
+
+        // Culling por meshlet en compute + draws indirectos (sin el .spv: draws indexados normales)
+        void EnableMeshletCulling(const std::string &computeShaderPath);
+        void SetMeshletCullingEnabled(bool enabled) { m_MeshletCullingEnabled = enabled; }
+        bool IsMeshletCullingEnabled() const { return m_MeshletCullingEnabled && m_MeshletPipeline != VK_NULL_HANDLE; }
+
+        // Luces dinámicas: el shader PBR lee el set 1 (luces + listas por cluster).
+        // Con light_cull.comp cada fragmento recorre solo las luces de su cluster;
+        // sin el .spv recorre todas (válido para pocas luces)
+        void EnableClusteredLighting(const std::string &computeShaderPath);
+        bool IsClusteredLightingEnabled() const { return m_LightCullShader != nullptr; }
+        void SetLights(const std::vector<GPULight> &lights) { m_Lights = lights; }
+        // Recrea los buffers de la rejilla (espera a la GPU)
+        void SetClusterSettings(const ClusterSettings &settings);
+        const ClusterSettings &GetClusterSettings() const { return m_ClusterSettings; }
+        const LightingStats &GetLightingStats() const { return m_LightingStats; }
+
+        // Cielo: un triángulo a pantalla completa tras los opacos de RenderToOffscreenFramebuffer,
+        // a depth 1.0 sin escribir (los píxeles cubiertos por geometría fallan el depth test)
+        void EnableSky(const std::string &vertexShaderPath, const std::string &fragmentShaderPath);
+        // data: por mip, las 6 caras (+X, -X, +Y, -Y, +Z, -Z) en RGBA8
+        std::shared_ptr<Texture> CreateCubemap(const unsigned char *data, uint32_t faceSize, uint32_t mipLevels);
+        void SetSkyCubemap(std::shared_ptr<Texture> cubemap);
+        void SetSkyTint(const glm::vec3 &tint) { m_SkyTint = tint; }
+        void SetSkyEnabled(bool enabled) { m_SkyEnabled = enabled; }
+        bool IsSkyEnabled() const { return m_SkyEnabled && m_SkyPipeline != VK_NULL_HANDLE && m_SkyCubemap != nullptr; }
+
         std::shared_ptr<Texture> CreateDefaultWhiteTexture();
 
         std::shared_ptr<Texture> CreateDefaultNormalTexture();
@@ -345,16 +797,116 @@ namespace Mantrax
 
         void DestroyOffscreenFramebuffer(std::shared_ptr<OffscreenFramebuffer> offscreen);
 
+        // Pool de render targets: Acquire devuelve un target de tamaño bucket con
+        // renderExtent = (width, height); Release lo devuelve al pool tras su fence
+        std::shared_ptr<OffscreenFramebuffer> AcquireOffscreenFramebuffer(uint32_t width, uint32_t height);
+        void ReleaseOffscreenFramebuffer(std::shared_ptr<OffscreenFramebuffer> offscreen);
+        // Resize sin esperas: conserva el target si cabe, si no cambia a otro del pool
+        // (el nuevo está listo antes de soltar el viejo)
+        std::shared_ptr<OffscreenFramebuffer> ResizeOffscreenPooled(std::shared_ptr<OffscreenFramebuffer> current,
+                                                                    uint32_t width, uint32_t height);
+        void SetRenderTargetPoolSettings(const RenderTargetPoolSettings &settings) { m_RenderTargetPoolSettings = settings; }
+        const RenderTargetPoolSettings &GetRenderTargetPoolSettings() const { return m_RenderTargetPoolSettings; }
+        size_t GetFreeRenderTargetCount() const { return m_FreeRenderTargets.size(); }
+        void ClearRenderTargetPool();
+
+        // Resolución dinámica: renderiza en un sub-rectángulo del offscreen sin realocar
+        void SetOffscreenRenderExtent(std::shared_ptr<OffscreenFramebuffer> offscreen,
+                                      uint32_t width, uint32_t height);
+        // Tiempo de GPU del último RenderToOffscreenFramebuffer (0 sin timestamps)
+        float GetOffscreenGPUTimeMs() const { return m_OffscreenGPUTimeMs; }
+        bool HasGPUTimestamps() const { return m_TimestampQueryPool != VK_NULL_HANDLE; }
+
+        // Compute: pipeline y descriptor layout propios por shader
+        std::shared_ptr<ComputeShader> CreateComputeShader(const ComputeShaderConfig &config);
+        VkDescriptorSet CreateComputeDescriptorSet(std::shared_ptr<ComputeShader> shader);
+        void BindStorageBuffer(VkDescriptorSet set, uint32_t binding, std::shared_ptr<StorageBuffer> buffer);
+        void BindStorageImage(VkDescriptorSet set, uint32_t binding, std::shared_ptr<StorageImage> image);
+        void BindSampledImage(VkDescriptorSet set, uint32_t binding, std::shared_ptr<StorageImage> image);
+        void BindSampledTexture(VkDescriptorSet set, uint32_t binding, std::shared_ptr<Texture> texture);
+
+        // extraUsage: ej. VERTEX_BUFFER o INDIRECT_BUFFER para consumirlo en gráficos
+        std::shared_ptr<StorageBuffer> CreateStorageBuffer(VkDeviceSize size, VkBufferUsageFlags extraUsage = 0,
+                                                           bool hostVisible = false);
+        std::shared_ptr<StorageImage> CreateStorageImage(uint32_t width, uint32_t height,
+                                                         VkFormat format = VK_FORMAT_R16G16B16A16_SFLOAT);
+
+        // Se graba en el command buffer del próximo frame, antes del render pass, con un
+        // barrier compute → gráficos (vertex input, indirect, shaders) tras el último dispatch
+        void Dispatch(std::shared_ptr<ComputeShader> shader, VkDescriptorSet set,
+                      uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1,
+                      const void *pushConstants = nullptr, uint32_t pushConstantSize = 0);
+
+        // Async compute: se envía a la cola de compute tras el submit gráfico del frame y
+        // se solapa con su raster; el resultado lo ve el siguiente frame (semáforo entre colas).
+        // ⚠️ No escribir recursos que lea el frame en curso (usar doble buffer).
+        // Sin familia de compute dedicada equivale a Dispatch.
+        void DispatchAsync(std::shared_ptr<ComputeShader> shader, VkDescriptorSet set,
+                           uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1,
+                           const void *pushConstants = nullptr, uint32_t pushConstantSize = 0);
+        bool HasAsyncCompute() const { return m_ComputeQueueFamily != m_GraphicsQueueFamily; }
+        uint32_t GetComputeQueueFamily() const { return m_ComputeQueueFamily; }
+
+        // Render graph del viewport: el callback añade pases (post-proceso, depth pre-pass...)
+        // sobre el color y el depth antes de compilar; se invoca en cada RenderToOffscreenFramebuffer
+        using OffscreenGraphCallback = std::function<void(RenderGraph &, RGResource color, RGResource depth)>;
+        void SetOffscreenGraphCallback(OffscreenGraphCallback callback) { m_OffscreenGraphCallback = std::move(callback); }
+        const RenderGraphStats &GetOffscreenGraphStats() const { return m_OffscreenGraphStats; }
+
+        // Presentación: se aplica recreando el swapchain en el próximo DrawFrame
+        void SetPresentMode(PresentMode mode);
+        void SetSwapchainImageCount(uint32_t count);
+        VkPresentModeKHR GetActivePresentMode() const { return m_ActivePresentMode; }
+        uint32_t GetSwapchainImageCount() const { return static_cast<uint32_t>(m_SwapchainImages.size()); }
+        bool SupportsPresentWait() const { return m_SupportsPresentWait; }
+
+        // Llamar al inicio del frame, antes de procesar input: espera a que el frame
+        // anterior se presente (VK_KHR_present_wait) o termine en GPU (fence) y
+        // registra la latencia input → present en el timer
+        void WaitForFramePacing(Timer *timer = nullptr);
+        void SetFramePacingSettings(const FramePacingSettings &settings) { m_FramePacing = settings; }
+        const FramePacingSettings &GetFramePacingSettings() const { return m_FramePacing; }
+
+        // Destrucción diferida por frame (sin vkDeviceWaitIdle)
+        std::shared_ptr<DeletionQueue> GetDeletionQueue() const { return m_DeletionQueue; }
+
+        // Presupuesto de VRAM: uso por categoría y desalojo LRU de las cachés que se registren
+        // (GetMemoryTracker()->RegisterEvictionHandler); el streaming de texturas ya lo está
+        std::shared_ptr<MemoryTracker> GetMemoryTracker() const { return m_MemoryTracker; }
+        void SetMemoryBudgetSettings(const MemoryBudgetSettings &settings) { m_MemoryTracker->SetSettings(settings); }
+        MemoryBudgetSettings GetMemoryBudgetSettings() const { return m_MemoryTracker->GetSettings(); }
+        MemoryStats GetMemoryStats() const { return m_MemoryTracker->GetStats(); }
+
         std::shared_ptr<Shader> CreateShader(const ShaderConfig &config);
 
         std::shared_ptr<Mesh> CreateMesh(const std::vector<Vertex> &vertices,
                                          const std::vector<uint32_t> &indices);
+        std::shared_ptr<Mesh> CreateMesh(const std::vector<Vertex> &vertices,
+                                         const std::vector<uint32_t> &indices,
+                                         const std::vector<MeshLODData> &lods,
+                                         const std::vector<Meshlet> &meshlets = {});
+        std::shared_ptr<Mesh> CreateMesh(const MeshSource &source);
+        // Otro objeto con la misma geometría: comparte los buffers de 'source' sin volver a subirlos
+        std::shared_ptr<Mesh> CreateMeshInstance(const std::shared_ptr<Mesh> &source);
+        // Un submesh de 'mesh' como mesh propio (otro RenderObject con su material): comparte la
+        // geometría y el UBO del objeto; bounds y LODs del submesh para culling y LOD por separado
+        std::shared_ptr<Mesh> CreateSubmeshMesh(const std::shared_ptr<Mesh> &mesh, uint32_t submeshIndex);
+
+        // Subidas agrupadas: entre Begin y End, CreateMesh / CreateTexture graban sus copias
+        // en un solo command buffer y End hace un único submit sin esperar: el staging se
+        // retira cuando la fence del lote señaliza (se pueden anidar)
+        void BeginUploadBatch();
+        void EndUploadBatch();
         void UpdateMeshUBO(Mesh *mesh, const UniformBufferObject &ubo);
         void CreateMeshDescriptorSet(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material);
         void UpdateMeshMaterialTextures(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material);
 
         std::shared_ptr<Material> CreateMaterial(std::shared_ptr<Shader> shader);
 
+        // Pipeline a enlazar para el material: la variante de su máscara de features
+        // (se compila la primera vez que se pide) o el pipeline base del shader
+        VkPipeline GetMaterialPipeline(const Material &material);
+
         std::shared_ptr<RenderPassObject> CreateRenderPass(const RenderPassConfig &config);
 
         void CreateFramebuffersForRenderPass(std::shared_ptr<RenderPassObject> renderPassObj,
@@ -424,6 +976,8 @@ namespace Mantrax
         uint32_t m_PresentQueueFamily;
         VkQueue m_GraphicsQueue;
         VkQueue m_PresentQueue;
+        uint32_t m_ComputeQueueFamily = UINT32_MAX; // == gráficos si no hay familia dedicada
+        VkQueue m_ComputeQueue = VK_NULL_HANDLE;
 
         VkImage m_DepthImage;
         VkDeviceMemory m_DepthImageMemory;
@@ -452,39 +1006,207 @@ namespace Mantrax
         std::vector<RenderObject> m_RenderObjects;
         bool m_NeedCommandBufferRebuild = false;
 
-        std::vector<std::shared_ptr<Shader>> m_AllShaders;
+        // weak_ptr: un shader que nadie usa se destruye y sus handles van a la cola
+        std::vector<std::weak_ptr<Shader>> m_AllShaders;
+
+        std::shared_ptr<DeletionQueue> m_DeletionQueue;
+
+        // Render targets libres (orden de liberación: el primero es el más viejo)
+        struct PooledRenderTarget
+        {
+            std::shared_ptr<OffscreenFramebuffer> target;
+            uint64_t releaseFrame = 0;
+        };
+        std::vector<PooledRenderTarget> m_FreeRenderTargets;
+        RenderTargetPoolSettings m_RenderTargetPoolSettings;
+
+        // HiZ occlusion culling
+        VkDescriptorSetLayout m_HiZDescriptorSetLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_HiZPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_HiZPipeline = VK_NULL_HANDLE;
+        bool m_HiZEnabled = false;
+        bool m_HasCullingCamera = false;
+        glm::mat4 m_CullingViewProj{1.0f};
+        glm::mat4 m_CullingView{1.0f};
+        glm::mat4 m_CullingProjection{1.0f};
+        glm::vec3 m_CullingCameraPos{0.0f};
+        glm::vec3 m_CullingViewDir{0.0f, 0.0f, -1.0f};
+        bool m_CullingOrthographic = false;
+        CullingStats m_CullingStats;
+
+        // Meshlet culling
+        VkDescriptorSetLayout m_MeshletDescriptorSetLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_MeshletPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_MeshletPipeline = VK_NULL_HANDLE;
+        bool m_MeshletCullingEnabled = false;
+        bool m_SupportsMultiDrawIndirect = false;
+        uint32_t m_MaxDrawIndirectCount = 1;
+
+        // Clustered lighting (set 1 de los pipelines gráficos)
+        VkDescriptorSetLayout m_LightingSetLayout = VK_NULL_HANDLE;
+        VkDescriptorSet m_LightingDescriptorSet = VK_NULL_HANDLE;
+        std::shared_ptr<StorageBuffer> m_ClusterParamsBuffer;
+        std::shared_ptr<StorageBuffer> m_LightBuffer;
+        std::shared_ptr<StorageBuffer> m_ClusterCountBuffer;
+        std::shared_ptr<StorageBuffer> m_ClusterIndexBuffer;
+        std::shared_ptr<ComputeShader> m_LightCullShader;
+        VkDescriptorSet m_LightCullSet = VK_NULL_HANDLE;
+        std::vector<GPULight> m_Lights;
+        ClusterSettings m_ClusterSettings;
+        LightingStats m_LightingStats;
+
+        // Cielo (cubemap muestreado por dirección de vista)
+        VkDescriptorSetLayout m_SkySetLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_SkyPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_SkyPipeline = VK_NULL_HANDLE;
+        VkDescriptorSet m_SkyDescriptorSet = VK_NULL_HANDLE;
+        std::shared_ptr<Texture> m_SkyCubemap;
+        glm::vec3 m_SkyTint{1.0f};
+        bool m_SkyEnabled = true;
+
+        // Streaming de texturas
+        struct StreamedTexture
+        {
+            std::weak_ptr<Texture> texture;
+            uint32_t requestedMip = UINT32_MAX; // Mínimo pedido este frame (UINT32_MAX = no visible)
+            uint64_t lastUsedFrame = 0;
+        };
+
+        // Copia staging → imagen nueva, grabada al inicio del command buffer del frame
+        struct PendingTextureUpload
+        {
+            VkImage image = VK_NULL_HANDLE;
+            uint32_t levelCount = 0;
+            VkBuffer stagingBuffer = VK_NULL_HANDLE;
+            VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+            std::vector<VkBufferImageCopy> regions;
+        };
+
+        TextureStreamingSettings m_TextureStreamingSettings;
+        TextureStreamingStats m_TextureStreamingStats;
+        std::vector<StreamedTexture> m_StreamedTextures;
+        std::vector<PendingTextureUpload> m_PendingTextureUploads;
+        bool m_StreamingDescriptorsDirty = false; // Hay imágenes reemplazadas con descriptor sets viejos
+        uint32_t m_StreamingEvictionHandler = 0;
+
+        // Memoria de dispositivo
+        std::shared_ptr<MemoryTracker> m_MemoryTracker;
+        bool m_SupportsMemoryBudget = false;
+        bool m_EvictingMemory = false; // Evita desalojos anidados (los handlers también allocan)
+
+        // Lote de subidas abierto (BeginUploadBatch): staging vivo hasta el submit
+        VkCommandBuffer m_UploadBatchCmd = VK_NULL_HANDLE;
+        uint32_t m_UploadBatchDepth = 0;
+        std::vector<std::pair<VkBuffer, VkDeviceMemory>> m_UploadBatchStaging;
+
+        // Lotes enviados sin esperar a la cola: cada uno con su fence y su staging
+        struct UploadBatch
+        {
+            VkCommandBuffer cmd = VK_NULL_HANDLE;
+            VkFence fence = VK_NULL_HANDLE;
+            std::vector<std::pair<VkBuffer, VkDeviceMemory>> staging;
+        };
+        std::vector<UploadBatch> m_InFlightUploadBatches;
+
+        // Timestamps del pase offscreen
+        VkQueryPool m_TimestampQueryPool = VK_NULL_HANDLE;
+        float m_TimestampPeriod = 0.0f; // ns por tick
+        uint64_t m_TimestampMask = ~0ull;
+        float m_OffscreenGPUTimeMs = 0.0f;
+
+        // Presentación y frame pacing
+        using PacingClock = std::chrono::steady_clock;
+        VkPresentModeKHR m_ActivePresentMode = VK_PRESENT_MODE_FIFO_KHR;
+        bool m_SupportsPresentWait = false;
+        PFN_vkWaitForPresentKHR m_vkWaitForPresentKHR = nullptr;
+        uint64_t m_PresentId = 0;                // Último id presentado (cuenta todos los presents)
+        uint64_t m_SwapchainFirstPresentId = 1; // Primer id presentado en el swapchain actual
+        FramePacingSettings m_FramePacing;
+        PacingClock::time_point m_InputSampleTime;
+        bool m_HasInputSample = false;
+        PacingClock::time_point m_NextFrameDeadline;
+        std::deque<std::pair<uint64_t, PacingClock::time_point>> m_PendingLatencies; // presentId → input
+
+        // Dispatches pendientes para el próximo frame
+        struct PendingDispatch
+        {
+            std::shared_ptr<ComputeShader> shader;
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            uint32_t groups[3] = {1, 1, 1};
+            std::vector<uint8_t> pushConstants;
+        };
+        std::vector<PendingDispatch> m_PendingDispatches;
+
+        // Async compute (familia dedicada)
+        std::vector<PendingDispatch> m_PendingAsyncDispatches;
+        VkCommandPool m_ComputeCommandPool = VK_NULL_HANDLE;
+        VkCommandBuffer m_ComputeCommandBuffer = VK_NULL_HANDLE;
+        VkSemaphore m_ComputeFinishedSemaphore = VK_NULL_HANDLE;
+        VkFence m_ComputeFence = VK_NULL_HANDLE;
+        bool m_ComputeSemaphorePending = false; // El próximo submit gráfico debe esperarlo
+        bool m_ComputeInFlight = false;
+
+        // Render graph del pase offscreen (conserva la memoria transitoria entre frames)
+        std::unique_ptr<RenderGraph> m_OffscreenGraph;
+        OffscreenGraphCallback m_OffscreenGraphCallback;
+        RenderGraphStats m_OffscreenGraphStats;
 
         void AddRenderObjectSafe(const RenderObject &obj);
 
     private:
         void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
+        // Staging → imagen (todas las regiones) y transición a SHADER_READ_ONLY
+        void UploadImageRegions(VkImage image, const void *data, VkDeviceSize size,
+                                const std::vector<VkBufferImageCopy> &regions,
+                                uint32_t mipLevels, uint32_t layerCount);
         void UpdateDescriptorSetWithTexture(std::shared_ptr<Material> material);
         static std::vector<char> ReadFile(const std::string &filename);
         void CreateImage(uint32_t width, uint32_t height, VkFormat format,
                          VkImageTiling tiling, VkImageUsageFlags usage,
                          VkMemoryPropertyFlags properties,
-                         VkImage &image, VkDeviceMemory &memory);
+                         VkImage &image, VkDeviceMemory &memory,
+                         uint32_t mipLevels = 1, bool shareWithCompute = false,
+                         uint32_t arrayLayers = 1, VkImageCreateFlags flags = 0);
         VkImageView CreateImageView(VkImage image, VkFormat format,
-                                    VkImageAspectFlags aspectFlags);
+                                    VkImageAspectFlags aspectFlags,
+                                    uint32_t baseMipLevel = 0, uint32_t levelCount = 1,
+                                    VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D, uint32_t layerCount = 1);
         VkRenderPass CreateOffscreenRenderPass(VkFormat colorFormat, VkFormat depthFormat);
         VkCommandBuffer BeginSingleTimeCommands();
-        void EndSingleTimeCommands(VkCommandBuffer cmd);
+        // waitAsyncCompute: el submit espera al compute asíncrono pendiente (lo consume)
+        void EndSingleTimeCommands(VkCommandBuffer cmd, bool waitAsyncCompute = false);
+        // Copias de subida: el command buffer del lote si hay uno abierto, si no uno propio
+        VkCommandBuffer BeginUploadCommands();
+        void EndUploadCommands(VkCommandBuffer cmd);
+        // Destruye el staging, o lo guarda hasta el submit del lote
+        void ReleaseStagingBuffer(VkBuffer buffer, VkDeviceMemory memory);
+        // Retira el staging de los lotes terminados (wait: espera a todos)
+        void CollectUploadBatches(bool wait = false);
         void TransitionImageLayout(VkImage image, VkFormat format,
                                    VkImageLayout oldLayout, VkImageLayout newLayout);
         void TransitionImageLayoutCmd(VkCommandBuffer cmd, VkImage image, VkFormat format,
                                       VkImageLayout oldLayout, VkImageLayout newLayout);
         VkShaderModule CreateShaderModule(const std::vector<char> &code);
         uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags props);
+        // vkAllocateMemory con presupuesto: desaloja cachés si no cabe y, si el driver se queda
+        // sin memoria, espera al device, libera lo retirado y cae a memoria del sistema
+        VkDeviceMemory AllocateMemory(const VkMemoryRequirements &reqs, VkMemoryPropertyFlags props,
+                                      MemoryCategory category);
+        void FreeMemory(VkDeviceMemory memory);
         void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
                           VkMemoryPropertyFlags props, VkBuffer &buffer,
-                          VkDeviceMemory &memory);
+                          VkDeviceMemory &memory, bool shareWithCompute = false);
         void CopyBuffer(VkBuffer src, VkBuffer dst, VkDeviceSize size);
+        // Staging + copia a un buffer DEVICE_LOCAL nuevo (usage recibe TRANSFER_DST)
+        void UploadDeviceBuffer(const void *source, VkDeviceSize size, VkBufferUsageFlags usage,
+                                VkBuffer &buffer, VkDeviceMemory &memory);
         void InitVulkan();
         void CreateInstance();
         void CreateSurface();
         void PickPhysicalDevice();
         void CreateLogicalDevice();
-        void CreateSwapchain(bool enableVSync);
+        void CreateSwapchain();
+        VkResult QueuePresent(uint32_t imageIndex);
         void CreateImageViews();
         VkFormat FindDepthFormat();
         void CreateDepthResources();
@@ -494,7 +1216,13 @@ namespace Mantrax
         void CreateCommandPool();
         void CreateCommandBuffers();
         void CreateSyncObjects();
+        void CreateTimestampQueries();
         void CreateShaderPipeline(std::shared_ptr<Shader> shader, VkRenderPass renderPass = VK_NULL_HANDLE);
+        VkPipeline CreateShaderVariant(const Shader &shader, uint32_t featureMask);
+        void DestroyShaderVariants(Shader &shader);
+        std::vector<std::shared_ptr<Shader>> LockLiveShaders();
+        VkExtent2D GetRenderTargetBucket(uint32_t width, uint32_t height) const;
+        void TrimRenderTargetPool();
         void CreateVertexBuffer(std::shared_ptr<Mesh> mesh);
         void CreateIndexBuffer(std::shared_ptr<Mesh> mesh);
         void CreateUniformBuffer(std::shared_ptr<Mesh> mesh);
@@ -502,6 +1230,42 @@ namespace Mantrax
         void CreateDescriptorSet(std::shared_ptr<Material> material);
         void RecordCommandBuffer(VkCommandBuffer cmd, uint32_t index,
                                  std::function<void(VkCommandBuffer)> imguiRenderCallback = nullptr);
+        void CreateHiZPyramid(std::shared_ptr<OffscreenFramebuffer> offscreen);
+        void DestroyHiZPyramid(std::shared_ptr<OffscreenFramebuffer> offscreen);
+        void ConfigureHiZReadback(HiZPyramid &hiz, VkExtent2D renderExtent);
+        void RecordHiZBuild(VkCommandBuffer cmd, std::shared_ptr<OffscreenFramebuffer> offscreen);
+        void CreateMeshletBuffers(std::shared_ptr<Mesh> mesh);
+        void CreateMeshletDrawBuffer(std::shared_ptr<Mesh> mesh);
+        bool RecordMeshletCull(VkCommandBuffer cmd, const RenderObject &obj, const Frustum &frustum);
+        void RecordMeshDraw(VkCommandBuffer cmd, const RenderObject &obj, bool useMeshlets);
+        void CreateLightingResources();
+        void CreateClusterBuffers();
+        void WriteLightingDescriptors();
+        void UploadLighting(VkExtent2D extent);
+        void RecordLightCulling(VkCommandBuffer cmd);
+        void BindMeshDescriptorSets(VkCommandBuffer cmd, VkPipelineLayout layout, VkDescriptorSet meshSet);
+        void WriteSkyDescriptor();
+        void RecordSky(VkCommandBuffer cmd);
+
+        uint32_t GetStreamingTailMip(const TextureImageData &image) const;
+        void RequestTextureMips(const std::vector<const RenderObject *> &visibleObjects, uint32_t viewportHeight);
+        void UpdateTextureStreaming(const std::vector<RenderObject> &objects);
+        // Reemplaza la imagen por una con los mips [firstMip, mipLevels); la copia queda en 'upload'
+        void ReplaceStreamedImage(Texture &texture, uint32_t firstMip, PendingTextureUpload &upload);
+        void RecordTextureUpload(VkCommandBuffer cmd, const PendingTextureUpload &upload);
+        void RefreshMeshTextures(const RenderObject &obj);
+        // Handler de desalojo: baja a la cola de mips la textura streameada menos usada
+        uint64_t GetOldestStreamedTextureUse() const;
+        uint64_t EvictOldestStreamedTexture();
+        void CreateComputePipeline(const std::string &computeShaderPath,
+                                   const std::vector<VkDescriptorType> &bindings, uint32_t pushConstantSize,
+                                   VkDescriptorSetLayout &setLayout, VkPipelineLayout &pipelineLayout,
+                                   VkPipeline &pipeline);
+        void RecordPendingDispatches(VkCommandBuffer cmd);
+        void RecordDispatchList(VkCommandBuffer cmd, const std::vector<PendingDispatch> &dispatches);
+        VkResult SubmitFrame(VkCommandBuffer cmd);
+        void SubmitAsyncCompute();
+        void WaitAsyncCompute();
         void CleanupSwapchain();
         void RecreateSwapchainWithCustomRenderPasses();
         void RecreateSwapchain();
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "../../MantraxECS/include/EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Contadores de culling del último RenderToOffscreenFramebuffer
+    struct MANTRAX_API CullingStats
+    {
+        uint32_t submitted = 0;         // Objetos recibidos
+        uint32_t frustumRejected = 0;   // Descartados por frustum
+        uint32_t occlusionTested = 0;   // Probados contra el HiZ
+        uint32_t occlusionRejected = 0; // Descartados por el HiZ
+        uint32_t drawn = 0;             // Objetos dibujados
+        uint32_t meshletObjects = 0;    // Dibujados con culling por meshlet en GPU
+    };
+
+    // Cluster de triángulos (layout std430 de meshlet_cull.comp).
+    // Los triángulos de un meshlet son un rango contiguo del LOD0.
+    struct MANTRAX_API Meshlet
+    {
+        glm::vec4 sphere{0.0f};                    // xyz: centro, w: radio (espacio objeto)
+        glm::vec4 cone{0.0f, 0.0f, 0.0f, 1.0f};    // xyz: eje, w: cutoff (>= 1 = sin cono)
+        glm::vec4 coneApex{0.0f};                  // xyz: vértice del cono
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        uint32_t vertexCount = 0;                  // Vértices únicos (informativo)
+        uint32_t padding = 0;
+    };
+
+    // Planos del frustum extraídos de una matriz viewProj (Gribb-Hartmann)
+    struct MANTRAX_API Frustum
+    {
+        glm::vec4 planes[6];
+
+        static Frustum FromMatrix(const glm::mat4 &viewProj);
+
+        // AABB en espacio local transformada por 'model'
+        bool IntersectsAABB(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax,
+                            const glm::mat4 &model) const;
+    };
+
+    // Nivel del HiZ (tamaños de Vulkan: max(1, w >> i))
+    struct MANTRAX_API HiZLevel
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        size_t offset = 0; // En floats dentro de HiZReadback::texels (solo niveles >= baseLevel)
+    };
+
+    // Copia en CPU de los niveles gruesos del HiZ del frame anterior.
+    // Cada texel guarda la profundidad MÁS LEJANA de su área.
+    struct MANTRAX_API HiZReadback
+    {
+        uint32_t depthWidth = 0;  // Resolución del depth de origen
+        uint32_t depthHeight = 0;
+        uint32_t baseLevel = 0;   // Primer nivel de la pirámide copiado a CPU
+        std::vector<HiZLevel> levels; // Todos los niveles de la pirámide
+        std::vector<float> texels;
+        glm::mat4 viewProj{1.0f}; // Cámara con la que se generó el depth
+        bool valid = false;
+
+        // true solo si la AABB está completamente detrás del HiZ.
+        // Ante cualquier duda (cruza el near plane, fuera de pantalla) devuelve false.
+        bool IsOccluded(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax,
+                        const glm::mat4 &model) const;
+    };
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <vulkan/vulkan.h>
+#include "../../MantraxECS/include/EngineLoaderDLL.h"
+#include "MantraxGFX_Memory.h"
+
+namespace Mantrax
+{
+    // Cola de destrucción diferida: cada handle retirado se marca con el último
+    // frame enviado (que aún puede usarlo) y se libera cuando su fence señaliza.
+    // Los recursos (Mesh, Texture, Shader, OffscreenFramebuffer) se entregan solos
+    // al destruirse, así que liberar no requiere vkDeviceWaitIdle.
+    class MANTRAX_API DeletionQueue
+    {
+    public:
+        DeletionQueue(VkDevice device, VkDescriptorPool descriptorPool);
+        ~DeletionQueue();
+
+        DeletionQueue(const DeletionQueue &) = delete;
+        DeletionQueue &operator=(const DeletionQueue &) = delete;
+
+        void RetireBuffer(VkBuffer buffer);
+        void RetireMemory(VkDeviceMemory memory);
+        void RetireImage(VkImage image);
+        void RetireImageView(VkImageView view);
+        void RetireSampler(VkSampler sampler);
+        void RetireFramebuffer(VkFramebuffer framebuffer);
+        void RetireRenderPass(VkRenderPass renderPass);
+        void RetirePipeline(VkPipeline pipeline);
+        void RetirePipelineLayout(VkPipelineLayout layout);
+        void RetireDescriptorSetLayout(VkDescriptorSetLayout layout);
+        void RetireDescriptorSet(VkDescriptorSet set); // Del descriptor pool global
+
+        // Liberación externa (ej. texturas de ImGui, que viven en otro pool)
+        void RetireCallback(std::function<void()> callback);
+
+        // Tras vkQueueSubmit del frame: lo retirado a partir de aquí puede estar en uso por él
+        void OnFrameSubmitted();
+        uint64_t GetSubmittedFrame() const;
+        uint64_t GetCompletedFrame() const; // Último frame cuya fence se ha visto señalizada
+
+        // Tras esperar la fence: libera todo lo marcado con frames <= completedFrame
+        void Collect(uint64_t completedFrame);
+
+        // Libera todo lo pendiente (el llamador garantiza que la GPU está idle)
+        void Flush();
+
+        // El device se va a destruir: libera lo pendiente e ignora retiros posteriores
+        void Shutdown();
+
+        size_t GetPendingCount() const;
+
+        // La memoria retirada se descuenta del tracker al liberarse de verdad
+        void SetMemoryTracker(std::shared_ptr<MemoryTracker> tracker) { m_MemoryTracker = std::move(tracker); }
+        std::shared_ptr<MemoryTracker> GetMemoryTracker() const { return m_MemoryTracker; }
+
+    private:
+        struct Entry
+        {
+            uint64_t frame;
+            VkObjectType type;
+            uint64_t handle;
+            std::function<void()> callback; // Solo para VK_OBJECT_TYPE_UNKNOWN
+        };
+
+        void Push(VkObjectType type, uint64_t handle);
+        void Destroy(const Entry &entry);
+
+        VkDevice m_Device;
+        VkDescriptorPool m_DescriptorPool;
+        std::shared_ptr<MemoryTracker> m_MemoryTracker;
+        std::deque<Entry> m_Entries; // Frames crecientes: se libera desde el frente
+        uint64_t m_SubmittedFrame = 0;
+        uint64_t m_CompletedFrame = 0;
+        mutable std::mutex m_Mutex; // Los recursos pueden destruirse desde cualquier hilo
+    };
+}
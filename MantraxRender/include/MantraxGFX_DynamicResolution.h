@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <vulkan/vulkan.h>
+#include "../../MantraxECS/include/EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    struct MANTRAX_API DynamicResolutionSettings
+    {
+        bool enabled = true;
+        float targetGPUTimeMs = 8.0f; // Presupuesto del pase de escena
+        float minScale = 0.5f;
+        float maxScale = 1.0f;
+        float scaleStep = 0.05f;      // Escala cuantizada: evita recrear el HiZ cada frame
+        float headroom = 0.85f;       // Subir escala solo por debajo de target * headroom
+        uint32_t adjustInterval = 15; // Frames entre ajustes
+        float smoothing = 0.1f;       // Peso de la media exponencial del tiempo de GPU
+    };
+
+    // Controlador de resolución dinámica: ajusta la escala del offscreen
+    // para acercar el tiempo de GPU medido (timestamps) al objetivo.
+    class MANTRAX_API DynamicResolution
+    {
+    public:
+        void SetSettings(const DynamicResolutionSettings &settings) { m_Settings = settings; }
+        const DynamicResolutionSettings &GetSettings() const { return m_Settings; }
+
+        // Registra el tiempo de GPU del último frame (<= 0 = sin medida) y devuelve la escala
+        float Update(float gpuTimeMs);
+
+        // Tamaño escalado de un viewport (mínimo 1x1)
+        VkExtent2D Apply(uint32_t width, uint32_t height) const;
+
+        float GetScale() const { return m_Scale; }
+        float GetAverageGPUTimeMs() const { return m_AverageMs; }
+
+    private:
+        DynamicResolutionSettings m_Settings;
+        float m_Scale = 1.0f;
+        float m_AverageMs = 0.0f;
+        uint32_t m_FramesSinceAdjust = 0;
+    };
+}
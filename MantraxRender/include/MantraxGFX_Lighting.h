@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include "../../MantraxECS/include/EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Máximo de luces por cluster (igual que MAX_LIGHTS_PER_CLUSTER en los shaders)
+    constexpr uint32_t CLUSTER_MAX_LIGHTS = 128;
+
+    enum class LightType : uint32_t
+    {
+        Directional = 0,
+        Point = 1,
+        Spot = 2,
+    };
+
+    // Luz en GPU (layout std430 de pbr.frag / light_cull.comp, 64 bytes)
+    struct MANTRAX_API GPULight
+    {
+        float position[3] = {0.0f, 0.0f, 0.0f};
+        float range = 10.0f; // Point/Spot: radio de influencia (la atenuación llega a 0)
+        float color[3] = {1.0f, 1.0f, 1.0f};
+        float intensity = 1.0f;
+        float direction[3] = {0.0f, -1.0f, 0.0f}; // Directional/Spot: hacia donde ilumina
+        uint32_t type = static_cast<uint32_t>(LightType::Point);
+        float cosInnerCone = 0.95f; // Spot: coseno del ángulo sin atenuación
+        float cosOuterCone = 0.85f; // Spot: coseno del ángulo donde llega a 0
+        float padding[2] = {0.0f, 0.0f};
+    };
+
+    // Rejilla 3D sobre el frustum: X/Y en tiles de pantalla, Z en cortes de profundidad
+    // (exponenciales en perspectiva, lineales en ortográfica)
+    struct MANTRAX_API ClusterSettings
+    {
+        uint32_t gridX = 16;
+        uint32_t gridY = 9;
+        uint32_t gridZ = 24;
+        uint32_t maxLights = 1024; // Capacidad del buffer de luces
+    };
+
+    // Contadores del último RenderToOffscreenFramebuffer
+    struct MANTRAX_API LightingStats
+    {
+        uint32_t lights = 0;   // Luces subidas al GPU
+        uint32_t dropped = 0;  // Descartadas por superar maxLights
+        uint32_t clusters = 0; // Celdas de la rejilla
+        bool clustered = false; // false = el shader recorre todas las luces
+    };
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <vulkan/vulkan.h>
+#include "../../MantraxECS/include/EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Categoría de cada allocation (se deduce del uso del buffer / imagen)
+    enum class MemoryCategory : uint32_t
+    {
+        Mesh,         // Vertex / index / meshlets / draws indirectos
+        Texture,      // Imágenes muestreadas
+        RenderTarget, // Attachments, storage images, transitorios del render graph
+        Staging,      // Subidas (solo TRANSFER_SRC)
+        Buffer,       // Uniform / storage / readbacks
+        Count
+    };
+
+    constexpr size_t MEMORY_CATEGORY_COUNT = static_cast<size_t>(MemoryCategory::Count);
+
+    MANTRAX_API const char *GetMemoryCategoryName(MemoryCategory category);
+    MANTRAX_API MemoryCategory ClassifyBufferMemory(VkBufferUsageFlags usage);
+    MANTRAX_API MemoryCategory ClassifyImageMemory(VkImageUsageFlags usage);
+
+    struct MANTRAX_API MemoryBudgetSettings
+    {
+        uint64_t budgetBytes = 0;      // 0 = automático: budgetFraction de lo que ofrece el driver
+        float budgetFraction = 0.9f;   // Margen para el compositor y otras aplicaciones
+        bool allowHostFallback = true; // Sin VRAM: a memoria del sistema (más lento, pero no se cae)
+    };
+
+    struct MANTRAX_API MemoryHeapInfo
+    {
+        uint64_t size = 0;
+        uint64_t budget = 0; // VK_EXT_memory_budget; sin la extensión, el tamaño del heap
+        uint64_t usage = 0;  // Del driver (todo el proceso) o, sin la extensión, lo registrado aquí
+        bool deviceLocal = false;
+    };
+
+    struct MANTRAX_API MemoryStats
+    {
+        uint64_t categoryBytes[MEMORY_CATEGORY_COUNT] = {};
+        uint32_t categoryAllocations[MEMORY_CATEGORY_COUNT] = {};
+        uint64_t hostFallbackBytes = 0; // Parte de lo anterior que acabó fuera de la VRAM
+        uint64_t retiredBytes = 0;      // En la DeletionQueue: se libera al terminar su frame
+        std::vector<MemoryHeapInfo> heaps;
+
+        uint64_t deviceLocalUsage = 0;
+        uint64_t deviceLocalBudget = 0; // Efectivo (settings + driver)
+        bool hasBudgetExtension = false;
+
+        // Acumulados desde el inicio
+        uint32_t evictions = 0;
+        uint64_t evictedBytes = 0;
+        uint32_t hostFallbacks = 0;
+        uint32_t failedAllocations = 0;
+    };
+
+    // Caché que puede soltar memoria de dispositivo bajo presión (texturas, meshes...).
+    // Los usos se miden en frames de DeletionQueue::GetSubmittedFrame, así que el
+    // tracker puede desalojar por LRU global entre todas las cachés registradas
+    struct MANTRAX_API MemoryEvictionHandler
+    {
+        std::string name;
+        // Frame de uso del candidato más viejo; UINT64_MAX = nada que soltar
+        std::function<uint64_t()> oldestUse;
+        // Suelta ese candidato; devuelve los bytes que se liberarán (0 = no pudo)
+        std::function<uint64_t()> evictOldest;
+    };
+
+    // Contabilidad de vkAllocateMemory / vkFreeMemory por categoría y heap, y
+    // presupuesto de VRAM. Los frees pueden llegar desde cualquier hilo (DeletionQueue)
+    class MANTRAX_API MemoryTracker
+    {
+    public:
+        MemoryTracker(VkPhysicalDevice physicalDevice, bool hasBudgetExtension);
+
+        MemoryTracker(const MemoryTracker &) = delete;
+        MemoryTracker &operator=(const MemoryTracker &) = delete;
+
+        void OnAllocate(VkDeviceMemory memory, uint64_t size, uint32_t memoryTypeIndex,
+                        MemoryCategory category, bool hostFallback = false);
+        // Retirada a la DeletionQueue: ya no cuenta para el presupuesto (evita desalojar dos veces)
+        void OnRetire(VkDeviceMemory memory);
+        void OnFree(VkDeviceMemory memory);
+        void OnFailedAllocation();
+
+        // Relee el presupuesto del driver (una vez por frame)
+        void Refresh();
+
+        bool IsDeviceLocalType(uint32_t memoryTypeIndex) const;
+        const VkPhysicalDeviceMemoryProperties &GetMemoryProperties() const { return m_MemoryProperties; }
+
+        // Bytes que sobran si se añadieran 'extraBytes' de VRAM (0 = cabe)
+        uint64_t GetOverBudget(uint64_t extraBytes) const;
+
+        uint32_t RegisterEvictionHandler(const MemoryEvictionHandler &handler);
+        void UnregisterEvictionHandler(uint32_t id);
+        // Desaloja el candidato más viejo de entre todas las cachés hasta cubrir 'bytes'
+        uint64_t Evict(uint64_t bytes);
+
+        void SetSettings(const MemoryBudgetSettings &settings);
+        MemoryBudgetSettings GetSettings() const;
+        MemoryStats GetStats() const;
+
+    private:
+        struct Allocation
+        {
+            uint64_t size;
+            uint32_t memoryTypeIndex;
+            MemoryCategory category;
+            bool hostFallback;
+            bool retired;
+        };
+
+        uint64_t GetDeviceLocalUsageLocked() const;
+        uint64_t GetDeviceLocalBudgetLocked() const;
+
+        VkPhysicalDevice m_PhysicalDevice;
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties{};
+        bool m_HasBudgetExtension;
+
+        MemoryBudgetSettings m_Settings;
+        std::unordered_map<VkDeviceMemory, Allocation> m_Allocations;
+        std::vector<uint64_t> m_HeapTracked; // Bytes registrados por heap
+        std::vector<uint64_t> m_HeapRetired; // Parte de lo anterior pendiente de liberar
+        std::vector<uint64_t> m_HeapBudget;  // Último Refresh
+        std::vector<uint64_t> m_HeapUsage;   // Último Refresh
+
+        std::unordered_map<uint32_t, MemoryEvictionHandler> m_Handlers;
+        uint32_t m_NextHandlerId = 1;
+
+        MemoryStats m_Counters; // Solo categorías y acumulados; heaps se calculan en GetStats
+        mutable std::mutex m_Mutex;
+    };
+}
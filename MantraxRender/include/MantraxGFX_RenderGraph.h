@@ -0,0 +1,214 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include <vulkan/vulkan.h>
+#include "../../MantraxECS/include/EngineLoaderDLL.h"
+#include "MantraxGFX_DeletionQueue.h"
+
+namespace Mantrax
+{
+    using RGResource = uint32_t;
+    constexpr RGResource RG_INVALID_RESOURCE = 0xffffffffu;
+
+    // Uso de un recurso dentro de un pase: define layout, stage y access del barrier
+    enum class RGAccess : uint32_t
+    {
+        ColorAttachmentWrite,
+        DepthAttachmentWrite,
+        DepthAttachmentRead, // Depth test sin escritura
+        SampledRead,         // Textura muestreada (fragment o compute según el pase)
+        StorageRead,
+        StorageWrite,
+        TransferRead,
+        TransferWrite,
+        IndirectRead, // Buffer de draws indirectos
+    };
+
+    enum class RGPassType : uint32_t
+    {
+        Graphics,
+        Compute,
+        Transfer,
+    };
+
+    // Estado de sincronización de un recurso (último uso conocido)
+    struct MANTRAX_API RGState
+    {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        VkAccessFlags access = 0;
+    };
+
+    // Imagen transitoria: la crea el grafo y su memoria se comparte (aliasing)
+    // con otras transitorias cuyas vidas no se solapan
+    struct MANTRAX_API RGImageDesc
+    {
+        VkExtent2D extent = {0, 0};
+        VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+        VkImageUsageFlags usage = 0;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        uint32_t mipLevels = 1;
+    };
+
+    struct MANTRAX_API RenderGraphStats
+    {
+        uint32_t passes = 0;
+        uint32_t culledPasses = 0;
+        uint32_t barrierBatches = 0; // vkCmdPipelineBarrier emitidos
+        uint32_t imageBarriers = 0;
+        uint32_t transientImages = 0;
+        VkDeviceSize transientBytes = 0; // Suma de lo que pedirían sin aliasing
+        VkDeviceSize allocatedBytes = 0; // Memoria realmente reservada
+    };
+
+    // Grafo de render por frame: los pases declaran lecturas y escrituras; el grafo
+    // descarta pases sin consumidores, inserta barriers/transiciones mínimas y
+    // reparte la memoria de los recursos transitorios.
+    //
+    // Uso por frame: Reset → Import/Create → AddPass → Compile → Execute.
+    class MANTRAX_API RenderGraph
+    {
+    public:
+        class MANTRAX_API PassBuilder
+        {
+        public:
+            // layoutAfter: layout en que el pase deja la imagen (ej. finalLayout de su VkRenderPass)
+            void Read(RGResource resource, RGAccess access);
+            void Write(RGResource resource, RGAccess access,
+                       VkImageLayout layoutAfter = VK_IMAGE_LAYOUT_UNDEFINED);
+            // El pase tiene efectos fuera del grafo (readback, timestamps): nunca se descarta
+            void SetSideEffects();
+
+        private:
+            friend class RenderGraph;
+            PassBuilder(RenderGraph *graph, uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+            RenderGraph *m_Graph;
+            uint32_t m_Pass;
+        };
+
+        using SetupFn = std::function<void(PassBuilder &)>;
+        using ExecuteFn = std::function<void(VkCommandBuffer)>;
+
+        RenderGraph(VkDevice device, VkPhysicalDevice physicalDevice,
+                    std::shared_ptr<DeletionQueue> deletionQueue);
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph &) = delete;
+        RenderGraph &operator=(const RenderGraph &) = delete;
+
+        // Empieza la descripción de un frame (la memoria transitoria se conserva)
+        void Reset();
+
+        // finalLayout UNDEFINED = dejar la imagen en el estado del último pase
+        RGResource ImportImage(const std::string &name, VkImage image, VkImageAspectFlags aspect,
+                               uint32_t mipLevels, const RGState &initial,
+                               VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                               VkPipelineStageFlags finalStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                               VkAccessFlags finalAccess = 0);
+        // buffer VK_NULL_HANDLE = dependencia lógica (se sincroniza con un barrier global)
+        RGResource ImportBuffer(const std::string &name, VkBuffer buffer, const RGState &initial = RGState{});
+        RGResource CreateImage(const std::string &name, const RGImageDesc &desc);
+
+        // Los pases que escriben recursos marcados como salida no se descartan
+        void MarkOutput(RGResource resource);
+
+        void AddPass(const std::string &name, RGPassType type, const SetupFn &setup, ExecuteFn execute);
+
+        void Compile();
+        void Execute(VkCommandBuffer cmd);
+
+        // Válidos tras Compile (transitorias) o tras Import
+        VkImage GetImage(RGResource resource) const;
+        VkImageView GetImageView(RGResource resource) const;
+
+        const RenderGraphStats &GetStats() const { return m_Stats; }
+
+    private:
+        struct Access
+        {
+            RGResource resource;
+            RGAccess access;
+            bool write;
+            VkImageLayout layoutAfter;
+        };
+
+        struct Pass
+        {
+            std::string name;
+            RGPassType type;
+            ExecuteFn execute;
+            std::vector<Access> accesses;
+            bool sideEffects = false;
+            bool culled = false;
+            uint32_t refCount = 0;
+        };
+
+        struct Resource
+        {
+            std::string name;
+            bool isImage = true;
+            bool imported = false;
+            bool output = false;
+
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView view = VK_NULL_HANDLE;
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+            uint32_t mipLevels = 1;
+
+            RGState state;
+            VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkPipelineStageFlags finalStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            VkAccessFlags finalAccess = 0;
+
+            // Transitorias
+            RGImageDesc desc;
+            uint32_t firstPass = 0xffffffffu;
+            uint32_t lastPass = 0;
+            RGResource aliasPredecessor = RG_INVALID_RESOURCE; // Ocupante anterior de su memoria
+            uint32_t readers = 0;
+            std::vector<uint32_t> producers;
+        };
+
+        // Imagen transitoria realizada (se conserva entre frames con la misma distribución)
+        struct TransientImage
+        {
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView view = VK_NULL_HANDLE;
+            uint32_t block = 0;
+            uint32_t predecessor = 0xffffffffu; // Índice en m_Transients
+        };
+
+        struct MemoryBlock
+        {
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            VkDeviceSize size = 0;
+            uint32_t memoryTypeIndex = 0;
+        };
+
+        void CullPasses();
+        void ComputeLifetimes();
+        void RealizeTransients();
+        void ReleaseTransients();
+        std::string BuildLayoutSignature() const;
+        uint32_t FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags props) const;
+
+        VkDevice m_Device;
+        VkPhysicalDevice m_PhysicalDevice;
+        std::shared_ptr<DeletionQueue> m_DeletionQueue;
+
+        std::vector<Pass> m_Passes;
+        std::vector<Resource> m_Resources;
+
+        std::vector<TransientImage> m_Transients; // En orden de las transitorias vivas
+        std::vector<MemoryBlock> m_Blocks;
+        std::string m_TransientSignature;
+
+        RenderGraphStats m_Stats;
+        bool m_Compiled = false;
+    };
+}
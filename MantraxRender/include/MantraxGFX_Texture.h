@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <vulkan/vulkan.h>
+#include "../../MantraxECS/include/EngineLoaderDLL.h"
+
+namespace Mantrax
+{
+    // Nivel de mip dentro de TextureImageData::bytes
+    struct MANTRAX_API TextureMip
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    // Imagen lista para subir: RGBA8 o comprimida por bloques (BC/ASTC), con sus mips.
+    // La producen el cook (TextureCompressor) y el lector KTX2; la consume GFX::CreateTexture
+    struct MANTRAX_API TextureImageData
+    {
+        VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<TextureMip> mips; // mips[0] = resolución completa
+        std::vector<uint8_t> bytes;
+
+        uint32_t GetMipLevels() const { return static_cast<uint32_t>(mips.size()); }
+    };
+
+    // Streaming de mips (GFX::CreateStreamedTexture): cada textura mantiene en VRAM solo los
+    // mips que pide su tamaño en pantalla; la cola (mips <= minResidentSize) nunca se descarga
+    struct MANTRAX_API TextureStreamingSettings
+    {
+        bool enabled = true;
+        uint64_t budgetBytes = 256ull * 1024 * 1024;         // VRAM máxima para texturas streameadas
+        uint64_t maxUploadBytesPerFrame = 16ull * 1024 * 1024; // Subidas de mips altos por frame
+        uint32_t minResidentSize = 64;                         // Lado del mip más grande siempre residente
+        uint32_t evictAfterFrames = 120;                       // Frames sin verse antes de volver a la cola
+        float mipBias = 0.0f;                                  // > 0 = menos resolución
+    };
+
+    struct MANTRAX_API TextureStreamingStats
+    {
+        uint32_t streamedTextures = 0;
+        uint32_t pendingRequests = 0; // Texturas que quieren más mips de los que tienen
+        uint32_t uploads = 0;         // Imágenes reemplazadas este frame (subida)
+        uint32_t evictions = 0;       // Imágenes reemplazadas este frame (descarga)
+        uint64_t residentBytes = 0;
+        uint64_t fullBytes = 0;       // Lo que ocuparían con todos los mips
+        uint64_t uploadedBytes = 0;   // Este frame
+    };
+
+    // Formatos de textura que sabe subir el GFX
+    MANTRAX_API bool IsBlockCompressedFormat(VkFormat format);
+    // Bloque de 4x4 (BC/ASTC 4x4) o 1x1 (RGBA8); 0 = formato no soportado
+    MANTRAX_API uint32_t GetFormatBlockExtent(VkFormat format);
+    MANTRAX_API uint32_t GetFormatBlockBytes(VkFormat format);
+    MANTRAX_API size_t GetTextureLevelSize(VkFormat format, uint32_t width, uint32_t height);
+    MANTRAX_API const char *GetTextureFormatName(VkFormat format);
+}
@@ -25,6 +25,11 @@ namespace Mantrax
         void SetMaxDeltaTime(float maxDelta) { m_MaxDeltaTime = maxDelta; }
         float GetMaxDeltaTime() const { return m_MaxDeltaTime; }
 
+        // Latencia input → present en ms (la registra GFX::WaitForFramePacing)
+        void RecordInputLatency(float milliseconds);
+        float GetInputLatencyMs() const { return m_InputLatencyMs; }         // Media suavizada
+        float GetPeakInputLatencyMs() const { return m_PeakInputLatencyMs; } // Máximo del último segundo
+
     private:
         using Clock = std::chrono::high_resolution_clock;
         using TimePoint = std::chrono::time_point<Clock>;
@@ -40,6 +45,10 @@ namespace Mantrax
         int m_FrameCount;
         int m_FPSFrameCount;
         int m_FPS;
+
+        float m_InputLatencyMs;
+        float m_PeakInputLatencyMs;
+        float m_WindowPeakLatencyMs;
     };
 
 }
\ No newline at end of file
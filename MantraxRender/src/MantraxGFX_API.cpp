@@ -1,8 +1,179 @@
 #include "../include/MantraxGFX_API.h"
+#include "../../MantraxECS/include/MappedFile.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <cstring>
+#include <thread>
 
 namespace Mantrax
 {
 
+    //=====================================
+    //
+    //
+    // RESOURCE DESTRUCTORS
+    //
+    //
+    //=====================================
+
+    // Sin cola (recurso creado a mano) los handles quedan a cargo de quien los creó
+
+    Mesh::~Mesh()
+    {
+        if (!deletionQueue)
+            return;
+
+        deletionQueue->RetireDescriptorSet(descriptorSet);
+        deletionQueue->RetireDescriptorSet(meshletDescriptorSet);
+        deletionQueue->RetireBuffer(drawCommandBuffer);
+        deletionQueue->RetireMemory(drawCommandBufferMemory);
+
+        // El UBO de un submesh es el de su objeto
+        if (!transformSource)
+        {
+            deletionQueue->RetireBuffer(uniformBuffer);
+            deletionQueue->RetireMemory(uniformBufferMemory);
+        }
+
+        // La geometría de una instancia la libera su geometrySource
+        if (geometrySource)
+            return;
+
+        deletionQueue->RetireBuffer(vertexBuffer);
+        deletionQueue->RetireMemory(vertexBufferMemory);
+        deletionQueue->RetireBuffer(indexBuffer);
+        deletionQueue->RetireMemory(indexBufferMemory);
+        deletionQueue->RetireBuffer(meshletBuffer);
+        deletionQueue->RetireMemory(meshletBufferMemory);
+    }
+
+    Shader::~Shader()
+    {
+        if (!deletionQueue)
+            return;
+
+        deletionQueue->RetirePipeline(pipeline);
+        for (auto &[mask, variant] : variants)
+            deletionQueue->RetirePipeline(variant);
+        deletionQueue->RetirePipelineLayout(pipelineLayout);
+        deletionQueue->RetireDescriptorSetLayout(descriptorSetLayout);
+    }
+
+    Texture::~Texture()
+    {
+        if (!deletionQueue)
+            return;
+
+        deletionQueue->RetireSampler(sampler);
+        deletionQueue->RetireImageView(imageView);
+        deletionQueue->RetireImage(image);
+        deletionQueue->RetireMemory(memory);
+    }
+
+    HiZPyramid::~HiZPyramid()
+    {
+        if (!deletionQueue)
+            return;
+
+        for (auto set : mipDescriptorSets)
+            deletionQueue->RetireDescriptorSet(set);
+        for (auto view : mipViews)
+            deletionQueue->RetireImageView(view);
+
+        deletionQueue->RetireSampler(sampler);
+        deletionQueue->RetireImage(image);
+        deletionQueue->RetireMemory(memory);
+
+        // vkFreeMemory desmapea implícitamente el readback
+        deletionQueue->RetireBuffer(readbackBuffer);
+        deletionQueue->RetireMemory(readbackMemory);
+    }
+
+    ComputeShader::~ComputeShader()
+    {
+        if (!deletionQueue)
+            return;
+
+        for (auto set : descriptorSets)
+            deletionQueue->RetireDescriptorSet(set);
+
+        deletionQueue->RetirePipeline(pipeline);
+        deletionQueue->RetirePipelineLayout(pipelineLayout);
+        deletionQueue->RetireDescriptorSetLayout(descriptorSetLayout);
+    }
+
+    StorageBuffer::~StorageBuffer()
+    {
+        if (!deletionQueue)
+            return;
+
+        // vkFreeMemory desmapea implícitamente
+        deletionQueue->RetireBuffer(buffer);
+        deletionQueue->RetireMemory(memory);
+    }
+
+    StorageImage::~StorageImage()
+    {
+        if (!deletionQueue)
+            return;
+
+        deletionQueue->RetireSampler(sampler);
+        deletionQueue->RetireImageView(imageView);
+        deletionQueue->RetireImage(image);
+        deletionQueue->RetireMemory(memory);
+    }
+
+    void OffscreenFramebuffer::RetireAttachments()
+    {
+        if (!deletionQueue)
+            return;
+
+        deletionQueue->RetireFramebuffer(framebuffer);
+        deletionQueue->RetireImageView(colorImageView);
+        deletionQueue->RetireImage(colorImage);
+        deletionQueue->RetireMemory(colorMemory);
+        deletionQueue->RetireImageView(depthImageView);
+        deletionQueue->RetireImage(depthImage);
+        deletionQueue->RetireMemory(depthMemory);
+
+        framebuffer = VK_NULL_HANDLE;
+        colorImageView = VK_NULL_HANDLE;
+        colorImage = VK_NULL_HANDLE;
+        colorMemory = VK_NULL_HANDLE;
+        depthImageView = VK_NULL_HANDLE;
+        depthImage = VK_NULL_HANDLE;
+        depthMemory = VK_NULL_HANDLE;
+    }
+
+    void OffscreenFramebuffer::RetireRenderID()
+    {
+        if (!deletionQueue || renderID == VK_NULL_HANDLE)
+            return;
+
+        if (releaseRenderID)
+        {
+            auto release = releaseRenderID;
+            VkDescriptorSet id = renderID;
+            deletionQueue->RetireCallback([release, id]()
+                                          { release(id); });
+        }
+
+        renderID = VK_NULL_HANDLE;
+    }
+
+    OffscreenFramebuffer::~OffscreenFramebuffer()
+    {
+        if (!deletionQueue)
+            return;
+
+        hiz.reset();
+        RetireRenderID();
+        RetireAttachments();
+        deletionQueue->RetireSampler(sampler);
+        deletionQueue->RetireRenderPass(renderPass);
+    }
+
     //=====================================
     //
     //
@@ -53,46 +224,70 @@ namespace Mantrax
 
     std::shared_ptr<Texture> GFX::CreateTexture(unsigned char *data, int width, int height, VkFilter TextureFilter)
     {
-        auto texture = std::make_shared<Texture>();
-        texture->width = width;
-        texture->height = height;
+        // RGBA8 sin mips: un solo nivel con los píxeles tal cual
+        TextureImageData image;
+        image.format = VK_FORMAT_R8G8B8A8_UNORM;
+        image.width = static_cast<uint32_t>(width);
+        image.height = static_cast<uint32_t>(height);
+        image.bytes.assign(data, data + static_cast<size_t>(width) * height * 4);
+        image.mips.push_back({image.width, image.height, 0, image.bytes.size()});
+
+        return CreateTexture(image, TextureFilter);
+    }
 
-        VkDeviceSize imageSize = width * height * 4; // RGBA
+    std::shared_ptr<Texture> GFX::CreateTexture(const TextureImageData &image, VkFilter TextureFilter)
+    {
+        if (image.mips.empty() || image.width == 0 || image.height == 0)
+            throw std::runtime_error("CreateTexture: imagen vacía");
 
-        // Crear staging buffer
-        VkBuffer stagingBuffer;
-        VkDeviceMemory stagingMemory;
-        CreateBuffer(imageSize,
-                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                     stagingBuffer, stagingMemory);
+        if (!IsTextureFormatSupported(image.format))
+            throw std::runtime_error(std::string("CreateTexture: formato no soportado por el dispositivo (") +
+                                     GetTextureFormatName(image.format) + ")");
 
-        void *mappedData;
-        vkMapMemory(m_Device, stagingMemory, 0, imageSize, 0, &mappedData);
-        memcpy(mappedData, data, imageSize);
-        vkUnmapMemory(m_Device, stagingMemory);
+        const uint32_t mipLevels = image.GetMipLevels();
+        const uint32_t blockBytes = GetFormatBlockBytes(image.format);
 
-        CreateImage(width, height, VK_FORMAT_R8G8B8A8_UNORM,
+        auto texture = std::make_shared<Texture>();
+        texture->deletionQueue = m_DeletionQueue;
+        texture->format = image.format;
+        texture->width = image.width;
+        texture->height = image.height;
+        texture->mipLevels = mipLevels;
+
+        // Una región por mip; los offsets de bloque tienen que estar alineados al tamaño del bloque
+        std::vector<VkBufferImageCopy> regions(mipLevels);
+        for (uint32_t mip = 0; mip < mipLevels; ++mip)
+        {
+            const TextureMip &level = image.mips[mip];
+
+            if (level.offset % blockBytes != 0 ||
+                level.offset + level.size > image.bytes.size() ||
+                level.size < GetTextureLevelSize(image.format, level.width, level.height))
+                throw std::runtime_error("CreateTexture: mip " + std::to_string(mip) + " fuera de rango");
+
+            VkBufferImageCopy &region = regions[mip];
+            region = {};
+            region.bufferOffset = level.offset;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = mip;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageExtent = {level.width, level.height, 1};
+        }
+
+        CreateImage(image.width, image.height, image.format,
                     VK_IMAGE_TILING_OPTIMAL,
                     VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                    texture->image, texture->memory);
+                    texture->image, texture->memory, mipLevels);
 
-        TransitionImageLayout(texture->image, VK_FORMAT_R8G8B8A8_UNORM,
-                              VK_IMAGE_LAYOUT_UNDEFINED,
-                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        UploadImageRegions(texture->image, image.bytes.data(), image.bytes.size(), regions, mipLevels, 1);
 
-        CopyBufferToImage(stagingBuffer, texture->image, width, height);
+        texture->imageView = CreateImageView(texture->image, image.format,
+                                             VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels);
 
-        TransitionImageLayout(texture->image, VK_FORMAT_R8G8B8A8_UNORM,
-                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-        vkDestroyBuffer(m_Device, stagingBuffer, nullptr);
-        vkFreeMemory(m_Device, stagingMemory, nullptr);
-
-        texture->imageView = CreateImageView(texture->image, VK_FORMAT_R8G8B8A8_UNORM,
-                                             VK_IMAGE_ASPECT_COLOR_BIT);
+        const uint32_t width = image.width;
+        const uint32_t height = image.height;
 
         // ✅ SAMPLER MEJORADO - Configuración óptima para texturas pequeñas
         VkSamplerCreateInfo samplerInfo{};
@@ -100,21 +295,9 @@ namespace Mantrax
 
         // ✅ Para texturas pequeñas/pixel art: NEAREST
         // Para texturas normales: LINEAR
-        // Puedes detectar automáticamente:
-        if (width <= 16 || height <= 16)
-        {
-            // Texturas muy pequeñas o pixel art
-            samplerInfo.magFilter = TextureFilter;
-            samplerInfo.minFilter = TextureFilter;
-            samplerInfo.mipmapMode = TextureFilter == VK_FILTER_NEAREST ? VK_SAMPLER_MIPMAP_MODE_NEAREST : VK_SAMPLER_MIPMAP_MODE_LINEAR;
-        }
-        else
-        {
-            // Texturas normales
-            samplerInfo.magFilter = TextureFilter;
-            samplerInfo.minFilter = TextureFilter;
-            samplerInfo.mipmapMode = TextureFilter == VK_FILTER_NEAREST ? VK_SAMPLER_MIPMAP_MODE_NEAREST : VK_SAMPLER_MIPMAP_MODE_LINEAR;
-        }
+        samplerInfo.magFilter = TextureFilter;
+        samplerInfo.minFilter = TextureFilter;
+        samplerInfo.mipmapMode = TextureFilter == VK_FILTER_NEAREST ? VK_SAMPLER_MIPMAP_MODE_NEAREST : VK_SAMPLER_MIPMAP_MODE_LINEAR;
 
         // ✅ CLAMP_TO_EDGE evita que se repita la textura
         samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
@@ -138,20 +321,34 @@ namespace Mantrax
         samplerInfo.compareEnable = VK_FALSE;
         samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
 
-        // ✅ LOD correcto para evitar problemas con texturas pequeñas
+        // ✅ Sin tope de LOD: la vista limita a sus mips (con streaming la imagen cambia de tamaño)
         samplerInfo.mipLodBias = 0.0f;
         samplerInfo.minLod = 0.0f;
-        samplerInfo.maxLod = 0.0f; // Sin mipmaps por ahora
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
         if (vkCreateSampler(m_Device, &samplerInfo, nullptr, &texture->sampler) != VK_SUCCESS)
             throw std::runtime_error("Error creando sampler de textura");
 
         std::cout << "✅ Textura creada: " << width << "x" << height
-                  << " (Filtro: " << (width <= 16 ? "NEAREST" : "LINEAR") << ")" << std::endl;
+                  << " (" << GetTextureFormatName(image.format) << ", " << mipLevels << " mips"
+                  << ", Filtro: " << (TextureFilter == VK_FILTER_NEAREST ? "NEAREST" : "LINEAR") << ")" << std::endl;
 
         return texture;
     }
 
+    bool GFX::IsTextureFormatSupported(VkFormat format) const
+    {
+        if (GetFormatBlockExtent(format) == 0)
+            return false;
+
+        // BC/ASTC dependen de textureCompressionBC / textureCompressionASTC_LDR (activadas si existen)
+        VkFormatProperties props;
+        vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &props);
+
+        const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+        return (props.optimalTilingFeatures & required) == required;
+    }
+
     void GFX::SetMaterialTexture(std::shared_ptr<Material> material, std::shared_ptr<Texture> texture)
     {
         // Ahora asigna a albedo para compatibilidad
@@ -192,7 +389,9 @@ namespace Mantrax
     std::shared_ptr<OffscreenFramebuffer> GFX::CreateOffscreenFramebuffer(uint32_t width, uint32_t height)
     {
         auto offscreen = std::make_shared<OffscreenFramebuffer>();
+        offscreen->deletionQueue = m_DeletionQueue;
         offscreen->extent = {width, height};
+        offscreen->renderExtent = offscreen->extent;
         offscreen->colorFormat = VK_FORMAT_R8G8B8A8_UNORM;
         offscreen->depthFormat = m_DepthFormat;
 
@@ -207,10 +406,10 @@ namespace Mantrax
                                                     offscreen->colorFormat,
                                                     VK_IMAGE_ASPECT_COLOR_BIT);
 
-        // Crear depth image
+        // Crear depth image (SAMPLED para construir el HiZ)
         CreateImage(width, height, offscreen->depthFormat,
                     VK_IMAGE_TILING_OPTIMAL,
-                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                     offscreen->depthImage, offscreen->depthMemory);
 
@@ -310,53 +509,18 @@ namespace Mantrax
             return;
         }
 
-        vkDeviceWaitIdle(m_Device);
-
-        // Limpiar recursos anteriores (orden importante)
-        if (offscreen->framebuffer != VK_NULL_HANDLE)
-        {
-            vkDestroyFramebuffer(m_Device, offscreen->framebuffer, nullptr);
-            offscreen->framebuffer = VK_NULL_HANDLE;
-        }
-
-        if (offscreen->colorImageView != VK_NULL_HANDLE)
-        {
-            vkDestroyImageView(m_Device, offscreen->colorImageView, nullptr);
-            offscreen->colorImageView = VK_NULL_HANDLE;
-        }
-
-        if (offscreen->depthImageView != VK_NULL_HANDLE)
-        {
-            vkDestroyImageView(m_Device, offscreen->depthImageView, nullptr);
-            offscreen->depthImageView = VK_NULL_HANDLE;
-        }
-
-        if (offscreen->colorImage != VK_NULL_HANDLE)
-        {
-            vkDestroyImage(m_Device, offscreen->colorImage, nullptr);
-            offscreen->colorImage = VK_NULL_HANDLE;
-        }
-
-        if (offscreen->depthImage != VK_NULL_HANDLE)
-        {
-            vkDestroyImage(m_Device, offscreen->depthImage, nullptr);
-            offscreen->depthImage = VK_NULL_HANDLE;
-        }
-
-        if (offscreen->colorMemory != VK_NULL_HANDLE)
-        {
-            vkFreeMemory(m_Device, offscreen->colorMemory, nullptr);
-            offscreen->colorMemory = VK_NULL_HANDLE;
-        }
+        // El HiZ depende del tamaño: se recrea en el próximo render
+        DestroyHiZPyramid(offscreen);
 
-        if (offscreen->depthMemory != VK_NULL_HANDLE)
-        {
-            vkFreeMemory(m_Device, offscreen->depthMemory, nullptr);
-            offscreen->depthMemory = VK_NULL_HANDLE;
-        }
+        // ✅ Sin vkDeviceWaitIdle: las imágenes viejas se liberan cuando el frame que
+        // aún las muestra (ImGui) termine. renderID apunta a la vista vieja: el llamador
+        // debe registrar uno nuevo
+        offscreen->RetireRenderID();
+        offscreen->RetireAttachments();
 
         // Actualizar dimensiones
         offscreen->extent = {width, height};
+        offscreen->renderExtent = offscreen->extent;
 
         // Recrear color image
         CreateImage(width, height, offscreen->colorFormat,
@@ -372,7 +536,7 @@ namespace Mantrax
         // Recrear depth image
         CreateImage(width, height, offscreen->depthFormat,
                     VK_IMAGE_TILING_OPTIMAL,
-                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                     offscreen->depthImage, offscreen->depthMemory);
 
@@ -489,36 +653,142 @@ namespace Mantrax
         UpdatePBRDescriptorSet(material);
     }
 
+    void GFX::SetOffscreenRenderExtent(std::shared_ptr<OffscreenFramebuffer> offscreen,
+                                       uint32_t width, uint32_t height)
+    {
+        if (!offscreen)
+            return;
+
+        // El sub-rectángulo nunca supera lo asignado: crecer requiere ResizeOffscreenFramebuffer
+        width = std::clamp(width, 1u, offscreen->extent.width);
+        height = std::clamp(height, 1u, offscreen->extent.height);
+
+        if (offscreen->renderExtent.width == width && offscreen->renderExtent.height == height)
+            return;
+
+        offscreen->renderExtent = {width, height};
+
+        // La pirámide se dimensiona con lo asignado: solo cambian los niveles activos
+        // y el readback del tamaño anterior deja de valer
+        if (offscreen->hiz)
+            ConfigureHiZReadback(*offscreen->hiz, offscreen->renderExtent);
+    }
+
     void GFX::DestroyOffscreenFramebuffer(std::shared_ptr<OffscreenFramebuffer> offscreen)
     {
         if (!offscreen)
             return;
 
-        vkDeviceWaitIdle(m_Device);
+        // Liberación diferida: el último frame enviado puede seguir leyendo el color
+        DestroyHiZPyramid(offscreen);
+        offscreen->RetireRenderID();
+        offscreen->RetireAttachments();
+        m_DeletionQueue->RetireSampler(offscreen->sampler);
+        m_DeletionQueue->RetireRenderPass(offscreen->renderPass);
+
+        offscreen->sampler = VK_NULL_HANDLE;
+        offscreen->renderPass = VK_NULL_HANDLE;
+    }
+
+    VkExtent2D GFX::GetRenderTargetBucket(uint32_t width, uint32_t height) const
+    {
+        const uint32_t g = std::max(1u, m_RenderTargetPoolSettings.bucketGranularity);
+
+        VkExtent2D bucket;
+        bucket.width = ((std::max(1u, width) + g - 1) / g) * g;
+        bucket.height = ((std::max(1u, height) + g - 1) / g) * g;
+        return bucket;
+    }
+
+    std::shared_ptr<OffscreenFramebuffer> GFX::AcquireOffscreenFramebuffer(uint32_t width, uint32_t height)
+    {
+        const VkExtent2D bucket = GetRenderTargetBucket(width, height);
+        const uint64_t completed = m_DeletionQueue->GetCompletedFrame();
+
+        // ✅ Reutilizar un target libre del mismo bucket cuyo último frame ya terminó
+        for (auto it = m_FreeRenderTargets.begin(); it != m_FreeRenderTargets.end(); ++it)
+        {
+            auto &target = it->target;
+            if (target->extent.width != bucket.width || target->extent.height != bucket.height)
+                continue;
+            if (it->releaseFrame > completed)
+                continue;
+
+            auto offscreen = target;
+            m_FreeRenderTargets.erase(it);
+
+            SetOffscreenRenderExtent(offscreen, width, height);
+            return offscreen;
+        }
+
+        auto offscreen = CreateOffscreenFramebuffer(bucket.width, bucket.height);
+        SetOffscreenRenderExtent(offscreen, width, height);
+        return offscreen;
+    }
+
+    void GFX::ReleaseOffscreenFramebuffer(std::shared_ptr<OffscreenFramebuffer> offscreen)
+    {
+        if (!offscreen)
+            return;
+
+        // El HiZ guarda la cámara de otro momento: no usarlo al reutilizar el target
+        if (offscreen->hiz)
+            offscreen->hiz->readback.valid = false;
+
+        m_FreeRenderTargets.push_back({offscreen, m_DeletionQueue->GetSubmittedFrame()});
+        TrimRenderTargetPool();
+    }
+
+    std::shared_ptr<OffscreenFramebuffer> GFX::ResizeOffscreenPooled(std::shared_ptr<OffscreenFramebuffer> current,
+                                                                     uint32_t width, uint32_t height)
+    {
+        if (current)
+        {
+            const VkExtent2D bucket = GetRenderTargetBucket(width, height);
+            const uint64_t neededArea = static_cast<uint64_t>(bucket.width) * bucket.height;
+            const uint64_t currentArea = static_cast<uint64_t>(current->extent.width) * current->extent.height;
+
+            // Cabe y no desperdicia más del doble: solo cambia el sub-rectángulo
+            if (width <= current->extent.width && height <= current->extent.height &&
+                currentArea <= neededArea * 2)
+            {
+                SetOffscreenRenderExtent(current, width, height);
+                return current;
+            }
+        }
+
+        // El nuevo target queda listo antes de devolver el actual al pool
+        auto next = AcquireOffscreenFramebuffer(width, height);
+        ReleaseOffscreenFramebuffer(current);
+        return next;
+    }
+
+    void GFX::TrimRenderTargetPool()
+    {
+        const uint64_t submitted = m_DeletionQueue->GetSubmittedFrame();
+        const auto &settings = m_RenderTargetPoolSettings;
+
+        // Soltar un target lo manda a la cola diferida (destructor de OffscreenFramebuffer)
+        m_FreeRenderTargets.erase(
+            std::remove_if(m_FreeRenderTargets.begin(), m_FreeRenderTargets.end(),
+                           [&](const PooledRenderTarget &entry)
+                           { return submitted - entry.releaseFrame > settings.maxIdleFrames; }),
+            m_FreeRenderTargets.end());
+
+        if (m_FreeRenderTargets.size() > settings.maxFreeTargets)
+            m_FreeRenderTargets.erase(m_FreeRenderTargets.begin(),
+                                      m_FreeRenderTargets.end() - settings.maxFreeTargets);
+    }
 
-        if (offscreen->sampler)
-            vkDestroySampler(m_Device, offscreen->sampler, nullptr);
-        if (offscreen->framebuffer)
-            vkDestroyFramebuffer(m_Device, offscreen->framebuffer, nullptr);
-        if (offscreen->colorImageView)
-            vkDestroyImageView(m_Device, offscreen->colorImageView, nullptr);
-        if (offscreen->colorImage)
-            vkDestroyImage(m_Device, offscreen->colorImage, nullptr);
-        if (offscreen->colorMemory)
-            vkFreeMemory(m_Device, offscreen->colorMemory, nullptr);
-        if (offscreen->depthImageView)
-            vkDestroyImageView(m_Device, offscreen->depthImageView, nullptr);
-        if (offscreen->depthImage)
-            vkDestroyImage(m_Device, offscreen->depthImage, nullptr);
-        if (offscreen->depthMemory)
-            vkFreeMemory(m_Device, offscreen->depthMemory, nullptr);
-        if (offscreen->renderPass)
-            vkDestroyRenderPass(m_Device, offscreen->renderPass, nullptr);
+    void GFX::ClearRenderTargetPool()
+    {
+        m_FreeRenderTargets.clear();
     }
 
     std::shared_ptr<Shader> GFX::CreateShader(const ShaderConfig &config)
     {
         auto shader = std::make_shared<Shader>(config);
+        shader->deletionQueue = m_DeletionQueue;
         CreateShaderPipeline(shader);
         return shader;
     }
@@ -527,12 +797,146 @@ namespace Mantrax
                                           const std::vector<uint32_t> &indices)
     {
         auto mesh = std::make_shared<Mesh>(vertices, indices);
+        mesh->deletionQueue = m_DeletionQueue;
         CreateVertexBuffer(mesh);
         CreateIndexBuffer(mesh);
         CreateUniformBuffer(mesh);
         return mesh;
     }
 
+    std::shared_ptr<Mesh> GFX::CreateMesh(const std::vector<Vertex> &vertices,
+                                          const std::vector<uint32_t> &indices,
+                                          const std::vector<MeshLODData> &lods,
+                                          const std::vector<Meshlet> &meshlets)
+    {
+        auto mesh = std::make_shared<Mesh>(vertices, indices);
+        mesh->deletionQueue = m_DeletionQueue;
+        for (const auto &lod : lods)
+        {
+            if (!lod.indices.empty())
+                mesh->AddLOD(lod.indices, lod.error);
+        }
+
+        CreateVertexBuffer(mesh);
+        CreateIndexBuffer(mesh); // LOD0 + LODs en un solo buffer
+        CreateUniformBuffer(mesh);
+
+        if (!meshlets.empty())
+        {
+            mesh->meshlets = meshlets;
+            CreateMeshletBuffers(mesh);
+        }
+
+        return mesh;
+    }
+
+    std::shared_ptr<Mesh> GFX::CreateMesh(const MeshSource &source)
+    {
+        if (!source.vertices || !source.indices || source.vertexCount == 0 || source.indexCount == 0)
+            throw std::runtime_error("CreateMesh: geometría vacía");
+
+        auto mesh = std::make_shared<Mesh>();
+        mesh->deletionQueue = m_DeletionQueue;
+        mesh->boundsMin = source.boundsMin;
+        mesh->boundsMax = source.boundsMax;
+        mesh->uvDensity = source.uvDensity;
+
+        // Sin 'indices' en CPU: el conteo de cada nivel sale siempre de 'lods'
+        if (source.lods && source.lodCount > 0)
+            mesh->lods.assign(source.lods, source.lods + source.lodCount);
+        else
+            mesh->lods.push_back({0, source.indexCount, 0.0f});
+
+        if (source.submeshes && source.submeshCount > 0)
+            mesh->submeshes.assign(source.submeshes, source.submeshes + source.submeshCount);
+        if (source.submeshLODs && source.submeshLODCount > 0)
+            mesh->submeshLODs.assign(source.submeshLODs, source.submeshLODs + source.submeshLODCount);
+
+        UploadDeviceBuffer(source.vertices, sizeof(Vertex) * source.vertexCount,
+                           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, mesh->vertexBuffer, mesh->vertexBufferMemory);
+        UploadDeviceBuffer(source.indices, sizeof(uint32_t) * source.indexCount,
+                           VK_BUFFER_USAGE_INDEX_BUFFER_BIT, mesh->indexBuffer, mesh->indexBufferMemory);
+        CreateUniformBuffer(mesh);
+
+        if (source.meshlets && source.meshletCount > 0)
+        {
+            mesh->meshlets.assign(source.meshlets, source.meshlets + source.meshletCount);
+            CreateMeshletBuffers(mesh);
+        }
+
+        return mesh;
+    }
+
+    std::shared_ptr<Mesh> GFX::CreateMeshInstance(const std::shared_ptr<Mesh> &source)
+    {
+        if (!source || source->vertexBuffer == VK_NULL_HANDLE || source->indexBuffer == VK_NULL_HANDLE)
+            throw std::runtime_error("CreateMeshInstance: mesh sin geometría");
+
+        auto mesh = std::make_shared<Mesh>();
+        mesh->deletionQueue = m_DeletionQueue;
+        mesh->geometrySource = source->geometrySource ? source->geometrySource : source;
+
+        const Mesh &geometry = *mesh->geometrySource;
+        mesh->vertexBuffer = geometry.vertexBuffer;
+        mesh->indexBuffer = geometry.indexBuffer;
+        mesh->boundsMin = geometry.boundsMin;
+        mesh->boundsMax = geometry.boundsMax;
+        mesh->uvDensity = geometry.uvDensity;
+
+        // Sin 'indices' en CPU: el conteo de cada nivel sale siempre de 'lods'
+        if (!geometry.lods.empty())
+            mesh->lods = geometry.lods;
+        else
+            mesh->lods.push_back({0, geometry.GetIndexCount(), 0.0f});
+
+        mesh->submeshes = geometry.submeshes;
+        mesh->submeshLODs = geometry.submeshLODs;
+
+        CreateUniformBuffer(mesh);
+
+        if (geometry.HasMeshlets())
+        {
+            mesh->meshlets = geometry.meshlets;
+            mesh->meshletBuffer = geometry.meshletBuffer;
+            CreateMeshletDrawBuffer(mesh);
+        }
+
+        return mesh;
+    }
+
+    std::shared_ptr<Mesh> GFX::CreateSubmeshMesh(const std::shared_ptr<Mesh> &mesh, uint32_t submeshIndex)
+    {
+        if (!mesh || mesh->vertexBuffer == VK_NULL_HANDLE || mesh->indexBuffer == VK_NULL_HANDLE)
+            throw std::runtime_error("CreateSubmeshMesh: mesh sin geometría");
+        if (submeshIndex >= mesh->submeshes.size())
+            throw std::runtime_error("CreateSubmeshMesh: submesh fuera de rango");
+
+        const MeshSubmesh &submesh = mesh->submeshes[submeshIndex];
+
+        auto view = std::make_shared<Mesh>();
+        view->deletionQueue = m_DeletionQueue;
+        view->geometrySource = mesh->geometrySource ? mesh->geometrySource : mesh;
+        view->transformSource = mesh->transformSource ? mesh->transformSource : mesh;
+
+        view->vertexBuffer = mesh->vertexBuffer;
+        view->indexBuffer = mesh->indexBuffer;
+        view->uniformBuffer = view->transformSource->uniformBuffer;
+        view->boundsMin = submesh.boundsMin;
+        view->boundsMax = submesh.boundsMax;
+        view->uvDensity = mesh->uvDensity;
+        view->submeshes.push_back(submesh);
+
+        // Sus LODs; el primero es su rango del LOD0
+        if (submesh.lodCount > 0 && submesh.firstLOD + submesh.lodCount <= mesh->submeshLODs.size())
+            view->lods.assign(mesh->submeshLODs.begin() + submesh.firstLOD,
+                              mesh->submeshLODs.begin() + submesh.firstLOD + submesh.lodCount);
+        else
+            view->lods.push_back({submesh.firstIndex, submesh.indexCount, 0.0f});
+
+        // Sin meshlets: los del mesh cubren todos los submeshes
+        return view;
+    }
+
     std::shared_ptr<Material> GFX::CreateMaterial(std::shared_ptr<Shader> shader)
     {
         auto material = std::make_shared<Material>(shader);
@@ -662,6 +1066,7 @@ namespace Mantrax
                                                             std::shared_ptr<RenderPassObject> renderPassObj)
     {
         auto shader = std::make_shared<Shader>(config);
+        shader->deletionQueue = m_DeletionQueue;
         CreateShaderPipeline(shader, renderPassObj->renderPass);
         return shader;
     }
@@ -696,6 +1101,10 @@ namespace Mantrax
             return;
 
         vkWaitForFences(m_Device, 1, &m_InFlightFence, VK_TRUE, UINT64_MAX);
+        WaitAsyncCompute();
+        CollectUploadBatches();
+        m_DeletionQueue->Collect(m_DeletionQueue->GetSubmittedFrame());
+        m_MemoryTracker->Refresh();
 
         uint32_t imageIndex;
         VkResult res = vkAcquireNextImageKHR(
@@ -718,6 +1127,8 @@ namespace Mantrax
         beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
         vkBeginCommandBuffer(cmd, &beginInfo);
 
+        RecordPendingDispatches(cmd);
+
         // Comenzar render pass personalizado
         VkRenderPassBeginInfo renderPassInfo{};
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -736,7 +1147,7 @@ namespace Mantrax
             if (!obj.mesh || !obj.material || !obj.material->shader)
                 continue;
 
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, obj.material->shader->pipeline);
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, GetMaterialPipeline(*obj.material));
 
             VkBuffer vertexBuffers[] = {obj.mesh->vertexBuffer};
             VkDeviceSize offsets[] = {0};
@@ -744,11 +1155,9 @@ namespace Mantrax
             vkCmdBindIndexBuffer(cmd, obj.mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
             // ✅ CAMBIAR ESTO:
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                    obj.material->shader->pipelineLayout,
-                                    0, 1, &obj.mesh->descriptorSet, 0, nullptr);
+            BindMeshDescriptorSets(cmd, obj.material->shader->pipelineLayout, obj.mesh->descriptorSet);
 
-            vkCmdDrawIndexed(cmd, static_cast<uint32_t>(obj.mesh->indices.size()), 1, 0, 0, 0);
+            vkCmdDrawIndexed(cmd, obj.mesh->GetIndexCount(), 1, obj.mesh->GetFirstIndex(), 0, 0);
         }
         // Comandos adicionales (ej: ImGui)
         if (additionalCommands)
@@ -760,28 +1169,9 @@ namespace Mantrax
         vkEndCommandBuffer(cmd);
 
         // Submit y present
-        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        VkSubmitInfo si{};
-        si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        si.waitSemaphoreCount = 1;
-        si.pWaitSemaphores = &m_ImageAvailableSemaphore;
-        si.pWaitDstStageMask = &waitStage;
-        si.commandBufferCount = 1;
-        si.pCommandBuffers = &cmd;
-        si.signalSemaphoreCount = 1;
-        si.pSignalSemaphores = &m_RenderFinishedSemaphore;
-
-        vkQueueSubmit(m_GraphicsQueue, 1, &si, m_InFlightFence);
-
-        VkPresentInfoKHR pi{};
-        pi.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        pi.waitSemaphoreCount = 1;
-        pi.pWaitSemaphores = &m_RenderFinishedSemaphore;
-        pi.swapchainCount = 1;
-        pi.pSwapchains = &m_Swapchain;
-        pi.pImageIndices = &imageIndex;
+        SubmitFrame(cmd);
 
-        vkQueuePresentKHR(m_PresentQueue, &pi);
+        QueuePresent(imageIndex);
     }
 
     // Limpiar render passes personalizados
@@ -824,6 +1214,9 @@ namespace Mantrax
 
     void GFX::UpdateMeshUBO(Mesh *mesh, const UniformBufferObject &ubo)
     {
+        if (mesh && mesh->transformSource)
+            mesh = mesh->transformSource.get();
+
         if (!mesh || mesh->uniformBuffer == VK_NULL_HANDLE)
         {
             throw std::runtime_error("Mesh no tiene uniform buffer válido");
@@ -859,13 +1252,17 @@ namespace Mantrax
             return true;
         }
 
-        if (m_NeedCommandBufferRebuild)
-        {
-            vkDeviceWaitIdle(m_Device);
-            m_NeedCommandBufferRebuild = false;
-        }
+        // Los command buffers se regraban cada frame tras la fence: no hace falta esperar al device
+        m_NeedCommandBufferRebuild = false;
 
         vkWaitForFences(m_Device, 1, &m_InFlightFence, VK_TRUE, UINT64_MAX);
+        WaitAsyncCompute();
+
+        // ✅ La fence cubre todos los frames enviados: liberar lo retirado hasta ahora
+        CollectUploadBatches();
+        m_DeletionQueue->Collect(m_DeletionQueue->GetSubmittedFrame());
+        TrimRenderTargetPool();
+        m_MemoryTracker->Refresh();
 
         uint32_t imageIndex;
         VkResult res = vkAcquireNextImageKHR(
@@ -893,30 +1290,10 @@ namespace Mantrax
         vkResetCommandBuffer(m_CommandBuffers[imageIndex], 0);
         RecordCommandBuffer(m_CommandBuffers[imageIndex], imageIndex, imguiRenderCallback);
 
-        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
-        VkSubmitInfo si{};
-        si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        si.waitSemaphoreCount = 1;
-        si.pWaitSemaphores = &m_ImageAvailableSemaphore;
-        si.pWaitDstStageMask = &waitStage;
-        si.commandBufferCount = 1;
-        si.pCommandBuffers = &m_CommandBuffers[imageIndex];
-        si.signalSemaphoreCount = 1;
-        si.pSignalSemaphores = &m_RenderFinishedSemaphore;
-
-        if (vkQueueSubmit(m_GraphicsQueue, 1, &si, m_InFlightFence) != VK_SUCCESS)
+        if (SubmitFrame(m_CommandBuffers[imageIndex]) != VK_SUCCESS)
             throw std::runtime_error("Error en vkQueueSubmit");
 
-        VkPresentInfoKHR pi{};
-        pi.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        pi.waitSemaphoreCount = 1;
-        pi.pWaitSemaphores = &m_RenderFinishedSemaphore;
-        pi.swapchainCount = 1;
-        pi.pSwapchains = &m_Swapchain;
-        pi.pImageIndices = &imageIndex;
-
-        res = vkQueuePresentKHR(m_PresentQueue, &pi);
+        res = QueuePresent(imageIndex);
         if (res == VK_ERROR_OUT_OF_DATE_KHR || res == VK_SUBOPTIMAL_KHR)
         {
             RecreateSwapchain();
@@ -930,17 +1307,126 @@ namespace Mantrax
         return false;
     }
 
-    void GFX::WaitIdle()
+    VkResult GFX::QueuePresent(uint32_t imageIndex)
     {
-        if (m_Device != VK_NULL_HANDLE)
-        {
-            vkDeviceWaitIdle(m_Device);
-        }
-    }
+        const uint64_t presentId = ++m_PresentId;
 
-    void GFX::ClearRenderObjectsSafe()
+        VkPresentIdKHR presentIdInfo{};
+        presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        presentIdInfo.swapchainCount = 1;
+        presentIdInfo.pPresentIds = &presentId;
+
+        VkPresentInfoKHR pi{};
+        pi.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        pi.pNext = m_SupportsPresentWait ? &presentIdInfo : nullptr;
+        pi.waitSemaphoreCount = 1;
+        pi.pWaitSemaphores = &m_RenderFinishedSemaphore;
+        pi.swapchainCount = 1;
+        pi.pSwapchains = &m_Swapchain;
+        pi.pImageIndices = &imageIndex;
+
+        // Input muestreado para este frame → se mide cuando se confirme su present
+        if (m_HasInputSample)
+        {
+            m_PendingLatencies.emplace_back(presentId, m_InputSampleTime);
+            m_HasInputSample = false;
+
+            while (m_PendingLatencies.size() > 16)
+                m_PendingLatencies.pop_front();
+        }
+
+        return vkQueuePresentKHR(m_PresentQueue, &pi);
+    }
+
+    void GFX::SetPresentMode(PresentMode mode)
     {
-        vkDeviceWaitIdle(m_Device);
+        if (m_Config.presentMode == mode)
+            return;
+
+        m_Config.presentMode = mode;
+        m_FramebufferResized = true;
+    }
+
+    void GFX::SetSwapchainImageCount(uint32_t count)
+    {
+        if (m_Config.swapchainImageCount == count)
+            return;
+
+        m_Config.swapchainImageCount = count;
+        m_FramebufferResized = true;
+    }
+
+    void GFX::WaitForFramePacing(Timer *timer)
+    {
+        if (m_Device == VK_NULL_HANDLE || m_Swapchain == VK_NULL_HANDLE)
+            return;
+
+        if (m_FramePacing.enabled && m_PresentId > 0)
+        {
+            uint64_t completedId = 0;
+
+            if (m_SupportsPresentWait)
+            {
+                // Esperar a que la cola de presentación baje de maxQueuedFrames
+                uint32_t queued = std::max(1u, m_FramePacing.maxQueuedFrames);
+                if (m_PresentId + 1 > queued)
+                {
+                    uint64_t target = m_PresentId + 1 - queued;
+
+                    // Timeout: un present descartado (minimizado, recreación) no debe colgar el loop
+                    if (target >= m_SwapchainFirstPresentId &&
+                        m_vkWaitForPresentKHR(m_Device, m_Swapchain, target, 100000000ull) == VK_SUCCESS)
+                        completedId = target;
+                }
+            }
+            else
+            {
+                // Sin present_wait: el frame anterior terminó en GPU (su present es inminente)
+                vkWaitForFences(m_Device, 1, &m_InFlightFence, VK_TRUE, UINT64_MAX);
+                completedId = m_PresentId;
+            }
+
+            auto now = PacingClock::now();
+            while (!m_PendingLatencies.empty() && m_PendingLatencies.front().first <= completedId)
+            {
+                if (m_PendingLatencies.front().first == completedId && timer)
+                {
+                    std::chrono::duration<float, std::milli> latency = now - m_PendingLatencies.front().second;
+                    timer->RecordInputLatency(latency.count());
+                }
+                m_PendingLatencies.pop_front();
+            }
+        }
+
+        // Límite de frame rate: dormir hasta el siguiente slot
+        if (m_FramePacing.enabled && m_FramePacing.targetFrameRate > 0.0f)
+        {
+            auto period = std::chrono::duration_cast<PacingClock::duration>(
+                std::chrono::duration<double>(1.0 / m_FramePacing.targetFrameRate));
+            auto now = PacingClock::now();
+
+            if (m_NextFrameDeadline > now)
+                std::this_thread::sleep_until(m_NextFrameDeadline);
+
+            // Si vamos tarde no se acumula deuda: el siguiente slot cuenta desde ahora
+            m_NextFrameDeadline = std::max(m_NextFrameDeadline, now) + period;
+        }
+
+        m_InputSampleTime = PacingClock::now();
+        m_HasInputSample = true;
+    }
+
+    void GFX::WaitIdle()
+    {
+        if (m_Device != VK_NULL_HANDLE)
+        {
+            vkDeviceWaitIdle(m_Device);
+        }
+    }
+
+    void GFX::ClearRenderObjectsSafe()
+    {
+        // Los meshes que se queden sin referencias se liberan por la cola diferida
         m_RenderObjects.clear();
         m_NeedCommandBufferRebuild = true;
     }
@@ -985,32 +1471,82 @@ namespace Mantrax
     //     UpdatePBRDescriptorSet(material);
     // }
 
+    void GFX::UploadImageRegions(VkImage image, const void *data, VkDeviceSize size,
+                                 const std::vector<VkBufferImageCopy> &regions,
+                                 uint32_t mipLevels, uint32_t layerCount)
+    {
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingMemory;
+        CreateBuffer(size,
+                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     stagingBuffer, stagingMemory);
+
+        void *mappedData;
+        vkMapMemory(m_Device, stagingMemory, 0, size, 0, &mappedData);
+        memcpy(mappedData, data, static_cast<size_t>(size));
+        vkUnmapMemory(m_Device, stagingMemory);
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, layerCount};
+
+        VkCommandBuffer cmd = BeginUploadCommands();
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        vkCmdCopyBufferToImage(cmd, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(regions.size()), regions.data());
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        EndUploadCommands(cmd);
+
+        ReleaseStagingBuffer(stagingBuffer, stagingMemory);
+    }
+
     std::vector<char> GFX::ReadFile(const std::string &filename)
     {
-        std::ifstream file(filename, std::ios::binary | std::ios::ate);
-        if (!file)
+        // Desde un .mxpak montado si lo contiene; si no, mapeado del disco
+        MappedFile file;
+        if (!file.Open(filename))
             throw std::runtime_error("No se pudo abrir: " + filename);
 
-        size_t size = (size_t)file.tellg();
-        std::vector<char> buffer(size);
-        file.seekg(0);
-        file.read(buffer.data(), size);
-        return buffer;
+        const char *data = reinterpret_cast<const char *>(file.GetData());
+        return std::vector<char>(data, data + file.GetSize());
     }
 
     void GFX::CreateImage(uint32_t width, uint32_t height, VkFormat format,
                           VkImageTiling tiling, VkImageUsageFlags usage,
                           VkMemoryPropertyFlags properties,
-                          VkImage &image, VkDeviceMemory &memory)
+                          VkImage &image, VkDeviceMemory &memory,
+                          uint32_t mipLevels, bool shareWithCompute,
+                          uint32_t arrayLayers, VkImageCreateFlags flags)
     {
+        uint32_t families[] = {m_GraphicsQueueFamily, m_ComputeQueueFamily};
+
         VkImageCreateInfo imageInfo{};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.flags = flags;
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
         imageInfo.extent.width = width;
         imageInfo.extent.height = height;
         imageInfo.extent.depth = 1;
-        imageInfo.mipLevels = 1;
-        imageInfo.arrayLayers = 1;
+        imageInfo.mipLevels = mipLevels;
+        imageInfo.arrayLayers = arrayLayers;
         imageInfo.format = format;
         imageInfo.tiling = tiling;
         imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -1018,36 +1554,48 @@ namespace Mantrax
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+        if (shareWithCompute && HasAsyncCompute())
+        {
+            imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            imageInfo.queueFamilyIndexCount = 2;
+            imageInfo.pQueueFamilyIndices = families;
+        }
+
         if (vkCreateImage(m_Device, &imageInfo, nullptr, &image) != VK_SUCCESS)
             throw std::runtime_error("Error creando imagen");
 
         VkMemoryRequirements memReqs;
         vkGetImageMemoryRequirements(m_Device, image, &memReqs);
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memReqs.size;
-        allocInfo.memoryTypeIndex = FindMemoryType(memReqs.memoryTypeBits, properties);
-
-        if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
-            throw std::runtime_error("Error allocando memoria de imagen");
+        try
+        {
+            memory = AllocateMemory(memReqs, properties, ClassifyImageMemory(usage));
+        }
+        catch (...)
+        {
+            vkDestroyImage(m_Device, image, nullptr);
+            image = VK_NULL_HANDLE;
+            throw;
+        }
 
         vkBindImageMemory(m_Device, image, memory, 0);
     }
 
     VkImageView GFX::CreateImageView(VkImage image, VkFormat format,
-                                     VkImageAspectFlags aspectFlags)
+                                     VkImageAspectFlags aspectFlags,
+                                     uint32_t baseMipLevel, uint32_t levelCount,
+                                     VkImageViewType viewType, uint32_t layerCount)
     {
         VkImageViewCreateInfo viewInfo{};
         viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         viewInfo.image = image;
-        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.viewType = viewType;
         viewInfo.format = format;
         viewInfo.subresourceRange.aspectMask = aspectFlags;
-        viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseMipLevel = baseMipLevel;
+        viewInfo.subresourceRange.levelCount = levelCount;
         viewInfo.subresourceRange.baseArrayLayer = 0;
-        viewInfo.subresourceRange.layerCount = 1;
+        viewInfo.subresourceRange.layerCount = layerCount;
 
         VkImageView imageView;
         if (vkCreateImageView(m_Device, &viewInfo, nullptr, &imageView) != VK_SUCCESS)
@@ -1072,7 +1620,7 @@ namespace Mantrax
         depthAttachment.format = depthFormat;
         depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
         depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE; // ✅ El HiZ lee el depth tras el pass
         depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -1148,7 +1696,7 @@ namespace Mantrax
         return cmd;
     }
 
-    void GFX::EndSingleTimeCommands(VkCommandBuffer cmd)
+    void GFX::EndSingleTimeCommands(VkCommandBuffer cmd, bool waitAsyncCompute)
     {
         vkEndCommandBuffer(cmd);
 
@@ -1157,12 +1705,124 @@ namespace Mantrax
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &cmd;
 
+        // El semáforo binario lo consume el primer submit que lee el compute asíncrono;
+        // SubmitFrame ya no debe esperarlo (nadie volvería a señalarlo)
+        const VkPipelineStageFlags computeWaitStage =
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+        if (waitAsyncCompute && m_ComputeSemaphorePending)
+        {
+            submitInfo.waitSemaphoreCount = 1;
+            submitInfo.pWaitSemaphores = &m_ComputeFinishedSemaphore;
+            submitInfo.pWaitDstStageMask = &computeWaitStage;
+            m_ComputeSemaphorePending = false;
+        }
+
         vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
         vkQueueWaitIdle(m_GraphicsQueue);
 
         vkFreeCommandBuffers(m_Device, m_CommandPool, 1, &cmd);
     }
 
+    VkCommandBuffer GFX::BeginUploadCommands()
+    {
+        return m_UploadBatchCmd != VK_NULL_HANDLE ? m_UploadBatchCmd : BeginSingleTimeCommands();
+    }
+
+    void GFX::EndUploadCommands(VkCommandBuffer cmd)
+    {
+        // Dentro de un lote se envía todo junto en EndUploadBatch
+        if (cmd != m_UploadBatchCmd)
+            EndSingleTimeCommands(cmd);
+    }
+
+    void GFX::ReleaseStagingBuffer(VkBuffer buffer, VkDeviceMemory memory)
+    {
+        if (m_UploadBatchCmd != VK_NULL_HANDLE)
+        {
+            m_UploadBatchStaging.emplace_back(buffer, memory);
+            return;
+        }
+
+        vkDestroyBuffer(m_Device, buffer, nullptr);
+        FreeMemory(memory);
+    }
+
+    void GFX::BeginUploadBatch()
+    {
+        if (m_UploadBatchDepth++ == 0)
+            m_UploadBatchCmd = BeginSingleTimeCommands();
+    }
+
+    void GFX::EndUploadBatch()
+    {
+        if (m_UploadBatchDepth == 0 || --m_UploadBatchDepth > 0)
+            return;
+
+        UploadBatch batch;
+        batch.cmd = m_UploadBatchCmd;
+        batch.staging = std::move(m_UploadBatchStaging);
+        m_UploadBatchCmd = VK_NULL_HANDLE;
+        m_UploadBatchStaging.clear();
+
+        // Sin esperar a la cola: los submits posteriores (misma cola) quedan detrás de esta barrera
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+                                VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT |
+                                VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+        vkCmdPipelineBarrier(batch.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                             1, &barrier, 0, nullptr, 0, nullptr);
+        vkEndCommandBuffer(batch.cmd);
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vkCreateFence(m_Device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS)
+            throw std::runtime_error("Error creando fence del lote de subidas");
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.cmd;
+
+        if (vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, batch.fence) != VK_SUCCESS)
+            throw std::runtime_error("Error en vkQueueSubmit (lote de subidas)");
+
+        // ✅ El staging se retira cuando la fence del lote señaliza (CollectUploadBatches)
+        m_InFlightUploadBatches.push_back(std::move(batch));
+        CollectUploadBatches();
+    }
+
+    void GFX::CollectUploadBatches(bool wait)
+    {
+        for (auto it = m_InFlightUploadBatches.begin(); it != m_InFlightUploadBatches.end();)
+        {
+            if (wait)
+                vkWaitForFences(m_Device, 1, &it->fence, VK_TRUE, UINT64_MAX);
+            else if (vkGetFenceStatus(m_Device, it->fence) != VK_SUCCESS)
+            {
+                ++it;
+                continue;
+            }
+
+            // Las copias terminaron: el staging pasa a la cola diferida como cualquier recurso
+            for (auto &[buffer, memory] : it->staging)
+            {
+                m_DeletionQueue->RetireBuffer(buffer);
+                m_DeletionQueue->RetireMemory(memory);
+            }
+
+            vkDestroyFence(m_Device, it->fence, nullptr);
+            vkFreeCommandBuffers(m_Device, m_CommandPool, 1, &it->cmd);
+            it = m_InFlightUploadBatches.erase(it);
+        }
+    }
+
     void GFX::TransitionImageLayout(VkImage image, VkFormat format,
                                     VkImageLayout oldLayout, VkImageLayout newLayout)
     {
@@ -1318,65 +1978,144 @@ namespace Mantrax
         throw std::runtime_error("No se encontró tipo de memoria adecuado");
     }
 
+    VkDeviceMemory GFX::AllocateMemory(const VkMemoryRequirements &reqs, VkMemoryPropertyFlags props,
+                                       MemoryCategory category)
+    {
+        uint32_t typeIndex = FindMemoryType(reqs.memoryTypeBits, props);
+        const bool deviceLocal = m_MemoryTracker->IsDeviceLocalType(typeIndex);
+
+        // ✅ Antes de pedir VRAM: si no cabe en el presupuesto, las cachés sueltan lo menos usado
+        if (deviceLocal && !m_EvictingMemory)
+        {
+            if (uint64_t over = m_MemoryTracker->GetOverBudget(reqs.size))
+            {
+                m_EvictingMemory = true;
+                m_MemoryTracker->Evict(over);
+                m_EvictingMemory = false;
+            }
+        }
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = reqs.size;
+        allocInfo.memoryTypeIndex = typeIndex;
+
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkResult result = vkAllocateMemory(m_Device, &allocInfo, nullptr, &memory);
+
+        if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY || result == VK_ERROR_OUT_OF_HOST_MEMORY)
+        {
+            m_MemoryTracker->OnFailedAllocation();
+
+            if (!m_EvictingMemory)
+            {
+                m_EvictingMemory = true;
+                m_MemoryTracker->Evict(reqs.size);
+                m_EvictingMemory = false;
+            }
+
+            // Lo retirado sigue ocupando memoria hasta su fence: esperar y liberarlo ya
+            vkDeviceWaitIdle(m_Device);
+            if (m_DeletionQueue)
+                m_DeletionQueue->Flush();
+
+            result = vkAllocateMemory(m_Device, &allocInfo, nullptr, &memory);
+        }
+
+        // ⚠️ Sin VRAM: cualquier otro tipo compatible fuera del heap local (más lento, pero no se cae)
+        bool hostFallback = false;
+        if (result != VK_SUCCESS && deviceLocal && m_MemoryTracker->GetSettings().allowHostFallback)
+        {
+            const VkPhysicalDeviceMemoryProperties &memProps = m_MemoryTracker->GetMemoryProperties();
+            const VkMemoryPropertyFlags required = props & ~VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+            for (uint32_t i = 0; i < memProps.memoryTypeCount && result != VK_SUCCESS; i++)
+            {
+                if (!(reqs.memoryTypeBits & (1u << i)) || m_MemoryTracker->IsDeviceLocalType(i) ||
+                    (memProps.memoryTypes[i].propertyFlags & required) != required)
+                    continue;
+
+                allocInfo.memoryTypeIndex = i;
+                result = vkAllocateMemory(m_Device, &allocInfo, nullptr, &memory);
+                if (result == VK_SUCCESS)
+                {
+                    typeIndex = i;
+                    hostFallback = true;
+                    std::cerr << "⚠️ VRAM agotada: " << GetMemoryCategoryName(category) << " ("
+                              << reqs.size / 1024 << " KB) en memoria del sistema" << std::endl;
+                }
+            }
+        }
+
+        if (result != VK_SUCCESS)
+        {
+            m_MemoryTracker->OnFailedAllocation();
+            throw std::runtime_error(std::string("Error allocando memoria (") + GetMemoryCategoryName(category) +
+                                     ", " + std::to_string(reqs.size / 1024) + " KB)");
+        }
+
+        m_MemoryTracker->OnAllocate(memory, reqs.size, typeIndex, category, hostFallback);
+        return memory;
+    }
+
+    void GFX::FreeMemory(VkDeviceMemory memory)
+    {
+        if (memory == VK_NULL_HANDLE)
+            return;
+
+        m_MemoryTracker->OnFree(memory);
+        vkFreeMemory(m_Device, memory, nullptr);
+    }
+
     void GFX::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
                            VkMemoryPropertyFlags props, VkBuffer &buffer,
-                           VkDeviceMemory &memory)
+                           VkDeviceMemory &memory, bool shareWithCompute)
     {
+        // CONCURRENT entre gráficos y compute: sin transferencias de ownership entre colas
+        uint32_t families[] = {m_GraphicsQueueFamily, m_ComputeQueueFamily};
+
         VkBufferCreateInfo bufferInfo{};
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         bufferInfo.size = size;
         bufferInfo.usage = usage;
         bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+        if (shareWithCompute && HasAsyncCompute())
+        {
+            bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = 2;
+            bufferInfo.pQueueFamilyIndices = families;
+        }
+
         if (vkCreateBuffer(m_Device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
             throw std::runtime_error("Error creando buffer");
 
         VkMemoryRequirements memReqs;
         vkGetBufferMemoryRequirements(m_Device, buffer, &memReqs);
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memReqs.size;
-        allocInfo.memoryTypeIndex = FindMemoryType(memReqs.memoryTypeBits, props);
-
-        if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
-            throw std::runtime_error("Error allocando memoria de buffer");
+        try
+        {
+            memory = AllocateMemory(memReqs, props, ClassifyBufferMemory(usage));
+        }
+        catch (...)
+        {
+            vkDestroyBuffer(m_Device, buffer, nullptr);
+            buffer = VK_NULL_HANDLE;
+            throw;
+        }
 
         vkBindBufferMemory(m_Device, buffer, memory, 0);
     }
 
     void GFX::CopyBuffer(VkBuffer src, VkBuffer dst, VkDeviceSize size)
     {
-        VkCommandBufferAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = m_CommandPool;
-        allocInfo.commandBufferCount = 1;
-
-        VkCommandBuffer cmd;
-        vkAllocateCommandBuffers(m_Device, &allocInfo, &cmd);
-
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-        vkBeginCommandBuffer(cmd, &beginInfo);
+        VkCommandBuffer cmd = BeginUploadCommands();
 
         VkBufferCopy copyRegion{};
         copyRegion.size = size;
         vkCmdCopyBuffer(cmd, src, dst, 1, &copyRegion);
 
-        vkEndCommandBuffer(cmd);
-
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &cmd;
-
-        vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(m_GraphicsQueue);
-
-        vkFreeCommandBuffers(m_Device, m_CommandPool, 1, &cmd);
+        EndUploadCommands(cmd);
     }
 
     void GFX::InitVulkan()
@@ -1385,7 +2124,7 @@ namespace Mantrax
         CreateSurface();
         PickPhysicalDevice();
         CreateLogicalDevice();
-        CreateSwapchain(false);
+        CreateSwapchain();
         CreateImageViews();
         CreateDepthResources();
         CreateRenderPass();
@@ -1394,6 +2133,20 @@ namespace Mantrax
         CreateCommandPool();
         CreateCommandBuffers();
         CreateSyncObjects();
+        CreateTimestampQueries();
+
+        m_DeletionQueue = std::make_shared<DeletionQueue>(m_Device, m_DescriptorPool);
+        m_DeletionQueue->SetMemoryTracker(m_MemoryTracker);
+
+        MemoryEvictionHandler streaming;
+        streaming.name = "Texture streaming";
+        streaming.oldestUse = [this]()
+        { return GetOldestStreamedTextureUse(); };
+        streaming.evictOldest = [this]()
+        { return EvictOldestStreamedTexture(); };
+        m_StreamingEvictionHandler = m_MemoryTracker->RegisterEvictionHandler(streaming);
+
+        CreateLightingResources();
     }
 
     void GFX::CreateInstance()
@@ -1447,12 +2200,18 @@ namespace Mantrax
 
             uint32_t gfx = UINT32_MAX;
             uint32_t present = UINT32_MAX;
+            uint32_t compute = UINT32_MAX;
 
             for (uint32_t i = 0; i < qCount; ++i)
             {
                 if (props[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
                     gfx = i;
 
+                // Familia solo-compute: corre en paralelo al raster (async compute)
+                if ((props[i].queueFlags & VK_QUEUE_COMPUTE_BIT) && !(props[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) &&
+                    compute == UINT32_MAX)
+                    compute = i;
+
                 VkBool32 support = VK_FALSE;
                 vkGetPhysicalDeviceSurfaceSupportKHR(dev, i, m_Surface, &support);
                 if (support)
@@ -1464,6 +2223,7 @@ namespace Mantrax
                 m_PhysicalDevice = dev;
                 m_GraphicsQueueFamily = gfx;
                 m_PresentQueueFamily = present;
+                m_ComputeQueueFamily = compute != UINT32_MAX ? compute : gfx;
                 return;
             }
         }
@@ -1476,7 +2236,7 @@ namespace Mantrax
         float priority = 1.0f;
 
         std::vector<VkDeviceQueueCreateInfo> queues;
-        std::set<uint32_t> uniqueFamilies = {m_GraphicsQueueFamily, m_PresentQueueFamily};
+        std::set<uint32_t> uniqueFamilies = {m_GraphicsQueueFamily, m_PresentQueueFamily, m_ComputeQueueFamily};
 
         for (uint32_t family : uniqueFamilies)
         {
@@ -1488,23 +2248,100 @@ namespace Mantrax
             queues.push_back(q);
         }
 
-        const char *exts[] = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+        std::vector<const char *> exts = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+
+        // ✅ VK_KHR_present_wait (+ present_id): pacing por frame presentado, no por fence
+        uint32_t extCount = 0;
+        vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extCount, nullptr);
+        std::vector<VkExtensionProperties> available(extCount);
+        vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extCount, available.data());
+
+        auto hasExtension = [&available](const char *name)
+        {
+            for (const auto &ext : available)
+            {
+                if (strcmp(ext.extensionName, name) == 0)
+                    return true;
+            }
+            return false;
+        };
+
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+        presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+        presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        presentWaitFeatures.pNext = &presentIdFeatures;
+
+        if (hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) && hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+        {
+            VkPhysicalDeviceFeatures2 features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &presentWaitFeatures;
+            vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &features2);
+
+            m_SupportsPresentWait = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+        }
+
+        if (m_SupportsPresentWait)
+        {
+            exts.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            exts.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        }
+
+        // ✅ VK_EXT_memory_budget: presupuesto y uso reales del heap (incluye otros procesos)
+        m_SupportsMemoryBudget = hasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        if (m_SupportsMemoryBudget)
+            exts.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+        // ✅ Features opcionales: solo se activan si el dispositivo las soporta
+        VkPhysicalDeviceFeatures supported{};
+        vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supported);
+
+        VkPhysicalDeviceFeatures features{};
+        features.samplerAnisotropy = supported.samplerAnisotropy;
+        features.multiDrawIndirect = supported.multiDrawIndirect; // Draws por meshlet en un solo comando
+        features.textureCompressionBC = supported.textureCompressionBC;             // Texturas cocinadas (desktop)
+        features.textureCompressionASTC_LDR = supported.textureCompressionASTC_LDR; // Texturas cocinadas (móvil)
+
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(m_PhysicalDevice, &props);
+        m_SupportsMultiDrawIndirect = supported.multiDrawIndirect == VK_TRUE;
+        m_MaxDrawIndirectCount = m_SupportsMultiDrawIndirect ? props.limits.maxDrawIndirectCount : 1;
 
         VkDeviceCreateInfo ci{};
         ci.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
         ci.queueCreateInfoCount = static_cast<uint32_t>(queues.size());
         ci.pQueueCreateInfos = queues.data();
-        ci.enabledExtensionCount = 1;
-        ci.ppEnabledExtensionNames = exts;
+        ci.enabledExtensionCount = static_cast<uint32_t>(exts.size());
+        ci.ppEnabledExtensionNames = exts.data();
+        ci.pEnabledFeatures = &features;
+        ci.pNext = m_SupportsPresentWait ? &presentWaitFeatures : nullptr;
 
         if (vkCreateDevice(m_PhysicalDevice, &ci, nullptr, &m_Device) != VK_SUCCESS)
             throw std::runtime_error("Error creando dispositivo lógico");
 
         vkGetDeviceQueue(m_Device, m_GraphicsQueueFamily, 0, &m_GraphicsQueue);
         vkGetDeviceQueue(m_Device, m_PresentQueueFamily, 0, &m_PresentQueue);
-    }
+        vkGetDeviceQueue(m_Device, m_ComputeQueueFamily, 0, &m_ComputeQueue);
 
-    void GFX::CreateSwapchain(bool enableVSync)
+        std::cout << (HasAsyncCompute() ? "✅ Async compute: familia " : "⚠️ Sin familia de compute dedicada, compute en la cola gráfica: familia ")
+                  << m_ComputeQueueFamily << "\n";
+
+        if (m_SupportsPresentWait)
+        {
+            m_vkWaitForPresentKHR = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+                vkGetDeviceProcAddr(m_Device, "vkWaitForPresentKHR"));
+            m_SupportsPresentWait = m_vkWaitForPresentKHR != nullptr;
+        }
+
+        m_MemoryTracker = std::make_shared<MemoryTracker>(m_PhysicalDevice, m_SupportsMemoryBudget);
+
+        MemoryStats memory = m_MemoryTracker->GetStats();
+        std::cout << (m_SupportsMemoryBudget ? "✅ VRAM budget (VK_EXT_memory_budget): " : "⚠️ Sin VK_EXT_memory_budget, presupuesto por tamaño de heap: ")
+                  << memory.deviceLocalBudget / (1024 * 1024) << " MB\n";
+    }
+
+    void GFX::CreateSwapchain()
     {
         VkSurfaceCapabilitiesKHR caps{};
         vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_PhysicalDevice, m_Surface, &caps);
@@ -1538,10 +2375,42 @@ namespace Mantrax
                                      std::min(caps.maxImageExtent.height, extent.height));
         }
 
-        uint32_t imgCount = caps.minImageCount + 1;
+        // MAILBOX necesita una imagen extra para no bloquear al adquirir
+        uint32_t imgCount = m_Config.swapchainImageCount > 0 ? m_Config.swapchainImageCount : caps.minImageCount + 1;
+        imgCount = std::max(imgCount, caps.minImageCount);
         if (caps.maxImageCount > 0 && imgCount > caps.maxImageCount)
             imgCount = caps.maxImageCount;
 
+        uint32_t pmCount = 0;
+        vkGetPhysicalDeviceSurfacePresentModesKHR(m_PhysicalDevice, m_Surface, &pmCount, nullptr);
+        std::vector<VkPresentModeKHR> presentModes(pmCount);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(m_PhysicalDevice, m_Surface, &pmCount, presentModes.data());
+
+        // Orden de preferencia según el modo pedido; FIFO siempre está disponible
+        std::vector<VkPresentModeKHR> preference;
+        switch (m_Config.presentMode)
+        {
+        case PresentMode::Mailbox:
+            // Sin MAILBOX se cae a FIFO: pedir "sin tearing" nunca debe acabar en IMMEDIATE
+            preference = {VK_PRESENT_MODE_MAILBOX_KHR};
+            break;
+        case PresentMode::Immediate:
+            preference = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR};
+            break;
+        case PresentMode::VSync:
+            break;
+        }
+
+        m_ActivePresentMode = VK_PRESENT_MODE_FIFO_KHR;
+        for (VkPresentModeKHR mode : preference)
+        {
+            if (std::find(presentModes.begin(), presentModes.end(), mode) != presentModes.end())
+            {
+                m_ActivePresentMode = mode;
+                break;
+            }
+        }
+
         VkSwapchainCreateInfoKHR ci{};
         ci.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
         ci.surface = m_Surface;
@@ -1567,14 +2436,7 @@ namespace Mantrax
         ci.preTransform = caps.currentTransform;
         ci.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 
-        if (enableVSync)
-        {
-            ci.presentMode = VK_PRESENT_MODE_FIFO_KHR;
-        }
-        else
-        {
-            ci.presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
-        }
+        ci.presentMode = m_ActivePresentMode;
 
         ci.clipped = VK_TRUE;
         ci.oldSwapchain = VK_NULL_HANDLE;
@@ -1586,6 +2448,9 @@ namespace Mantrax
         m_SwapchainImages.resize(imgCount);
         vkGetSwapchainImagesKHR(m_Device, m_Swapchain, &imgCount, m_SwapchainImages.data());
 
+        // Los ids de present_wait solo valen para el swapchain en que se presentaron
+        m_SwapchainFirstPresentId = m_PresentId + 1;
+
         m_SwapchainImageFormat = chosen.format;
         m_SwapchainExtent = extent;
     }
@@ -1657,14 +2522,7 @@ namespace Mantrax
         VkMemoryRequirements memReqs;
         vkGetImageMemoryRequirements(m_Device, m_DepthImage, &memReqs);
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memReqs.size;
-        allocInfo.memoryTypeIndex = FindMemoryType(memReqs.memoryTypeBits,
-                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-        if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &m_DepthImageMemory) != VK_SUCCESS)
-            throw std::runtime_error("Error allocando memoria depth");
+        m_DepthImageMemory = AllocateMemory(memReqs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryCategory::RenderTarget);
 
         vkBindImageMemory(m_Device, m_DepthImage, m_DepthImageMemory, 0);
 
@@ -1747,7 +2605,7 @@ namespace Mantrax
 
     void GFX::CreateDescriptorPool()
     {
-        std::array<VkDescriptorPoolSize, 2> poolSizes{};
+        std::array<VkDescriptorPoolSize, 4> poolSizes{};
 
         // UBOs
         poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -1757,6 +2615,14 @@ namespace Mantrax
         poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         poolSizes[1].descriptorCount = 5000; // 1000 materiales * 5 texturas
 
+        // Storage images (niveles del HiZ + compute de usuario)
+        poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        poolSizes[2].descriptorCount = 1024;
+
+        // Storage buffers (meshlets + draw commands por mesh + compute de usuario)
+        poolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[3].descriptorCount = 2000;
+
         VkDescriptorPoolCreateInfo poolInfo{};
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
@@ -1831,40 +2697,153 @@ namespace Mantrax
             vkCreateSemaphore(m_Device, &si, nullptr, &m_RenderFinishedSemaphore) != VK_SUCCESS ||
             vkCreateFence(m_Device, &fi, nullptr, &m_InFlightFence) != VK_SUCCESS)
             throw std::runtime_error("Error creando objetos de sincronización");
+
+        if (!HasAsyncCompute())
+            return;
+
+        // ✅ Async compute: pool/command buffer propios + semáforo hacia el siguiente submit gráfico
+        VkCommandPoolCreateInfo pi{};
+        pi.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pi.queueFamilyIndex = m_ComputeQueueFamily;
+        pi.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        if (vkCreateCommandPool(m_Device, &pi, nullptr, &m_ComputeCommandPool) != VK_SUCCESS)
+            throw std::runtime_error("Error creando command pool de compute");
+
+        VkCommandBufferAllocateInfo ai{};
+        ai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        ai.commandPool = m_ComputeCommandPool;
+        ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        ai.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(m_Device, &ai, &m_ComputeCommandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Error allocando command buffer de compute");
+
+        if (vkCreateSemaphore(m_Device, &si, nullptr, &m_ComputeFinishedSemaphore) != VK_SUCCESS ||
+            vkCreateFence(m_Device, &fi, nullptr, &m_ComputeFence) != VK_SUCCESS)
+            throw std::runtime_error("Error creando sincronización de compute");
     }
 
-    void GFX::CreateShaderPipeline(std::shared_ptr<Shader> shader, VkRenderPass renderPass)
+    void GFX::CreateTimestampQueries()
+    {
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(m_PhysicalDevice, &props);
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &familyCount, families.data());
+
+        const uint32_t validBits = families[m_GraphicsQueueFamily].timestampValidBits;
+
+        // ⚠️ Sin timestamps la resolución dinámica se queda en escala fija
+        if (validBits == 0 || props.limits.timestampPeriod <= 0.0f)
+        {
+            std::cout << "⚠️ GPU timestamps not supported on graphics queue" << std::endl;
+            return;
+        }
+
+        m_TimestampPeriod = props.limits.timestampPeriod;
+        m_TimestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1ull);
+
+        VkQueryPoolCreateInfo qi{};
+        qi.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        qi.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        qi.queryCount = 2; // Inicio y fin del pase offscreen
+
+        if (vkCreateQueryPool(m_Device, &qi, nullptr, &m_TimestampQueryPool) != VK_SUCCESS)
+        {
+            std::cerr << "⚠️ Failed to create timestamp query pool" << std::endl;
+            m_TimestampQueryPool = VK_NULL_HANDLE;
+        }
+    }
+
+    std::vector<std::shared_ptr<Shader>> GFX::LockLiveShaders()
+    {
+        // Descartar los shaders ya destruidos (sus handles están en la cola diferida)
+        std::vector<std::shared_ptr<Shader>> live;
+        live.reserve(m_AllShaders.size());
+
+        auto it = m_AllShaders.begin();
+        while (it != m_AllShaders.end())
+        {
+            if (auto shader = it->lock())
+            {
+                live.push_back(shader);
+                ++it;
+            }
+            else
+            {
+                it = m_AllShaders.erase(it);
+            }
+        }
+
+        return live;
+    }
+
+    VkPipeline GFX::CreateShaderVariant(const Shader &shader, uint32_t featureMask)
     {
-        auto vertCode = ReadFile(shader->config.vertexShaderPath);
-        auto fragCode = ReadFile(shader->config.fragmentShaderPath);
+        auto vertCode = ReadFile(shader.config.vertexShaderPath);
+        auto fragCode = ReadFile(shader.config.fragmentShaderPath);
 
         VkShaderModule vert = CreateShaderModule(vertCode);
         VkShaderModule frag = CreateShaderModule(fragCode);
 
+        // Constantes de especialización: las del config + las features del material
+        std::vector<VkSpecializationMapEntry> specEntries;
+        std::vector<uint32_t> specData;
+
+        for (const auto &constant : shader.config.specializationConstants)
+        {
+            // La máscara manda sobre los IDs reservados a features
+            if (shader.config.materialVariants && constant.constantID < MATERIAL_FEATURE_COUNT)
+                continue;
+
+            specEntries.push_back({constant.constantID, static_cast<uint32_t>(specData.size() * sizeof(uint32_t)), sizeof(uint32_t)});
+            specData.push_back(constant.value);
+        }
+
+        if (shader.config.materialVariants)
+        {
+            for (uint32_t id = 0; id < MATERIAL_FEATURE_COUNT; ++id)
+            {
+                specEntries.push_back({id, static_cast<uint32_t>(specData.size() * sizeof(uint32_t)), sizeof(VkBool32)});
+                specData.push_back((featureMask & (1u << id)) ? VK_TRUE : VK_FALSE);
+            }
+        }
+
+        VkSpecializationInfo specInfo{};
+        specInfo.mapEntryCount = static_cast<uint32_t>(specEntries.size());
+        specInfo.pMapEntries = specEntries.data();
+        specInfo.dataSize = specData.size() * sizeof(uint32_t);
+        specInfo.pData = specData.data();
+
         VkPipelineShaderStageCreateInfo vs{};
         vs.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         vs.stage = VK_SHADER_STAGE_VERTEX_BIT;
         vs.module = vert;
         vs.pName = "main";
+        vs.pSpecializationInfo = specEntries.empty() ? nullptr : &specInfo;
 
         VkPipelineShaderStageCreateInfo fs{};
         fs.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         fs.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
         fs.module = frag;
         fs.pName = "main";
+        fs.pSpecializationInfo = specEntries.empty() ? nullptr : &specInfo;
 
         VkPipelineShaderStageCreateInfo stages[] = {vs, fs};
 
         VkPipelineVertexInputStateCreateInfo vin{};
         vin.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
         vin.vertexBindingDescriptionCount = 1;
-        vin.pVertexBindingDescriptions = &shader->config.vertexBinding;
-        vin.vertexAttributeDescriptionCount = static_cast<uint32_t>(shader->config.vertexAttributes.size());
-        vin.pVertexAttributeDescriptions = shader->config.vertexAttributes.data();
+        vin.pVertexBindingDescriptions = &shader.config.vertexBinding;
+        vin.vertexAttributeDescriptionCount = static_cast<uint32_t>(shader.config.vertexAttributes.size());
+        vin.pVertexAttributeDescriptions = shader.config.vertexAttributes.data();
 
         VkPipelineInputAssemblyStateCreateInfo ia{};
         ia.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        ia.topology = shader->config.topology;
+        ia.topology = shader.config.topology;
 
         // ✅ VIEWPORT Y SCISSOR DINÁMICOS
         VkViewport vp{};
@@ -1886,9 +2865,9 @@ namespace Mantrax
 
         VkPipelineRasterizationStateCreateInfo rs{};
         rs.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rs.polygonMode = shader->config.polygonMode;
-        rs.cullMode = shader->config.cullMode;
-        rs.frontFace = shader->config.frontFace;
+        rs.polygonMode = shader.config.polygonMode;
+        rs.cullMode = shader.config.cullMode;
+        rs.frontFace = shader.config.frontFace;
         rs.lineWidth = 1.0f;
 
         VkPipelineMultisampleStateCreateInfo ms{};
@@ -1899,7 +2878,7 @@ namespace Mantrax
         cba.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
                              VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
 
-        if (shader->config.blendEnable)
+        if (shader.config.blendEnable)
         {
             cba.blendEnable = VK_TRUE;
             // Alpha blending correcto
@@ -1921,6 +2900,68 @@ namespace Mantrax
         cb.attachmentCount = 1;
         cb.pAttachments = &cba;
 
+        VkPipelineDepthStencilStateCreateInfo ds{};
+        ds.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+
+        // ✅ CRÍTICO: Para objetos transparentes
+        if (shader.config.blendEnable)
+        {
+            ds.depthTestEnable = VK_TRUE;   // Leer depth buffer
+            ds.depthWriteEnable = VK_FALSE; // NO escribir en depth buffer
+            ds.depthCompareOp = VK_COMPARE_OP_LESS;
+        }
+        else
+        {
+            // Para objetos opacos
+            ds.depthTestEnable = shader.config.depthTestEnable ? VK_TRUE : VK_FALSE;
+            ds.depthWriteEnable = shader.config.depthWriteEnable ? VK_TRUE : VK_FALSE;
+            ds.depthCompareOp = shader.config.depthCompareOp;
+        }
+
+        ds.depthBoundsTestEnable = VK_FALSE;
+        ds.stencilTestEnable = VK_FALSE;
+
+        // ✅ DYNAMIC STATE PARA VIEWPORT Y SCISSOR
+        std::vector<VkDynamicState> dynamicStates = {
+            VK_DYNAMIC_STATE_VIEWPORT,
+            VK_DYNAMIC_STATE_SCISSOR};
+
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicState.pDynamicStates = dynamicStates.data();
+
+        // Crear pipeline
+        VkGraphicsPipelineCreateInfo pi{};
+        pi.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pi.stageCount = 2;
+        pi.pStages = stages;
+        pi.pVertexInputState = &vin;
+        pi.pInputAssemblyState = &ia;
+        pi.pViewportState = &vpst;
+        pi.pRasterizationState = &rs;
+        pi.pMultisampleState = &ms;
+        pi.pColorBlendState = &cb;
+        pi.pDepthStencilState = &ds;
+        pi.pDynamicState = &dynamicState; // ✅ AÑADIR DYNAMIC STATE
+        pi.layout = shader.pipelineLayout;
+        pi.renderPass = shader.renderPass;
+        pi.subpass = 0;
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkResult result = vkCreateGraphicsPipelines(m_Device, VK_NULL_HANDLE, 1, &pi, nullptr, &pipeline);
+
+        vkDestroyShaderModule(m_Device, vert, nullptr);
+        vkDestroyShaderModule(m_Device, frag, nullptr);
+
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Error creando pipeline");
+
+        return pipeline;
+    }
+
+    void GFX::CreateShaderPipeline(std::shared_ptr<Shader> shader, VkRenderPass renderPass)
+    {
         // Descriptor Set Layout con todas las texturas PBR
         std::array<VkDescriptorSetLayoutBinding, 6> bindings{};
 
@@ -1974,75 +3015,27 @@ namespace Mantrax
         pushConstantRange.offset = 0;
         pushConstantRange.size = sizeof(MaterialPushConstants);
 
+        // Set 0: mesh/material, Set 1: luces (global, igual para todos los shaders)
+        VkDescriptorSetLayout setLayouts[] = {shader->descriptorSetLayout, m_LightingSetLayout};
+
         VkPipelineLayoutCreateInfo pl{};
         pl.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pl.setLayoutCount = 1;
-        pl.pSetLayouts = &shader->descriptorSetLayout;
+        pl.setLayoutCount = 2;
+        pl.pSetLayouts = setLayouts;
         pl.pushConstantRangeCount = 1;
         pl.pPushConstantRanges = &pushConstantRange;
 
         if (vkCreatePipelineLayout(m_Device, &pl, nullptr, &shader->pipelineLayout) != VK_SUCCESS)
             throw std::runtime_error("Error creando pipeline layout");
 
-        VkPipelineDepthStencilStateCreateInfo ds{};
-        ds.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-
-        // ✅ CRÍTICO: Para objetos transparentes
-        if (shader->config.blendEnable)
-        {
-            ds.depthTestEnable = VK_TRUE;   // Leer depth buffer
-            ds.depthWriteEnable = VK_FALSE; // NO escribir en depth buffer
-            ds.depthCompareOp = VK_COMPARE_OP_LESS;
-        }
-        else
-        {
-            // Para objetos opacos
-            ds.depthTestEnable = shader->config.depthTestEnable ? VK_TRUE : VK_FALSE;
-            ds.depthWriteEnable = shader->config.depthWriteEnable ? VK_TRUE : VK_FALSE;
-            ds.depthCompareOp = shader->config.depthCompareOp;
-        }
-
-        ds.depthBoundsTestEnable = VK_FALSE;
-        ds.stencilTestEnable = VK_FALSE;
-
-        // ✅ DYNAMIC STATE PARA VIEWPORT Y SCISSOR
-        std::vector<VkDynamicState> dynamicStates = {
-            VK_DYNAMIC_STATE_VIEWPORT,
-            VK_DYNAMIC_STATE_SCISSOR};
-
-        VkPipelineDynamicStateCreateInfo dynamicState{};
-        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-        dynamicState.pDynamicStates = dynamicStates.data();
-
-        // Crear pipeline
-        VkGraphicsPipelineCreateInfo pi{};
-        pi.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pi.stageCount = 2;
-        pi.pStages = stages;
-        pi.pVertexInputState = &vin;
-        pi.pInputAssemblyState = &ia;
-        pi.pViewportState = &vpst;
-        pi.pRasterizationState = &rs;
-        pi.pMultisampleState = &ms;
-        pi.pColorBlendState = &cb;
-        pi.pDepthStencilState = &ds;
-        pi.pDynamicState = &dynamicState; // ✅ AÑADIR DYNAMIC STATE
-        pi.layout = shader->pipelineLayout;
-        pi.renderPass = (renderPass != VK_NULL_HANDLE) ? renderPass : m_RenderPass;
-        pi.subpass = 0;
-
-        if (vkCreateGraphicsPipelines(m_Device, VK_NULL_HANDLE, 1, &pi, nullptr, &shader->pipeline) != VK_SUCCESS)
-            throw std::runtime_error("Error creando pipeline");
-
-        vkDestroyShaderModule(m_Device, vert, nullptr);
-        vkDestroyShaderModule(m_Device, frag, nullptr);
+        shader->renderPass = (renderPass != VK_NULL_HANDLE) ? renderPass : m_RenderPass;
+        shader->pipeline = CreateShaderVariant(*shader, 0);
 
         // Agregar a la lista de shaders
         bool exists = false;
         for (const auto &s : m_AllShaders)
         {
-            if (s == shader)
+            if (s.lock() == shader)
             {
                 exists = true;
                 break;
@@ -2054,10 +3047,45 @@ namespace Mantrax
         }
     }
 
+    VkPipeline GFX::GetMaterialPipeline(const Material &material)
+    {
+        const auto &shader = material.shader;
+        if (!shader || shader->pipeline == VK_NULL_HANDLE)
+            return VK_NULL_HANDLE;
+
+        uint32_t mask = material.GetFeatureMask();
+        if (!shader->config.materialVariants || mask == 0)
+            return shader->pipeline;
+
+        auto it = shader->variants.find(mask);
+        if (it != shader->variants.end())
+            return it->second;
+
+        // ✅ Primera vez que se ve esta combinación de texturas: compilar y cachear
+        VkPipeline pipeline = CreateShaderVariant(*shader, mask);
+        shader->variants[mask] = pipeline;
+
+        std::cout << "✅ Variante de pipeline compilada (máscara 0x" << std::hex << mask << std::dec
+                  << ", " << shader->variants.size() + 1 << " variantes)\n";
+        return pipeline;
+    }
+
+    void GFX::DestroyShaderVariants(Shader &shader)
+    {
+        for (auto &[mask, variant] : shader.variants)
+            vkDestroyPipeline(m_Device, variant, nullptr);
+        shader.variants.clear();
+    }
+
     void GFX::CreateVertexBuffer(std::shared_ptr<Mesh> mesh)
     {
-        VkDeviceSize size = sizeof(Vertex) * mesh->vertices.size();
+        UploadDeviceBuffer(mesh->vertices.data(), sizeof(Vertex) * mesh->vertices.size(),
+                           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, mesh->vertexBuffer, mesh->vertexBufferMemory);
+    }
 
+    void GFX::UploadDeviceBuffer(const void *source, VkDeviceSize size, VkBufferUsageFlags usage,
+                                 VkBuffer &buffer, VkDeviceMemory &memory)
+    {
         VkBuffer staging;
         VkDeviceMemory stagingMem;
 
@@ -2068,23 +3096,23 @@ namespace Mantrax
 
         void *data;
         vkMapMemory(m_Device, stagingMem, 0, size, 0, &data);
-        memcpy(data, mesh->vertices.data(), size);
+        memcpy(data, source, size);
         vkUnmapMemory(m_Device, stagingMem);
 
         CreateBuffer(size,
-                     VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                     mesh->vertexBuffer, mesh->vertexBufferMemory);
+                     buffer, memory);
 
-        CopyBuffer(staging, mesh->vertexBuffer, size);
+        CopyBuffer(staging, buffer, size);
 
-        vkDestroyBuffer(m_Device, staging, nullptr);
-        vkFreeMemory(m_Device, stagingMem, nullptr);
+        ReleaseStagingBuffer(staging, stagingMem);
     }
 
     void GFX::CreateIndexBuffer(std::shared_ptr<Mesh> mesh)
     {
-        VkDeviceSize size = sizeof(uint32_t) * mesh->indices.size();
+        VkDeviceSize lod0Size = sizeof(uint32_t) * mesh->indices.size();
+        VkDeviceSize size = lod0Size + sizeof(uint32_t) * mesh->lodIndices.size();
 
         VkBuffer staging;
         VkDeviceMemory stagingMem;
@@ -2096,7 +3124,9 @@ namespace Mantrax
 
         void *data;
         vkMapMemory(m_Device, stagingMem, 0, size, 0, &data);
-        memcpy(data, mesh->indices.data(), size);
+        memcpy(data, mesh->indices.data(), lod0Size);
+        if (!mesh->lodIndices.empty())
+            memcpy(static_cast<char *>(data) + lod0Size, mesh->lodIndices.data(), size - lod0Size);
         vkUnmapMemory(m_Device, stagingMem);
 
         CreateBuffer(size,
@@ -2106,8 +3136,7 @@ namespace Mantrax
 
         CopyBuffer(staging, mesh->indexBuffer, size);
 
-        vkDestroyBuffer(m_Device, staging, nullptr);
-        vkFreeMemory(m_Device, stagingMem, nullptr);
+        ReleaseStagingBuffer(staging, stagingMem);
     }
 
     void GFX::CreateUniformBuffer(std::shared_ptr<Mesh> mesh)
@@ -2207,6 +3236,8 @@ namespace Mantrax
 
         vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(writes.size()),
                                writes.data(), 0, nullptr);
+
+        mesh->textureGeneration = material->GetTextureGeneration();
     }
 
     void GFX::CleanupSwapchain()
@@ -2238,7 +3269,7 @@ namespace Mantrax
         }
         if (m_DepthImageMemory)
         {
-            vkFreeMemory(m_Device, m_DepthImageMemory, nullptr);
+            FreeMemory(m_DepthImageMemory);
             m_DepthImageMemory = VK_NULL_HANDLE;
         }
 
@@ -2270,7 +3301,7 @@ namespace Mantrax
         CleanupCustomRenderPasses();
 
         // Recrear swapchain base
-        CreateSwapchain(false);
+        CreateSwapchain();
         CreateImageViews();
         CreateDepthResources();
         CreateRenderPass();
@@ -2288,9 +3319,10 @@ namespace Mantrax
         }
 
         // Recrear pipelines
-        auto shadersToRecreate = m_AllShaders;
+        auto shadersToRecreate = LockLiveShaders();
         for (auto &shader : shadersToRecreate)
         {
+            DestroyShaderVariants(*shader);
             if (shader->pipeline != VK_NULL_HANDLE)
                 vkDestroyPipeline(m_Device, shader->pipeline, nullptr);
             if (shader->pipelineLayout != VK_NULL_HANDLE)
@@ -2335,14 +3367,15 @@ namespace Mantrax
         {
             if (obj.mesh && obj.mesh->descriptorSet != VK_NULL_HANDLE)
             {
-                // El descriptor set se liberará con el pool, solo invalidamos la referencia
+                // Devolver el set al pool antes de crear el nuevo (no se pierde capacidad)
+                m_DeletionQueue->RetireDescriptorSet(obj.mesh->descriptorSet);
                 obj.mesh->descriptorSet = VK_NULL_HANDLE;
             }
         }
 
         CleanupSwapchain();
 
-        CreateSwapchain(false);
+        CreateSwapchain();
         CreateImageViews();
         CreateDepthResources();
         CreateRenderPass();
@@ -2350,10 +3383,11 @@ namespace Mantrax
         CreateCommandBuffers();
 
         // Recrear shaders
-        auto shadersToRecreate = m_AllShaders;
+        auto shadersToRecreate = LockLiveShaders();
 
         for (auto &shader : shadersToRecreate)
         {
+            DestroyShaderVariants(*shader);
             if (shader->pipeline != VK_NULL_HANDLE)
             {
                 vkDestroyPipeline(m_Device, shader->pipeline, nullptr);
@@ -2405,6 +3439,9 @@ namespace Mantrax
         if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS)
             throw std::runtime_error("Error comenzando command buffer");
 
+        // ✅ Compute del frame antes del render pass
+        RecordPendingDispatches(cmd);
+
         std::array<VkClearValue, 2> clearValues{};
         clearValues[0].color = m_Config.clearColor;
         clearValues[1].depthStencil = {1.0f, 0};
@@ -2453,11 +3490,11 @@ namespace Mantrax
             if (obj.material->shader->config.blendEnable)
                 continue;
 
-            if (obj.material->shader->pipeline != lastPipeline)
+            VkPipeline pipeline = GetMaterialPipeline(*obj.material);
+            if (pipeline != lastPipeline)
             {
-                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                  obj.material->shader->pipeline);
-                lastPipeline = obj.material->shader->pipeline;
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                lastPipeline = pipeline;
             }
 
             // Push constants del material
@@ -2475,12 +3512,10 @@ namespace Mantrax
             vkCmdBindIndexBuffer(cmd, obj.mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
             // ✅ CAMBIO CRÍTICO: Usar descriptor set del MESH
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                    obj.material->shader->pipelineLayout,
-                                    0, 1, &obj.mesh->descriptorSet, 0, nullptr);
+            BindMeshDescriptorSets(cmd, obj.material->shader->pipelineLayout, obj.mesh->descriptorSet);
 
-            vkCmdDrawIndexed(cmd, static_cast<uint32_t>(obj.mesh->indices.size()),
-                             1, 0, 0, 0);
+            vkCmdDrawIndexed(cmd, obj.mesh->GetIndexCount(),
+                             1, obj.mesh->GetFirstIndex(), 0, 0);
         }
 
         // ✅ PASO 2: Renderizar objetos TRANSPARENTES
@@ -2499,11 +3534,11 @@ namespace Mantrax
             if (!obj.material->shader->config.blendEnable)
                 continue;
 
-            if (obj.material->shader->pipeline != lastPipeline)
+            VkPipeline pipeline = GetMaterialPipeline(*obj.material);
+            if (pipeline != lastPipeline)
             {
-                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                  obj.material->shader->pipeline);
-                lastPipeline = obj.material->shader->pipeline;
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                lastPipeline = pipeline;
             }
 
             // Push constants del material
@@ -2521,12 +3556,10 @@ namespace Mantrax
             vkCmdBindIndexBuffer(cmd, obj.mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
             // ✅ CAMBIO CRÍTICO: Usar descriptor set del MESH
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                    obj.material->shader->pipelineLayout,
-                                    0, 1, &obj.mesh->descriptorSet, 0, nullptr);
+            BindMeshDescriptorSets(cmd, obj.material->shader->pipelineLayout, obj.mesh->descriptorSet);
 
-            vkCmdDrawIndexed(cmd, static_cast<uint32_t>(obj.mesh->indices.size()),
-                             1, 0, 0, 0);
+            vkCmdDrawIndexed(cmd, obj.mesh->GetIndexCount(),
+                             1, obj.mesh->GetFirstIndex(), 0, 0);
         }
 
         // Renderizar ImGui si hay callback
@@ -2548,200 +3581,2234 @@ namespace Mantrax
     void GFX::RenderToOffscreenFramebuffer(std::shared_ptr<OffscreenFramebuffer> offscreen,
                                            const std::vector<RenderObject> &objects)
     {
-        VkCommandBuffer cmd = BeginSingleTimeCommands();
-
-        // Transición: SHADER_READ_ONLY → COLOR_ATTACHMENT
-        VkImageMemoryBarrier barrier1{};
-        barrier1.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier1.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier1.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        barrier1.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier1.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier1.image = offscreen->colorImage;
-        barrier1.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier1.subresourceRange.baseMipLevel = 0;
-        barrier1.subresourceRange.levelCount = 1;
-        barrier1.subresourceRange.baseArrayLayer = 0;
-        barrier1.subresourceRange.layerCount = 1;
-        barrier1.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        barrier1.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        // ✅ Culling: frustum con la cámara actual, HiZ con el depth del frame anterior
+        m_CullingStats = CullingStats{};
+        m_CullingStats.submitted = static_cast<uint32_t>(objects.size());
 
-        vkCmdPipelineBarrier(
-            cmd,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-            0,
-            0, nullptr,
-            0, nullptr,
-            1, &barrier1);
-
-        // Comenzar render pass
-        std::array<VkClearValue, 2> clearValues{};
-        clearValues[0].color = m_Config.clearColor;
-        clearValues[1].depthStencil = {1.0f, 0};
-
-        VkRenderPassBeginInfo renderPassInfo{};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = offscreen->renderPass;
-        renderPassInfo.framebuffer = offscreen->framebuffer;
-        renderPassInfo.renderArea.offset = {0, 0};
-        renderPassInfo.renderArea.extent = offscreen->extent;
-        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-        renderPassInfo.pClearValues = clearValues.data();
-
-        vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-        // ✅ ESTABLECER VIEWPORT Y SCISSOR
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = static_cast<float>(offscreen->extent.width);
-        viewport.height = static_cast<float>(offscreen->extent.height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        vkCmdSetViewport(cmd, 0, 1, &viewport);
-
-        VkRect2D scissor{};
-        scissor.offset = {0, 0};
-        scissor.extent = offscreen->extent;
-        vkCmdSetScissor(cmd, 0, 1, &scissor);
+        const bool useHiZ = IsHiZOcclusionEnabled() && offscreen->hiz && offscreen->hiz->readback.valid;
+        Frustum frustum = Frustum::FromMatrix(m_CullingViewProj);
 
-        VkPipeline lastPipeline = VK_NULL_HANDLE;
+        std::vector<const RenderObject *> visibleObjects;
+        visibleObjects.reserve(objects.size());
 
-        // Renderizar objetos OPACOS primero
         for (const auto &obj : objects)
         {
-            if (!obj.mesh || !obj.material || !obj.material->shader)
-                continue;
+            if (m_HasCullingCamera && obj.enableCulling && obj.mesh)
+            {
+                glm::mat4 model = glm::make_mat4(obj.mesh->GetTransformUBO().model);
 
-            if (!obj.mesh->vertexBuffer || !obj.mesh->indexBuffer)
-                continue;
+                if (!frustum.IntersectsAABB(obj.mesh->boundsMin, obj.mesh->boundsMax, model))
+                {
+                    m_CullingStats.frustumRejected++;
+                    continue;
+                }
 
-            if (!obj.material->shader->pipeline)
-                continue;
+                if (useHiZ)
+                {
+                    m_CullingStats.occlusionTested++;
+                    if (offscreen->hiz->readback.IsOccluded(obj.mesh->boundsMin, obj.mesh->boundsMax, model))
+                    {
+                        m_CullingStats.occlusionRejected++;
+                        continue;
+                    }
+                }
+            }
 
-            // Saltar transparentes
-            if (obj.material->shader->config.blendEnable)
-                continue;
+            visibleObjects.push_back(&obj);
+        }
 
-            if (obj.material->shader->pipeline != lastPipeline)
-            {
-                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                  obj.material->shader->pipeline);
-                lastPipeline = obj.material->shader->pipeline;
-            }
+        // ✅ Streaming: mips según el tamaño en pantalla de los visibles; las copias van en este command buffer
+        RequestTextureMips(visibleObjects, offscreen->renderExtent.height);
+        UpdateTextureStreaming(objects);
 
-            vkCmdPushConstants(
-                cmd,
-                obj.material->shader->pipelineLayout,
-                VK_SHADER_STAGE_FRAGMENT_BIT,
-                0,
-                sizeof(MaterialPushConstants),
-                &obj.material->pushConstants);
+        // ✅ Render graph: los pases declaran sus recursos y el grafo coloca los barriers
+        if (!m_OffscreenGraph)
+            m_OffscreenGraph = std::make_unique<RenderGraph>(m_Device, m_PhysicalDevice, m_DeletionQueue);
 
-            VkBuffer vertexBuffers[] = {obj.mesh->vertexBuffer};
-            VkDeviceSize offsets[] = {0};
-            vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
-            vkCmdBindIndexBuffer(cmd, obj.mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        RenderGraph &graph = *m_OffscreenGraph;
+        graph.Reset();
+
+        // ImGui muestreó el color en el frame anterior; el depth se limpia en cada pase
+        RGResource color = graph.ImportImage(
+            "OffscreenColor", offscreen->colorImage, VK_IMAGE_ASPECT_COLOR_BIT, 1,
+            {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT},
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        RGResource depth = graph.ImportImage(
+            "OffscreenDepth", offscreen->depthImage, VK_IMAGE_ASPECT_DEPTH_BIT, 1,
+            {VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT});
+        graph.MarkOutput(color);
 
-            // ✅ CAMBIO: Usar descriptor set del MESH
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                    obj.material->shader->pipelineLayout,
-                                    0, 1, &obj.mesh->descriptorSet, 0, nullptr);
+        // ✅ Meshlets: culling por cluster en compute (fuera del render pass)
+        std::vector<uint8_t> useMeshlets(visibleObjects.size(), 0);
+        RGResource drawCommands = RG_INVALID_RESOURCE;
 
-            vkCmdDrawIndexed(cmd, static_cast<uint32_t>(obj.mesh->indices.size()),
-                             1, 0, 0, 0);
+        if (IsMeshletCullingEnabled() && m_HasCullingCamera)
+        {
+            // Un buffer de comandos por mesh: se sincroniza con un barrier global
+            drawCommands = graph.ImportBuffer("MeshletDrawCommands", VK_NULL_HANDLE);
+
+            graph.AddPass(
+                "MeshletCull", RGPassType::Compute,
+                [drawCommands](RenderGraph::PassBuilder &builder)
+                { builder.Write(drawCommands, RGAccess::StorageWrite); },
+                [this, &visibleObjects, &useMeshlets, &frustum](VkCommandBuffer cmd)
+                {
+                    for (size_t i = 0; i < visibleObjects.size(); ++i)
+                    {
+                        if (RecordMeshletCull(cmd, *visibleObjects[i], frustum))
+                            useMeshlets[i] = 1;
+                    }
+                });
         }
 
-        // Renderizar objetos TRANSPARENTES
-        for (const auto &obj : objects)
+        // ✅ Luces: subir la lista y asignarlas a los clusters de este viewport
+        UploadLighting(offscreen->renderExtent);
+        RGResource lightClusters = RG_INVALID_RESOURCE;
+
+        if (m_LightingStats.clustered)
         {
-            if (!obj.mesh || !obj.material || !obj.material->shader)
+            // Contadores + índices por cluster: un barrier global basta
+            lightClusters = graph.ImportBuffer("LightClusters", VK_NULL_HANDLE);
+
+            graph.AddPass(
+                "LightCull", RGPassType::Compute,
+                [lightClusters](RenderGraph::PassBuilder &builder)
+                { builder.Write(lightClusters, RGAccess::StorageWrite); },
+                [this](VkCommandBuffer cmd)
+                { RecordLightCulling(cmd); });
+        }
+
+        // El render pass deja el color en SHADER_READ_ONLY (su finalLayout)
+        graph.AddPass(
+            "Scene", RGPassType::Graphics,
+            [color, depth, drawCommands, lightClusters](RenderGraph::PassBuilder &builder)
+            {
+                builder.Write(color, RGAccess::ColorAttachmentWrite, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                builder.Write(depth, RGAccess::DepthAttachmentWrite);
+                if (drawCommands != RG_INVALID_RESOURCE)
+                    builder.Read(drawCommands, RGAccess::IndirectRead);
+                if (lightClusters != RG_INVALID_RESOURCE)
+                    builder.Read(lightClusters, RGAccess::StorageRead);
+            },
+            [this, offscreen, &visibleObjects, &useMeshlets](VkCommandBuffer cmd)
+            {
+                // Comenzar render pass
+                std::array<VkClearValue, 2> clearValues{};
+                clearValues[0].color = m_Config.clearColor;
+                clearValues[1].depthStencil = {1.0f, 0};
+
+                VkRenderPassBeginInfo renderPassInfo{};
+                renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+                renderPassInfo.renderPass = offscreen->renderPass;
+                renderPassInfo.framebuffer = offscreen->framebuffer;
+                renderPassInfo.renderArea.offset = {0, 0};
+                renderPassInfo.renderArea.extent = offscreen->renderExtent;
+                renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+                renderPassInfo.pClearValues = clearValues.data();
+
+                vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+                // ✅ ESTABLECER VIEWPORT Y SCISSOR
+                VkViewport viewport{};
+                viewport.x = 0.0f;
+                viewport.y = 0.0f;
+                viewport.width = static_cast<float>(offscreen->renderExtent.width);
+                viewport.height = static_cast<float>(offscreen->renderExtent.height);
+                viewport.minDepth = 0.0f;
+                viewport.maxDepth = 1.0f;
+                vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+                VkRect2D scissor{};
+                scissor.offset = {0, 0};
+                scissor.extent = offscreen->renderExtent;
+                vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+                VkPipeline lastPipeline = VK_NULL_HANDLE;
+
+                // ✅ Opacos agrupados por pipeline y material: los submeshes que comparten material
+                // (de este u otros objetos) quedan seguidos y solo se cambia el estado necesario
+                struct OpaqueDraw
+                {
+                    VkPipeline pipeline;
+                    const Material *material;
+                    VkBuffer indexBuffer;
+                    size_t index;
+                };
+
+                std::vector<OpaqueDraw> opaqueDraws;
+                opaqueDraws.reserve(visibleObjects.size());
+
+                for (size_t i = 0; i < visibleObjects.size(); ++i)
+                {
+                    const RenderObject *obj = visibleObjects[i];
+
+                    if (!obj->mesh || !obj->material || !obj->material->shader)
+                        continue;
+
+                    if (!obj->mesh->vertexBuffer || !obj->mesh->indexBuffer)
+                        continue;
+
+                    if (!obj->material->shader->pipeline)
+                        continue;
+
+                    // Saltar transparentes
+                    if (obj->material->shader->config.blendEnable)
+                        continue;
+
+                    opaqueDraws.push_back({GetMaterialPipeline(*obj->material), obj->material.get(),
+                                           obj->mesh->indexBuffer, i});
+                }
+
+                std::sort(opaqueDraws.begin(), opaqueDraws.end(),
+                          [](const OpaqueDraw &a, const OpaqueDraw &b)
+                          {
+                              if (a.pipeline != b.pipeline)
+                                  return a.pipeline < b.pipeline;
+                              if (a.material != b.material)
+                                  return a.material < b.material;
+                              return a.indexBuffer < b.indexBuffer;
+                          });
+
+                const Material *lastMaterial = nullptr;
+                VkBuffer lastIndexBuffer = VK_NULL_HANDLE;
+
+                // Renderizar objetos OPACOS primero
+                for (const OpaqueDraw &draw : opaqueDraws)
+                {
+                    const RenderObject *obj = visibleObjects[draw.index];
+
+                    if (draw.pipeline != lastPipeline)
+                    {
+                        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+                        lastPipeline = draw.pipeline;
+                        lastMaterial = nullptr; // Otro layout: volver a subir las push constants
+                    }
+
+                    if (draw.material != lastMaterial)
+                    {
+                        vkCmdPushConstants(
+                            cmd,
+                            obj->material->shader->pipelineLayout,
+                            VK_SHADER_STAGE_FRAGMENT_BIT,
+                            0,
+                            sizeof(MaterialPushConstants),
+                            &obj->material->pushConstants);
+                        lastMaterial = draw.material;
+                    }
+
+                    // Submeshes e instancias comparten vertex / index buffer
+                    if (draw.indexBuffer != lastIndexBuffer)
+                    {
+                        VkBuffer vertexBuffers[] = {obj->mesh->vertexBuffer};
+                        VkDeviceSize offsets[] = {0};
+                        vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
+                        vkCmdBindIndexBuffer(cmd, obj->mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                        lastIndexBuffer = draw.indexBuffer;
+                    }
+
+                    // ✅ CAMBIO: Usar descriptor set del MESH
+                    BindMeshDescriptorSets(cmd, obj->material->shader->pipelineLayout, obj->mesh->descriptorSet);
+
+                    RecordMeshDraw(cmd, *obj, useMeshlets[draw.index] != 0);
+                    m_CullingStats.drawn++;
+                    if (useMeshlets[draw.index])
+                        m_CullingStats.meshletObjects++;
+                }
+
+                // ✅ Cielo después de los opacos: el depth test descarta lo ya cubierto
+                if (IsSkyEnabled() && m_HasCullingCamera)
+                {
+                    RecordSky(cmd);
+                    lastPipeline = VK_NULL_HANDLE;
+                }
+
+                // Renderizar objetos TRANSPARENTES
+                for (size_t i = 0; i < visibleObjects.size(); ++i)
+                {
+                    const RenderObject *obj = visibleObjects[i];
+
+                    if (!obj->mesh || !obj->material || !obj->material->shader)
+                        continue;
+
+                    if (!obj->mesh->vertexBuffer || !obj->mesh->indexBuffer)
+                        continue;
+
+                    if (!obj->material->shader->pipeline)
+                        continue;
+
+                    // Solo transparentes
+                    if (!obj->material->shader->config.blendEnable)
+                        continue;
+
+                    VkPipeline pipeline = GetMaterialPipeline(*obj->material);
+                    if (pipeline != lastPipeline)
+                    {
+                        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                        lastPipeline = pipeline;
+                    }
+
+                    vkCmdPushConstants(
+                        cmd,
+                        obj->material->shader->pipelineLayout,
+                        VK_SHADER_STAGE_FRAGMENT_BIT,
+                        0,
+                        sizeof(MaterialPushConstants),
+                        &obj->material->pushConstants);
+
+                    VkBuffer vertexBuffers[] = {obj->mesh->vertexBuffer};
+                    VkDeviceSize offsets[] = {0};
+                    vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
+                    vkCmdBindIndexBuffer(cmd, obj->mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+                    // ✅ CAMBIO: Usar descriptor set del MESH
+                    BindMeshDescriptorSets(cmd, obj->material->shader->pipelineLayout, obj->mesh->descriptorSet);
+
+                    RecordMeshDraw(cmd, *obj, useMeshlets[i] != 0);
+                    m_CullingStats.drawn++;
+                    if (useMeshlets[i])
+                        m_CullingStats.meshletObjects++;
+                }
+
+                vkCmdEndRenderPass(cmd);
+            });
+
+        // ✅ HiZ: construir la pirámide con el depth de este frame (la usa el siguiente)
+        const bool buildHiZ = IsHiZOcclusionEnabled() && m_HasCullingCamera;
+        if (buildHiZ)
+        {
+            if (!offscreen->hiz)
+                CreateHiZPyramid(offscreen);
+
+            // El contenido anterior no importa; el frame previo lo copió a CPU
+            RGResource hiz = graph.ImportImage(
+                "HiZ", offscreen->hiz->image, VK_IMAGE_ASPECT_COLOR_BIT, offscreen->hiz->mipLevels,
+                {VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT});
+
+            // El readback a CPU queda fuera del grafo: el pase nunca se descarta
+            graph.AddPass(
+                "HiZBuild", RGPassType::Compute,
+                [depth, hiz](RenderGraph::PassBuilder &builder)
+                {
+                    builder.Read(depth, RGAccess::SampledRead);
+                    builder.Write(hiz, RGAccess::StorageWrite);
+                    builder.SetSideEffects();
+                },
+                [this, offscreen](VkCommandBuffer cmd)
+                { RecordHiZBuild(cmd, offscreen); });
+        }
+
+        if (m_OffscreenGraphCallback)
+            m_OffscreenGraphCallback(graph, color, depth);
+
+        graph.Compile();
+
+        VkCommandBuffer cmd = BeginSingleTimeCommands();
+
+        // ✅ Timestamps: tiempo de GPU del pase completo (culling + render + HiZ)
+        if (m_TimestampQueryPool != VK_NULL_HANDLE)
+        {
+            vkCmdResetQueryPool(cmd, m_TimestampQueryPool, 0, 2);
+            vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_TimestampQueryPool, 0);
+        }
+
+        for (const auto &upload : m_PendingTextureUploads)
+            RecordTextureUpload(cmd, upload);
+        m_PendingTextureUploads.clear();
+
+        graph.Execute(cmd);
+        m_OffscreenGraphStats = graph.GetStats();
+
+        if (m_TimestampQueryPool != VK_NULL_HANDLE)
+            vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TimestampQueryPool, 1);
+
+        // ✅ El compute asíncrono del frame anterior (partículas, skinning...) lo lee este render
+        EndSingleTimeCommands(cmd, true);
+
+        // EndSingleTimeCommands espera a la cola: los resultados ya están disponibles
+        if (m_TimestampQueryPool != VK_NULL_HANDLE)
+        {
+            uint64_t ticks[2] = {0, 0};
+            if (vkGetQueryPoolResults(m_Device, m_TimestampQueryPool, 0, 2, sizeof(ticks), ticks,
+                                      sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+            {
+                uint64_t elapsed = ((ticks[1] & m_TimestampMask) - (ticks[0] & m_TimestampMask)) & m_TimestampMask;
+                m_OffscreenGPUTimeMs = static_cast<float>(static_cast<double>(elapsed) * m_TimestampPeriod / 1.0e6);
+            }
+        }
+
+        if (buildHiZ)
+        {
+            auto &readback = offscreen->hiz->readback;
+            memcpy(readback.texels.data(), offscreen->hiz->readbackMapped,
+                   readback.texels.size() * sizeof(float));
+            readback.viewProj = m_CullingViewProj;
+            readback.valid = true;
+        }
+        else if (offscreen->hiz)
+        {
+            // Datos viejos: no usarlos si se vuelve a activar
+            offscreen->hiz->readback.valid = false;
+        }
+    }
+
+    // ============================================
+    // HiZ OCCLUSION CULLING
+    // ============================================
+
+    void GFX::EnableHiZOcclusion(const std::string &computeShaderPath)
+    {
+        if (m_HiZPipeline != VK_NULL_HANDLE)
+        {
+            m_HiZEnabled = true;
+            return;
+        }
+
+        // Binding 0: nivel de origen (depth o mip anterior), Binding 1: nivel destino
+        // Push constants: srcSize (ivec2) + dstSize (ivec2)
+        CreateComputePipeline(computeShaderPath,
+                              {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE},
+                              sizeof(int32_t) * 4,
+                              m_HiZDescriptorSetLayout, m_HiZPipelineLayout, m_HiZPipeline);
+
+        m_HiZEnabled = true;
+        std::cout << "✅ HiZ occlusion culling habilitado (" << computeShaderPath << ")\n";
+    }
+
+    void GFX::SetCullingCamera(const glm::mat4 &view, const glm::mat4 &projection)
+    {
+        m_CullingViewProj = projection * view;
+        m_CullingView = view;
+        m_CullingProjection = projection;
+        m_HasCullingCamera = true;
+
+        // Posición / dirección de la cámara para el cono de los meshlets
+        glm::mat4 invView = glm::inverse(view);
+        m_CullingCameraPos = glm::vec3(invView[3]);
+        m_CullingViewDir = glm::normalize(-glm::vec3(invView[2]));
+        m_CullingOrthographic = projection[3][3] == 1.0f;
+    }
+
+    void GFX::CreateHiZPyramid(std::shared_ptr<OffscreenFramebuffer> offscreen)
+    {
+        auto hiz = std::make_shared<HiZPyramid>();
+        hiz->deletionQueue = m_DeletionQueue;
+
+        // Nivel 0 = mitad del depth asignado, luego la cadena normal de mips de Vulkan.
+        // El área renderizada puede ser menor: se usa solo la esquina activa de cada nivel
+        hiz->extent.width = std::max(1u, offscreen->extent.width >> 1);
+        hiz->extent.height = std::max(1u, offscreen->extent.height >> 1);
+        hiz->mipLevels = static_cast<uint32_t>(
+                             std::floor(std::log2(std::max(hiz->extent.width, hiz->extent.height)))) +
+                         1;
+
+        CreateImage(hiz->extent.width, hiz->extent.height, VK_FORMAT_R32_SFLOAT,
+                    VK_IMAGE_TILING_OPTIMAL,
+                    VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                    hiz->image, hiz->memory, hiz->mipLevels);
+
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_NEAREST;
+        samplerInfo.minFilter = VK_FILTER_NEAREST;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.maxAnisotropy = 1.0f;
+        samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+        samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+
+        if (vkCreateSampler(m_Device, &samplerInfo, nullptr, &hiz->sampler) != VK_SUCCESS)
+            throw std::runtime_error("Error creando sampler del HiZ");
+
+        // Readback: el peor caso de los niveles gruesos (<= 128 px por lado) para el tamaño asignado,
+        // así ningún renderExtent posterior necesita otro buffer
+        size_t texelCapacity = 0;
+        for (uint32_t level = 0; level < hiz->mipLevels; ++level)
+        {
+            uint32_t levelWidth = std::min(128u, std::max(1u, hiz->extent.width >> level));
+            uint32_t levelHeight = std::min(128u, std::max(1u, hiz->extent.height >> level));
+            texelCapacity += static_cast<size_t>(levelWidth) * levelHeight;
+        }
+
+        CreateBuffer(texelCapacity * sizeof(float),
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     hiz->readbackBuffer, hiz->readbackMemory);
+
+        vkMapMemory(m_Device, hiz->readbackMemory, 0, texelCapacity * sizeof(float), 0, &hiz->readbackMapped);
+
+        hiz->readback.texels.reserve(texelCapacity);
+        ConfigureHiZReadback(*hiz, offscreen->renderExtent);
+
+        // Una vista y un descriptor set por nivel
+        hiz->mipViews.resize(hiz->mipLevels);
+        hiz->mipDescriptorSets.resize(hiz->mipLevels);
+
+        for (uint32_t level = 0; level < hiz->mipLevels; ++level)
+        {
+            hiz->mipViews[level] = CreateImageView(hiz->image, VK_FORMAT_R32_SFLOAT,
+                                                   VK_IMAGE_ASPECT_COLOR_BIT, level, 1);
+        }
+
+        std::vector<VkDescriptorSetLayout> layouts(hiz->mipLevels, m_HiZDescriptorSetLayout);
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_DescriptorPool;
+        allocInfo.descriptorSetCount = hiz->mipLevels;
+        allocInfo.pSetLayouts = layouts.data();
+
+        if (vkAllocateDescriptorSets(m_Device, &allocInfo, hiz->mipDescriptorSets.data()) != VK_SUCCESS)
+            throw std::runtime_error("Error allocando descriptor sets del HiZ");
+
+        for (uint32_t level = 0; level < hiz->mipLevels; ++level)
+        {
+            VkDescriptorImageInfo srcInfo{};
+            srcInfo.sampler = hiz->sampler;
+            if (level == 0)
+            {
+                srcInfo.imageView = offscreen->depthImageView;
+                srcInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            }
+            else
+            {
+                srcInfo.imageView = hiz->mipViews[level - 1];
+                srcInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            }
+
+            VkDescriptorImageInfo dstInfo{};
+            dstInfo.imageView = hiz->mipViews[level];
+            dstInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+            std::array<VkWriteDescriptorSet, 2> writes{};
+            writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[0].dstSet = hiz->mipDescriptorSets[level];
+            writes[0].dstBinding = 0;
+            writes[0].descriptorCount = 1;
+            writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            writes[0].pImageInfo = &srcInfo;
+
+            writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[1].dstSet = hiz->mipDescriptorSets[level];
+            writes[1].dstBinding = 1;
+            writes[1].descriptorCount = 1;
+            writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            writes[1].pImageInfo = &dstInfo;
+
+            vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        }
+
+        // Sin log: se crea una por render target del pool (solo al cambiar el tamaño asignado);
+        // el aviso de HiZ activo sale una sola vez en EnableHiZOcclusion
+        offscreen->hiz = hiz;
+    }
+
+    void GFX::ConfigureHiZReadback(HiZPyramid &hiz, VkExtent2D renderExtent)
+    {
+        // Niveles activos: la cadena de mips del área renderizada, dentro de la imagen asignada
+        auto &readback = hiz.readback;
+        readback.depthWidth = renderExtent.width;
+        readback.depthHeight = renderExtent.height;
+        readback.levels.resize(hiz.mipLevels);
+        readback.baseLevel = hiz.mipLevels - 1;
+
+        const uint32_t activeWidth = std::max(1u, renderExtent.width >> 1);
+        const uint32_t activeHeight = std::max(1u, renderExtent.height >> 1);
+
+        for (uint32_t level = 0; level < hiz.mipLevels; ++level)
+        {
+            auto &lvl = readback.levels[level];
+            lvl.width = std::max(1u, activeWidth >> level);
+            lvl.height = std::max(1u, activeHeight >> level);
+
+            if (std::max(lvl.width, lvl.height) <= 128 && level < readback.baseLevel)
+                readback.baseLevel = level;
+        }
+
+        // Solo los niveles gruesos (<= 128 px) se copian a CPU: el test de oclusión es barato
+        size_t texelCount = 0;
+        for (uint32_t level = readback.baseLevel; level < hiz.mipLevels; ++level)
+        {
+            auto &lvl = readback.levels[level];
+            lvl.offset = texelCount;
+            texelCount += static_cast<size_t>(lvl.width) * lvl.height;
+        }
+
+        // Lo copiado con el tamaño anterior ya no corresponde: hasta el próximo build no se ocluye nada
+        readback.texels.assign(texelCount, 1.0f);
+        readback.valid = false;
+    }
+
+    void GFX::DestroyHiZPyramid(std::shared_ptr<OffscreenFramebuffer> offscreen)
+    {
+        if (!offscreen || !offscreen->hiz)
+            return;
+
+        // El destructor de HiZPyramid entrega sus handles a la cola diferida
+        offscreen->hiz.reset();
+    }
+
+    void GFX::RecordHiZBuild(VkCommandBuffer cmd, std::shared_ptr<OffscreenFramebuffer> offscreen)
+    {
+        auto &hiz = *offscreen->hiz;
+
+        // Depth en READ_ONLY y HiZ en GENERAL: las transiciones las pone el render graph
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_HiZPipeline);
+
+        // Nivel 0 lee solo el sub-rectángulo renderizado del depth
+        uint32_t srcWidth = offscreen->renderExtent.width;
+        uint32_t srcHeight = offscreen->renderExtent.height;
+
+        for (uint32_t level = 0; level < hiz.mipLevels; ++level)
+        {
+            uint32_t dstWidth = hiz.readback.levels[level].width;
+            uint32_t dstHeight = hiz.readback.levels[level].height;
+
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_HiZPipelineLayout,
+                                    0, 1, &hiz.mipDescriptorSets[level], 0, nullptr);
+
+            int32_t params[4] = {
+                static_cast<int32_t>(srcWidth), static_cast<int32_t>(srcHeight),
+                static_cast<int32_t>(dstWidth), static_cast<int32_t>(dstHeight)};
+
+            vkCmdPushConstants(cmd, m_HiZPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+                               0, sizeof(params), params);
+
+            vkCmdDispatch(cmd, (dstWidth + 7) / 8, (dstHeight + 7) / 8, 1);
+
+            // El siguiente nivel (o la copia a CPU) lee lo que acabamos de escribir
+            VkImageMemoryBarrier levelBarrier{};
+            levelBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            levelBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+            levelBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            levelBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            levelBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            levelBarrier.image = hiz.image;
+            levelBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            levelBarrier.subresourceRange.baseMipLevel = level;
+            levelBarrier.subresourceRange.levelCount = 1;
+            levelBarrier.subresourceRange.baseArrayLayer = 0;
+            levelBarrier.subresourceRange.layerCount = 1;
+            levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+
+            vkCmdPipelineBarrier(
+                cmd,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0,
+                0, nullptr,
+                0, nullptr,
+                1, &levelBarrier);
+
+            srcWidth = dstWidth;
+            srcHeight = dstHeight;
+        }
+
+        // Copiar los niveles gruesos al buffer de readback
+        std::vector<VkBufferImageCopy> regions;
+        for (uint32_t level = hiz.readback.baseLevel; level < hiz.mipLevels; ++level)
+        {
+            const auto &lvl = hiz.readback.levels[level];
+
+            VkBufferImageCopy region{};
+            region.bufferOffset = lvl.offset * sizeof(float);
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = level;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = {0, 0, 0};
+            region.imageExtent = {lvl.width, lvl.height, 1};
+            regions.push_back(region);
+        }
+
+        vkCmdCopyImageToBuffer(cmd, hiz.image, VK_IMAGE_LAYOUT_GENERAL, hiz.readbackBuffer,
+                               static_cast<uint32_t>(regions.size()), regions.data());
+
+        VkBufferMemoryBarrier hostBarrier{};
+        hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.buffer = hiz.readbackBuffer;
+        hostBarrier.offset = 0;
+        hostBarrier.size = VK_WHOLE_SIZE;
+
+        vkCmdPipelineBarrier(
+            cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_HOST_BIT,
+            0,
+            0, nullptr,
+            1, &hostBarrier,
+            0, nullptr);
+    }
+
+    // ============================================
+    // MESHLET CULLING
+    // ============================================
+
+    namespace
+    {
+        // Layout de push constants de meshlet_cull.comp (128 bytes, el mínimo garantizado)
+        struct MeshletCullPush
+        {
+            glm::vec4 planes[6]; // Frustum en espacio objeto (Mᵀ · plano)
+            glm::vec4 camera;    // xyz: posición (o dirección en ortho) en espacio objeto, w: escala máxima
+            uint32_t meshletCount;
+            uint32_t flags; // bit0: test de cono, bit1: ortográfica
+            uint32_t padding[2];
+        };
+        static_assert(sizeof(MeshletCullPush) == 128, "MeshletCullPush debe ocupar 128 bytes");
+    }
+
+    void GFX::EnableMeshletCulling(const std::string &computeShaderPath)
+    {
+        if (m_MeshletPipeline != VK_NULL_HANDLE)
+        {
+            m_MeshletCullingEnabled = true;
+            return;
+        }
+
+        // Binding 0: meshlets (lectura), Binding 1: draw commands (escritura)
+        CreateComputePipeline(computeShaderPath,
+                              {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+                              sizeof(MeshletCullPush),
+                              m_MeshletDescriptorSetLayout, m_MeshletPipelineLayout, m_MeshletPipeline);
+
+        m_MeshletCullingEnabled = true;
+        std::cout << "✅ Meshlet culling habilitado (" << computeShaderPath << ")"
+                  << (m_SupportsMultiDrawIndirect ? "" : " [sin multiDrawIndirect]") << "\n";
+    }
+
+    void GFX::CreateMeshletBuffers(std::shared_ptr<Mesh> mesh)
+    {
+        VkDeviceSize size = sizeof(Meshlet) * mesh->meshlets.size();
+
+        VkBuffer staging;
+        VkDeviceMemory stagingMem;
+
+        CreateBuffer(size,
+                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     staging, stagingMem);
+
+        void *data;
+        vkMapMemory(m_Device, stagingMem, 0, size, 0, &data);
+        memcpy(data, mesh->meshlets.data(), size);
+        vkUnmapMemory(m_Device, stagingMem);
+
+        CreateBuffer(size,
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                     mesh->meshletBuffer, mesh->meshletBufferMemory);
+
+        CopyBuffer(staging, mesh->meshletBuffer, size);
+
+        ReleaseStagingBuffer(staging, stagingMem);
+
+        CreateMeshletDrawBuffer(mesh);
+    }
+
+    void GFX::CreateMeshletDrawBuffer(std::shared_ptr<Mesh> mesh)
+    {
+        // Lo rellena el compute cada frame antes de los draws indirectos (uno por objeto)
+        CreateBuffer(sizeof(VkDrawIndexedIndirectCommand) * mesh->meshlets.size(),
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                     mesh->drawCommandBuffer, mesh->drawCommandBufferMemory);
+    }
+
+    bool GFX::RecordMeshletCull(VkCommandBuffer cmd, const RenderObject &obj, const Frustum &frustum)
+    {
+        const auto &mesh = obj.mesh;
+
+        // Los meshlets solo cubren el LOD0
+        if (!obj.enableCulling || !mesh || !mesh->HasMeshlets() || mesh->activeLOD != 0)
+            return false;
+
+        if (!obj.material || !obj.material->shader)
+            return false;
+
+        // Descriptor set perezoso: el pipeline puede habilitarse después de crear el mesh
+        if (mesh->meshletDescriptorSet == VK_NULL_HANDLE)
+        {
+            VkDescriptorSetAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocInfo.descriptorPool = m_DescriptorPool;
+            allocInfo.descriptorSetCount = 1;
+            allocInfo.pSetLayouts = &m_MeshletDescriptorSetLayout;
+
+            if (vkAllocateDescriptorSets(m_Device, &allocInfo, &mesh->meshletDescriptorSet) != VK_SUCCESS)
+                throw std::runtime_error("Error asignando descriptor set de meshlets");
+
+            VkDescriptorBufferInfo bufferInfos[2]{};
+            bufferInfos[0].buffer = mesh->meshletBuffer;
+            bufferInfos[0].offset = 0;
+            bufferInfos[0].range = VK_WHOLE_SIZE;
+            bufferInfos[1].buffer = mesh->drawCommandBuffer;
+            bufferInfos[1].offset = 0;
+            bufferInfos[1].range = VK_WHOLE_SIZE;
+
+            std::array<VkWriteDescriptorSet, 2> writes{};
+            for (uint32_t i = 0; i < writes.size(); ++i)
+            {
+                writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet = mesh->meshletDescriptorSet;
+                writes[i].dstBinding = i;
+                writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[i].descriptorCount = 1;
+                writes[i].pBufferInfo = &bufferInfos[i];
+            }
+
+            vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        }
+
+        glm::mat4 model = glm::make_mat4(mesh->GetTransformUBO().model);
+        glm::mat4 modelT = glm::transpose(model);
+        glm::mat4 invModel = glm::inverse(model);
+
+        MeshletCullPush push{};
+
+        // dot(P, M·x) = dot(Mᵀ·P, x): el plano en espacio objeto conserva la distancia en mundo
+        for (int i = 0; i < 6; ++i)
+            push.planes[i] = modelT * frustum.planes[i];
+
+        glm::vec3 scale(glm::length(glm::vec3(model[0])),
+                        glm::length(glm::vec3(model[1])),
+                        glm::length(glm::vec3(model[2])));
+        float maxScale = glm::max(scale.x, glm::max(scale.y, scale.z));
+        float minScale = glm::min(scale.x, glm::min(scale.y, scale.z));
+
+        // El cono solo es válido con back-face culling CCW, escala uniforme y sin espejo
+        const auto &config = obj.material->shader->config;
+        bool backfaceCulled = config.cullMode == VK_CULL_MODE_BACK_BIT &&
+                              config.frontFace == VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        bool uniformScale = (maxScale - minScale) <= maxScale * 0.01f;
+        bool mirrored = glm::determinant(glm::mat3(model)) < 0.0f;
+
+        push.flags = 0;
+        if (backfaceCulled && uniformScale && !mirrored)
+            push.flags |= 1u;
+
+        if (m_CullingOrthographic)
+        {
+            push.flags |= 2u;
+            push.camera = glm::vec4(glm::normalize(glm::vec3(invModel * glm::vec4(m_CullingViewDir, 0.0f))), maxScale);
+        }
+        else
+        {
+            push.camera = glm::vec4(glm::vec3(invModel * glm::vec4(m_CullingCameraPos, 1.0f)), maxScale);
+        }
+
+        push.meshletCount = static_cast<uint32_t>(mesh->meshlets.size());
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_MeshletPipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_MeshletPipelineLayout,
+                                0, 1, &mesh->meshletDescriptorSet, 0, nullptr);
+        vkCmdPushConstants(cmd, m_MeshletPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+                           0, sizeof(MeshletCullPush), &push);
+        vkCmdDispatch(cmd, (push.meshletCount + 63) / 64, 1, 1);
+
+        return true;
+    }
+
+    void GFX::RecordMeshDraw(VkCommandBuffer cmd, const RenderObject &obj, bool useMeshlets)
+    {
+        if (!useMeshlets)
+        {
+            vkCmdDrawIndexed(cmd, obj.mesh->GetIndexCount(),
+                             1, obj.mesh->GetFirstIndex(), 0, 0);
+            return;
+        }
+
+        // Meshlets descartados tienen indexCount = 0.
+        // Sin multiDrawIndirect m_MaxDrawIndirectCount es 1: un comando por meshlet.
+        const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+        const uint32_t count = static_cast<uint32_t>(obj.mesh->meshlets.size());
+
+        for (uint32_t first = 0; first < count; first += m_MaxDrawIndirectCount)
+        {
+            uint32_t batch = std::min(m_MaxDrawIndirectCount, count - first);
+            vkCmdDrawIndexedIndirect(cmd, obj.mesh->drawCommandBuffer,
+                                     static_cast<VkDeviceSize>(first) * stride, batch, stride);
+        }
+    }
+
+    // ============================================
+    // FUNCIÓN COMPLETA: UpdatePBRDescriptorSet
+    // ============================================
+
+    void GFX::UpdatePBRDescriptorSet(std::shared_ptr<Material> material)
+    {
+        // NOTA: Esta función ahora debe recibir también el mesh
+        // Se mantiene para compatibilidad pero el flujo correcto es:
+        // 1. Crear mesh
+        // 2. Crear material
+        // 3. Llamar a CreateMeshDescriptorSet(mesh, material)
+
+        std::cerr << "⚠️ WARNING: UpdatePBRDescriptorSet() está deprecada.\n"
+                  << "Usa CreateMeshDescriptorSet(mesh, material) en su lugar.\n";
+    }
+
+    // ============================================
+    // SKY
+    // ============================================
+
+    namespace
+    {
+        // Push constants de sky.vert / sky.frag
+        struct SkyPushConstants
+        {
+            glm::mat4 invViewProj; // (proyección * vista sin traslación)^-1
+            glm::vec4 tint;
+        };
+    }
+
+    void GFX::EnableSky(const std::string &vertexShaderPath, const std::string &fragmentShaderPath)
+    {
+        if (m_SkyPipeline != VK_NULL_HANDLE)
+            return;
+
+        // Leer primero: sin los .spv no se crea nada
+        auto vertCode = ReadFile(vertexShaderPath);
+        auto fragCode = ReadFile(fragmentShaderPath);
+
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+
+        if (vkCreateDescriptorSetLayout(m_Device, &layoutInfo, nullptr, &m_SkySetLayout) != VK_SUCCESS)
+            throw std::runtime_error("Error creando descriptor set layout del cielo");
+
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        pushRange.offset = 0;
+        pushRange.size = sizeof(SkyPushConstants);
+
+        VkPipelineLayoutCreateInfo pl{};
+        pl.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pl.setLayoutCount = 1;
+        pl.pSetLayouts = &m_SkySetLayout;
+        pl.pushConstantRangeCount = 1;
+        pl.pPushConstantRanges = &pushRange;
+
+        if (vkCreatePipelineLayout(m_Device, &pl, nullptr, &m_SkyPipelineLayout) != VK_SUCCESS)
+            throw std::runtime_error("Error creando pipeline layout del cielo");
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_DescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_SkySetLayout;
+
+        if (vkAllocateDescriptorSets(m_Device, &allocInfo, &m_SkyDescriptorSet) != VK_SUCCESS)
+            throw std::runtime_error("Error allocando descriptor set del cielo");
+
+        VkShaderModule vert = CreateShaderModule(vertCode);
+        VkShaderModule frag = CreateShaderModule(fragCode);
+
+        VkPipelineShaderStageCreateInfo stages[2]{};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = vert;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = frag;
+        stages[1].pName = "main";
+
+        // Sin vertex buffer: el triángulo sale de gl_VertexIndex
+        VkPipelineVertexInputStateCreateInfo vin{};
+        vin.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+        VkPipelineInputAssemblyStateCreateInfo ia{};
+        ia.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        VkPipelineViewportStateCreateInfo vpst{};
+        vpst.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        vpst.viewportCount = 1;
+        vpst.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rs{};
+        rs.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rs.polygonMode = VK_POLYGON_MODE_FILL;
+        rs.cullMode = VK_CULL_MODE_NONE;
+        rs.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        rs.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo ms{};
+        ms.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineColorBlendAttachmentState cba{};
+        cba.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                             VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        cba.blendEnable = VK_FALSE;
+
+        VkPipelineColorBlendStateCreateInfo cb{};
+        cb.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        cb.attachmentCount = 1;
+        cb.pAttachments = &cba;
+
+        // depth = 1.0 con LESS_OR_EQUAL: solo pasa donde el depth sigue en el valor de clear
+        VkPipelineDepthStencilStateCreateInfo ds{};
+        ds.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        ds.depthTestEnable = VK_TRUE;
+        ds.depthWriteEnable = VK_FALSE;
+        ds.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+        VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = 2;
+        dynamicState.pDynamicStates = dynamicStates;
+
+        // Todos los offscreen tienen los mismos formatos: basta un render pass compatible
+        VkRenderPass renderPass = CreateOffscreenRenderPass(VK_FORMAT_R8G8B8A8_UNORM, m_DepthFormat);
+
+        VkGraphicsPipelineCreateInfo pi{};
+        pi.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pi.stageCount = 2;
+        pi.pStages = stages;
+        pi.pVertexInputState = &vin;
+        pi.pInputAssemblyState = &ia;
+        pi.pViewportState = &vpst;
+        pi.pRasterizationState = &rs;
+        pi.pMultisampleState = &ms;
+        pi.pColorBlendState = &cb;
+        pi.pDepthStencilState = &ds;
+        pi.pDynamicState = &dynamicState;
+        pi.layout = m_SkyPipelineLayout;
+        pi.renderPass = renderPass;
+        pi.subpass = 0;
+
+        VkResult result = vkCreateGraphicsPipelines(m_Device, VK_NULL_HANDLE, 1, &pi, nullptr, &m_SkyPipeline);
+
+        vkDestroyRenderPass(m_Device, renderPass, nullptr);
+        vkDestroyShaderModule(m_Device, vert, nullptr);
+        vkDestroyShaderModule(m_Device, frag, nullptr);
+
+        if (result != VK_SUCCESS)
+        {
+            m_SkyPipeline = VK_NULL_HANDLE;
+            throw std::runtime_error("Error creando pipeline del cielo");
+        }
+
+        WriteSkyDescriptor();
+
+        std::cout << "✅ Cielo habilitado (" << vertexShaderPath << ", " << fragmentShaderPath << ")\n";
+    }
+
+    std::shared_ptr<Texture> GFX::CreateCubemap(const unsigned char *data, uint32_t faceSize, uint32_t mipLevels)
+    {
+        if (!data || faceSize == 0 || mipLevels == 0)
+            throw std::runtime_error("Cubemap inválido");
+
+        auto texture = std::make_shared<Texture>();
+        texture->deletionQueue = m_DeletionQueue;
+        texture->width = faceSize;
+        texture->height = faceSize;
+        texture->mipLevels = mipLevels;
+        texture->cubemap = true;
+
+        // Una copia por mip con las 6 capas contiguas
+        std::vector<VkBufferImageCopy> regions(mipLevels);
+        VkDeviceSize totalSize = 0;
+
+        for (uint32_t mip = 0; mip < mipLevels; ++mip)
+        {
+            uint32_t size = std::max(1u, faceSize >> mip);
+
+            VkBufferImageCopy &region = regions[mip];
+            region = {};
+            region.bufferOffset = totalSize;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = mip;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 6;
+            region.imageExtent = {size, size, 1};
+
+            totalSize += static_cast<VkDeviceSize>(size) * size * 4 * 6;
+        }
+
+        CreateImage(faceSize, faceSize, VK_FORMAT_R8G8B8A8_UNORM,
+                    VK_IMAGE_TILING_OPTIMAL,
+                    VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                    texture->image, texture->memory,
+                    mipLevels, false, 6, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
+
+        UploadImageRegions(texture->image, data, totalSize, regions, mipLevels, 6);
+
+        texture->imageView = CreateImageView(texture->image, VK_FORMAT_R8G8B8A8_UNORM,
+                                             VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels,
+                                             VK_IMAGE_VIEW_TYPE_CUBE, 6);
+
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.anisotropyEnable = VK_FALSE;
+        samplerInfo.maxAnisotropy = 1.0f;
+        samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = static_cast<float>(mipLevels);
+
+        if (vkCreateSampler(m_Device, &samplerInfo, nullptr, &texture->sampler) != VK_SUCCESS)
+            throw std::runtime_error("Error creando sampler del cubemap");
+
+        std::cout << "✅ Cubemap creado: 6x " << faceSize << "x" << faceSize
+                  << " (" << mipLevels << " mips)" << std::endl;
+
+        return texture;
+    }
+
+    void GFX::SetSkyCubemap(std::shared_ptr<Texture> cubemap)
+    {
+        if (cubemap && !cubemap->cubemap)
+            throw std::runtime_error("SetSkyCubemap: la textura no es un cubemap");
+
+        m_SkyCubemap = cubemap;
+        WriteSkyDescriptor();
+    }
+
+    void GFX::WriteSkyDescriptor()
+    {
+        if (m_SkyDescriptorSet == VK_NULL_HANDLE || !m_SkyCubemap)
+            return;
+
+        // RenderToOffscreenFramebuffer espera a la cola al terminar: el set nunca está en vuelo aquí
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = m_SkyCubemap->imageView;
+        imageInfo.sampler = m_SkyCubemap->sampler;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_SkyDescriptorSet;
+        write.dstBinding = 0;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.descriptorCount = 1;
+        write.pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(m_Device, 1, &write, 0, nullptr);
+    }
+
+    void GFX::RecordSky(VkCommandBuffer cmd)
+    {
+        // Solo la rotación: el cielo está en el infinito
+        glm::mat4 view = glm::mat4(glm::mat3(m_CullingView));
+        glm::mat4 projection = m_CullingProjection;
+
+        // En ortográfica todos los rayos son paralelos (un solo color): se usa una
+        // perspectiva de referencia con el mismo aspecto y el mismo signo de Y
+        if (m_CullingOrthographic)
+        {
+            float aspect = std::abs(m_CullingProjection[1][1] / m_CullingProjection[0][0]);
+            float flipY = m_CullingProjection[1][1] < 0.0f ? -1.0f : 1.0f;
+            projection = glm::perspective(glm::radians(60.0f), aspect, 0.1f, 10.0f);
+            projection[1][1] *= flipY;
+        }
+
+        SkyPushConstants push{};
+        push.invViewProj = glm::inverse(projection * view);
+        push.tint = glm::vec4(m_SkyTint, 1.0f);
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_SkyPipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_SkyPipelineLayout,
+                                0, 1, &m_SkyDescriptorSet, 0, nullptr);
+        vkCmdPushConstants(cmd, m_SkyPipelineLayout,
+                           VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0, sizeof(SkyPushConstants), &push);
+        vkCmdDraw(cmd, 3, 1, 0, 0);
+    }
+
+    // ============================================
+    // TEXTURE STREAMING
+    // ============================================
+
+    namespace
+    {
+        uint64_t StreamedResidentBytes(const TextureImageData &source, uint32_t firstMip)
+        {
+            uint64_t bytes = 0;
+            for (uint32_t mip = firstMip; mip < source.GetMipLevels(); ++mip)
+                bytes += source.mips[mip].size;
+            return bytes;
+        }
+    }
+
+    std::shared_ptr<Texture> GFX::CreateStreamedTexture(std::shared_ptr<const TextureImageData> image, VkFilter TextureFilter)
+    {
+        if (!image || image->mips.empty())
+            throw std::runtime_error("CreateStreamedTexture: imagen vacía");
+
+        const uint32_t tailMip = GetStreamingTailMip(*image);
+        if (!m_TextureStreamingSettings.enabled || tailMip == 0)
+            return CreateTexture(*image, TextureFilter);
+
+        // Solo la cola: el resto de mips llega cuando un objeto visible los pide
+        const size_t alignment = GetFormatBlockBytes(image->format);
+        TextureImageData tail;
+        tail.format = image->format;
+        tail.width = image->mips[tailMip].width;
+        tail.height = image->mips[tailMip].height;
+
+        for (uint32_t mip = tailMip; mip < image->GetMipLevels(); ++mip)
+        {
+            TextureMip level = image->mips[mip];
+            const uint8_t *src = image->bytes.data() + level.offset;
+
+            level.offset = (tail.bytes.size() + alignment - 1) / alignment * alignment;
+            tail.bytes.resize(level.offset + level.size);
+            memcpy(tail.bytes.data() + level.offset, src, level.size);
+            tail.mips.push_back(level);
+        }
+
+        auto texture = CreateTexture(tail, TextureFilter);
+        texture->width = image->width;
+        texture->height = image->height;
+        texture->mipLevels = image->GetMipLevels();
+        texture->residentMip = tailMip;
+        texture->streamSource = std::move(image);
+
+        StreamedTexture entry;
+        entry.texture = texture;
+        entry.lastUsedFrame = m_DeletionQueue->GetSubmittedFrame();
+        m_StreamedTextures.push_back(entry);
+
+        return texture;
+    }
+
+    uint32_t GFX::GetStreamingTailMip(const TextureImageData &image) const
+    {
+        const uint32_t levels = image.GetMipLevels();
+        for (uint32_t mip = 0; mip < levels; ++mip)
+        {
+            if (std::max(image.mips[mip].width, image.mips[mip].height) <= m_TextureStreamingSettings.minResidentSize)
+                return mip;
+        }
+        return levels - 1;
+    }
+
+    void GFX::RequestTextureMips(const std::vector<const RenderObject *> &visibleObjects, uint32_t viewportHeight)
+    {
+        if (!m_HasCullingCamera || m_StreamedTextures.empty())
+            return;
+
+        std::unordered_map<const Texture *, StreamedTexture *> entries;
+        for (auto &entry : m_StreamedTextures)
+        {
+            if (auto texture = entry.texture.lock())
+                entries[texture.get()] = &entry;
+        }
+
+        // Píxeles de pantalla por unidad de mundo a distancia 1
+        const float focal = 0.5f * static_cast<float>(std::max(1u, viewportHeight)) * std::abs(m_CullingProjection[1][1]);
+
+        for (const RenderObject *obj : visibleObjects)
+        {
+            if (!obj->mesh || !obj->material || obj->mesh->uvDensity <= 0.0f)
+                continue;
+
+            glm::mat4 model = glm::make_mat4(obj->mesh->GetTransformUBO().model);
+            float scale = std::max({glm::length(glm::vec3(model[0])),
+                                    glm::length(glm::vec3(model[1])),
+                                    glm::length(glm::vec3(model[2]))});
+            if (scale <= 0.0f)
+                continue;
+
+            // Punto más cercano de la esfera envolvente: el mip lo decide la parte más cercana a la cámara
+            glm::vec3 center = glm::vec3(model * glm::vec4((obj->mesh->boundsMin + obj->mesh->boundsMax) * 0.5f, 1.0f));
+            float radius = glm::length(obj->mesh->boundsMax - obj->mesh->boundsMin) * 0.5f * scale;
+            float distance = std::max(glm::length(center - m_CullingCameraPos) - radius, 0.1f);
+
+            float pixelsPerUnit = m_CullingOrthographic ? focal : focal / distance;
+            float uvPerUnit = obj->mesh->uvDensity / scale;
+
+            const PBRTextures &textures = obj->material->pbrTextures;
+            for (const Texture *texture : {textures.albedo.get(), textures.normal.get(), textures.metallic.get(),
+                                           textures.roughness.get(), textures.ao.get()})
+            {
+                if (!texture || !texture->streamSource)
+                    continue;
+
+                auto it = entries.find(texture);
+                if (it == entries.end())
+                    continue;
+
+                float texelsPerPixel = std::max(texture->width, texture->height) * uvPerUnit / pixelsPerUnit;
+                float lod = std::log2(std::max(texelsPerPixel, 1e-6f)) + m_TextureStreamingSettings.mipBias;
+                uint32_t mip = lod <= 0.0f ? 0u : std::min(static_cast<uint32_t>(lod), texture->mipLevels - 1);
+
+                it->second->requestedMip = std::min(it->second->requestedMip, mip);
+            }
+        }
+    }
+
+    void GFX::UpdateTextureStreaming(const std::vector<RenderObject> &objects)
+    {
+        // Mismo reloj que el resto de cachés: el LRU del tracker compara entre todas
+        const uint64_t frame = m_DeletionQueue->GetSubmittedFrame();
+        m_TextureStreamingStats = TextureStreamingStats{};
+
+        m_StreamedTextures.erase(
+            std::remove_if(m_StreamedTextures.begin(), m_StreamedTextures.end(),
+                           [](const StreamedTexture &entry)
+                           { return entry.texture.expired(); }),
+            m_StreamedTextures.end());
+
+        if (m_StreamedTextures.empty())
+            return;
+
+        const TextureStreamingSettings &settings = m_TextureStreamingSettings;
+
+        struct Plan
+        {
+            std::shared_ptr<Texture> texture;
+            StreamedTexture *entry;
+            uint32_t tail;
+            uint32_t wanted; // Lo que pide la pantalla
+            uint32_t target; // Lo que queda tras el presupuesto
+        };
+
+        std::vector<Plan> plans;
+        plans.reserve(m_StreamedTextures.size());
+        uint64_t totalBytes = 0;
+
+        for (auto &entry : m_StreamedTextures)
+        {
+            Plan plan;
+            plan.texture = entry.texture.lock();
+            plan.entry = &entry;
+            plan.tail = GetStreamingTailMip(*plan.texture->streamSource);
+
+            const bool visible = entry.requestedMip != UINT32_MAX;
+            if (visible)
+                entry.lastUsedFrame = frame;
+
+            if (!settings.enabled)
+            {
+                plan.wanted = plan.target = 0;
+            }
+            else if (visible)
+            {
+                // Visible: sube lo que pida, pero no baja por sí sola (evita ir y venir al mover la cámara)
+                plan.wanted = std::min(entry.requestedMip, plan.tail);
+                plan.target = std::min(plan.wanted, plan.texture->residentMip);
+            }
+            else
+            {
+                plan.wanted = plan.tail;
+                plan.target = frame - entry.lastUsedFrame > settings.evictAfterFrames
+                                  ? plan.tail
+                                  : std::min(plan.texture->residentMip, plan.tail);
+            }
+
+            entry.requestedMip = UINT32_MAX;
+            totalBytes += StreamedResidentBytes(*plan.texture->streamSource, plan.target);
+            m_TextureStreamingStats.fullBytes += StreamedResidentBytes(*plan.texture->streamSource, 0);
+            plans.push_back(plan);
+        }
+
+        // Presupuesto: se quitan mips (de a uno) primero a quien tiene más de lo que pide,
+        // después a la menos usada recientemente y, a igualdad, a la que más ocupa
+        while (settings.enabled && totalBytes > settings.budgetBytes)
+        {
+            Plan *victim = nullptr;
+            for (auto &plan : plans)
+            {
+                if (plan.target >= plan.tail)
+                    continue;
+
+                if (!victim)
+                {
+                    victim = &plan;
+                    continue;
+                }
+
+                bool planExcess = plan.target < plan.wanted, victimExcess = victim->target < victim->wanted;
+                if (planExcess != victimExcess)
+                {
+                    if (planExcess)
+                        victim = &plan;
+                }
+                else if (plan.entry->lastUsedFrame != victim->entry->lastUsedFrame)
+                {
+                    if (plan.entry->lastUsedFrame < victim->entry->lastUsedFrame)
+                        victim = &plan;
+                }
+                else if (plan.target < victim->target)
+                {
+                    victim = &plan;
+                }
+            }
+
+            if (!victim)
+                break;
+
+            const TextureImageData &source = *victim->texture->streamSource;
+            totalBytes -= source.mips[victim->target].size;
+            victim->target++;
+        }
+
+        // Las imágenes nuevas no disparan el desalojo global: podría tocar texturas de este mismo plan
+        const bool wasEvicting = m_EvictingMemory;
+        m_EvictingMemory = true;
+
+        // Descargas: siempre (la copia es de los mips chicos); subidas: las más urgentes hasta el límite por frame
+        std::vector<Plan *> uploads;
+        for (auto &plan : plans)
+        {
+            Texture &texture = *plan.texture;
+            if (plan.target > texture.residentMip)
+            {
+                PendingTextureUpload upload;
+                ReplaceStreamedImage(texture, plan.target, upload);
+                m_TextureStreamingStats.evictions++;
+                m_PendingTextureUploads.push_back(std::move(upload));
+            }
+            else if (plan.target < texture.residentMip)
+            {
+                uploads.push_back(&plan);
+            }
+        }
+
+        std::sort(uploads.begin(), uploads.end(),
+                  [](const Plan *a, const Plan *b)
+                  {
+                      uint32_t gapA = a->texture->residentMip - a->target, gapB = b->texture->residentMip - b->target;
+                      if (a->entry->lastUsedFrame != b->entry->lastUsedFrame)
+                          return a->entry->lastUsedFrame > b->entry->lastUsedFrame;
+                      return gapA > gapB;
+                  });
+
+        for (Plan *plan : uploads)
+        {
+            uint64_t bytes = StreamedResidentBytes(*plan->texture->streamSource, plan->target);
+            if (m_TextureStreamingStats.uploads > 0 &&
+                m_TextureStreamingStats.uploadedBytes + bytes > settings.maxUploadBytesPerFrame)
+                continue;
+
+            // Presupuesto global de VRAM (meshes, render targets...): se espera a que haya sitio
+            if (m_MemoryTracker->GetOverBudget(bytes) > 0)
+                continue;
+
+            PendingTextureUpload upload;
+            ReplaceStreamedImage(*plan->texture, plan->target, upload);
+            m_TextureStreamingStats.uploads++;
+            m_TextureStreamingStats.uploadedBytes += bytes;
+            m_PendingTextureUploads.push_back(std::move(upload));
+        }
+
+        for (const auto &plan : plans)
+        {
+            m_TextureStreamingStats.residentBytes +=
+                StreamedResidentBytes(*plan.texture->streamSource, plan.texture->residentMip);
+            if (plan.wanted < plan.texture->residentMip)
+                m_TextureStreamingStats.pendingRequests++;
+        }
+        m_TextureStreamingStats.streamedTextures = static_cast<uint32_t>(plans.size());
+        m_EvictingMemory = wasEvicting;
+
+        // Descriptor sets que apuntan a imágenes reemplazadas (las viejas siguen vivas hasta su fence)
+        if (m_StreamingDescriptorsDirty)
+        {
+            for (const auto &obj : objects)
+                RefreshMeshTextures(obj);
+            for (const auto &obj : m_RenderObjects)
+                RefreshMeshTextures(obj);
+            m_StreamingDescriptorsDirty = false;
+        }
+    }
+
+    void GFX::ReplaceStreamedImage(Texture &texture, uint32_t firstMip, PendingTextureUpload &upload)
+    {
+        const TextureImageData &source = *texture.streamSource;
+        const uint32_t levelCount = texture.mipLevels - firstMip;
+        const size_t alignment = GetFormatBlockBytes(source.format);
+
+        VkDeviceSize size = 0;
+        upload.regions.assign(levelCount, VkBufferImageCopy{});
+        for (uint32_t i = 0; i < levelCount; ++i)
+        {
+            const TextureMip &level = source.mips[firstMip + i];
+            size = (size + alignment - 1) / alignment * alignment;
+
+            VkBufferImageCopy &region = upload.regions[i];
+            region.bufferOffset = size;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = i;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageExtent = {level.width, level.height, 1};
+
+            size += level.size;
+        }
+
+        CreateBuffer(size,
+                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     upload.stagingBuffer, upload.stagingMemory);
+
+        void *mappedData;
+        vkMapMemory(m_Device, upload.stagingMemory, 0, size, 0, &mappedData);
+        for (uint32_t i = 0; i < levelCount; ++i)
+        {
+            const TextureMip &level = source.mips[firstMip + i];
+            memcpy(static_cast<uint8_t *>(mappedData) + upload.regions[i].bufferOffset,
+                   source.bytes.data() + level.offset, level.size);
+        }
+        vkUnmapMemory(m_Device, upload.stagingMemory);
+
+        VkImage image;
+        VkDeviceMemory memory;
+        CreateImage(source.mips[firstMip].width, source.mips[firstMip].height, source.format,
+                    VK_IMAGE_TILING_OPTIMAL,
+                    VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                    image, memory, levelCount);
+        VkImageView view = CreateImageView(image, source.format, VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount);
+
+        // La imagen vieja puede estar en el frame en vuelo; el sampler se conserva (maxLod sin límite)
+        m_DeletionQueue->RetireImageView(texture.imageView);
+        m_DeletionQueue->RetireImage(texture.image);
+        m_DeletionQueue->RetireMemory(texture.memory);
+
+        texture.image = image;
+        texture.memory = memory;
+        texture.imageView = view;
+        texture.residentMip = firstMip;
+        texture.generation++;
+        m_StreamingDescriptorsDirty = true;
+
+        upload.image = image;
+        upload.levelCount = levelCount;
+    }
+
+    void GFX::RecordTextureUpload(VkCommandBuffer cmd, const PendingTextureUpload &upload)
+    {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = upload.image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, upload.levelCount, 0, 1};
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        vkCmdCopyBufferToImage(cmd, upload.stagingBuffer, upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(upload.regions.size()), upload.regions.data());
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        // El staging vive hasta que termine el frame que lo copia
+        m_DeletionQueue->RetireBuffer(upload.stagingBuffer);
+        m_DeletionQueue->RetireMemory(upload.stagingMemory);
+    }
+
+    void GFX::RefreshMeshTextures(const RenderObject &obj)
+    {
+        if (!obj.mesh || !obj.material || obj.mesh->descriptorSet == VK_NULL_HANDLE)
+            return;
+
+        if (obj.mesh->textureGeneration == obj.material->GetTextureGeneration())
+            return;
+
+        m_DeletionQueue->RetireDescriptorSet(obj.mesh->descriptorSet);
+        obj.mesh->descriptorSet = VK_NULL_HANDLE;
+        CreateMeshDescriptorSet(obj.mesh, obj.material);
+    }
+
+    uint64_t GFX::GetOldestStreamedTextureUse() const
+    {
+        uint64_t oldest = UINT64_MAX;
+        for (const auto &entry : m_StreamedTextures)
+        {
+            auto texture = entry.texture.lock();
+            if (texture && texture->residentMip < GetStreamingTailMip(*texture->streamSource))
+                oldest = std::min(oldest, entry.lastUsedFrame);
+        }
+        return oldest;
+    }
+
+    uint64_t GFX::EvictOldestStreamedTexture()
+    {
+        StreamedTexture *victim = nullptr;
+        std::shared_ptr<Texture> texture;
+        uint32_t tail = 0;
+
+        for (auto &entry : m_StreamedTextures)
+        {
+            auto candidate = entry.texture.lock();
+            if (!candidate)
                 continue;
 
-            if (!obj.mesh->vertexBuffer || !obj.mesh->indexBuffer)
-                continue;
+            uint32_t candidateTail = GetStreamingTailMip(*candidate->streamSource);
+            if (candidate->residentMip >= candidateTail)
+                continue;
+
+            if (!victim || entry.lastUsedFrame < victim->lastUsedFrame)
+            {
+                victim = &entry;
+                texture = candidate;
+                tail = candidateTail;
+            }
+        }
+
+        if (!victim)
+            return 0;
+
+        const TextureImageData &source = *texture->streamSource;
+        uint64_t released = StreamedResidentBytes(source, texture->residentMip) - StreamedResidentBytes(source, tail);
+
+        // Fuera del frame (puede llamarse desde cualquier allocation): la cola se sube en el acto
+        PendingTextureUpload upload;
+        ReplaceStreamedImage(*texture, tail, upload);
+
+        VkCommandBuffer cmd = BeginSingleTimeCommands();
+        RecordTextureUpload(cmd, upload);
+        EndSingleTimeCommands(cmd);
+
+        // Lo que se dibuja fuera del offscreen no pasa por UpdateTextureStreaming
+        for (const auto &obj : m_RenderObjects)
+            RefreshMeshTextures(obj);
+
+        return released;
+    }
+
+    // ============================================
+    // CLUSTERED LIGHTING
+    // ============================================
+
+    namespace
+    {
+        // Layout std430 del buffer ClusterParams (pbr.frag / light_cull.comp)
+        struct ClusterParamsGPU
+        {
+            glm::mat4 view;
+            glm::mat4 invProjection;
+            uint32_t grid[4];  // xyz: celdas, w: número de luces
+            float viewport[4]; // xy: tamaño, z: near, w: far
+            uint32_t flags[4]; // x: cortes lineales, y: clusters válidos
+        };
+    }
+
+    void GFX::CreateLightingResources()
+    {
+        // Set 1 de los pipelines gráficos: params, luces, contadores e índices por cluster
+        std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+        for (uint32_t i = 0; i < bindings.size(); ++i)
+        {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
+
+        if (vkCreateDescriptorSetLayout(m_Device, &layoutInfo, nullptr, &m_LightingSetLayout) != VK_SUCCESS)
+            throw std::runtime_error("Error creando descriptor set layout de luces");
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_DescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_LightingSetLayout;
+
+        if (vkAllocateDescriptorSets(m_Device, &allocInfo, &m_LightingDescriptorSet) != VK_SUCCESS)
+            throw std::runtime_error("Error allocando descriptor set de luces");
+
+        m_ClusterParamsBuffer = CreateStorageBuffer(sizeof(ClusterParamsGPU), 0, true);
+        memset(m_ClusterParamsBuffer->mapped, 0, sizeof(ClusterParamsGPU));
+
+        CreateClusterBuffers();
+    }
+
+    void GFX::CreateClusterBuffers()
+    {
+        const ClusterSettings &cs = m_ClusterSettings;
+        VkDeviceSize clusterCount = static_cast<VkDeviceSize>(cs.gridX) * cs.gridY * cs.gridZ;
+
+        m_LightBuffer = CreateStorageBuffer(sizeof(GPULight) * std::max(1u, cs.maxLights), 0, true);
+        m_ClusterCountBuffer = CreateStorageBuffer(sizeof(uint32_t) * clusterCount);
+        m_ClusterIndexBuffer = CreateStorageBuffer(sizeof(uint32_t) * clusterCount * CLUSTER_MAX_LIGHTS);
+
+        // Sin culling todavía: ningún cluster tiene luces
+        VkCommandBuffer cmd = BeginSingleTimeCommands();
+        vkCmdFillBuffer(cmd, m_ClusterCountBuffer->buffer, 0, VK_WHOLE_SIZE, 0);
+        EndSingleTimeCommands(cmd);
+
+        WriteLightingDescriptors();
+    }
+
+    void GFX::WriteLightingDescriptors()
+    {
+        for (VkDescriptorSet set : {m_LightingDescriptorSet, m_LightCullSet})
+        {
+            BindStorageBuffer(set, 0, m_ClusterParamsBuffer);
+            BindStorageBuffer(set, 1, m_LightBuffer);
+            BindStorageBuffer(set, 2, m_ClusterCountBuffer);
+            BindStorageBuffer(set, 3, m_ClusterIndexBuffer);
+        }
+    }
+
+    void GFX::EnableClusteredLighting(const std::string &computeShaderPath)
+    {
+        if (m_LightCullShader)
+            return;
+
+        ComputeShaderConfig config;
+        config.computeShaderPath = computeShaderPath;
+        config.bindings = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                           VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER};
 
-            if (!obj.material->shader->pipeline)
-                continue;
+        m_LightCullShader = CreateComputeShader(config);
+        m_LightCullSet = CreateComputeDescriptorSet(m_LightCullShader);
+        WriteLightingDescriptors();
 
-            // Solo transparentes
-            if (!obj.material->shader->config.blendEnable)
-                continue;
+        std::cout << "✅ Clustered lighting habilitado (" << computeShaderPath << ", "
+                  << m_ClusterSettings.gridX << "x" << m_ClusterSettings.gridY << "x" << m_ClusterSettings.gridZ
+                  << " clusters)\n";
+    }
+
+    void GFX::SetClusterSettings(const ClusterSettings &settings)
+    {
+        m_ClusterSettings = settings;
+        m_ClusterSettings.gridX = std::max(1u, settings.gridX);
+        m_ClusterSettings.gridY = std::max(1u, settings.gridY);
+        m_ClusterSettings.gridZ = std::max(1u, settings.gridZ);
+        m_ClusterSettings.maxLights = std::max(1u, settings.maxLights);
+
+        // Los sets están en uso por frames enviados: no se pueden reescribir en vuelo
+        vkDeviceWaitIdle(m_Device);
+        CreateClusterBuffers();
+    }
+
+    void GFX::UploadLighting(VkExtent2D extent)
+    {
+        const ClusterSettings &cs = m_ClusterSettings;
+        uint32_t lightCount = static_cast<uint32_t>(std::min<size_t>(m_Lights.size(), cs.maxLights));
+
+        if (m_Lights.size() > lightCount && m_LightingStats.dropped == 0)
+            std::cerr << "⚠️ " << m_Lights.size() << " luces, capacidad " << cs.maxLights
+                      << ": se ignoran las sobrantes (ver ClusterSettings::maxLights)\n";
+
+        if (lightCount > 0)
+            memcpy(m_LightBuffer->mapped, m_Lights.data(), sizeof(GPULight) * lightCount);
+
+        ClusterParamsGPU params{};
+        params.view = m_CullingView;
+        params.invProjection = glm::inverse(m_CullingProjection);
+        params.grid[0] = cs.gridX;
+        params.grid[1] = cs.gridY;
+        params.grid[2] = cs.gridZ;
+        params.grid[3] = lightCount;
+        params.viewport[0] = static_cast<float>(std::max(1u, extent.width));
+        params.viewport[1] = static_cast<float>(std::max(1u, extent.height));
+
+        // Rango de profundidad visible: en Vulkan NDC z va de 0 a 1
+        glm::vec4 nearPoint = params.invProjection * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        glm::vec4 farPoint = params.invProjection * glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        float zNear = -nearPoint.z / nearPoint.w;
+        float zFar = -farPoint.z / farPoint.w;
+        params.viewport[2] = zNear;
+        params.viewport[3] = zFar;
+
+        // Cortes exponenciales solo en perspectiva (necesitan near > 0)
+        bool linear = m_CullingOrthographic || zNear <= 0.0f;
+        bool clustered = IsClusteredLightingEnabled() && m_HasCullingCamera && zFar > zNear;
+        params.flags[0] = linear ? 1u : 0u;
+        params.flags[1] = clustered ? 1u : 0u;
+
+        memcpy(m_ClusterParamsBuffer->mapped, &params, sizeof(params));
+
+        m_LightingStats.lights = lightCount;
+        m_LightingStats.dropped = static_cast<uint32_t>(m_Lights.size() - lightCount);
+        m_LightingStats.clusters = cs.gridX * cs.gridY * cs.gridZ;
+        m_LightingStats.clustered = clustered;
+    }
+
+    void GFX::RecordLightCulling(VkCommandBuffer cmd)
+    {
+        // Un hilo por cluster, grupos de 64 (BATCH_SIZE en light_cull.comp)
+        uint32_t groups = (m_LightingStats.clusters + 63) / 64;
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_LightCullShader->pipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_LightCullShader->pipelineLayout,
+                                0, 1, &m_LightCullSet, 0, nullptr);
+        vkCmdDispatch(cmd, groups, 1, 1);
+    }
+
+    void GFX::BindMeshDescriptorSets(VkCommandBuffer cmd, VkPipelineLayout layout, VkDescriptorSet meshSet)
+    {
+        VkDescriptorSet sets[] = {meshSet, m_LightingDescriptorSet};
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 2, sets, 0, nullptr);
+    }
+
+    // ============================================
+    // COMPUTE
+    // ============================================
+
+    void GFX::CreateComputePipeline(const std::string &computeShaderPath,
+                                    const std::vector<VkDescriptorType> &bindings, uint32_t pushConstantSize,
+                                    VkDescriptorSetLayout &setLayout, VkPipelineLayout &pipelineLayout,
+                                    VkPipeline &pipeline)
+    {
+        std::vector<VkDescriptorSetLayoutBinding> layoutBindings(bindings.size());
+        for (uint32_t i = 0; i < layoutBindings.size(); ++i)
+        {
+            layoutBindings[i].binding = i;
+            layoutBindings[i].descriptorType = bindings[i];
+            layoutBindings[i].descriptorCount = 1;
+            layoutBindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<uint32_t>(layoutBindings.size());
+        layoutInfo.pBindings = layoutBindings.data();
+
+        if (vkCreateDescriptorSetLayout(m_Device, &layoutInfo, nullptr, &setLayout) != VK_SUCCESS)
+            throw std::runtime_error("Error creando descriptor set layout de compute (" + computeShaderPath + ")");
+
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushRange.offset = 0;
+        pushRange.size = pushConstantSize;
+
+        VkPipelineLayoutCreateInfo plInfo{};
+        plInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        plInfo.setLayoutCount = 1;
+        plInfo.pSetLayouts = &setLayout;
+        plInfo.pushConstantRangeCount = pushConstantSize > 0 ? 1 : 0;
+        plInfo.pPushConstantRanges = pushConstantSize > 0 ? &pushRange : nullptr;
+
+        if (vkCreatePipelineLayout(m_Device, &plInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+            throw std::runtime_error("Error creando pipeline layout de compute (" + computeShaderPath + ")");
+
+        auto compCode = ReadFile(computeShaderPath);
+        VkShaderModule compModule = CreateShaderModule(compCode);
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = compModule;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = pipelineLayout;
+
+        VkResult result = vkCreateComputePipelines(m_Device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+        vkDestroyShaderModule(m_Device, compModule, nullptr);
+
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Error creando compute pipeline (" + computeShaderPath + ")");
+    }
+
+    std::shared_ptr<ComputeShader> GFX::CreateComputeShader(const ComputeShaderConfig &config)
+    {
+        if (config.pushConstantSize > 128)
+            throw std::runtime_error("Compute push constants > 128 bytes (" + config.computeShaderPath + ")");
+
+        auto shader = std::make_shared<ComputeShader>(config);
+
+        CreateComputePipeline(config.computeShaderPath, config.bindings, config.pushConstantSize,
+                              shader->descriptorSetLayout, shader->pipelineLayout, shader->pipeline);
+
+        // La cola se asigna al final: si algo falló arriba, el shader a medias no se retira
+        shader->deletionQueue = m_DeletionQueue;
+
+        std::cout << "✅ Compute shader creado (" << config.computeShaderPath << ")\n";
+        return shader;
+    }
+
+    VkDescriptorSet GFX::CreateComputeDescriptorSet(std::shared_ptr<ComputeShader> shader)
+    {
+        if (!shader || shader->descriptorSetLayout == VK_NULL_HANDLE)
+            throw std::runtime_error("CreateComputeDescriptorSet: compute shader inválido");
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_DescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &shader->descriptorSetLayout;
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        if (vkAllocateDescriptorSets(m_Device, &allocInfo, &set) != VK_SUCCESS)
+            throw std::runtime_error("Error allocando descriptor set de compute");
+
+        // Se liberan con el shader
+        shader->descriptorSets.push_back(set);
+        return set;
+    }
+
+    void GFX::BindStorageBuffer(VkDescriptorSet set, uint32_t binding, std::shared_ptr<StorageBuffer> buffer)
+    {
+        if (set == VK_NULL_HANDLE || !buffer)
+            return;
+
+        VkDescriptorBufferInfo bufferInfo{buffer->buffer, 0, VK_WHOLE_SIZE};
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &bufferInfo;
+
+        vkUpdateDescriptorSets(m_Device, 1, &write, 0, nullptr);
+    }
+
+    void GFX::BindStorageImage(VkDescriptorSet set, uint32_t binding, std::shared_ptr<StorageImage> image)
+    {
+        if (set == VK_NULL_HANDLE || !image)
+            return;
+
+        VkDescriptorImageInfo imageInfo{VK_NULL_HANDLE, image->imageView, VK_IMAGE_LAYOUT_GENERAL};
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        write.pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(m_Device, 1, &write, 0, nullptr);
+    }
+
+    void GFX::BindSampledImage(VkDescriptorSet set, uint32_t binding, std::shared_ptr<StorageImage> image)
+    {
+        if (set == VK_NULL_HANDLE || !image)
+            return;
+
+        VkDescriptorImageInfo imageInfo{image->sampler, image->imageView, VK_IMAGE_LAYOUT_GENERAL};
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(m_Device, 1, &write, 0, nullptr);
+    }
+
+    void GFX::BindSampledTexture(VkDescriptorSet set, uint32_t binding, std::shared_ptr<Texture> texture)
+    {
+        if (set == VK_NULL_HANDLE || !texture)
+            return;
+
+        VkDescriptorImageInfo imageInfo{texture->sampler, texture->imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(m_Device, 1, &write, 0, nullptr);
+    }
+
+    std::shared_ptr<StorageBuffer> GFX::CreateStorageBuffer(VkDeviceSize size, VkBufferUsageFlags extraUsage,
+                                                            bool hostVisible)
+    {
+        if (size == 0)
+            throw std::runtime_error("CreateStorageBuffer: tamaño 0");
+
+        auto storage = std::make_shared<StorageBuffer>();
+        storage->size = size;
+
+        VkMemoryPropertyFlags props = hostVisible
+                                          ? VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+                                          : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+        CreateBuffer(size,
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                         VK_BUFFER_USAGE_TRANSFER_SRC_BIT | extraUsage,
+                     props, storage->buffer, storage->memory, true);
+
+        if (hostVisible)
+            vkMapMemory(m_Device, storage->memory, 0, size, 0, &storage->mapped);
+
+        storage->deletionQueue = m_DeletionQueue;
+        return storage;
+    }
+
+    std::shared_ptr<StorageImage> GFX::CreateStorageImage(uint32_t width, uint32_t height, VkFormat format)
+    {
+        VkFormatProperties formatProps;
+        vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &formatProps);
+        if (!(formatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+            throw std::runtime_error("CreateStorageImage: formato sin soporte de storage image");
+
+        auto storage = std::make_shared<StorageImage>();
+        storage->format = format;
+        storage->width = std::max(1u, width);
+        storage->height = std::max(1u, height);
+
+        CreateImage(storage->width, storage->height, format, VK_IMAGE_TILING_OPTIMAL,
+                    VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, storage->image, storage->memory, 1, true);
+
+        storage->imageView = CreateImageView(storage->image, format, VK_IMAGE_ASPECT_COLOR_BIT, 0, 1);
+
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.maxLod = 0.0f;
+
+        if (vkCreateSampler(m_Device, &samplerInfo, nullptr, &storage->sampler) != VK_SUCCESS)
+            throw std::runtime_error("Error creando sampler de storage image");
+
+        // Vive en GENERAL toda su vida: compute escribe y gráficos muestrea sin transiciones
+        VkCommandBuffer cmd = BeginSingleTimeCommands();
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = storage->image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &barrier);
+
+        EndSingleTimeCommands(cmd);
+
+        storage->deletionQueue = m_DeletionQueue;
+        return storage;
+    }
+
+    void GFX::Dispatch(std::shared_ptr<ComputeShader> shader, VkDescriptorSet set,
+                       uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ,
+                       const void *pushConstants, uint32_t pushConstantSize)
+    {
+        if (!shader || shader->pipeline == VK_NULL_HANDLE)
+            return;
+
+        if (groupsX == 0 || groupsY == 0 || groupsZ == 0)
+            return;
+
+        PendingDispatch dispatch;
+        dispatch.shader = shader;
+        dispatch.set = set;
+        dispatch.groups[0] = groupsX;
+        dispatch.groups[1] = groupsY;
+        dispatch.groups[2] = groupsZ;
+
+        if (pushConstants && pushConstantSize > 0)
+        {
+            uint32_t size = std::min(pushConstantSize, shader->config.pushConstantSize);
+            const uint8_t *bytes = static_cast<const uint8_t *>(pushConstants);
+            dispatch.pushConstants.assign(bytes, bytes + size);
+        }
+
+        m_PendingDispatches.push_back(std::move(dispatch));
+    }
+
+    void GFX::DispatchAsync(std::shared_ptr<ComputeShader> shader, VkDescriptorSet set,
+                            uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ,
+                            const void *pushConstants, uint32_t pushConstantSize)
+    {
+        size_t queued = m_PendingDispatches.size();
+        Dispatch(shader, set, groupsX, groupsY, groupsZ, pushConstants, pushConstantSize);
+
+        // Sin familia dedicada se queda en la cola gráfica (inicio del próximo frame)
+        if (HasAsyncCompute() && m_PendingDispatches.size() > queued)
+        {
+            m_PendingAsyncDispatches.push_back(std::move(m_PendingDispatches.back()));
+            m_PendingDispatches.pop_back();
+        }
+    }
+
+    void GFX::RecordDispatchList(VkCommandBuffer cmd, const std::vector<PendingDispatch> &dispatches)
+    {
+        VkPipeline lastPipeline = VK_NULL_HANDLE;
 
-            if (obj.material->shader->pipeline != lastPipeline)
+        for (const auto &dispatch : dispatches)
+        {
+            const ComputeShader &shader = *dispatch.shader;
+
+            if (shader.pipeline != lastPipeline)
             {
-                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                  obj.material->shader->pipeline);
-                lastPipeline = obj.material->shader->pipeline;
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, shader.pipeline);
+                lastPipeline = shader.pipeline;
             }
 
-            vkCmdPushConstants(
-                cmd,
-                obj.material->shader->pipelineLayout,
-                VK_SHADER_STAGE_FRAGMENT_BIT,
-                0,
-                sizeof(MaterialPushConstants),
-                &obj.material->pushConstants);
+            if (dispatch.set != VK_NULL_HANDLE)
+                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, shader.pipelineLayout,
+                                        0, 1, &dispatch.set, 0, nullptr);
 
-            VkBuffer vertexBuffers[] = {obj.mesh->vertexBuffer};
-            VkDeviceSize offsets[] = {0};
-            vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
-            vkCmdBindIndexBuffer(cmd, obj.mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            if (!dispatch.pushConstants.empty())
+                vkCmdPushConstants(cmd, shader.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                                   static_cast<uint32_t>(dispatch.pushConstants.size()),
+                                   dispatch.pushConstants.data());
+
+            vkCmdDispatch(cmd, dispatch.groups[0], dispatch.groups[1], dispatch.groups[2]);
 
-            // ✅ CAMBIO: Usar descriptor set del MESH
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                    obj.material->shader->pipelineLayout,
-                                    0, 1, &obj.mesh->descriptorSet, 0, nullptr);
+            // Dispatches encadenados (ej. simulación → compactado) leen lo anterior
+            VkMemoryBarrier chain{};
+            chain.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            chain.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            chain.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
 
-            vkCmdDrawIndexed(cmd, static_cast<uint32_t>(obj.mesh->indices.size()),
-                             1, 0, 0, 0);
+            if (&dispatch != &dispatches.back())
+                vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                     1, &chain, 0, nullptr, 0, nullptr);
         }
+    }
 
-        vkCmdEndRenderPass(cmd);
+    void GFX::RecordPendingDispatches(VkCommandBuffer cmd)
+    {
+        if (m_PendingDispatches.empty())
+            return;
 
-        // Transición: COLOR_ATTACHMENT → SHADER_READ_ONLY
-        VkImageMemoryBarrier barrier2{};
-        barrier2.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier2.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        barrier2.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier2.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier2.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier2.image = offscreen->colorImage;
-        barrier2.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier2.subresourceRange.baseMipLevel = 0;
-        barrier2.subresourceRange.levelCount = 1;
-        barrier2.subresourceRange.baseArrayLayer = 0;
-        barrier2.subresourceRange.layerCount = 1;
-        barrier2.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        barrier2.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        RecordDispatchList(cmd, m_PendingDispatches);
+
+        // ✅ Compute → gráficos: buffers como vértices/índices/indirect y SSBO/imagenes en shaders
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT |
+                                VK_ACCESS_SHADER_READ_BIT;
 
         vkCmdPipelineBarrier(
             cmd,
-            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
             0,
+            1, &barrier,
             0, nullptr,
-            0, nullptr,
-            1, &barrier2);
+            0, nullptr);
 
-        EndSingleTimeCommands(cmd);
+        m_PendingDispatches.clear();
     }
 
-    // ============================================
-    // FUNCIÓN COMPLETA: UpdatePBRDescriptorSet
-    // ============================================
+    VkResult GFX::SubmitFrame(VkCommandBuffer cmd)
+    {
+        // El compute asíncrono del frame anterior debe terminar antes de que el raster lo lea
+        VkSemaphore waitSemaphores[2] = {m_ImageAvailableSemaphore, m_ComputeFinishedSemaphore};
+        VkPipelineStageFlags waitStages[2] = {
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT};
 
-    void GFX::UpdatePBRDescriptorSet(std::shared_ptr<Material> material)
+        VkSubmitInfo si{};
+        si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        si.waitSemaphoreCount = m_ComputeSemaphorePending ? 2 : 1;
+        si.pWaitSemaphores = waitSemaphores;
+        si.pWaitDstStageMask = waitStages;
+        si.commandBufferCount = 1;
+        si.pCommandBuffers = &cmd;
+        si.signalSemaphoreCount = 1;
+        si.pSignalSemaphores = &m_RenderFinishedSemaphore;
+
+        VkResult result = vkQueueSubmit(m_GraphicsQueue, 1, &si, m_InFlightFence);
+        if (result != VK_SUCCESS)
+            return result;
+
+        m_ComputeSemaphorePending = false;
+        m_DeletionQueue->OnFrameSubmitted();
+
+        // Tras el submit gráfico: el compute de este frame corre en paralelo a su raster
+        SubmitAsyncCompute();
+        return result;
+    }
+
+    void GFX::SubmitAsyncCompute()
     {
-        // NOTA: Esta función ahora debe recibir también el mesh
-        // Se mantiene para compatibilidad pero el flujo correcto es:
-        // 1. Crear mesh
-        // 2. Crear material
-        // 3. Llamar a CreateMeshDescriptorSet(mesh, material)
+        if (m_PendingAsyncDispatches.empty() || m_ComputeCommandBuffer == VK_NULL_HANDLE)
+            return;
 
-        std::cerr << "⚠️ WARNING: UpdatePBRDescriptorSet() está deprecada.\n"
-                  << "Usa CreateMeshDescriptorSet(mesh, material) en su lugar.\n";
+        WaitAsyncCompute();
+        vkResetFences(m_Device, 1, &m_ComputeFence);
+        vkResetCommandBuffer(m_ComputeCommandBuffer, 0);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        vkBeginCommandBuffer(m_ComputeCommandBuffer, &beginInfo);
+        RecordDispatchList(m_ComputeCommandBuffer, m_PendingAsyncDispatches);
+        vkEndCommandBuffer(m_ComputeCommandBuffer);
+
+        VkSubmitInfo si{};
+        si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        si.commandBufferCount = 1;
+        si.pCommandBuffers = &m_ComputeCommandBuffer;
+        si.signalSemaphoreCount = 1;
+        si.pSignalSemaphores = &m_ComputeFinishedSemaphore;
+
+        if (vkQueueSubmit(m_ComputeQueue, 1, &si, m_ComputeFence) != VK_SUCCESS)
+            throw std::runtime_error("Error en vkQueueSubmit (compute)");
+
+        m_ComputeInFlight = true;
+        m_ComputeSemaphorePending = true;
+        m_PendingAsyncDispatches.clear();
+    }
+
+    void GFX::WaitAsyncCompute()
+    {
+        if (!m_ComputeInFlight)
+            return;
+
+        vkWaitForFences(m_Device, 1, &m_ComputeFence, VK_TRUE, UINT64_MAX);
+        m_ComputeInFlight = false;
     }
 
     // ============================================
@@ -2763,8 +5830,8 @@ namespace Mantrax
         else
         {
             // Recrear descriptor set con las nuevas texturas
-            // Primero liberarlo
-            vkFreeDescriptorSets(m_Device, m_DescriptorPool, 1, &mesh->descriptorSet);
+            // El viejo puede estar en el frame en vuelo: liberarlo cuando termine
+            m_DeletionQueue->RetireDescriptorSet(mesh->descriptorSet);
             mesh->descriptorSet = VK_NULL_HANDLE;
 
             // Crear nuevo
@@ -2799,7 +5866,7 @@ namespace Mantrax
                 }
                 if (obj.mesh->vertexBufferMemory != VK_NULL_HANDLE)
                 {
-                    vkFreeMemory(m_Device, obj.mesh->vertexBufferMemory, nullptr);
+                    FreeMemory(obj.mesh->vertexBufferMemory);
                     obj.mesh->vertexBufferMemory = VK_NULL_HANDLE;
                 }
                 if (obj.mesh->indexBuffer != VK_NULL_HANDLE)
@@ -2809,7 +5876,7 @@ namespace Mantrax
                 }
                 if (obj.mesh->indexBufferMemory != VK_NULL_HANDLE)
                 {
-                    vkFreeMemory(m_Device, obj.mesh->indexBufferMemory, nullptr);
+                    FreeMemory(obj.mesh->indexBufferMemory);
                     obj.mesh->indexBufferMemory = VK_NULL_HANDLE;
                 }
 
@@ -2821,18 +5888,42 @@ namespace Mantrax
                 }
                 if (obj.mesh->uniformBufferMemory != VK_NULL_HANDLE)
                 {
-                    vkFreeMemory(m_Device, obj.mesh->uniformBufferMemory, nullptr);
+                    FreeMemory(obj.mesh->uniformBufferMemory);
                     obj.mesh->uniformBufferMemory = VK_NULL_HANDLE;
                 }
 
+                // Meshlets
+                if (obj.mesh->meshletBuffer != VK_NULL_HANDLE)
+                {
+                    vkDestroyBuffer(m_Device, obj.mesh->meshletBuffer, nullptr);
+                    obj.mesh->meshletBuffer = VK_NULL_HANDLE;
+                }
+                if (obj.mesh->meshletBufferMemory != VK_NULL_HANDLE)
+                {
+                    FreeMemory(obj.mesh->meshletBufferMemory);
+                    obj.mesh->meshletBufferMemory = VK_NULL_HANDLE;
+                }
+                if (obj.mesh->drawCommandBuffer != VK_NULL_HANDLE)
+                {
+                    vkDestroyBuffer(m_Device, obj.mesh->drawCommandBuffer, nullptr);
+                    obj.mesh->drawCommandBuffer = VK_NULL_HANDLE;
+                }
+                if (obj.mesh->drawCommandBufferMemory != VK_NULL_HANDLE)
+                {
+                    FreeMemory(obj.mesh->drawCommandBufferMemory);
+                    obj.mesh->drawCommandBufferMemory = VK_NULL_HANDLE;
+                }
+
                 // Descriptor set se libera automáticamente con el pool
                 obj.mesh->descriptorSet = VK_NULL_HANDLE;
+                obj.mesh->meshletDescriptorSet = VK_NULL_HANDLE;
             }
         }
 
         // Limpiar shaders
-        for (auto &shader : m_AllShaders)
+        for (auto &shader : LockLiveShaders())
         {
+            DestroyShaderVariants(*shader);
             if (shader->pipeline != VK_NULL_HANDLE)
             {
                 vkDestroyPipeline(m_Device, shader->pipeline, nullptr);
@@ -2850,10 +5941,75 @@ namespace Mantrax
             }
         }
 
+        // Set de luces (el descriptor set se libera con el pool)
+        if (m_LightingSetLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorSetLayout(m_Device, m_LightingSetLayout, nullptr);
+            m_LightingSetLayout = VK_NULL_HANDLE;
+            m_LightingDescriptorSet = VK_NULL_HANDLE;
+        }
+
+        // Cielo (el descriptor set se libera con el pool)
+        if (m_SkyPipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(m_Device, m_SkyPipeline, nullptr);
+            m_SkyPipeline = VK_NULL_HANDLE;
+        }
+        if (m_SkyPipelineLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyPipelineLayout(m_Device, m_SkyPipelineLayout, nullptr);
+            m_SkyPipelineLayout = VK_NULL_HANDLE;
+        }
+        if (m_SkySetLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorSetLayout(m_Device, m_SkySetLayout, nullptr);
+            m_SkySetLayout = VK_NULL_HANDLE;
+            m_SkyDescriptorSet = VK_NULL_HANDLE;
+        }
+
+        // Limpiar pipeline del HiZ
+        if (m_HiZPipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(m_Device, m_HiZPipeline, nullptr);
+            m_HiZPipeline = VK_NULL_HANDLE;
+        }
+        if (m_HiZPipelineLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyPipelineLayout(m_Device, m_HiZPipelineLayout, nullptr);
+            m_HiZPipelineLayout = VK_NULL_HANDLE;
+        }
+        if (m_HiZDescriptorSetLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorSetLayout(m_Device, m_HiZDescriptorSetLayout, nullptr);
+            m_HiZDescriptorSetLayout = VK_NULL_HANDLE;
+        }
+
+        // Limpiar pipeline de meshlets
+        if (m_MeshletPipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(m_Device, m_MeshletPipeline, nullptr);
+            m_MeshletPipeline = VK_NULL_HANDLE;
+        }
+        if (m_MeshletPipelineLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyPipelineLayout(m_Device, m_MeshletPipelineLayout, nullptr);
+            m_MeshletPipelineLayout = VK_NULL_HANDLE;
+        }
+        if (m_MeshletDescriptorSetLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorSetLayout(m_Device, m_MeshletDescriptorSetLayout, nullptr);
+            m_MeshletDescriptorSetLayout = VK_NULL_HANDLE;
+        }
+
         // Limpiar custom render passes
         CleanupCustomRenderPasses();
 
         // Sincronización
+        if (m_TimestampQueryPool != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(m_Device, m_TimestampQueryPool, nullptr);
+            m_TimestampQueryPool = VK_NULL_HANDLE;
+        }
         if (m_InFlightFence != VK_NULL_HANDLE)
         {
             vkDestroyFence(m_Device, m_InFlightFence, nullptr);
@@ -2873,6 +6029,33 @@ namespace Mantrax
         // Swapchain
         CleanupSwapchain();
 
+        // Cola diferida: liberar lo pendiente (GPU idle) e ignorar retiros posteriores
+        ClearRenderTargetPool();
+        m_PendingDispatches.clear();
+        m_PendingAsyncDispatches.clear();
+        m_OffscreenGraph.reset();
+        m_LightCullShader.reset();
+        m_LightCullSet = VK_NULL_HANDLE;
+        m_ClusterParamsBuffer.reset();
+        m_LightBuffer.reset();
+        m_ClusterCountBuffer.reset();
+        m_ClusterIndexBuffer.reset();
+        m_SkyCubemap.reset();
+        for (const auto &upload : m_PendingTextureUploads)
+        {
+            vkDestroyBuffer(m_Device, upload.stagingBuffer, nullptr);
+            FreeMemory(upload.stagingMemory);
+        }
+        m_PendingTextureUploads.clear();
+        m_StreamedTextures.clear();
+        if (m_MemoryTracker)
+            m_MemoryTracker->UnregisterEvictionHandler(m_StreamingEvictionHandler);
+        if (m_DeletionQueue)
+        {
+            CollectUploadBatches(true);
+            m_DeletionQueue->Shutdown();
+        }
+
         // Descriptor pool
         if (m_DescriptorPool != VK_NULL_HANDLE)
         {
@@ -2880,6 +6063,23 @@ namespace Mantrax
             m_DescriptorPool = VK_NULL_HANDLE;
         }
 
+        // Async compute
+        if (m_ComputeFence != VK_NULL_HANDLE)
+        {
+            vkDestroyFence(m_Device, m_ComputeFence, nullptr);
+            m_ComputeFence = VK_NULL_HANDLE;
+        }
+        if (m_ComputeFinishedSemaphore != VK_NULL_HANDLE)
+        {
+            vkDestroySemaphore(m_Device, m_ComputeFinishedSemaphore, nullptr);
+            m_ComputeFinishedSemaphore = VK_NULL_HANDLE;
+        }
+        if (m_ComputeCommandPool != VK_NULL_HANDLE)
+        {
+            vkDestroyCommandPool(m_Device, m_ComputeCommandPool, nullptr);
+            m_ComputeCommandPool = VK_NULL_HANDLE;
+        }
+
         // Command pool
         if (m_CommandPool != VK_NULL_HANDLE)
         {
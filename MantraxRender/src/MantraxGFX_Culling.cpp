@@ -0,0 +1,143 @@
+#include "../include/MantraxGFX_Culling.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Mantrax
+{
+    Frustum Frustum::FromMatrix(const glm::mat4 &viewProj)
+    {
+        // glm es column-major: la fila i es (m[0][i], m[1][i], m[2][i], m[3][i])
+        auto row = [&viewProj](int i)
+        {
+            return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+        };
+
+        Frustum f;
+        f.planes[0] = row(3) + row(0); // Left
+        f.planes[1] = row(3) - row(0); // Right
+        f.planes[2] = row(3) + row(1); // Bottom
+        f.planes[3] = row(3) - row(1); // Top
+        f.planes[4] = row(3) + row(2); // Near (z >= -w, válido también para depth 0..1)
+        f.planes[5] = row(3) - row(2); // Far
+
+        for (auto &p : f.planes)
+        {
+            float len = glm::length(glm::vec3(p));
+            if (len > 0.0f)
+                p /= len;
+        }
+
+        return f;
+    }
+
+    bool Frustum::IntersectsAABB(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax,
+                                 const glm::mat4 &model) const
+    {
+        // AABB local → AABB en mundo (centro + extents con |M|)
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        glm::vec3 extents = (boundsMax - boundsMin) * 0.5f;
+
+        glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+        glm::mat3 absModel = glm::mat3(model);
+        for (int c = 0; c < 3; ++c)
+            absModel[c] = glm::abs(absModel[c]);
+        glm::vec3 worldExtents = absModel * extents;
+
+        for (const auto &p : planes)
+        {
+            glm::vec3 n = glm::vec3(p);
+            float d = glm::dot(n, worldCenter) + p.w;
+            float r = glm::dot(glm::abs(n), worldExtents);
+
+            if (d + r < 0.0f)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool HiZReadback::IsOccluded(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax,
+                                 const glm::mat4 &model) const
+    {
+        if (!valid || levels.empty() || depthWidth == 0 || depthHeight == 0)
+            return false;
+
+        // Proyectar con la cámara del frame en el que se generó el HiZ
+        glm::mat4 mvp = viewProj * model;
+
+        glm::vec3 ndcMin(FLT_MAX);
+        glm::vec3 ndcMax(-FLT_MAX);
+
+        for (int i = 0; i < 8; ++i)
+        {
+            glm::vec3 corner(
+                (i & 1) ? boundsMax.x : boundsMin.x,
+                (i & 2) ? boundsMax.y : boundsMin.y,
+                (i & 4) ? boundsMax.z : boundsMin.z);
+
+            glm::vec4 clip = mvp * glm::vec4(corner, 1.0f);
+
+            // Detrás de la cámara: no sabemos nada, se dibuja
+            if (clip.w <= 1e-5f)
+                return false;
+
+            glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            ndcMin = glm::min(ndcMin, ndc);
+            ndcMax = glm::max(ndcMax, ndc);
+        }
+
+        // Cruza el near plane
+        if (ndcMin.z <= 0.0f)
+            return false;
+
+        // Fuera de la vista anterior: el HiZ no cubre esa zona
+        if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+            return false;
+
+        // Rectángulo en píxeles del depth original
+        uint32_t x0 = std::min(static_cast<uint32_t>((glm::clamp(ndcMin.x, -1.0f, 1.0f) * 0.5f + 0.5f) * depthWidth), depthWidth - 1);
+        uint32_t x1 = std::min(static_cast<uint32_t>((glm::clamp(ndcMax.x, -1.0f, 1.0f) * 0.5f + 0.5f) * depthWidth), depthWidth - 1);
+        uint32_t y0 = std::min(static_cast<uint32_t>((glm::clamp(ndcMin.y, -1.0f, 1.0f) * 0.5f + 0.5f) * depthHeight), depthHeight - 1);
+        uint32_t y1 = std::min(static_cast<uint32_t>((glm::clamp(ndcMax.y, -1.0f, 1.0f) * 0.5f + 0.5f) * depthHeight), depthHeight - 1);
+
+        // Bajar nivel a nivel con el mismo mapeo que hiz.comp (texel = floor(p * dst / src)),
+        // así el rango de texels siempre contiene el footprint completo
+        uint32_t srcWidth = depthWidth;
+        uint32_t srcHeight = depthHeight;
+        uint32_t level = 0;
+
+        for (;; ++level)
+        {
+            const HiZLevel &lvl = levels[level];
+            x0 = static_cast<uint32_t>(uint64_t(x0) * lvl.width / srcWidth);
+            x1 = static_cast<uint32_t>(uint64_t(x1) * lvl.width / srcWidth);
+            y0 = static_cast<uint32_t>(uint64_t(y0) * lvl.height / srcHeight);
+            y1 = static_cast<uint32_t>(uint64_t(y1) * lvl.height / srcHeight);
+            srcWidth = lvl.width;
+            srcHeight = lvl.height;
+
+            // Parar cuando el rectángulo ocupa ~2x2 texels de un nivel disponible en CPU
+            bool smallEnough = (x1 - x0) <= 1 && (y1 - y0) <= 1;
+            if (level + 1 >= levels.size() || (level >= baseLevel && smallEnough))
+                break;
+        }
+
+        if (level < baseLevel)
+            return false;
+
+        const HiZLevel &lvl = levels[level];
+
+        float farthest = 0.0f;
+        for (uint32_t ty = y0; ty <= y1; ++ty)
+        {
+            for (uint32_t tx = x0; tx <= x1; ++tx)
+            {
+                farthest = std::max(farthest, texels[lvl.offset + ty * lvl.width + tx]);
+            }
+        }
+
+        // Ocluido solo si su punto más cercano está detrás de todo lo que cubre
+        return ndcMin.z > farthest;
+    }
+}
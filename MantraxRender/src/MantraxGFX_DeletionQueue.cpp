@@ -0,0 +1,190 @@
+#include "../include/MantraxGFX_DeletionQueue.h"
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace Mantrax
+{
+    namespace
+    {
+        // Los handles no dispatchables son punteros en 64 bits y uint64_t en 32 bits
+        template <typename T>
+        uint64_t ToHandle(T handle) { return (uint64_t)(handle); }
+
+        template <typename T>
+        T FromHandle(uint64_t handle) { return (T)(handle); }
+    }
+
+    DeletionQueue::DeletionQueue(VkDevice device, VkDescriptorPool descriptorPool)
+        : m_Device(device), m_DescriptorPool(descriptorPool)
+    {
+    }
+
+    DeletionQueue::~DeletionQueue()
+    {
+        if (!m_Entries.empty())
+            std::cerr << "⚠️ DeletionQueue destruida con " << m_Entries.size() << " handles pendientes" << std::endl;
+    }
+
+    void DeletionQueue::RetireBuffer(VkBuffer buffer) { Push(VK_OBJECT_TYPE_BUFFER, ToHandle(buffer)); }
+    void DeletionQueue::RetireMemory(VkDeviceMemory memory)
+    {
+        if (m_MemoryTracker)
+            m_MemoryTracker->OnRetire(memory);
+        Push(VK_OBJECT_TYPE_DEVICE_MEMORY, ToHandle(memory));
+    }
+    void DeletionQueue::RetireImage(VkImage image) { Push(VK_OBJECT_TYPE_IMAGE, ToHandle(image)); }
+    void DeletionQueue::RetireImageView(VkImageView view) { Push(VK_OBJECT_TYPE_IMAGE_VIEW, ToHandle(view)); }
+    void DeletionQueue::RetireSampler(VkSampler sampler) { Push(VK_OBJECT_TYPE_SAMPLER, ToHandle(sampler)); }
+    void DeletionQueue::RetireFramebuffer(VkFramebuffer framebuffer) { Push(VK_OBJECT_TYPE_FRAMEBUFFER, ToHandle(framebuffer)); }
+    void DeletionQueue::RetireRenderPass(VkRenderPass renderPass) { Push(VK_OBJECT_TYPE_RENDER_PASS, ToHandle(renderPass)); }
+    void DeletionQueue::RetirePipeline(VkPipeline pipeline) { Push(VK_OBJECT_TYPE_PIPELINE, ToHandle(pipeline)); }
+    void DeletionQueue::RetirePipelineLayout(VkPipelineLayout layout) { Push(VK_OBJECT_TYPE_PIPELINE_LAYOUT, ToHandle(layout)); }
+    void DeletionQueue::RetireDescriptorSetLayout(VkDescriptorSetLayout layout) { Push(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, ToHandle(layout)); }
+    void DeletionQueue::RetireDescriptorSet(VkDescriptorSet set) { Push(VK_OBJECT_TYPE_DESCRIPTOR_SET, ToHandle(set)); }
+
+    void DeletionQueue::RetireCallback(std::function<void()> callback)
+    {
+        if (!callback)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Device == VK_NULL_HANDLE)
+            return;
+
+        m_Entries.push_back({m_SubmittedFrame, VK_OBJECT_TYPE_UNKNOWN, 0, std::move(callback)});
+    }
+
+    void DeletionQueue::Push(VkObjectType type, uint64_t handle)
+    {
+        if (handle == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        // Device ya destruido (recursos que sobreviven al GFX): no hay nada que liberar
+        if (m_Device == VK_NULL_HANDLE)
+            return;
+
+        m_Entries.push_back({m_SubmittedFrame, type, handle, nullptr});
+    }
+
+    void DeletionQueue::OnFrameSubmitted()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_SubmittedFrame++;
+    }
+
+    uint64_t DeletionQueue::GetSubmittedFrame() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_SubmittedFrame;
+    }
+
+    uint64_t DeletionQueue::GetCompletedFrame() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_CompletedFrame;
+    }
+
+    void DeletionQueue::Collect(uint64_t completedFrame)
+    {
+        std::vector<Entry> expired;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_CompletedFrame = std::max(m_CompletedFrame, completedFrame);
+
+            while (!m_Entries.empty() && m_Entries.front().frame <= completedFrame)
+            {
+                expired.push_back(std::move(m_Entries.front()));
+                m_Entries.pop_front();
+            }
+        }
+
+        // Fuera del lock: un callback puede soltar recursos que vuelvan a retirar handles
+        for (const auto &entry : expired)
+            Destroy(entry);
+    }
+
+    void DeletionQueue::Flush()
+    {
+        std::vector<Entry> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            pending.assign(std::make_move_iterator(m_Entries.begin()),
+                           std::make_move_iterator(m_Entries.end()));
+            m_Entries.clear();
+            m_CompletedFrame = m_SubmittedFrame;
+        }
+
+        for (const auto &entry : pending)
+            Destroy(entry);
+    }
+
+    void DeletionQueue::Shutdown()
+    {
+        Flush();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Device = VK_NULL_HANDLE;
+        m_DescriptorPool = VK_NULL_HANDLE;
+    }
+
+    size_t DeletionQueue::GetPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Entries.size();
+    }
+
+    void DeletionQueue::Destroy(const Entry &entry)
+    {
+        switch (entry.type)
+        {
+        case VK_OBJECT_TYPE_UNKNOWN:
+            entry.callback();
+            break;
+        case VK_OBJECT_TYPE_BUFFER:
+            vkDestroyBuffer(m_Device, FromHandle<VkBuffer>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_DEVICE_MEMORY:
+            if (m_MemoryTracker)
+                m_MemoryTracker->OnFree(FromHandle<VkDeviceMemory>(entry.handle));
+            vkFreeMemory(m_Device, FromHandle<VkDeviceMemory>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_IMAGE:
+            vkDestroyImage(m_Device, FromHandle<VkImage>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_IMAGE_VIEW:
+            vkDestroyImageView(m_Device, FromHandle<VkImageView>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_SAMPLER:
+            vkDestroySampler(m_Device, FromHandle<VkSampler>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_FRAMEBUFFER:
+            vkDestroyFramebuffer(m_Device, FromHandle<VkFramebuffer>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_RENDER_PASS:
+            vkDestroyRenderPass(m_Device, FromHandle<VkRenderPass>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE:
+            vkDestroyPipeline(m_Device, FromHandle<VkPipeline>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+            vkDestroyPipelineLayout(m_Device, FromHandle<VkPipelineLayout>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT:
+            vkDestroyDescriptorSetLayout(m_Device, FromHandle<VkDescriptorSetLayout>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET:
+        {
+            VkDescriptorSet set = FromHandle<VkDescriptorSet>(entry.handle);
+            vkFreeDescriptorSets(m_Device, m_DescriptorPool, 1, &set);
+            break;
+        }
+        default:
+            std::cerr << "⚠️ DeletionQueue: tipo de objeto no soportado " << entry.type << std::endl;
+            break;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#include "../include/MantraxGFX_DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Mantrax
+{
+    float DynamicResolution::Update(float gpuTimeMs)
+    {
+        const auto &s = m_Settings;
+
+        if (!s.enabled)
+        {
+            m_Scale = s.maxScale;
+            m_FramesSinceAdjust = 0;
+            return m_Scale;
+        }
+
+        m_Scale = std::clamp(m_Scale, s.minScale, s.maxScale);
+
+        // Sin timestamps no hay nada que controlar
+        if (gpuTimeMs <= 0.0f)
+            return m_Scale;
+
+        m_AverageMs = (m_AverageMs <= 0.0f)
+                          ? gpuTimeMs
+                          : m_AverageMs + (gpuTimeMs - m_AverageMs) * s.smoothing;
+
+        if (++m_FramesSinceAdjust < s.adjustInterval)
+            return m_Scale;
+
+        m_FramesSinceAdjust = 0;
+
+        // El coste es ~proporcional a los píxeles (escala²)
+        float ideal = m_Scale * std::sqrt(s.targetGPUTimeMs / std::max(m_AverageMs, 0.01f));
+        float step = std::max(s.scaleStep, 0.01f);
+
+        if (m_AverageMs > s.targetGPUTimeMs)
+        {
+            // Bajar de golpe hasta el escalón que cumple el objetivo
+            float next = std::floor(ideal / step) * step;
+            m_Scale = std::max(s.minScale, std::min(next, m_Scale - step));
+        }
+        else if (m_AverageMs < s.targetGPUTimeMs * s.headroom)
+        {
+            // Subir de un escalón en uno para no pasarse
+            if (ideal >= m_Scale + step)
+                m_Scale = std::min(s.maxScale, m_Scale + step);
+        }
+
+        return m_Scale;
+    }
+
+    VkExtent2D DynamicResolution::Apply(uint32_t width, uint32_t height) const
+    {
+        VkExtent2D extent;
+        extent.width = std::max(1u, static_cast<uint32_t>(std::lround(width * m_Scale)));
+        extent.height = std::max(1u, static_cast<uint32_t>(std::lround(height * m_Scale)));
+        return extent;
+    }
+}
@@ -0,0 +1,294 @@
+#include "../include/MantraxGFX_Memory.h"
+#include <algorithm>
+#include <iostream>
+
+namespace Mantrax
+{
+    const char *GetMemoryCategoryName(MemoryCategory category)
+    {
+        switch (category)
+        {
+        case MemoryCategory::Mesh: return "Meshes";
+        case MemoryCategory::Texture: return "Textures";
+        case MemoryCategory::RenderTarget: return "Render targets";
+        case MemoryCategory::Staging: return "Staging";
+        case MemoryCategory::Buffer: return "Buffers";
+        default: return "?";
+        }
+    }
+
+    MemoryCategory ClassifyBufferMemory(VkBufferUsageFlags usage)
+    {
+        if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                     VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT))
+            return MemoryCategory::Mesh;
+
+        if (usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+            return MemoryCategory::Staging;
+
+        return MemoryCategory::Buffer;
+    }
+
+    MemoryCategory ClassifyImageMemory(VkImageUsageFlags usage)
+    {
+        if (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                     VK_IMAGE_USAGE_STORAGE_BIT))
+            return MemoryCategory::RenderTarget;
+
+        return MemoryCategory::Texture;
+    }
+
+    MemoryTracker::MemoryTracker(VkPhysicalDevice physicalDevice, bool hasBudgetExtension)
+        : m_PhysicalDevice(physicalDevice), m_HasBudgetExtension(hasBudgetExtension)
+    {
+        vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
+
+        m_HeapTracked.assign(m_MemoryProperties.memoryHeapCount, 0);
+        m_HeapRetired.assign(m_MemoryProperties.memoryHeapCount, 0);
+        m_HeapBudget.assign(m_MemoryProperties.memoryHeapCount, 0);
+        m_HeapUsage.assign(m_MemoryProperties.memoryHeapCount, 0);
+        for (uint32_t i = 0; i < m_MemoryProperties.memoryHeapCount; ++i)
+            m_HeapBudget[i] = m_MemoryProperties.memoryHeaps[i].size;
+
+        Refresh();
+    }
+
+    void MemoryTracker::OnAllocate(VkDeviceMemory memory, uint64_t size, uint32_t memoryTypeIndex,
+                                   MemoryCategory category, bool hostFallback)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Allocations[memory] = {size, memoryTypeIndex, category, hostFallback, false};
+        m_HeapTracked[m_MemoryProperties.memoryTypes[memoryTypeIndex].heapIndex] += size;
+
+        size_t c = static_cast<size_t>(category);
+        m_Counters.categoryBytes[c] += size;
+        m_Counters.categoryAllocations[c]++;
+
+        if (hostFallback)
+        {
+            m_Counters.hostFallbackBytes += size;
+            m_Counters.hostFallbacks++;
+        }
+    }
+
+    void MemoryTracker::OnRetire(VkDeviceMemory memory)
+    {
+        if (memory == VK_NULL_HANDLE)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_Allocations.find(memory);
+        if (it == m_Allocations.end() || it->second.retired)
+            return;
+
+        it->second.retired = true;
+        m_HeapRetired[m_MemoryProperties.memoryTypes[it->second.memoryTypeIndex].heapIndex] += it->second.size;
+        m_Counters.retiredBytes += it->second.size;
+    }
+
+    void MemoryTracker::OnFree(VkDeviceMemory memory)
+    {
+        if (memory == VK_NULL_HANDLE)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_Allocations.find(memory);
+        if (it == m_Allocations.end())
+            return;
+
+        const Allocation &alloc = it->second;
+        uint32_t heap = m_MemoryProperties.memoryTypes[alloc.memoryTypeIndex].heapIndex;
+        m_HeapTracked[heap] -= alloc.size;
+
+        if (alloc.retired)
+        {
+            m_HeapRetired[heap] -= alloc.size;
+            m_Counters.retiredBytes -= alloc.size;
+        }
+
+        size_t c = static_cast<size_t>(alloc.category);
+        m_Counters.categoryBytes[c] -= alloc.size;
+        m_Counters.categoryAllocations[c]--;
+
+        if (alloc.hostFallback)
+            m_Counters.hostFallbackBytes -= alloc.size;
+
+        m_Allocations.erase(it);
+    }
+
+    void MemoryTracker::OnFailedAllocation()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Counters.failedAllocations++;
+    }
+
+    void MemoryTracker::Refresh()
+    {
+        if (!m_HasBudgetExtension)
+            return;
+
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+        budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+        VkPhysicalDeviceMemoryProperties2 props2{};
+        props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        props2.pNext = &budget;
+        vkGetPhysicalDeviceMemoryProperties2(m_PhysicalDevice, &props2);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (uint32_t i = 0; i < m_MemoryProperties.memoryHeapCount; ++i)
+        {
+            m_HeapBudget[i] = budget.heapBudget[i];
+            m_HeapUsage[i] = budget.heapUsage[i];
+        }
+    }
+
+    bool MemoryTracker::IsDeviceLocalType(uint32_t memoryTypeIndex) const
+    {
+        uint32_t heap = m_MemoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+        return (m_MemoryProperties.memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    }
+
+    uint64_t MemoryTracker::GetDeviceLocalUsageLocked() const
+    {
+        uint64_t usage = 0;
+        for (uint32_t i = 0; i < m_MemoryProperties.memoryHeapCount; ++i)
+        {
+            if (!(m_MemoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+                continue;
+
+            // El driver se actualiza con retraso (lo registrado desde el último Refresh también
+            // cuenta) y aún incluye lo retirado, que ya está de salida
+            uint64_t live = m_HeapTracked[i] - m_HeapRetired[i];
+            uint64_t driver = m_HeapUsage[i] > m_HeapRetired[i] ? m_HeapUsage[i] - m_HeapRetired[i] : 0;
+            usage += m_HasBudgetExtension ? std::max(driver, live) : live;
+        }
+        return usage;
+    }
+
+    uint64_t MemoryTracker::GetDeviceLocalBudgetLocked() const
+    {
+        uint64_t available = 0;
+        for (uint32_t i = 0; i < m_MemoryProperties.memoryHeapCount; ++i)
+        {
+            if (m_MemoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                available += m_HeapBudget[i];
+        }
+
+        uint64_t budget = static_cast<uint64_t>(static_cast<double>(available) * m_Settings.budgetFraction);
+        return m_Settings.budgetBytes > 0 ? std::min(m_Settings.budgetBytes, budget) : budget;
+    }
+
+    uint64_t MemoryTracker::GetOverBudget(uint64_t extraBytes) const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        uint64_t usage = GetDeviceLocalUsageLocked() + extraBytes;
+        uint64_t budget = GetDeviceLocalBudgetLocked();
+        return usage > budget ? usage - budget : 0;
+    }
+
+    uint32_t MemoryTracker::RegisterEvictionHandler(const MemoryEvictionHandler &handler)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        uint32_t id = m_NextHandlerId++;
+        m_Handlers[id] = handler;
+        return id;
+    }
+
+    void MemoryTracker::UnregisterEvictionHandler(uint32_t id)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Handlers.erase(id);
+    }
+
+    uint64_t MemoryTracker::Evict(uint64_t bytes)
+    {
+        // Los handlers pueden allocar (ej. la cola de mips de una textura): se llaman sin el lock
+        std::vector<MemoryEvictionHandler> handlers;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (const auto &[id, handler] : m_Handlers)
+                handlers.push_back(handler);
+        }
+
+        uint64_t freed = 0;
+        uint32_t evictions = 0;
+
+        while (freed < bytes)
+        {
+            MemoryEvictionHandler *oldest = nullptr;
+            uint64_t oldestUse = UINT64_MAX;
+
+            for (auto &handler : handlers)
+            {
+                uint64_t use = handler.oldestUse();
+                if (use < oldestUse)
+                {
+                    oldestUse = use;
+                    oldest = &handler;
+                }
+            }
+
+            if (!oldest)
+                break;
+
+            uint64_t released = oldest->evictOldest();
+            if (released == 0)
+                break;
+
+            freed += released;
+            evictions++;
+        }
+
+        if (evictions > 0)
+        {
+            std::cout << "⚠️ VRAM por encima del presupuesto: desalojadas " << evictions << " entradas de caché ("
+                      << freed / (1024 * 1024) << " MB)" << std::endl;
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Counters.evictions += evictions;
+            m_Counters.evictedBytes += freed;
+        }
+
+        return freed;
+    }
+
+    void MemoryTracker::SetSettings(const MemoryBudgetSettings &settings)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Settings = settings;
+        m_Settings.budgetFraction = std::clamp(m_Settings.budgetFraction, 0.1f, 1.0f);
+    }
+
+    MemoryBudgetSettings MemoryTracker::GetSettings() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Settings;
+    }
+
+    MemoryStats MemoryTracker::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        MemoryStats stats = m_Counters;
+        stats.hasBudgetExtension = m_HasBudgetExtension;
+        stats.deviceLocalUsage = GetDeviceLocalUsageLocked();
+        stats.deviceLocalBudget = GetDeviceLocalBudgetLocked();
+
+        stats.heaps.resize(m_MemoryProperties.memoryHeapCount);
+        for (uint32_t i = 0; i < m_MemoryProperties.memoryHeapCount; ++i)
+        {
+            MemoryHeapInfo &heap = stats.heaps[i];
+            heap.size = m_MemoryProperties.memoryHeaps[i].size;
+            heap.budget = m_HeapBudget[i];
+            heap.usage = m_HasBudgetExtension ? m_HeapUsage[i] : m_HeapTracked[i];
+            heap.deviceLocal = (m_MemoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        }
+
+        return stats;
+    }
+}
@@ -0,0 +1,730 @@
+#include "../include/MantraxGFX_RenderGraph.h"
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <sstream>
+
+namespace Mantrax
+{
+    namespace
+    {
+        constexpr VkAccessFlags kWriteAccessMask =
+            VK_ACCESS_SHADER_WRITE_BIT |
+            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+            VK_ACCESS_TRANSFER_WRITE_BIT |
+            VK_ACCESS_HOST_WRITE_BIT |
+            VK_ACCESS_MEMORY_WRITE_BIT;
+
+        struct AccessInfo
+        {
+            VkImageLayout layout;
+            VkPipelineStageFlags stage;
+            VkAccessFlags access;
+        };
+
+        AccessInfo GetAccessInfo(RGAccess access, RGPassType type, VkImageAspectFlags aspect)
+        {
+            const bool depth = (aspect & VK_IMAGE_ASPECT_DEPTH_BIT) != 0;
+            const VkPipelineStageFlags shaderStage =
+                type == RGPassType::Compute ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                            : VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            const VkPipelineStageFlags depthStages =
+                VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+            switch (access)
+            {
+            case RGAccess::ColorAttachmentWrite:
+                return {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT};
+            case RGAccess::DepthAttachmentWrite:
+                return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, depthStages,
+                        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT};
+            case RGAccess::DepthAttachmentRead:
+                return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, depthStages,
+                        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT};
+            case RGAccess::SampledRead:
+                return {depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        type == RGPassType::Compute ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                        VK_ACCESS_SHADER_READ_BIT};
+            case RGAccess::StorageRead:
+                return {VK_IMAGE_LAYOUT_GENERAL, shaderStage, VK_ACCESS_SHADER_READ_BIT};
+            case RGAccess::StorageWrite:
+                return {VK_IMAGE_LAYOUT_GENERAL, shaderStage, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT};
+            case RGAccess::TransferRead:
+                return {VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT};
+            case RGAccess::TransferWrite:
+                return {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT};
+            case RGAccess::IndirectRead:
+                return {VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT};
+            }
+
+            return {VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT};
+        }
+
+        // Acumula los barriers de un pase para emitirlos en un único vkCmdPipelineBarrier
+        struct BarrierBatch
+        {
+            std::vector<VkImageMemoryBarrier> images;
+            std::vector<VkBufferMemoryBarrier> buffers;
+            VkMemoryBarrier global{};
+            bool hasGlobal = false;
+            VkPipelineStageFlags srcStages = 0;
+            VkPipelineStageFlags dstStages = 0;
+
+            bool Empty() const { return images.empty() && buffers.empty() && !hasGlobal; }
+        };
+    }
+
+    // ============================================
+    // PASS BUILDER
+    // ============================================
+
+    void RenderGraph::PassBuilder::Read(RGResource resource, RGAccess access)
+    {
+        if (resource >= m_Graph->m_Resources.size())
+            throw std::runtime_error("RenderGraph: recurso inválido leído en el pase " + m_Graph->m_Passes[m_Pass].name);
+
+        m_Graph->m_Passes[m_Pass].accesses.push_back({resource, access, false, VK_IMAGE_LAYOUT_UNDEFINED});
+    }
+
+    void RenderGraph::PassBuilder::Write(RGResource resource, RGAccess access, VkImageLayout layoutAfter)
+    {
+        if (resource >= m_Graph->m_Resources.size())
+            throw std::runtime_error("RenderGraph: recurso inválido escrito en el pase " + m_Graph->m_Passes[m_Pass].name);
+
+        m_Graph->m_Passes[m_Pass].accesses.push_back({resource, access, true, layoutAfter});
+    }
+
+    void RenderGraph::PassBuilder::SetSideEffects()
+    {
+        m_Graph->m_Passes[m_Pass].sideEffects = true;
+    }
+
+    // ============================================
+    // GRAPH DESCRIPTION
+    // ============================================
+
+    RenderGraph::RenderGraph(VkDevice device, VkPhysicalDevice physicalDevice,
+                             std::shared_ptr<DeletionQueue> deletionQueue)
+        : m_Device(device), m_PhysicalDevice(physicalDevice), m_DeletionQueue(std::move(deletionQueue))
+    {
+    }
+
+    RenderGraph::~RenderGraph()
+    {
+        ReleaseTransients();
+    }
+
+    void RenderGraph::Reset()
+    {
+        m_Passes.clear();
+        m_Resources.clear();
+        m_Compiled = false;
+    }
+
+    RGResource RenderGraph::ImportImage(const std::string &name, VkImage image, VkImageAspectFlags aspect,
+                                        uint32_t mipLevels, const RGState &initial,
+                                        VkImageLayout finalLayout, VkPipelineStageFlags finalStage,
+                                        VkAccessFlags finalAccess)
+    {
+        Resource res;
+        res.name = name;
+        res.isImage = true;
+        res.imported = true;
+        res.image = image;
+        res.aspect = aspect;
+        res.mipLevels = mipLevels;
+        res.state = initial;
+        res.finalLayout = finalLayout;
+        res.finalStage = finalStage;
+        res.finalAccess = finalAccess;
+
+        m_Resources.push_back(std::move(res));
+        return static_cast<RGResource>(m_Resources.size() - 1);
+    }
+
+    RGResource RenderGraph::ImportBuffer(const std::string &name, VkBuffer buffer, const RGState &initial)
+    {
+        Resource res;
+        res.name = name;
+        res.isImage = false;
+        res.imported = true;
+        res.buffer = buffer;
+        res.state = initial;
+        res.state.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        m_Resources.push_back(std::move(res));
+        return static_cast<RGResource>(m_Resources.size() - 1);
+    }
+
+    RGResource RenderGraph::CreateImage(const std::string &name, const RGImageDesc &desc)
+    {
+        if (desc.extent.width == 0 || desc.extent.height == 0 || desc.usage == 0)
+            throw std::runtime_error("RenderGraph: imagen transitoria inválida " + name);
+
+        Resource res;
+        res.name = name;
+        res.isImage = true;
+        res.imported = false;
+        res.aspect = desc.aspect;
+        res.mipLevels = std::max(1u, desc.mipLevels);
+        res.desc = desc;
+        res.desc.mipLevels = res.mipLevels;
+
+        m_Resources.push_back(std::move(res));
+        return static_cast<RGResource>(m_Resources.size() - 1);
+    }
+
+    void RenderGraph::MarkOutput(RGResource resource)
+    {
+        if (resource < m_Resources.size())
+            m_Resources[resource].output = true;
+    }
+
+    void RenderGraph::AddPass(const std::string &name, RGPassType type, const SetupFn &setup, ExecuteFn execute)
+    {
+        Pass pass;
+        pass.name = name;
+        pass.type = type;
+        pass.execute = std::move(execute);
+        m_Passes.push_back(std::move(pass));
+
+        PassBuilder builder(this, static_cast<uint32_t>(m_Passes.size() - 1));
+        if (setup)
+            setup(builder);
+
+        m_Compiled = false;
+    }
+
+    VkImage RenderGraph::GetImage(RGResource resource) const
+    {
+        return resource < m_Resources.size() ? m_Resources[resource].image : VK_NULL_HANDLE;
+    }
+
+    VkImageView RenderGraph::GetImageView(RGResource resource) const
+    {
+        return resource < m_Resources.size() ? m_Resources[resource].view : VK_NULL_HANDLE;
+    }
+
+    // ============================================
+    // COMPILE
+    // ============================================
+
+    void RenderGraph::Compile()
+    {
+        m_Stats = RenderGraphStats{};
+        m_Stats.passes = static_cast<uint32_t>(m_Passes.size());
+
+        CullPasses();
+        ComputeLifetimes();
+        RealizeTransients();
+
+        m_Compiled = true;
+    }
+
+    void RenderGraph::CullPasses()
+    {
+        for (auto &res : m_Resources)
+        {
+            res.readers = 0;
+            res.producers.clear();
+        }
+
+        for (uint32_t p = 0; p < m_Passes.size(); ++p)
+        {
+            Pass &pass = m_Passes[p];
+            pass.culled = false;
+            pass.refCount = 0;
+
+            for (const auto &a : pass.accesses)
+            {
+                if (a.write)
+                {
+                    pass.refCount++;
+                    m_Resources[a.resource].producers.push_back(p);
+                }
+                else
+                {
+                    m_Resources[a.resource].readers++;
+                }
+            }
+        }
+
+        // Recorrido inverso desde los recursos que nadie lee: sus productores
+        // pierden una referencia y, si llegan a cero, dejan de leer sus entradas
+        std::vector<RGResource> unreferenced;
+        for (RGResource r = 0; r < m_Resources.size(); ++r)
+        {
+            if (m_Resources[r].readers == 0 && !m_Resources[r].output)
+                unreferenced.push_back(r);
+        }
+
+        auto cullPass = [this, &unreferenced](Pass &pass)
+        {
+            pass.culled = true;
+            m_Stats.culledPasses++;
+
+            for (const auto &a : pass.accesses)
+            {
+                if (a.write)
+                    continue;
+
+                Resource &input = m_Resources[a.resource];
+                if (--input.readers == 0 && !input.output)
+                    unreferenced.push_back(a.resource);
+            }
+        };
+
+        for (auto &pass : m_Passes)
+        {
+            if (pass.refCount == 0 && !pass.sideEffects)
+                cullPass(pass);
+        }
+
+        while (!unreferenced.empty())
+        {
+            RGResource r = unreferenced.back();
+            unreferenced.pop_back();
+
+            for (uint32_t p : m_Resources[r].producers)
+            {
+                Pass &producer = m_Passes[p];
+                if (producer.culled || producer.refCount == 0)
+                    continue;
+
+                if (--producer.refCount == 0 && !producer.sideEffects)
+                    cullPass(producer);
+            }
+        }
+    }
+
+    void RenderGraph::ComputeLifetimes()
+    {
+        for (auto &res : m_Resources)
+        {
+            res.firstPass = 0xffffffffu;
+            res.lastPass = 0;
+            res.aliasPredecessor = RG_INVALID_RESOURCE;
+        }
+
+        for (uint32_t p = 0; p < m_Passes.size(); ++p)
+        {
+            if (m_Passes[p].culled)
+                continue;
+
+            for (const auto &a : m_Passes[p].accesses)
+            {
+                Resource &res = m_Resources[a.resource];
+                res.firstPass = std::min(res.firstPass, p);
+                res.lastPass = std::max(res.lastPass, p);
+            }
+        }
+    }
+
+    std::string RenderGraph::BuildLayoutSignature() const
+    {
+        std::ostringstream ss;
+        for (const auto &res : m_Resources)
+        {
+            if (res.imported || res.firstPass == 0xffffffffu)
+                continue;
+
+            ss << res.desc.extent.width << 'x' << res.desc.extent.height << ':' << res.desc.format << ':'
+               << res.desc.usage << ':' << res.desc.aspect << ':' << res.desc.mipLevels << '@'
+               << res.firstPass << '-' << res.lastPass << ';';
+        }
+        return ss.str();
+    }
+
+    void RenderGraph::RealizeTransients()
+    {
+        std::vector<RGResource> live;
+        for (RGResource r = 0; r < m_Resources.size(); ++r)
+        {
+            if (!m_Resources[r].imported && m_Resources[r].firstPass != 0xffffffffu)
+                live.push_back(r);
+        }
+
+        // Misma distribución que el frame anterior: se reutilizan imágenes y memoria
+        std::string signature = BuildLayoutSignature();
+        if (signature != m_TransientSignature || m_Transients.size() != live.size())
+        {
+            ReleaseTransients();
+
+            std::vector<VkMemoryRequirements> requirements(live.size());
+            m_Transients.resize(live.size());
+
+            for (size_t i = 0; i < live.size(); ++i)
+            {
+                const RGImageDesc &desc = m_Resources[live[i]].desc;
+
+                VkImageCreateInfo imageInfo{};
+                imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+                imageInfo.imageType = VK_IMAGE_TYPE_2D;
+                imageInfo.extent = {desc.extent.width, desc.extent.height, 1};
+                imageInfo.mipLevels = desc.mipLevels;
+                imageInfo.arrayLayers = 1;
+                imageInfo.format = desc.format;
+                imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+                imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                imageInfo.usage = desc.usage;
+                imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+                imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+                if (vkCreateImage(m_Device, &imageInfo, nullptr, &m_Transients[i].image) != VK_SUCCESS)
+                    throw std::runtime_error("RenderGraph: error creando la imagen transitoria " + m_Resources[live[i]].name);
+
+                vkGetImageMemoryRequirements(m_Device, m_Transients[i].image, &requirements[i]);
+                m_Stats.transientBytes += requirements[i].size;
+            }
+
+            // Aliasing greedy: de mayor a menor, cada imagen entra en el primer bloque
+            // compatible cuyos ocupantes no se solapen con su vida [firstPass, lastPass]
+            std::vector<size_t> order(live.size());
+            for (size_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [&requirements](size_t l, size_t r)
+                             { return requirements[l].size > requirements[r].size; });
+
+            std::vector<std::vector<size_t>> occupants;
+
+            for (size_t i : order)
+            {
+                const Resource &res = m_Resources[live[i]];
+                const VkMemoryRequirements &req = requirements[i];
+                uint32_t chosen = 0xffffffffu;
+
+                for (uint32_t b = 0; b < m_Blocks.size() && chosen == 0xffffffffu; ++b)
+                {
+                    if (!(req.memoryTypeBits & (1u << m_Blocks[b].memoryTypeIndex)) || m_Blocks[b].size < req.size)
+                        continue;
+
+                    bool overlaps = false;
+                    for (size_t other : occupants[b])
+                    {
+                        const Resource &o = m_Resources[live[other]];
+                        if (res.firstPass <= o.lastPass && o.firstPass <= res.lastPass)
+                        {
+                            overlaps = true;
+                            break;
+                        }
+                    }
+
+                    if (!overlaps)
+                        chosen = b;
+                }
+
+                if (chosen == 0xffffffffu)
+                {
+                    MemoryBlock block;
+                    block.size = req.size;
+                    block.memoryTypeIndex = FindMemoryType(req.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+                    VkMemoryAllocateInfo allocInfo{};
+                    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+                    allocInfo.allocationSize = block.size;
+                    allocInfo.memoryTypeIndex = block.memoryTypeIndex;
+
+                    if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &block.memory) != VK_SUCCESS)
+                        throw std::runtime_error("RenderGraph: error reservando memoria transitoria");
+
+                    if (auto tracker = m_DeletionQueue->GetMemoryTracker())
+                        tracker->OnAllocate(block.memory, block.size, block.memoryTypeIndex, MemoryCategory::RenderTarget);
+
+                    m_Blocks.push_back(block);
+                    occupants.emplace_back();
+                    chosen = static_cast<uint32_t>(m_Blocks.size() - 1);
+                }
+
+                occupants[chosen].push_back(i);
+                m_Transients[i].block = chosen;
+                vkBindImageMemory(m_Device, m_Transients[i].image, m_Blocks[chosen].memory, 0);
+            }
+
+            for (size_t i = 0; i < live.size(); ++i)
+            {
+                const Resource &res = m_Resources[live[i]];
+
+                VkImageViewCreateInfo viewInfo{};
+                viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+                viewInfo.image = m_Transients[i].image;
+                viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+                viewInfo.format = res.desc.format;
+                viewInfo.subresourceRange.aspectMask = res.desc.aspect;
+                viewInfo.subresourceRange.levelCount = res.desc.mipLevels;
+                viewInfo.subresourceRange.layerCount = 1;
+
+                if (vkCreateImageView(m_Device, &viewInfo, nullptr, &m_Transients[i].view) != VK_SUCCESS)
+                    throw std::runtime_error("RenderGraph: error creando la vista transitoria " + res.name);
+
+                // Ocupante anterior del mismo bloque: su último uso debe terminar
+                // antes de que esta imagen escriba en la memoria compartida
+                m_Transients[i].predecessor = 0xffffffffu;
+                uint32_t bestLast = 0;
+                for (size_t other : occupants[m_Transients[i].block])
+                {
+                    const Resource &o = m_Resources[live[other]];
+                    if (o.lastPass < res.firstPass &&
+                        (m_Transients[i].predecessor == 0xffffffffu || o.lastPass >= bestLast))
+                    {
+                        m_Transients[i].predecessor = static_cast<uint32_t>(other);
+                        bestLast = o.lastPass;
+                    }
+                }
+            }
+
+            m_TransientSignature = signature;
+
+            VkDeviceSize allocated = 0;
+            for (const auto &block : m_Blocks)
+                allocated += block.size;
+
+            std::cout << "🧩 RenderGraph: " << live.size() << " imágenes transitorias en "
+                      << m_Blocks.size() << " bloques (" << allocated / 1024 << " KB, "
+                      << m_Stats.transientBytes / 1024 << " KB sin aliasing)" << std::endl;
+        }
+        else
+        {
+            for (size_t i = 0; i < live.size(); ++i)
+            {
+                VkMemoryRequirements req;
+                vkGetImageMemoryRequirements(m_Device, m_Transients[i].image, &req);
+                m_Stats.transientBytes += req.size;
+            }
+        }
+
+        for (size_t i = 0; i < live.size(); ++i)
+        {
+            Resource &res = m_Resources[live[i]];
+            res.image = m_Transients[i].image;
+            res.view = m_Transients[i].view;
+            res.state = RGState{};
+
+            uint32_t pred = m_Transients[i].predecessor;
+            res.aliasPredecessor = pred == 0xffffffffu ? RG_INVALID_RESOURCE : live[pred];
+        }
+
+        m_Stats.transientImages = static_cast<uint32_t>(live.size());
+        for (const auto &block : m_Blocks)
+            m_Stats.allocatedBytes += block.size;
+    }
+
+    void RenderGraph::ReleaseTransients()
+    {
+        for (auto &t : m_Transients)
+        {
+            m_DeletionQueue->RetireImageView(t.view);
+            m_DeletionQueue->RetireImage(t.image);
+        }
+
+        for (auto &block : m_Blocks)
+            m_DeletionQueue->RetireMemory(block.memory);
+
+        m_Transients.clear();
+        m_Blocks.clear();
+        m_TransientSignature.clear();
+    }
+
+    uint32_t RenderGraph::FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags props) const
+    {
+        VkPhysicalDeviceMemoryProperties memProps;
+        vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &memProps);
+
+        for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i)
+        {
+            if ((typeBits & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & props) == props)
+                return i;
+        }
+
+        throw std::runtime_error("RenderGraph: no se encontró tipo de memoria adecuado");
+    }
+
+    // ============================================
+    // EXECUTE
+    // ============================================
+
+    void RenderGraph::Execute(VkCommandBuffer cmd)
+    {
+        if (!m_Compiled)
+            Compile();
+
+        // Sincronización por recurso: última escritura y lectores ya sincronizados con ella
+        struct Sync
+        {
+            VkImageLayout layout;
+            VkPipelineStageFlags writeStage;
+            VkAccessFlags writeAccess;
+            VkPipelineStageFlags readStages;
+            VkAccessFlags readAccess;
+        };
+
+        std::vector<Sync> sync(m_Resources.size());
+        for (size_t r = 0; r < m_Resources.size(); ++r)
+        {
+            const RGState &s = m_Resources[r].state;
+            if (s.access & kWriteAccessMask)
+                sync[r] = {s.layout, s.stage, s.access, 0, 0};
+            else
+                sync[r] = {s.layout, 0, 0, s.stage, s.access};
+        }
+
+        auto addBarrier = [this, &sync](BarrierBatch &batch, RGResource r, const AccessInfo &info, bool write)
+        {
+            const Resource &res = m_Resources[r];
+            Sync &s = sync[r];
+
+            const bool layoutChange = res.isImage && s.layout != info.layout;
+
+            if (!write && !layoutChange)
+            {
+                // Lectura tras lectura o lectura ya visible para este stage: sin barrier
+                if (s.writeStage == 0 ||
+                    ((info.stage & ~s.readStages) == 0 && (info.access & ~s.readAccess) == 0))
+                {
+                    s.readStages |= info.stage;
+                    s.readAccess |= info.access;
+                    return;
+                }
+            }
+
+            VkPipelineStageFlags srcStage = s.writeStage;
+            VkAccessFlags srcAccess = s.writeAccess & kWriteAccessMask;
+
+            // Escrituras y transiciones esperan también a los lectores previos (WAR)
+            if (write || layoutChange)
+                srcStage |= s.readStages;
+
+            if (srcStage == 0)
+                srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+
+            batch.srcStages |= srcStage;
+            batch.dstStages |= info.stage;
+
+            if (res.isImage)
+            {
+                VkImageMemoryBarrier barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                barrier.oldLayout = s.layout;
+                barrier.newLayout = info.layout;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = res.image;
+                barrier.subresourceRange.aspectMask = res.aspect;
+                barrier.subresourceRange.levelCount = res.mipLevels;
+                barrier.subresourceRange.layerCount = 1;
+                barrier.srcAccessMask = srcAccess;
+                barrier.dstAccessMask = info.access;
+                batch.images.push_back(barrier);
+            }
+            else if (res.buffer != VK_NULL_HANDLE)
+            {
+                VkBufferMemoryBarrier barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.buffer = res.buffer;
+                barrier.offset = 0;
+                barrier.size = VK_WHOLE_SIZE;
+                barrier.srcAccessMask = srcAccess;
+                barrier.dstAccessMask = info.access;
+                batch.buffers.push_back(barrier);
+            }
+            else
+            {
+                batch.global.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                batch.global.srcAccessMask |= srcAccess;
+                batch.global.dstAccessMask |= info.access;
+                batch.hasGlobal = true;
+            }
+
+            if (res.isImage)
+                s.layout = info.layout;
+
+            if (write)
+            {
+                s.writeStage = info.stage;
+                s.writeAccess = info.access;
+                s.readStages = 0;
+                s.readAccess = 0;
+            }
+            else if (layoutChange)
+            {
+                // La transición cuenta como escritura ordenada antes de este stage
+                s.writeStage = info.stage;
+                s.writeAccess = 0;
+                s.readStages = info.stage;
+                s.readAccess = info.access;
+            }
+            else
+            {
+                s.readStages |= info.stage;
+                s.readAccess |= info.access;
+            }
+        };
+
+        auto flush = [this, cmd](BarrierBatch &batch)
+        {
+            if (batch.Empty())
+                return;
+
+            vkCmdPipelineBarrier(cmd, batch.srcStages, batch.dstStages, 0,
+                                 batch.hasGlobal ? 1 : 0, batch.hasGlobal ? &batch.global : nullptr,
+                                 static_cast<uint32_t>(batch.buffers.size()), batch.buffers.data(),
+                                 static_cast<uint32_t>(batch.images.size()), batch.images.data());
+
+            m_Stats.barrierBatches++;
+            m_Stats.imageBarriers += static_cast<uint32_t>(batch.images.size());
+        };
+
+        for (uint32_t p = 0; p < m_Passes.size(); ++p)
+        {
+            Pass &pass = m_Passes[p];
+            if (pass.culled)
+                continue;
+
+            BarrierBatch batch;
+
+            for (const auto &a : pass.accesses)
+            {
+                Resource &res = m_Resources[a.resource];
+
+                // Primer uso de una transitoria aliasada: hereda la dependencia del ocupante anterior
+                if (!res.imported && res.firstPass == p && res.aliasPredecessor != RG_INVALID_RESOURCE)
+                {
+                    const Sync &pred = sync[res.aliasPredecessor];
+                    sync[a.resource] = {VK_IMAGE_LAYOUT_UNDEFINED, pred.writeStage | pred.readStages,
+                                        pred.writeAccess, 0, 0};
+                }
+
+                addBarrier(batch, a.resource, GetAccessInfo(a.access, pass.type, res.aspect), a.write);
+            }
+
+            flush(batch);
+
+            if (pass.execute)
+                pass.execute(cmd);
+
+            // Layout en que el pase deja la imagen por su cuenta (finalLayout del VkRenderPass)
+            for (const auto &a : pass.accesses)
+            {
+                if (a.write && a.layoutAfter != VK_IMAGE_LAYOUT_UNDEFINED && m_Resources[a.resource].isImage)
+                    sync[a.resource].layout = a.layoutAfter;
+            }
+        }
+
+        // Imágenes importadas: dejarlas en el layout que esperan sus usuarios fuera del grafo
+        BarrierBatch finalBatch;
+        for (RGResource r = 0; r < m_Resources.size(); ++r)
+        {
+            const Resource &res = m_Resources[r];
+            if (!res.imported || !res.isImage || res.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+                continue;
+
+            AccessInfo info{res.finalLayout, res.finalStage, res.finalAccess};
+            addBarrier(finalBatch, r, info, (res.finalAccess & kWriteAccessMask) != 0);
+        }
+        flush(finalBatch);
+    }
+}
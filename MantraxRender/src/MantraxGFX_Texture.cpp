@@ -0,0 +1,90 @@
+#include "../include/MantraxGFX_Texture.h"
+
+namespace Mantrax
+{
+    bool IsBlockCompressedFormat(VkFormat format)
+    {
+        return GetFormatBlockExtent(format) == 4;
+    }
+
+    uint32_t GetFormatBlockExtent(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return 1;
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    uint32_t GetFormatBlockBytes(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return 4;
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            return 8;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    size_t GetTextureLevelSize(VkFormat format, uint32_t width, uint32_t height)
+    {
+        uint32_t block = GetFormatBlockExtent(format);
+        if (block == 0)
+            return 0;
+
+        size_t blocksX = (width + block - 1) / block;
+        size_t blocksY = (height + block - 1) / block;
+        return blocksX * blocksY * GetFormatBlockBytes(format);
+    }
+
+    const char *GetTextureFormatName(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8G8B8A8_UNORM: return "RGBA8";
+        case VK_FORMAT_R8G8B8A8_SRGB: return "RGBA8 sRGB";
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK: return "BC1";
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK: return "BC1 sRGB";
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK: return "BC1A";
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK: return "BC1A sRGB";
+        case VK_FORMAT_BC3_UNORM_BLOCK: return "BC3";
+        case VK_FORMAT_BC3_SRGB_BLOCK: return "BC3 sRGB";
+        case VK_FORMAT_BC5_UNORM_BLOCK: return "BC5";
+        case VK_FORMAT_BC7_UNORM_BLOCK: return "BC7";
+        case VK_FORMAT_BC7_SRGB_BLOCK: return "BC7 sRGB";
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK: return "ASTC 4x4";
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK: return "ASTC 4x4 sRGB";
+        default: return "?";
+        }
+    }
+}
@@ -8,7 +8,10 @@ namespace Mantrax
           m_MaxDeltaTime(0.1f),
           m_FrameCount(0),
           m_FPSFrameCount(0),
-          m_FPS(0)
+          m_FPS(0),
+          m_InputLatencyMs(0.0f),
+          m_PeakInputLatencyMs(0.0f),
+          m_WindowPeakLatencyMs(0.0f)
     {
         Start();
     }
@@ -23,6 +26,9 @@ namespace Mantrax
         m_FrameCount = 0;
         m_FPSFrameCount = 0;
         m_FPS = 0;
+        m_InputLatencyMs = 0.0f;
+        m_PeakInputLatencyMs = 0.0f;
+        m_WindowPeakLatencyMs = 0.0f;
     }
 
     void Timer::Update()
@@ -54,7 +60,22 @@ namespace Mantrax
             m_FPS = m_FPSFrameCount;
             m_FPSFrameCount = 0;
             m_FPSCounterTime = currentTime;
+
+            m_PeakInputLatencyMs = m_WindowPeakLatencyMs;
+            m_WindowPeakLatencyMs = 0.0f;
         }
     }
 
+    void Timer::RecordInputLatency(float milliseconds)
+    {
+        // Media exponencial: estable para mostrar, reacciona en ~10 frames
+        if (m_InputLatencyMs <= 0.0f)
+            m_InputLatencyMs = milliseconds;
+        else
+            m_InputLatencyMs += (milliseconds - m_InputLatencyMs) * 0.1f;
+
+        if (milliseconds > m_WindowPeakLatencyMs)
+            m_WindowPeakLatencyMs = milliseconds;
+    }
+
 }
\ No newline at end of file